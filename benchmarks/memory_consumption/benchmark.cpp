@@ -22,7 +22,12 @@ struct Allocation
 // BENCHMARK VARIABLES
 static constexpr std::size_t SIZE_CLASS_COUNT = 8;
 static constexpr std::size_t SCALE = 25;
+// By default all sizes are power of two. Build with -DUSE_NON_POW2_SIZES for sizes which fall between power of two size classes
+#ifdef USE_NON_POW2_SIZES
+static constexpr std::size_t SIZE_CLASSES[SIZE_CLASS_COUNT] = { 24,48,80,160,320,600,1100,2100 };
+#else
 static constexpr std::size_t SIZE_CLASSES[SIZE_CLASS_COUNT] = { 16,32,64,128,256,512,1024,2048 };
+#endif
 static constexpr std::size_t ALLOCATION_COUNTS_FOR_SIZE_CLASSES[SIZE_CLASS_COUNT] = { 4089*SCALE,2044*SCALE,1022*SCALE,511*SCALE,255*SCALE,127*SCALE,63*SCALE,31*SCALE};
 static constexpr std::size_t TOTAL_ALLOCATIONS_PER_THREAD = 8142*SCALE;
 static constexpr std::size_t THREAD_COUNT = 16;
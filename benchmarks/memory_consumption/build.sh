@@ -1,3 +1,4 @@
 #!/bin/bash
-rm -f benchmark
-g++ -DNDEBUG -O3 -fno-rtti -std=c++2a -o benchmark benchmark.cpp -pthread
\ No newline at end of file
+rm -f benchmark benchmark_non_pow2
+g++ -DNDEBUG -O3 -fno-rtti -std=c++2a -o benchmark benchmark.cpp -pthread
+g++ -DNDEBUG -DUSE_NON_POW2_SIZES -O3 -fno-rtti -std=c++2a -o benchmark_non_pow2 benchmark.cpp -pthread
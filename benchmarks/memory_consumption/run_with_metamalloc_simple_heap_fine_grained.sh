@@ -0,0 +1,22 @@
+#!/bin/bash
+# Requires metamalloc_simple_heap_fine_grained.so , run build.sh in examples/integration-linux_so_ld_preload
+# Pass ./benchmark_non_pow2 as the first argument for the non power of two size distribution
+BENCHMARK=${1:-./benchmark}
+# Our initial VM allocation -> 54525952 = 52 MB
+export metamalloc_simple_heap_fine_grained_arena_capacity=54525952
+export metamalloc_thread_local_heap_cache_count=0
+export metamalloc_simple_heap_fine_grained_logical_page_size=65536
+# 40 VALUES ARE FOR SIZECLASSES = 16 32 48 64 80 96 112 128 160 192 224 256 320 384 448 512 640 768 896 1024 1280 1536 1792 2048 2560 ... 32768
+# AS FOR SIMPLEHEAPPOW2 , ONLY THE BINS USED BY THE BENCHMARK GET 25 PAGES , AS INITIAL PAGES OF UNUSED BINS WOULD STAY
+if [ "$(basename $BENCHMARK)" = "benchmark_non_pow2" ]; then
+    # 24 48 80 160 320 600 1100 2100 -> 32 48 80 160 320 640 1280 2560
+    export metamalloc_simple_heap_fine_grained_central_page_counts=1,25,25,1,25,1,1,1,25,1,1,1,25,1,1,1,25,1,1,1,25,1,1,1,25,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1
+else
+    # 16 32 64 128 256 512 1024 2048
+    export metamalloc_simple_heap_fine_grained_central_page_counts=25,25,1,25,1,1,1,25,1,1,1,25,1,1,1,25,1,1,1,25,1,1,1,25,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1
+fi
+export metamalloc_simple_heap_fine_grained_local_page_counts=0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
+# grow coefficient = 0 means we will be growing in virtual memory at minimum level
+export metamalloc_simple_heap_fine_grained_grow_coefficient=0
+export metamalloc_simple_heap_fine_grained_logical_page_recycling_threshold=1
+LD_PRELOAD=../../examples/integration-linux_so_ld_preload/metamalloc_simple_heap_fine_grained.so $BENCHMARK
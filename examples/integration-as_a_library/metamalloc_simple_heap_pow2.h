@@ -87,7 +87,6 @@ void metamalloc_initialise()
     LocalHeapType::HeapCreationParams params_local;
     params_local.m_logical_page_size = params_central.m_logical_page_size;
     params_local.m_logical_page_recycling_threshold = params_central.m_logical_page_recycling_threshold;
-    params_local.m_segment_deallocation_queue_initial_capacity = EnvironmentVariable::get_variable("metamalloc_simple_heappow2_deallocation_queue_initial_capacity", 3276800);
 
     EnvironmentVariable::set_numeric_array_from_comma_separated_value_string(params_central.m_bin_logical_page_counts, EnvironmentVariable::get_variable("metamalloc_simple_heappow2_central_page_counts", "1,1,1,1,1,1,1,1,1,1,1,1"));
     EnvironmentVariable::set_numeric_array_from_comma_separated_value_string(params_local.m_bin_logical_page_counts, EnvironmentVariable::get_variable("metamalloc_simple_heappow2_local_page_counts", "100,100,100,100,100,100,100,100,100,100,100,100"));
@@ -2,6 +2,8 @@
 rm -f metamalloc*so sample_app
 # RELEASE VERSION
 g++ -DNDEBUG -O3 -fno-rtti -shared -I../../ -I../../examples/ -std=c++2a  -fPIC -o metamalloc_simple_heap_pow2.so metamalloc_simple_heap_pow2.cpp -lstdc++ -pthread -ldl
+# RELEASE VERSION WITH FINE GRAINED SIZE CLASSES
+g++ -DNDEBUG -DUSE_SIMPLE_HEAP_FINE_GRAINED -O3 -fno-rtti -shared -I../../ -I../../examples/ -std=c++2a  -fPIC -o metamalloc_simple_heap_fine_grained.so metamalloc_simple_heap_pow2.cpp -lstdc++ -pthread -ldl
 # DEBUG VERSION
 g++ -shared -I../../ -I../../examples/ -std=c++2a -fPIC -g -o metamalloc_simple_heap_pow2_debug.so metamalloc_simple_heap_pow2.cpp -lstdc++ -pthread -ldl
 # SAMPLE APP
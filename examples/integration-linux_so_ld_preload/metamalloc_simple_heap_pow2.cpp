@@ -54,12 +54,29 @@
 //#define ENABLE_TRACER
 #include <metamalloc.h>
 #include <simple_heap_pow2.h>
+#include <simple_heap_fine_grained.h>
 using namespace metamalloc;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // ALLOCATOR TYPE
+// Define USE_SIMPLE_HEAP_FINE_GRAINED to build with 4 size classes per doubling instead of power of two size classes
+// Its environment variables start with metamalloc_simple_heap_fine_grained_ instead of metamalloc_simple_heappow2_ and page count lists have 40 values
+// Its thread local heaps use a shared logical page pool by default , so that 40 bins don't hold logical pages separately
+#ifdef USE_SIMPLE_HEAP_FINE_GRAINED
+using CentralHeapType = SimpleHeapFineGrained<ConcurrencyPolicy::CENTRAL>;
+using LocalHeapType = SimpleHeapFineGrained<ConcurrencyPolicy::THREAD_LOCAL>;
+#define HEAP_ENVIRONMENT_VARIABLE(name) "metamalloc_simple_heap_fine_grained_" name
+static constexpr const char* DEFAULT_CENTRAL_PAGE_COUNTS = "1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1";
+static constexpr const char* DEFAULT_LOCAL_PAGE_COUNTS = "15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15"; // Same total as SimpleHeapPow2 defaults
+static constexpr std::size_t DEFAULT_USE_SHARED_LOGICAL_PAGE_POOL = 1;
+#else
 using CentralHeapType = SimpleHeapPow2<ConcurrencyPolicy::CENTRAL>;
 using LocalHeapType = SimpleHeapPow2<ConcurrencyPolicy::THREAD_LOCAL>;
+#define HEAP_ENVIRONMENT_VARIABLE(name) "metamalloc_simple_heappow2_" name
+static constexpr const char* DEFAULT_CENTRAL_PAGE_COUNTS = "1,1,1,1,1,1,1,1,1,1,1,1";
+static constexpr const char* DEFAULT_LOCAL_PAGE_COUNTS = "50,50,50,50,50,50,50,50,50,50,50,50";
+static constexpr std::size_t DEFAULT_USE_SHARED_LOGICAL_PAGE_POOL = 0;
+#endif
 
 using ScalableAllocatorType = ScalableAllocator<
     CentralHeapType,
@@ -87,30 +104,30 @@ void initialise_shared_object()
     /////////////////////////////////////////////////////////////////////////////////////////////
     std::size_t default_arena_capacity = 149946368;
 
-    std::size_t ARENA_CAPACITY = EnvironmentVariable::get_variable("metamalloc_simple_heappow2_arena_capacity", default_arena_capacity);
+    std::size_t ARENA_CAPACITY = EnvironmentVariable::get_variable(HEAP_ENVIRONMENT_VARIABLE("arena_capacity"), default_arena_capacity);
     std::size_t thread_local_heap_cache_count = EnvironmentVariable::get_variable("metamalloc_thread_local_heap_cache_count", 4);
 
     CentralHeapType::HeapCreationParams params_central;
-    params_central.m_logical_page_size          = EnvironmentVariable::get_variable("metamalloc_simple_heappow2_logical_page_size", 65536);
-    params_central.m_segment_grow_coefficient               = EnvironmentVariable::get_variable("metamalloc_simple_heappow2_grow_coefficient", 0.0);
-    params_central.m_logical_page_recycling_threshold = EnvironmentVariable::get_variable("metamalloc_simple_heappow2_logical_page_recycling_threshold", 1000);
+    params_central.m_logical_page_size          = EnvironmentVariable::get_variable(HEAP_ENVIRONMENT_VARIABLE("logical_page_size"), 65536);
+    params_central.m_segment_grow_coefficient               = EnvironmentVariable::get_variable(HEAP_ENVIRONMENT_VARIABLE("grow_coefficient"), 0.0);
+    params_central.m_logical_page_recycling_threshold = EnvironmentVariable::get_variable(HEAP_ENVIRONMENT_VARIABLE("logical_page_recycling_threshold"), 1000);
 
     LocalHeapType::HeapCreationParams params_local;
     params_local.m_logical_page_size             = params_central.m_logical_page_size;
     params_local.m_logical_page_recycling_threshold   = params_central.m_logical_page_recycling_threshold;
-    params_local.m_segment_deallocation_queue_initial_capacity       = EnvironmentVariable::get_variable("metamalloc_simple_heappow2_deallocation_queue_initial_capacity", 3276800);
+    params_local.m_use_shared_logical_page_pool = EnvironmentVariable::get_variable(HEAP_ENVIRONMENT_VARIABLE("use_shared_logical_page_pool"), DEFAULT_USE_SHARED_LOGICAL_PAGE_POOL) != 0;
 
-    EnvironmentVariable::set_numeric_array_from_comma_separated_value_string(params_central.m_bin_logical_page_counts, EnvironmentVariable::get_variable("metamalloc_simple_heappow2_central_page_counts", "1,1,1,1,1,1,1,1,1,1,1,1"));
-    EnvironmentVariable::set_numeric_array_from_comma_separated_value_string(params_local.m_bin_logical_page_counts, EnvironmentVariable::get_variable("metamalloc_simple_heappow2_local_page_counts", "50,50,50,50,50,50,50,50,50,50,50,50"));
+    EnvironmentVariable::set_numeric_array_from_comma_separated_value_string(params_central.m_bin_logical_page_counts, EnvironmentVariable::get_variable(HEAP_ENVIRONMENT_VARIABLE("central_page_counts"), DEFAULT_CENTRAL_PAGE_COUNTS));
+    EnvironmentVariable::set_numeric_array_from_comma_separated_value_string(params_local.m_bin_logical_page_counts, EnvironmentVariable::get_variable(HEAP_ENVIRONMENT_VARIABLE("local_page_counts"), DEFAULT_LOCAL_PAGE_COUNTS));
 
-    trace_integer_value("metamalloc_simple_heappow2_arena_capacity", ARENA_CAPACITY);
+    trace_integer_value(HEAP_ENVIRONMENT_VARIABLE("arena_capacity"), ARENA_CAPACITY);
     trace_integer_value("metamalloc_thread_local_heap_cache_count", thread_local_heap_cache_count);
-    trace_string_value("metamalloc_simple_heappow2_central_page_counts", EnvironmentVariable::get_variable("metamalloc_simple_heappow2_central_page_counts", "1,1,1,1,1,1,1,1,1,1,1,1"));
-    trace_string_value("metamalloc_simple_heappow2_local_page_counts", EnvironmentVariable::get_variable("metamalloc_simple_heappow2_local_page_counts", "50,50,50,50,50,50,50,50,50,50,50,50"));
-    trace_integer_value("metamalloc_simple_heappow2_logical_page_size", params_central.m_logical_page_size);
-    trace_double_value("metamalloc_simple_heappow2_grow_coefficient", params_local.m_segment_grow_coefficient);
-    trace_integer_value("metamalloc_simple_heappow2_deallocation_queue_initial_capacity", params_local.m_segment_deallocation_queue_initial_capacity);
-    trace_integer_value("metamalloc_simple_heappow2_logical_page_recycling_threshold", params_local.m_logical_page_recycling_threshold);
+    trace_string_value(HEAP_ENVIRONMENT_VARIABLE("central_page_counts"), EnvironmentVariable::get_variable(HEAP_ENVIRONMENT_VARIABLE("central_page_counts"), DEFAULT_CENTRAL_PAGE_COUNTS));
+    trace_string_value(HEAP_ENVIRONMENT_VARIABLE("local_page_counts"), EnvironmentVariable::get_variable(HEAP_ENVIRONMENT_VARIABLE("local_page_counts"), DEFAULT_LOCAL_PAGE_COUNTS));
+    trace_integer_value(HEAP_ENVIRONMENT_VARIABLE("logical_page_size"), params_central.m_logical_page_size);
+    trace_double_value(HEAP_ENVIRONMENT_VARIABLE("grow_coefficient"), params_local.m_segment_grow_coefficient);
+    trace_integer_value(HEAP_ENVIRONMENT_VARIABLE("logical_page_recycling_threshold"), params_local.m_logical_page_recycling_threshold);
+    trace_integer_value(HEAP_ENVIRONMENT_VARIABLE("use_shared_logical_page_pool"), params_local.m_use_shared_logical_page_pool);
     /////////////////////////////////////////////////////////////////////////////////////////////
     ScalableAllocatorType::get_instance().set_thread_local_heap_cache_count(thread_local_heap_cache_count);
     bool success = ScalableAllocatorType::get_instance().create(params_central, params_local, ARENA_CAPACITY);
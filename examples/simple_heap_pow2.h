@@ -4,6 +4,11 @@
     - LOGICAL PAGES ARE PLACED ON ADDRESSES WHICH ARE ALIGNED TO THEIR LOGICAL PAGE SIZES. 
       THEREFORE SEGMENT WILL TAKE ADVANTAGE OF IT DURING DEALLOCATIONS BY  DIRECTLY ACCESSING A LOGICAL PAGE HEADER BY BITWISE-APPLYING A MASK
       (SEE THE LAST TEMPLATE ARG OF SegmentSmallObject/ CLASS SEGMENT.)
+
+    - BINS CAN HAVE DIFFERENT LOGICAL PAGE SIZES. AS A 64 BYTE HEADER SITS IN EACH LOGICAL PAGE, A 64KB PAGE HOLDS ONLY ONE 32KB CHUNK AND THREE 16KB CHUNKS.
+      GIVING BIGGER LOGICAL PAGES TO LARGE SIZECLASSES FIXES THAT ( FOR EX 32KB SIZECLASS IN 1MB PAGES WILL USE 31/32 OF A PAGE ).
+      IN THAT CASE BINS WITH SMALLER PAGES PLACE THEM BACK TO BACK IN BLOCKS WHICH ARE ALIGNED TO THE BIGGEST LOGICAL PAGE SIZE AND GROW BY WHOLE BLOCKS , SO THAT THE MASK LOOKUP STILL WORKS WITH A SINGLE MASK.
+      THE MASK FINDS THE HEADER OF A BLOCK'S FIRST LOGICAL PAGE , WHICH HAS THE SIZE CLASS OF THE ENTIRE BLOCK , SO THE FIRST LOGICAL PAGE OF EACH BLOCK IS NOT RECYCLED WHILE ITS SEGMENT LIVES
 */
 #ifndef __SIMPLE_HEAP_POW2_H__
 #define __SIMPLE_HEAP_POW2_H__
@@ -17,20 +22,35 @@ template <
             ConcurrencyPolicy concurrency_policy = ConcurrencyPolicy::SINGLE_THREAD,
             typename ArenaType = Arena<>,
             PageRecyclingPolicy page_recycling_policy = PageRecyclingPolicy::IMMEDIATE,
-            typename LogicalPageType = LogicalPage<>
+            typename LogicalPageType = LogicalPage<>,
+            RemoteDeallocationPolicy remote_deallocation_policy = RemoteDeallocationPolicy::DEALLOCATION_QUEUE,
+            CentralFreeListPolicy central_free_list_policy = CentralFreeListPolicy::LOCKED
         >
-class SimpleHeapPow2 : public HeapBase<SimpleHeapPow2<concurrency_policy, ArenaType, page_recycling_policy, LogicalPageType>, concurrency_policy> // CRTP derivation
+class SimpleHeapPow2 : public HeapBase<SimpleHeapPow2<concurrency_policy, ArenaType, page_recycling_policy, LogicalPageType, remote_deallocation_policy, central_free_list_policy>, concurrency_policy> // CRTP derivation
 {
     public:
 
         SimpleHeapPow2() = default;
         SimpleHeapPow2(const SimpleHeapPow2& other) = delete;
         SimpleHeapPow2(SimpleHeapPow2&& other) = delete;
-        ~SimpleHeapPow2() = default;
+        ~SimpleHeapPow2()
+        {
+            if (m_arena != nullptr)
+            {
+                m_logical_page_pool.release_free_slots(m_arena);
+            }
+
+            this->template destroy_extra_region_table<typename ArenaType::MetadataAllocator>();
+        }
         SimpleHeapPow2& operator= (const SimpleHeapPow2& other) = delete;       
         SimpleHeapPow2& operator=(SimpleHeapPow2&& other) = delete;
 
-        using SegmentType = Segment <concurrency_policy, LogicalPageType, ArenaType, page_recycling_policy, true>; // The last is true as we place logical pages at "logical page size" aligned addresses
+        using SegmentType = Segment <concurrency_policy, LogicalPageType, ArenaType, page_recycling_policy, true, remote_deallocation_policy, central_free_list_policy>; // true as we place logical pages at "logical page size" aligned addresses
+
+        using BaseType = HeapBase<SimpleHeapPow2<concurrency_policy, ArenaType, page_recycling_policy, LogicalPageType, remote_deallocation_policy, central_free_list_policy>, concurrency_policy>;
+        using BaseType::allocate;                   // allocate<size>
+        using BaseType::deallocate;                 // deallocate<size>
+        using BaseType::deallocate_from_owner;      // deallocate_from_owner<size>
 
         static constexpr std::size_t MIN_SIZE_CLASS = 16;
         static constexpr std::size_t BIN_COUNT = 12; // 16 32 64 128 256 512 1024 2048 4096 8192 16384 32768
@@ -40,66 +60,135 @@ class SimpleHeapPow2 : public HeapBase<SimpleHeapPow2<concurrency_policy, ArenaT
         {
             // BINS
             std::size_t m_logical_page_size = 65536;
-            std::size_t m_bin_logical_page_counts[BIN_COUNT] = { 1,1,1,1,1,1,1,1,1,1,1,1 };
+            std::size_t m_bin_logical_page_counts[BIN_COUNT] = { 1,1,1,1,1,1,1,1,1,1,1,1 }; // Bins with smaller logical pages than the biggest one round them up to fill blocks
+            std::size_t m_bin_logical_page_sizes[BIN_COUNT] = { 0,0,0,0,0,0,0,0,0,0,0,0 }; // 0 means m_logical_page_size. Otherwise should be a power of two. Arena page alignment should be the biggest one
             // SEGMENT LEVEL
             std::size_t m_logical_page_recycling_threshold = 0;
             double m_segment_grow_coefficient = 1.0;
-            std::size_t m_segment_deallocation_queue_initial_capacity = 65536; // applies in thread-local case
+            std::size_t m_segment_deallocation_queue_drain_budget = 128; // applies in thread-local case with RemoteDeallocationPolicy::DEALLOCATION_QUEUE , 0 means no limit
+            // HEAP LEVEL
+            bool m_use_shared_logical_page_pool = false; // Thread local heaps only. Bins start empty and take logical pages from a pool of the sum of bin logical page counts on demand.
+                                                         // Recycled logical pages go back to the pool , so the pool size is the only bound instead of fixed per bin counts.
+                                                         // Requires the same logical page size for all bins
+            std::size_t m_max_extra_region_count = 0;    // Thread local heaps with a shared logical page pool only. When the pool runs out , the heap reserves another region from the arena
+                                                         // and adds its logical pages to the pool instead of failing over to the central heap. At most HeapBase::MAX_EXTRA_REGION_COUNT
+            std::size_t m_extra_region_logical_page_count = 0; // 0 means the initial pool size
         };
 
         [[nodiscard]] bool create(const HeapCreationParams& params, ArenaType* arena)
         {
             //////////////////////////////////////////////////////////////////////////////////////////////
             // 1. CHECKS
-            if (arena == nullptr || params.m_logical_page_size <= 0 || arena->page_alignment() != params.m_logical_page_size)
+            if (arena == nullptr || params.m_logical_page_size <= 0)
             {
                 return false;
             }
 
-            // Logical page sizes should be multiples of page allocation granularity ( 4KB on Linux ,64 KB on Windows )
-            if (!MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(params.m_logical_page_size) )
+            std::size_t bin_logical_page_sizes[BIN_COUNT];
+            m_logical_page_alignment = 0;
+
+            for (std::size_t i = 0; i < BIN_COUNT; i++)
+            {
+                bin_logical_page_sizes[i] = params.m_bin_logical_page_sizes[i] == 0 ? params.m_logical_page_size : params.m_bin_logical_page_sizes[i];
+
+                // Logical page sizes should be multiples of page allocation granularity ( 4KB on Linux ,64 KB on Windows )
+                if (!MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(bin_logical_page_sizes[i]))
+                {
+                    return false;
+                }
+
+                m_logical_page_alignment = bin_logical_page_sizes[i] > m_logical_page_alignment ? bin_logical_page_sizes[i] : m_logical_page_alignment;
+            }
+
+            // Different logical page sizes are looked up with the biggest one's mask , that works only if all are power of two
+            for (std::size_t i = 0; i < BIN_COUNT; i++)
+            {
+                if (bin_logical_page_sizes[i] != m_logical_page_alignment && (!Pow2Utilities::is_power_of_two(bin_logical_page_sizes[i]) || !Pow2Utilities::is_power_of_two(m_logical_page_alignment)))
+                {
+                    return false;
+                }
+            }
+
+            if (arena->page_alignment() != m_logical_page_alignment)
             {
                 return false;
             }
 
-            m_logical_page_size = params.m_logical_page_size;
+            if (params.m_use_shared_logical_page_pool)
+            {
+                if (concurrency_policy != ConcurrencyPolicy::THREAD_LOCAL)
+                {
+                    return false;
+                }
+
+                for (std::size_t i = 0; i < BIN_COUNT; i++)
+                {
+                    if (bin_logical_page_sizes[i] != m_logical_page_alignment)
+                    {
+                        return false; // Any pool slot should be usable by any bin
+                    }
+                }
+            }
+
+            if (params.m_max_extra_region_count > 0 && (!params.m_use_shared_logical_page_pool || params.m_max_extra_region_count > this->MAX_EXTRA_REGION_COUNT))
+            {
+                return false; // Extra regions are used through the pool
+            }
+
+            m_arena = arena;
 
             //////////////////////////////////////////////////////////////////////////////////////////////
             // 2. CALCULATE REQUIRED BUFFER SIZE
             std::size_t required_buffer_size{ 0 };
-            std::size_t size_class = MIN_SIZE_CLASS;
 
             for (std::size_t i = 0; i < BIN_COUNT; i++)
             {
-                required_buffer_size += (params.m_bin_logical_page_counts[i] * m_logical_page_size);
-                size_class = size_class << 1;
+                required_buffer_size += MultipleUtilities::get_next_pow2_multiple_of(params.m_bin_logical_page_counts[i] * bin_logical_page_sizes[i], m_logical_page_alignment);
             }
 
             this->m_buffer_length = required_buffer_size;
 
+            if (params.m_max_extra_region_count > 0)
+            {
+                std::size_t extra_region_length = params.m_extra_region_logical_page_count == 0 ? required_buffer_size : params.m_extra_region_logical_page_count * m_logical_page_alignment;
+
+                if (this->template create_extra_region_table<typename ArenaType::MetadataAllocator>(extra_region_length, params.m_max_extra_region_count) == false)
+                {
+                    return false;
+                }
+            }
+
             //////////////////////////////////////////////////////////////////////////////////////////////
             // 3. ALLOCATE BUFFER
             this->m_buffer_address = reinterpret_cast<uint64_t>(arena->allocate(this->m_buffer_length));
 
+            if (params.m_use_shared_logical_page_pool)
+            {
+                m_logical_page_pool.create(reinterpret_cast<char*>(this->m_buffer_address), m_logical_page_alignment, this->m_buffer_length / m_logical_page_alignment);
+            }
+
             //////////////////////////////////////////////////////////////////////////////////////////////
             // 4. DISTRIBUTE BUFFER TO BINS
             std::size_t buffer_index{ 0 };
-            size_class = MIN_SIZE_CLASS;
+            std::size_t size_class = MIN_SIZE_CLASS;
             
             for (std::size_t i = 0; i < BIN_COUNT; i++)
             {
-                auto required_logical_page_count = params.m_bin_logical_page_counts[i];
-                auto bin_buffer_size = required_logical_page_count * m_logical_page_size;
+                // Bins with smaller logical pages fill whole blocks of the biggest logical page size , see SegmentCreationParameters::m_logical_page_alignment
+                auto bin_buffer_size = params.m_use_shared_logical_page_pool ? 0 : MultipleUtilities::get_next_pow2_multiple_of(params.m_bin_logical_page_counts[i] * bin_logical_page_sizes[i], m_logical_page_alignment);
+                auto required_logical_page_count = bin_buffer_size / bin_logical_page_sizes[i];
 
                 SegmentCreationParameters segment_params;
                 segment_params.m_size_class = static_cast<uint32_t>(size_class);
                 segment_params.m_logical_page_count = required_logical_page_count;
-                segment_params.m_logical_page_size = params.m_logical_page_size;
+                segment_params.m_logical_page_size = bin_logical_page_sizes[i];
+                segment_params.m_logical_page_alignment = m_logical_page_alignment;
                 segment_params.m_page_recycling_threshold = params.m_logical_page_recycling_threshold;
                 segment_params.m_grow_coefficient = params.m_segment_grow_coefficient;
-                segment_params.m_deallocation_queue_initial_capacity = params.m_segment_deallocation_queue_initial_capacity;
+                segment_params.m_deallocation_queue_drain_budget = params.m_segment_deallocation_queue_drain_budget;
+                segment_params.m_logical_page_pool = params.m_use_shared_logical_page_pool ? &m_logical_page_pool : nullptr;
 
-                bool success = m_bins[i].create(reinterpret_cast<char*>(this->m_buffer_address) + buffer_index, arena, segment_params);
+                bool success = m_bins[i].create(params.m_use_shared_logical_page_pool ? nullptr : reinterpret_cast<char*>(this->m_buffer_address) + buffer_index, arena, segment_params);
 
                 if (!success)
                 {
@@ -118,7 +207,15 @@ class SimpleHeapPow2 : public HeapBase<SimpleHeapPow2<concurrency_policy, ArenaT
         {
             std::size_t adjusted_size = Pow2Utilities::get_first_pow2_of(size);
             adjusted_size = adjusted_size < MIN_SIZE_CLASS ? MIN_SIZE_CLASS : adjusted_size;
-            return m_bins[SizeUtilities::get_pow2_bin_index_from_size<MIN_SIZE_CLASS, MAX_BIN_INDEX>(adjusted_size)].allocate(adjusted_size);
+            auto bin_index = SizeUtilities::get_pow2_bin_index_from_size<MIN_SIZE_CLASS, MAX_BIN_INDEX>(adjusted_size);
+            void* ret = m_bins[bin_index].allocate(adjusted_size);
+
+            if (unlikely(ret == nullptr) && grow_by_extra_region())
+            {
+                ret = m_bins[bin_index].allocate(adjusted_size);
+            }
+
+            return ret;
         }
 
         // YOU DON'T NEED TO IMPLEMENT AN ALLOCATE METHOD THAT ACCEPTS AN ALIGNMENT PARAMETER, AS allocate_aligned IS IMPLEMENTED IN heap_base
@@ -126,13 +223,83 @@ class SimpleHeapPow2 : public HeapBase<SimpleHeapPow2<concurrency_policy, ArenaT
         ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
         void deallocate(void* ptr)
         {
-            auto size_class = static_cast<std::size_t>(SegmentType::get_size_class_from_address(ptr, m_logical_page_size));
+            auto size_class = static_cast<std::size_t>(SegmentType::get_size_class_from_address(ptr, m_logical_page_alignment));
             m_bins[SizeUtilities::get_pow2_bin_index_from_size<MIN_SIZE_CLASS, MAX_BIN_INDEX>(size_class)].deallocate(ptr);
         }
 
+        // You need to implement it in case it will be used as a thread local heap in a thread caching allocator
+        // ScalableAllocator calls it instead of deallocate when the calling thread owns the heap. See ScalableAllocator::deallocate
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        void deallocate_from_owner(void* ptr)
+        {
+            auto size_class = static_cast<std::size_t>(SegmentType::get_size_class_from_address(ptr, m_logical_page_alignment));
+            m_bins[SizeUtilities::get_pow2_bin_index_from_size<MIN_SIZE_CLASS, MAX_BIN_INDEX>(size_class)].deallocate_from_owner(ptr);
+        }
+
+        // You need to implement the 5 methods below for compile time sizes , for ex sizeof(T). See HeapBase::allocate<size> and ScalableAllocator::allocate<size>
+        static constexpr bool has_bin_for_size(std::size_t size)
+        {
+            return size <= LARGEST_SIZE_CLASS;
+        }
+
+        static constexpr std::size_t get_bin_index_from_size(std::size_t size)
+        {
+            std::size_t size_class = Pow2Utilities::compile_time_first_pow2_of(size);
+            size_class = size_class < MIN_SIZE_CLASS ? MIN_SIZE_CLASS : size_class;
+            return SizeUtilities::compile_time_get_pow2_bin_index_from_size<MIN_SIZE_CLASS, MAX_BIN_INDEX>(size_class);
+        }
+
+        template <std::size_t bin_index>
+        [[nodiscard]] FORCE_INLINE void* allocate_from_bin()
+        {
+            void* ret = m_bins[bin_index].allocate();
+
+            if (unlikely(ret == nullptr) && grow_by_extra_region())
+            {
+                ret = m_bins[bin_index].allocate();
+            }
+
+            return ret;
+        }
+
+        template <std::size_t bin_index>
+        FORCE_INLINE void deallocate_from_bin(void* ptr)
+        {
+            m_bins[bin_index].deallocate(ptr);
+        }
+
+        template <std::size_t bin_index>
+        FORCE_INLINE void deallocate_from_owner_to_bin(void* ptr)
+        {
+            m_bins[bin_index].deallocate_from_owner(ptr);
+        }
+
+        // You need to implement it in case it will be used as a central heap in a thread caching allocator with transfer caches. See TransferCache
+        std::size_t get_size_class_from_size(std::size_t size)
+        {
+            std::size_t size_class = Pow2Utilities::get_first_pow2_of(size);
+            return size_class < MIN_SIZE_CLASS ? MIN_SIZE_CLASS : size_class;
+        }
+
+        // You need to implement it in case it will be used as a central heap in a thread caching allocator with transfer caches
+        // Allocates up to 'count' chunks which can hold 'size' bytes in one go , links them through their first 8 bytes and returns their number
+        std::size_t allocate_batch(std::size_t size, std::size_t count, void** first)
+        {
+            auto size_class = get_size_class_from_size(size);
+            return m_bins[SizeUtilities::get_pow2_bin_index_from_size<MIN_SIZE_CLASS, MAX_BIN_INDEX>(size_class)].allocate_batch(count, first);
+        }
+
+        // You need to implement it in case it will be used in a thread caching allocator with remote deallocation batching or transfer caches
+        // All chunks in a batch belong to the same size class. See RemoteDeallocationCache and TransferCache
+        void deallocate_batch(void* first, void* last)
+        {
+            auto size_class = static_cast<std::size_t>(SegmentType::get_size_class_from_address(first, m_logical_page_alignment));
+            m_bins[SizeUtilities::get_pow2_bin_index_from_size<MIN_SIZE_CLASS, MAX_BIN_INDEX>(size_class)].deallocate_batch(first, last);
+        }
+
         std::size_t get_usable_size(void* ptr)
         {
-            auto size_class = static_cast<std::size_t>(SegmentType::get_size_class_from_address(ptr, m_logical_page_size));
+            auto size_class = static_cast<std::size_t>(SegmentType::get_size_class_from_address(ptr, m_logical_page_alignment));
             return size_class;
         }
 
@@ -155,10 +322,90 @@ class SimpleHeapPow2 : public HeapBase<SimpleHeapPow2<concurrency_policy, ArenaT
             }
         }
 
+        // You need to implement the 2 methods below in case prewarming of thread local heaps will lock pages. See ScalableAllocator::prewarm_current_thread
+        // Locks logical pages of the bin which serves 'size' , see Segment::lock_pages
+        bool lock_pages(std::size_t size)
+        {
+            if (size > LARGEST_SIZE_CLASS)
+            {
+                return false;
+            }
+
+            return m_bins[SizeUtilities::get_pow2_bin_index_from_size<MIN_SIZE_CLASS, MAX_BIN_INDEX>(get_size_class_from_size(size))].lock_pages();
+        }
+
+        void unlock_pages()
+        {
+            for (std::size_t i = 0; i < BIN_COUNT; i++)
+            {
+                m_bins[i].unlock_pages();
+            }
+        }
+
+        // You need to implement it if thread-local heaps will be drained explicitly. See ScalableAllocator::drain_thread_local_heap
+        std::size_t drain(std::size_t budget = 0)
+        {
+            std::size_t processed_count = 0;
+
+            for (std::size_t i = 0; i < BIN_COUNT; i++)
+            {
+                if (budget != 0 && processed_count >= budget)
+                {
+                    break;
+                }
+
+                processed_count += m_bins[i].drain(budget == 0 ? 0 : budget - processed_count);
+            }
+
+            return processed_count;
+        }
+
         std::size_t get_bin_logical_page_count(std::size_t bin_index)
         {
             return m_bins[bin_index].get_logical_page_count();
         }
+
+        std::size_t get_free_logical_page_pool_slot_count() const
+        {
+            return m_logical_page_pool.get_free_slot_count();
+        }
+
+        // You need to implement it in case it will be used as a thread local heap in a thread caching allocator
+        // Called after transfer_logical_pages_from unless other heaps can still steal them. See ScalableAllocator::set_page_stealing
+        // Also called by ScalableAllocator to shrink heaps when page stealing is disabled , otherwise it releases slots itself to update its stolen logical page table. Returns the number of released slots
+        std::size_t release_free_logical_page_pool_slots(std::size_t reserved_slot_count = 0)
+        {
+            if (m_arena == nullptr)
+            {
+                return 0;
+            }
+
+            return m_logical_page_pool.release_free_slots(m_arena, reserved_slot_count);
+        }
+
+        // Number of logical pages which belong to the heap , either free in its pool or used by its bins
+        std::size_t get_logical_page_pool_capacity() const
+        {
+            return m_logical_page_pool.get_capacity();
+        }
+
+        // You need to implement the 3 methods below in case it will be used as a thread local heap in a thread caching allocator with page stealing
+        // They can be called by other threads. See ScalableAllocator::set_page_stealing
+        std::size_t get_logical_page_pool_slot_size() const
+        {
+            return m_logical_page_pool.get_slot_size();
+        }
+
+        [[nodiscard]] void* steal_logical_page_pool_slot(std::size_t reserved_slot_count)
+        {
+            return m_logical_page_pool.steal(reserved_slot_count);
+        }
+
+        // The slot will be used by the next bin which runs out of logical pages
+        void adopt_logical_page_pool_slot(void* slot)
+        {
+            m_logical_page_pool.adopt(slot);
+        }
         
         std::size_t get_max_allocation_size()
         {
@@ -166,8 +413,30 @@ class SimpleHeapPow2 : public HeapBase<SimpleHeapPow2<concurrency_policy, ArenaT
         }
 
     private:
-        std::size_t m_logical_page_size = 0;
+        std::size_t m_logical_page_alignment = 0; // The biggest logical page size among bins , logical pages are grouped in blocks aligned to it
         SegmentType m_bins[BIN_COUNT];
+        LogicalPagePool m_logical_page_pool; // Exists in all heaps so that layouts don't depend on creation parameters. Used if m_use_shared_logical_page_pool is set
+        ArenaType* m_arena = nullptr;
+
+        // Called when a bin can't get a logical page from the pool , returns false if the heap can't grow
+        bool grow_by_extra_region()
+        {
+            if (likely(this->can_add_extra_region() == false))
+            {
+                return false;
+            }
+
+            auto region = static_cast<char*>(m_arena->allocate(this->m_extra_regions->m_region_length));
+
+            if (region == nullptr)
+            {
+                return false;
+            }
+
+            this->add_extra_region(region);
+            m_logical_page_pool.adopt_buffer(region, this->m_extra_regions->m_region_length / m_logical_page_alignment);
+            return true;
+        }
         static constexpr inline std::size_t LARGEST_SIZE_CLASS = Pow2Utilities::compile_time_pow2<BIN_COUNT + 3>(); // +3 since we skip bin2 bin4 and bin8 as the sizeclasses start from 16
 };
 
@@ -11,6 +11,8 @@
 
     - SUPPORTS NO LOCKING AND LOCKING (EITHER OS_LOCK OR USERSPACE_SPINLOCK) SO THAT IT CAN BE USED BY A SINGLE HEAP OR SHARED BY MULTIPLE HEAPS
 
+    - RELEASES CAN BE DEFERRED TO A HELPER THREAD ( SEE set_deferred_release ) , SO THAT CALLERS DON'T STALL IN MUNMAP AND ITS TLB SHOOTDOWNS
+
     - lock_pages & unlock_pages METHODS CAN BE USED SO THAT THE SYSTEM WILL NOT SWAP PAGES TO THE PAGING FILE
 
     - LINUX ALLOCATION GRANULARITY IS 4KB (4096) , OTH IT IS 64KB ( 16 * 4096 ) ON WINDOWS .
@@ -28,6 +30,7 @@
 #include "utilities/lockable.h"
 #include "utilities/multiple_utilities.h"
 #include "arena_base.h"
+#include "deallocation_queue.h"
 
 #ifdef UNIT_TEST // VOLTRON_EXCLUDE
 #include <string>
@@ -72,6 +75,7 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
 
         ~Arena()
         {
+            process_deferred_releases();
             destroy();
         }
 
@@ -90,6 +94,7 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
             this->enter_concurrent_context();
             //////////////////////////////////////////////////
             m_page_alignment = page_alignment;
+            m_cache_capacity = cache_capacity;
             auto ret =  build_cache(cache_capacity);
             //////////////////////////////////////////////////
             this->leave_concurrent_context();
@@ -105,9 +110,10 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
                 std::size_t release_start_address = reinterpret_cast<std::size_t>(m_cache_buffer + m_cache_used_size);
                 std::size_t release_end_address = reinterpret_cast<std::size_t>(m_cache_buffer + m_cache_size);
 
+                // Not deferred as writing the size into them would touch never-requested pages
                 for (; release_start_address < release_end_address; release_start_address += m_vm_page_size)
                 {
-                    release_to_system(reinterpret_cast<void *>(release_start_address), m_vm_page_size);
+                    VirtualMemory::deallocate(reinterpret_cast<void *>(release_start_address), m_vm_page_size);
                 }
 
             }
@@ -138,6 +144,31 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
             return ret;
         }
 
+        // Rebuilds the cache in advance if 'low_watermark' bytes can't be served from it , so that allocations after it don't need to build the cache
+        // It is for calling from a background thread. Returns false if the system is out of memory
+        [[nodiscard]] bool replenish_cache(std::size_t low_watermark)
+        {
+            bool ret = true;
+
+            this->enter_concurrent_context();
+            //////////////////////////////////////////////////
+            // Same check as allocate
+            if (low_watermark + m_page_alignment > (m_cache_size - m_cache_used_size))
+            {
+                destroy();
+
+                std::size_t required_size = MultipleUtilities::get_next_pow2_multiple_of(low_watermark + m_page_alignment, m_page_alignment);
+                ret = build_cache(required_size > m_cache_capacity ? required_size : m_cache_capacity);
+            }
+            //////////////////////////////////////////////////
+            this->leave_concurrent_context();
+
+            return ret;
+        }
+
+        // Bytes which can be served without building the cache
+        std::size_t get_available_cache_size() const { return m_cache_size > m_cache_used_size ? m_cache_size - m_cache_used_size : 0; }
+
         std::size_t page_size()const { return m_vm_page_size; }
         std::size_t page_alignment() const { return m_page_alignment; }
 
@@ -187,9 +218,35 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
 
         void release_to_system(void* address, std::size_t size)
         {
+            if (m_deferred_release)
+            {
+                // Released pages are not in use anymore , so they hold their own queue node and size
+                reinterpret_cast<std::size_t*>(address)[1] = size;
+                m_deferred_release_queue.push(address);
+                return;
+            }
+
             VirtualMemory::deallocate(address, size);
         }
 
+        // When enabled , release_to_system only queues pages with a lockfree push and process_deferred_releases gives them back to the system
+        void set_deferred_release(bool deferred_release) { m_deferred_release = deferred_release; }
+
+        // Should be called by only one thread at a time , for ex a helper thread. Returns the number of released buffers
+        std::size_t process_deferred_releases()
+        {
+            std::size_t released_count = 0;
+            void* address = nullptr;
+
+            while ((address = m_deferred_release_queue.pop()) != nullptr)
+            {
+                VirtualMemory::deallocate(address, reinterpret_cast<std::size_t*>(address)[1]);
+                released_count++;
+            }
+
+            return released_count;
+        }
+
         class MetadataAllocator
         {
             public:
@@ -212,8 +269,11 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
         std::size_t m_vm_page_size = 0;
         std::size_t m_page_alignment = 0;
         char* m_cache_buffer = nullptr;
+        std::size_t m_cache_capacity = 0; // Size passed to create , used when the cache is replenished
         std::size_t m_cache_size = 0;
         std::size_t m_cache_used_size = 0;
+        bool m_deferred_release = false;
+        DeallocationQueue m_deferred_release_queue;
 
         #ifdef ENABLE_STATS
         ArenaStats m_stats;
@@ -64,6 +64,75 @@ inline int builtin_clz(unsigned long value) // Implementation is for 32-bit only
 #define builtin_cas(pointer, old_value, new_value) _InterlockedCompareExchange(reinterpret_cast<long*>(pointer), new_value, old_value)
 #endif
 
+//////////////////////////////////////////////////////////////////////
+// 64 bit compare and swap, exchange and load. For lockfree lists embedded in packed headers
+#include <cstdint>
+#if defined(__GNUC__)
+#define builtin_cas64(pointer, old_value, new_value) __sync_val_compare_and_swap(pointer, old_value, new_value)
+#define builtin_atomic_exchange64(pointer, new_value) __atomic_exchange_n(pointer, new_value, __ATOMIC_ACQ_REL)
+#define builtin_atomic_load64(pointer) __atomic_load_n(pointer, __ATOMIC_ACQUIRE)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define builtin_cas64(pointer, old_value, new_value) static_cast<uint64_t>(_InterlockedCompareExchange64(reinterpret_cast<volatile long long*>(pointer), static_cast<long long>(new_value), static_cast<long long>(old_value)))
+#define builtin_atomic_exchange64(pointer, new_value) static_cast<uint64_t>(_InterlockedExchange64(reinterpret_cast<volatile long long*>(pointer), static_cast<long long>(new_value)))
+#define builtin_atomic_load64(pointer) (*reinterpret_cast<volatile uint64_t*>(pointer))
+#endif
+
+#if defined(__GNUC__)
+#define builtin_atomic_store64(pointer, new_value) __atomic_store_n(pointer, new_value, __ATOMIC_RELEASE)
+#elif defined(_MSC_VER)
+#define builtin_atomic_store64(pointer, new_value) (*reinterpret_cast<volatile uint64_t*>(pointer) = static_cast<uint64_t>(new_value))
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// 32 bit fetch-add and load with sequential consistency. For counters which are read by other threads right after a CAS
+#if defined(__GNUC__)
+#define builtin_atomic_fetch_add32(pointer, value) __atomic_fetch_add(pointer, value, __ATOMIC_SEQ_CST)
+#define builtin_atomic_load32(pointer) __atomic_load_n(pointer, __ATOMIC_SEQ_CST)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define builtin_atomic_fetch_add32(pointer, value) static_cast<uint32_t>(_InterlockedExchangeAdd(reinterpret_cast<volatile long*>(pointer), static_cast<long>(value)))
+#define builtin_atomic_load32(pointer) (*reinterpret_cast<volatile uint32_t*>(pointer))
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// 128 bit compare and swap ( cmpxchg16b ). 'pointer' should be 16 byte aligned , 'expected' holds the low and the high 64 bits
+// Returns true on success. On failure 'expected' is updated to the current value
+// Inline assembly is used with GCC as __sync and __atomic 128 bit builtins need -mcx16 or libatomic
+#if defined(__GNUC__)
+inline bool builtin_cas128(uint64_t* pointer, uint64_t* expected, uint64_t new_low, uint64_t new_high)
+{
+#if defined(__SANITIZE_THREAD__)
+    // Thread sanitizer can't see inline assembly
+    unsigned __int128 desired = (static_cast<unsigned __int128>(new_high) << 64) | new_low;
+    return __atomic_compare_exchange_n(reinterpret_cast<unsigned __int128*>(pointer), reinterpret_cast<unsigned __int128*>(expected), desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#else
+    bool result;
+    __asm__ __volatile__
+    (
+        "lock cmpxchg16b %1\n\t"
+        "setz %0"
+        : "=q"(result), "+m"(*reinterpret_cast<volatile unsigned __int128*>(pointer)), "+a"(expected[0]), "+d"(expected[1])
+        : "b"(new_low), "c"(new_high)
+        : "cc", "memory"
+    );
+    return result;
+#endif
+}
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define builtin_cas128(pointer, expected, new_low, new_high) (_InterlockedCompareExchange128(reinterpret_cast<volatile long long*>(pointer), static_cast<long long>(new_high), static_cast<long long>(new_low), reinterpret_cast<long long*>(expected)) != 0)
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// High 64 bits of 64bit x 64bit multiplication
+#if defined(__GNUC__)
+#define builtin_mulhi64(first, second)  static_cast<uint64_t>((static_cast<unsigned __int128>(first) * static_cast<unsigned __int128>(second)) >> 64)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define builtin_mulhi64(first, second)  __umulh(first, second)
+#endif
+
 //////////////////////////////////////////////////////////////////////
 // memcpy
 #if defined(__GNUC__)
@@ -1,6 +1,15 @@
 /*
-    UNBOUNDED THREAD SAFE QUEUE FOR STORING 64 BIT POINTERS
-    STORES THEM IN A DOUBLY LINKED LIST OF 64KB "POINTER PAGE"S
+    LOCKFREE MULTI PRODUCER SINGLE CONSUMER QUEUE FOR STORING POINTERS OF DEALLOCATED MEMORY CHUNKS
+
+    - IT IS INTRUSIVE : FIRST 8 BYTES OF EACH PUSHED CHUNK HOLD THE NEXT POINTER. THEREFORE IT DOESN'T ALLOCATE ANY MEMORY
+      AND ITS MEMORY USAGE DOESN'T DEPEND ON ITS DEPTH. PUSHED POINTERS SHOULD POINT TO AT LEAST 8 BYTES WHICH ARE NOT IN USE ANYMORE
+
+    - PRODUCERS CAS-PUSH TO THE SHARED HEAD. THE CONSUMER TAKES THE ENTIRE SHARED LIST WITH A SINGLE ATOMIC EXCHANGE
+      AND POPS FROM ITS PRIVATE LIST. AS ONLY PUSHES HAPPEN CONCURRENTLY , THERE IS NO ABA PROBLEM
+
+    - POP ORDER IS LIFO WITHIN EACH TAKEN LIST
+
+    - METADATA USAGE : 16 BYTES. IT IS NOT CACHE LINE PADDED AS THREAD LOCAL HEAPS AND THEIR SEGMENTS ARE PLACED IN A FIXED SIZE METADATA BUFFER
 */
 #ifndef __DEALLOCATION_QUEUE__
 #define __DEALLOCATION_QUEUE__
@@ -9,165 +18,95 @@
 #include <cstdint>
 #include "compiler/builtin_functions.h"
 #include "compiler/hints_branch_predictor.h"
-#include "compiler/packed.h"
 #include "compiler/hints_hot_code.h"
-#include "utilities/lockable.h"
-
-#ifdef ENABLE_PERF_TRACES // VOLTRON_EXCLUDE
-#include <cstdio>
-#endif // VOLTRON_EXCLUDE
-
-// FIRST 16 BYTES OF EACH PAGE IS "next" and "prev" PTRS
-// THE REST WILL BE USED TO STORE POINTERS
-PACKED
-(
-    struct PointerPage
-    {
-        static constexpr std::size_t POINTER_CAPACITY = 8190; // 8190=(65536-(2*8))/8
-        PointerPage* m_next = nullptr;
-        PointerPage* m_prev = nullptr;
-        uint64_t m_pointers[POINTER_CAPACITY] = { 0 };
-    }
-);
-
-template <typename AllocatorType>
-class DeallocationQueue : public Lockable<LockPolicy::USERSPACE_LOCK>
+
+class DeallocationQueue
 {
     public:
 
         DeallocationQueue() = default;
+        ~DeallocationQueue() = default;
 
-        ~DeallocationQueue()
-        {
-            this->enter_concurrent_context();
-            auto iter = m_head;
-            while (iter)
-            {
-                auto next = iter->m_next;
-                AllocatorType::deallocate(iter, sizeof(PointerPage));
-                iter = next;
-            }
-            this->leave_concurrent_context();
-        }
+        DeallocationQueue(const DeallocationQueue& other) = delete;
+        DeallocationQueue& operator= (const DeallocationQueue& other) = delete;
+        DeallocationQueue(DeallocationQueue&& other) = delete;
+        DeallocationQueue& operator=(DeallocationQueue&& other) = delete;
 
-        [[nodiscard]] bool create(std::size_t initial_pointer_page_count, void* external_buffer = nullptr)
+        // Can be called from any thread
+        FORCE_INLINE void push(void* pointer)
         {
-            if (!initial_pointer_page_count) { return false; }
-
-            PointerPage* buffer = nullptr;
+            QueueNode* new_node = static_cast<QueueNode*>(pointer);
+            uint64_t expected_head = builtin_atomic_load64(&m_shared_head);
 
-            if (external_buffer == nullptr)
+            while (true)
             {
-                buffer = reinterpret_cast<PointerPage*>(AllocatorType::allocate(initial_pointer_page_count * sizeof(PointerPage)));
-
-                if (buffer == nullptr)
-                {
-                    return false;
-                }
-            }
-            else
-            {
-                buffer = reinterpret_cast<PointerPage*>(external_buffer);
-            }
-
-            builtin_memset(reinterpret_cast<void*>(buffer), 0, initial_pointer_page_count * sizeof(PointerPage));
-
-            m_head = buffer;
-            m_head->m_next = nullptr;
-            m_head->m_prev = nullptr;
+                new_node->m_next = reinterpret_cast<QueueNode*>(expected_head);
 
-            auto iter = m_head;
+                uint64_t previous_head = builtin_cas64(&m_shared_head, expected_head, reinterpret_cast<uint64_t>(new_node));
 
-            for (std::size_t i = 0; i < initial_pointer_page_count; i++)
-            {
-                if (i + 1 < initial_pointer_page_count)
-                {
-                    auto* next = &(buffer[i + 1]);
-                    iter->m_next = next;
-                    next->m_prev = iter;
-                }
-                else
+                if (likely(previous_head == expected_head))
                 {
-                    iter->m_next = nullptr;
+                    break;
                 }
-            }
-
-            m_active_page = m_head;
 
-            return true;
+                expected_head = previous_head;
+            }
         }
 
-        FORCE_INLINE void push(void* pointer)
+        // Can be called from any thread
+        // Pushes a list of chunks which are already linked through their first 8 bytes , with a single CAS
+        FORCE_INLINE void push_batch(void* first, void* last)
         {
-            this->enter_concurrent_context();
-            ////////////////////////////////////
-            if (unlikely(m_active_page_used_count == PointerPage::POINTER_CAPACITY))
+            QueueNode* first_node = static_cast<QueueNode*>(first);
+            QueueNode* last_node = static_cast<QueueNode*>(last);
+            uint64_t expected_head = builtin_atomic_load64(&m_shared_head);
+
+            while (true)
             {
-                // We need to start using a new page
+                last_node->m_next = reinterpret_cast<QueueNode*>(expected_head);
 
-                if (m_active_page->m_next == nullptr)
-                {
-                    #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
-                    fprintf(stderr, "deallocation queue grow\n");
-                    #endif
-                    // We need to allocate a new page
-                    auto new_page = reinterpret_cast<PointerPage*>(AllocatorType::allocate(sizeof(PointerPage)));
-                    new_page->m_next = nullptr;
-
-                    m_active_page->m_next = new_page;
-                    new_page->m_prev = m_active_page;
-                    m_active_page = new_page;
-                }
-                else
+                uint64_t previous_head = builtin_cas64(&m_shared_head, expected_head, reinterpret_cast<uint64_t>(first_node));
+
+                if (likely(previous_head == expected_head))
                 {
-                    m_active_page = m_active_page->m_next;
+                    break;
                 }
 
-                m_active_page_used_count = 0;
+                expected_head = previous_head;
             }
-
-            m_active_page->m_pointers[m_active_page_used_count] = reinterpret_cast<uint64_t>(pointer);
-            m_active_page_used_count++;
-            ////////////////////////////////////
-            this->leave_concurrent_context();
         }
 
+        // Should be called only by the consumer
         FORCE_INLINE [[nodiscard]] void* pop()
         {
-            void* ret = nullptr;
-            this->enter_concurrent_context();
-            ////////////////////////////////////
-            if (m_active_page_used_count == 0)
+            if (m_consumer_head == nullptr)
             {
-                if (m_head == m_active_page)
+                if (builtin_atomic_load64(&m_shared_head) == 0)
                 {
-                    this->leave_concurrent_context();
                     return nullptr;
                 }
-                else
+
+                m_consumer_head = reinterpret_cast<QueueNode*>(builtin_atomic_exchange64(&m_shared_head, static_cast<uint64_t>(0)));
+
+                if (unlikely(m_consumer_head == nullptr))
                 {
-                    m_active_page = m_active_page->m_prev;
-                    m_active_page_used_count = PointerPage::POINTER_CAPACITY;
+                    return nullptr;
                 }
             }
 
-            ret = reinterpret_cast<void*>(m_active_page->m_pointers[m_active_page_used_count - 1]);
-            m_active_page_used_count--;
-
-            ////////////////////////////////////
-            this->leave_concurrent_context();
+            QueueNode* ret = m_consumer_head;
+            m_consumer_head = ret->m_next;
             return ret;
         }
 
-        DeallocationQueue(const DeallocationQueue& other) = delete;
-        DeallocationQueue& operator= (const DeallocationQueue& other) = delete;
-        DeallocationQueue(DeallocationQueue&& other) = delete;
-        DeallocationQueue& operator=(DeallocationQueue&& other) = delete;
-
     private:
-        PointerPage* m_head = nullptr;
-        PointerPage* m_active_page = nullptr;
-        std::size_t m_active_page_used_count = 0;
+        struct QueueNode
+        {
+            QueueNode* m_next;
+        };
+
+        uint64_t m_shared_head = 0;
+        QueueNode* m_consumer_head = nullptr;
 };
 
-#endif
\ No newline at end of file
+#endif
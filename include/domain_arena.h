@@ -0,0 +1,214 @@
+/*
+    ARENA OF A MEMORY DOMAIN ( SEE memory_domain.h )
+
+    - RESERVES A SINGLE VIRTUAL MEMORY REGION OF 'region_size' BYTES , ALIGNED TO ITS SIZE. THEREFORE THE REGION OF ANY POINTER IN IT IS FOUND BY APPLYING A MASK
+
+    - THE FIRST 'page_alignment' BYTES OF THE REGION ARE RESERVED FOR ITS OWNER , THE REST IS SERVED WITH A BUMP POINTER
+
+    - RELEASED BUFFERS ARE NOT GIVEN BACK TO THE SYSTEM ONE BY ONE , SO THAT THE REGION HAS NO HOLES WHICH OTHER MAPPINGS CAN TAKE.
+      THEY ARE KEPT IN AN INTRUSIVE LIST AND REUSED BY ALLOCATIONS OF THE SAME SIZE. reset GIVES THE ENTIRE REGION BACK TO THE SYSTEM AT ONCE
+
+    - VIRTUAL MEMORY IS ONLY RESERVED , PAGES ARE BACKED BY PHYSICAL MEMORY WHEN THEY ARE TOUCHED.
+      ON WINDOWS BUMP ALLOCATIONS COMMIT THEIR PAGES ON DEMAND , SO THAT ONLY THE USED PART OF THE REGION IS CHARGED TO THE COMMIT LIMIT
+*/
+#ifndef _DOMAIN_ARENA_H_
+#define _DOMAIN_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "os/virtual_memory.h"
+
+#include "utilities/lockable.h"
+#include "utilities/modulo_utilities.h"
+#include "utilities/multiple_utilities.h"
+#include "utilities/pow2_utilities.h"
+#include "arena_base.h"
+
+template <std::size_t region_size = 1073741824, LockPolicy lock_policy = LockPolicy::USERSPACE_LOCK> // Default 1GB
+class DomainArena : public Lockable<lock_policy>, public ArenaBase<DomainArena<region_size, lock_policy>>
+{
+    public:
+
+        static_assert(Pow2Utilities::compile_time_is_power_of_two<region_size>());
+
+        DomainArena()
+        {
+            m_vm_page_size = VirtualMemory::get_page_size();
+        }
+
+        ~DomainArena()
+        {
+            destroy();
+        }
+
+        DomainArena(const DomainArena& other) = delete;
+        DomainArena& operator= (const DomainArena& other) = delete;
+        DomainArena(DomainArena&& other) = delete;
+        DomainArena& operator=(DomainArena&& other) = delete;
+
+        [[nodiscard]] bool create(std::size_t page_alignment)
+        {
+            if (MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(page_alignment) == false || Pow2Utilities::is_power_of_two(page_alignment) == false || page_alignment >= region_size)
+            {
+                return false;
+            }
+
+            m_page_alignment = page_alignment;
+            return reserve_region();
+        }
+
+        // Gives the entire region back to the system and reserves a new one. Its address may change
+        [[nodiscard]] bool reset()
+        {
+            this->enter_concurrent_context();
+            //////////////////////////////////////////////////
+            destroy();
+            bool ret = reserve_region();
+            //////////////////////////////////////////////////
+            this->leave_concurrent_context();
+
+            return ret;
+        }
+
+        void destroy()
+        {
+            if (m_region != nullptr)
+            {
+                VirtualMemory::deallocate(m_region, region_size);
+                m_region = nullptr;
+            }
+
+            m_used_size = 0;
+            m_released_head = nullptr;
+        }
+
+        [[nodiscard]] char* allocate(std::size_t size)
+        {
+            size = MultipleUtilities::get_next_pow2_multiple_of(size, m_page_alignment);
+            char* ret = nullptr;
+
+            this->enter_concurrent_context();
+            //////////////////////////////////////////////////
+            ReleasedBuffer** iter = &m_released_head;
+
+            while (*iter != nullptr && (*iter)->m_size != size)
+            {
+                iter = &((*iter)->m_next);
+            }
+
+            if (*iter != nullptr)
+            {
+                ret = reinterpret_cast<char*>(*iter);
+                *iter = (*iter)->m_next;
+            }
+            else if (m_region != nullptr && size <= region_size - m_used_size && VirtualMemory::commit(m_region + m_used_size, size))
+            {
+                ret = m_region + m_used_size;
+                m_used_size += size;
+            }
+            //////////////////////////////////////////////////
+            this->leave_concurrent_context();
+
+            return ret;
+        }
+
+        void release_to_system(void* address, std::size_t size)
+        {
+            ReleasedBuffer* buffer = static_cast<ReleasedBuffer*>(address);
+
+            this->enter_concurrent_context();
+            //////////////////////////////////////////////////
+            buffer->m_size = MultipleUtilities::get_next_pow2_multiple_of(size, m_page_alignment);
+            buffer->m_next = m_released_head;
+            m_released_head = buffer;
+            //////////////////////////////////////////////////
+            this->leave_concurrent_context();
+        }
+
+        [[nodiscard]] void* allocate_from_system(std::size_t size)
+        {
+            void* ret = VirtualMemory::reserve(size);
+
+            if (ret != nullptr && VirtualMemory::commit(ret, size) == false)
+            {
+                VirtualMemory::deallocate(ret, size);
+                ret = nullptr;
+            }
+
+            return ret;
+        }
+
+        char* get_region() const { return m_region; }
+        bool owns_pointer(void* ptr) const { return m_region != nullptr && get_region_of(ptr) == m_region; }
+        std::size_t get_used_size() const { return m_used_size; } // Including the owner's reserved bytes
+        std::size_t page_size()const { return m_vm_page_size; }
+        std::size_t page_alignment() const { return m_page_alignment; }
+
+        static char* get_region_of(void* ptr)
+        {
+            return reinterpret_cast<char*>(reinterpret_cast<uint64_t>(ptr) & ~(static_cast<uint64_t>(region_size) - 1));
+        }
+
+        class MetadataAllocator
+        {
+            public:
+                static void* allocate(std::size_t size, void* hint_address = nullptr)
+                {
+                    return VirtualMemory::allocate<false>(size, hint_address); // No hugepage, no NUMA and no zeroing
+                }
+
+                static void deallocate(void* address, std::size_t size)
+                {
+                    VirtualMemory::deallocate(address, size);
+                }
+        };
+
+    private:
+        struct ReleasedBuffer
+        {
+            ReleasedBuffer* m_next;
+            std::size_t m_size;
+        };
+
+        std::size_t m_vm_page_size = 0;
+        std::size_t m_page_alignment = 0;
+        char* m_region = nullptr;
+        std::size_t m_used_size = 0;
+        ReleasedBuffer* m_released_head = nullptr;
+
+        // Same over-sized reservation as ArenaBase::allocate_aligned , however paddings go back to the system directly rather than to the released buffers
+        [[nodiscard]] bool reserve_region()
+        {
+            char* buffer = static_cast<char*>(VirtualMemory::reserve(region_size * 2));
+
+            if (buffer == nullptr)
+            {
+                return false;
+            }
+
+            std::size_t remainder = ModuloUtilities::modulo_pow2(reinterpret_cast<std::size_t>(buffer), region_size);
+            std::size_t delta = remainder > 0 ? region_size - remainder : 0;
+
+            if (delta > 0)
+            {
+                VirtualMemory::deallocate(buffer, delta);
+            }
+
+            VirtualMemory::deallocate(buffer + delta + region_size, region_size - delta);
+
+            m_region = buffer + delta;
+
+            if (VirtualMemory::commit(m_region, m_page_alignment) == false)
+            {
+                VirtualMemory::deallocate(m_region, region_size);
+                m_region = nullptr;
+                return false;
+            }
+
+            m_used_size = m_page_alignment; // Reserved for the owner
+            return true;
+        }
+};
+
+#endif
@@ -2,13 +2,23 @@
 #ifndef __HEAP_BASE_H__
 #define __HEAP_BASE_H__
 
+#include "compiler/builtin_functions.h"
 #include "compiler/hints_hot_code.h"
 #include "cpu/alignment_constants.h"
 #include <cstdint>
 #include <cstddef>
+#include <new>
+#include <type_traits>
 #include "utilities/modulo_utilities.h"
 #include "segment.h" // Concurrency policy
 
+// Heaps which provide 'static constexpr bool has_bin_for_size(std::size_t)' resolve bins of compile time sizes. See HeapBase::allocate<size>
+template <typename HeapType, typename = void>
+struct HasCompileTimeBins : std::false_type {};
+
+template <typename HeapType>
+struct HasCompileTimeBins<HeapType, std::void_t<decltype(HeapType::has_bin_for_size(0))>> : std::true_type {};
+
 template <typename HeapImplementation, ConcurrencyPolicy concurrency_policy = ConcurrencyPolicy::SINGLE_THREAD>
 class HeapBase
 {
@@ -22,6 +32,67 @@ class HeapBase
 
         [[nodiscard]] void* allocate(std::size_t size) { return static_cast<HeapImplementation*>(this)->allocate(size); }
 
+        /*
+            For sizes known at compile time , for ex sizeof(T)
+
+            If the heap has compile time bins ( see HasCompileTimeBins ) , it also needs to implement
+            'static constexpr std::size_t get_bin_index_from_size(std::size_t)' and 'allocate_from_bin<bin_index>' , 'deallocate_from_bin<bin_index>' , 'deallocate_from_owner_to_bin<bin_index>'
+            Then there is no size to bin lookup at runtime. Otherwise they are same as the runtime versions
+
+            Heaps which declare their own allocate/deallocate/deallocate_from_owner should bring these ones in with using declarations
+        */
+        template <std::size_t size>
+        static constexpr bool has_compile_time_bin()
+        {
+            if constexpr (HasCompileTimeBins<HeapImplementation>::value)
+            {
+                return HeapImplementation::has_bin_for_size(size);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <std::size_t size>
+        [[nodiscard]] FORCE_INLINE void* allocate()
+        {
+            if constexpr (has_compile_time_bin<size>())
+            {
+                return static_cast<HeapImplementation*>(this)->template allocate_from_bin<HeapImplementation::get_bin_index_from_size(size)>();
+            }
+            else
+            {
+                return static_cast<HeapImplementation*>(this)->allocate(size);
+            }
+        }
+
+        template <std::size_t size>
+        FORCE_INLINE void deallocate(void* ptr)
+        {
+            if constexpr (has_compile_time_bin<size>())
+            {
+                static_cast<HeapImplementation*>(this)->template deallocate_from_bin<HeapImplementation::get_bin_index_from_size(size)>(ptr);
+            }
+            else
+            {
+                static_cast<HeapImplementation*>(this)->deallocate(ptr);
+            }
+        }
+
+        template <std::size_t size>
+        FORCE_INLINE void deallocate_from_owner(void* ptr)
+        {
+            if constexpr (has_compile_time_bin<size>())
+            {
+                static_cast<HeapImplementation*>(this)->template deallocate_from_owner_to_bin<HeapImplementation::get_bin_index_from_size(size)>(ptr);
+            }
+            else
+            {
+                static_cast<HeapImplementation*>(this)->deallocate_from_owner(ptr);
+            }
+        }
+
         /*
             Alignment has to be a power of two
 
@@ -53,6 +124,7 @@ class HeapBase
         // Should be called only from bounded heaps as unbounded heaps may not have contigious memory
         // Only Central and SingleThread concurrency policies are unbounded
         // In other words owns_pointer is supposed to be called from only Thread Local or CPU Local heaps
+        // Bounded heaps can also grow by a few extra regions ( see add_extra_region ) , they are checked after the initial buffer
         ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
         bool owns_pointer(void* ptr)
         {
@@ -68,12 +140,75 @@ class HeapBase
                 return true;
             }
 
+            // Other threads may call it while the owner thread adds a region , the count is published after the region address
+            uint64_t extra_region_count = builtin_atomic_load64(&m_extra_region_count);
+
+            for (uint64_t i = 0; i < extra_region_count; i++)
+            {
+                if ( address_in_question >= m_extra_regions->m_addresses[i] && address_in_question < m_extra_regions->m_addresses[i] + m_extra_regions->m_region_length )
+                {
+                    return true;
+                }
+            }
+
             return false;
         }
 
+        std::size_t get_extra_region_count() { return static_cast<std::size_t>(builtin_atomic_load64(&m_extra_region_count)); }
+
     protected:
+        static constexpr inline std::size_t MAX_EXTRA_REGION_COUNT = 8; // Keeps owns_pointer cheap
+
+        // Kept out of the heap as heaps live in ScalableAllocator's metadata , only heaps which can grow have one
+        struct ExtraRegionTable
+        {
+            std::size_t m_region_length = 0;       // All extra regions of a heap have the same length
+            std::size_t m_max_region_count = 0;
+            uint64_t m_addresses[MAX_EXTRA_REGION_COUNT] = {};
+        };
+
         uint64_t m_buffer_address = 0;
         std::size_t m_buffer_length = 0;
+        ExtraRegionTable* m_extra_regions = nullptr;
+        uint64_t m_extra_region_count = 0;
+
+        template <typename MetadataAllocator>
+        bool create_extra_region_table(std::size_t region_length, std::size_t max_region_count)
+        {
+            m_extra_regions = static_cast<ExtraRegionTable*>(MetadataAllocator::allocate(sizeof(ExtraRegionTable)));
+
+            if (m_extra_regions == nullptr)
+            {
+                return false;
+            }
+
+            new(m_extra_regions) ExtraRegionTable();    // Placement new , does not invoke memory allocation
+            m_extra_regions->m_region_length = region_length;
+            m_extra_regions->m_max_region_count = max_region_count;
+            return true;
+        }
+
+        template <typename MetadataAllocator>
+        void destroy_extra_region_table()
+        {
+            if (m_extra_regions != nullptr)
+            {
+                MetadataAllocator::deallocate(m_extra_regions, sizeof(ExtraRegionTable));
+                m_extra_regions = nullptr;
+            }
+        }
+
+        bool can_add_extra_region() const
+        {
+            return m_extra_regions != nullptr && m_extra_region_count < m_extra_regions->m_max_region_count;
+        }
+
+        // Should be called only by the owner thread after can_add_extra_region
+        void add_extra_region(void* address)
+        {
+            m_extra_regions->m_addresses[m_extra_region_count] = reinterpret_cast<uint64_t>(address);
+            builtin_atomic_exchange64(&m_extra_region_count, m_extra_region_count + 1);
+        }
         static constexpr inline std::size_t MINIMUM_ALIGNMENT = 16;
 };
 
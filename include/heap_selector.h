@@ -0,0 +1,38 @@
+/*
+    HEAP SELECTION POLICIES OF SCALABLE ALLOCATOR
+
+    - BY DEFAULT SCALABLE ALLOCATOR SELECTS THE CALLING THREAD'S LOCAL HEAP THROUGH THREAD LOCAL STORAGE
+
+    - RUNTIMES WHICH ALREADY HAVE A DENSE CONTEXT KEY , FOR EX A WORKER ID OF A FIXED THREAD POOL OR A FIBER ID , CAN SELECT HEAPS BY THAT KEY INSTEAD.
+      A SELECTOR PASSED AS THE LAST TEMPLATE PARAMETER OF SCALABLE ALLOCATOR PROVIDES THE KEY :
+
+            struct WorkerIdHeapSelector
+            {
+                static constexpr inline bool USES_CONTEXT_KEY = true;
+                static std::size_t get_context_key() { return current_worker_id; } // Or HeapSelector::NO_CONTEXT_KEY
+            };
+
+      THEN HEAP SELECTION IS A LOAD FROM A TABLE INDEXED BY THE KEY. SEE ScalableAllocator::set_context_key_count
+
+    - A KEY SHOULD BE USED BY ONLY ONE RUNNING CONTEXT AT A TIME. CONTEXTS CAN MIGRATE BETWEEN THREADS , FOR EX COROUTINES ,
+      AS LONG AS THEY DON'T RUN CONCURRENTLY WITH ANOTHER CONTEXT WHICH HAS THE SAME KEY
+
+    - CONTEXTS WITHOUT A KEY , FOR EX THREADS OUTSIDE THE POOL , RETURN NO_CONTEXT_KEY AND USE THEIR THREAD LOCAL HEAPS
+*/
+#ifndef __HEAP_SELECTOR__
+#define __HEAP_SELECTOR__
+
+#include <cstddef>
+
+namespace HeapSelector
+{
+    constexpr std::size_t NO_CONTEXT_KEY = static_cast<std::size_t>(-1);
+}
+
+struct ThreadLocalHeapSelector
+{
+    static constexpr inline bool USES_CONTEXT_KEY = false;
+    static std::size_t get_context_key() { return HeapSelector::NO_CONTEXT_KEY; }
+};
+
+#endif
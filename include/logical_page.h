@@ -1,6 +1,9 @@
 /*
     - IT IS A FIRST-IN-LAST-OUT FREELIST IMPLEMENTATION. IT CAN HOLD ONLY ONE SIZE CLASS. ALLOCATE METHOD WILL IGNORE THE SIZE PARAMETER
 
+    - SIZE CLASSES DON'T NEED TO BE POWER OF TWO. DEALLOCATIONS OF PADDED POINTERS ARE MAPPED TO CHUNK STARTS WITH A PRECOMPUTED RECIPROCAL MULTIPLICATION
+      SIZE CLASSES SHOULD BE MULTIPLES OF 16 IN ORDER TO KEEP THE MINIMUM ALIGNMENT GUARANTEE. MAXIMUM BUFFER SIZE IS 4GB
+
     - IF THE PASSED BUFFER IS START OF A VIRTUAL PAGE AND THE PASSED SIZE IS A VM PAGE SIZE , THEN IT WILL BE CORRESPONDING TO AN ACTUAL VM PAGE
       IDEAL USE CASE IS ITS CORRESPONDING TO A VM PAGE / BEING VM PAGE ALIGNED. SO THAT A SINGLE PAYLOAD WILL NOT SPREAD TO DIFFERENT VM PAGES
 
@@ -11,18 +14,23 @@
     - DOESN'T SUPPORT ALIGNMENT. ALLOCATE METHOD WILL IGNORE THE ALIGNMENT PARAMETER
 
     - METADATA USAGE : 64 BYTES (PAGE HEADER) PER LOGICAL PAGE
+
+    - HAS 2 FREELISTS LIKE MIMALLOC PAGES : THE LOCAL FREELIST WHICH IS ACCESSED ONLY BY THE OWNER AND THE THREAD FREE LIST WHICH OTHER THREADS PUSH TO ATOMICALLY.
+      THE OWNER MOVES THE ENTIRE THREAD FREE LIST TO THE LOCAL FREELIST WITH A SINGLE ATOMIC EXCHANGE. SEE collect_thread_free_list
 */
 #ifndef __LOGICAL_PAGE_H__
 #define __LOGICAL_PAGE_H__
 
 #include <cstddef>
 #include <cstdint>
+#include "compiler/builtin_functions.h"
 #include "compiler/unused.h"
 #include "compiler/packed.h"
 #include "compiler/hints_hot_code.h"
 #include "compiler/hints_branch_predictor.h"
 #include "cpu/alignment_constants.h"
 #include "utilities/alignment_checks.h"
+#include "utilities/division_utilities.h"
 #include "logical_page_base.h"
 
 #ifdef UNIT_TEST // VOLTRON_EXCLUDE
@@ -54,7 +62,7 @@ class LogicalPage : public LogicalPageBase<LogicalPage<adjust_padded_pointers, N
         [[nodiscard]] bool create(void* buffer, const std::size_t buffer_size, uint32_t size_class)
         {
             // Chunk size can't be smaller than a 'next' pointer-or-offset which is 64bit
-            if (buffer == nullptr || buffer_size < size_class || size_class < sizeof(uint64_t))
+            if (buffer == nullptr || buffer_size < size_class || size_class < sizeof(uint64_t) || buffer_size > UINT32_MAX)
             {
                 return false;
             }
@@ -77,8 +85,9 @@ class LogicalPage : public LogicalPageBase<LogicalPage<adjust_padded_pointers, N
 
             this->m_page_header.initialise();
             this->m_page_header.m_size_class = size_class;
+            this->m_page_header.m_size_class_reciprocal = DivisionUtilities::get_reciprocal(size_class);
             this->m_page_header.m_logical_page_start_address = reinterpret_cast<uint64_t>(buffer);
-            this->m_page_header.m_logical_page_size = buffer_size;
+            this->m_page_header.m_logical_page_size = static_cast<uint32_t>(buffer_size);
 
             grow(buffer, buffer_size);
 
@@ -112,10 +121,83 @@ class LogicalPage : public LogicalPageBase<LogicalPage<adjust_padded_pointers, N
             }
             
             this->m_page_header.m_used_size -= this->m_page_header.m_size_class;
-            
+
+            push(static_cast<NodeType*>(get_chunk_start(ptr)));
+        }
+
+        // Can be called from any thread. Non-owner threads CAS-push to the thread free list and quit,
+        // they don't touch the local freelist or the used size. Only pushes happen concurrently, the owner takes the whole list at once, hence no ABA
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        void deallocate_to_thread_free_list(void* ptr)
+        {
+            if( unlikely(this->owns_pointer(ptr) == false) )
+            {
+                return;
+            }
+
+            NodeType* new_node = static_cast<NodeType*>(get_chunk_start(ptr));
+            uint64_t expected_head = builtin_atomic_load64(&this->m_page_header.m_thread_free_head);
+
+            while (true)
+            {
+                new_node->m_next = reinterpret_cast<NodeType*>(expected_head);
+
+                uint64_t previous_head = builtin_cas64(&this->m_page_header.m_thread_free_head, expected_head, reinterpret_cast<uint64_t>(new_node));
+
+                if (likely(previous_head == expected_head))
+                {
+                    break;
+                }
+
+                expected_head = previous_head;
+            }
+        }
+
+        // Should be called only by the owner. Swaps out the entire thread free list with one atomic exchange and appends it to the local freelist
+        // Returns the number of reclaimed chunks
+        std::size_t collect_thread_free_list()
+        {
+            if (builtin_atomic_load64(&this->m_page_header.m_thread_free_head) == 0)
+            {
+                return 0;
+            }
+
+            uint64_t collected_head = builtin_atomic_exchange64(&this->m_page_header.m_thread_free_head, static_cast<uint64_t>(0));
+
+            if (unlikely(collected_head == 0))
+            {
+                return 0;
+            }
+
+            NodeType* collected_tail = reinterpret_cast<NodeType*>(collected_head);
+            std::size_t collected_count = 1;
+
+            while (collected_tail->m_next)
+            {
+                collected_tail = collected_tail->m_next;
+                collected_count++;
+            }
+
+            collected_tail->m_next = reinterpret_cast<NodeType*>(this->m_page_header.m_head);
+            this->m_page_header.m_head = collected_head;
+            this->m_page_header.m_used_size -= static_cast<uint32_t>(collected_count) * this->m_page_header.m_size_class;
+
+            return collected_count;
+        }
+
+        std::size_t get_usable_size(void* ptr) { return  static_cast<std::size_t>(this->m_page_header.m_size_class); }
+        static constexpr bool supports_any_size() { return false; }
+
+        #ifdef UNIT_TEST
+        const std::string get_type_name() const { return "LogicalPage"; }
+        #endif
+
+        // Finds the start of the chunk which holds ptr , ptr may have been padded for an aligned allocation
+        FORCE_INLINE void* get_chunk_start(void* ptr)
+        {
             if constexpr(adjust_padded_pointers == false)
             {
-                push(static_cast<NodeType*>(ptr));
+                return ptr;
             }
             else
             {
@@ -127,28 +209,17 @@ class LogicalPage : public LogicalPageBase<LogicalPage<adjust_padded_pointers, N
                 However if the freed ptr was not adjusted, this formula will not change the ptr which is being freed :
                 
                     correct address =  base address + (  sizeclass *  floor(   (freed address - base address) / sizeclass  )  )
-                                    or
-                    void* actual_ptr = reinterpret_cast<void*>( this->m_page_header.m_logical_page_start_address + (  (reinterpret_cast<uint64_t>(ptr) - this->m_page_header.m_logical_page_start_address) / this->m_page_header.m_size_class) * this->m_page_header.m_size_class );
                     
-                Basically we find out the highest multiple of a pow2 sizeclass which is less than the passed pointer with start address offset which is not guaranteed to be pow2
+                Size classes are not necessarily power of two , therefore instead of a mask we use a precomputed reciprocal
+                so that the division above becomes a multiplication
                     
                 */
-                uint64_t offset = reinterpret_cast<uint64_t>(ptr) - this->m_page_header.m_logical_page_start_address;
-                uint64_t mask = ~( static_cast<uint64_t>(this->m_page_header.m_size_class) - 1);
-                uint64_t unpadded_offset = offset & mask;
-                void* actual_ptr = reinterpret_cast<void*>(this->m_page_header.m_logical_page_start_address + unpadded_offset);
-                
-                push(static_cast<NodeType*>(actual_ptr));
+                uint32_t offset = static_cast<uint32_t>(reinterpret_cast<uint64_t>(ptr) - this->m_page_header.m_logical_page_start_address);
+                uint32_t chunk_index = DivisionUtilities::divide_by_reciprocal(offset, this->m_page_header.m_size_class_reciprocal);
+                return reinterpret_cast<void*>(this->m_page_header.m_logical_page_start_address + static_cast<uint64_t>(chunk_index) * this->m_page_header.m_size_class);
             }
         }
 
-        std::size_t get_usable_size(void* ptr) { return  static_cast<std::size_t>(this->m_page_header.m_size_class); }
-        static constexpr bool supports_any_size() { return false; }
-
-        #ifdef UNIT_TEST
-        const std::string get_type_name() const { return "LogicalPage"; }
-        #endif
-
     private:
 
         void grow(void* buffer, std::size_t buffer_size)
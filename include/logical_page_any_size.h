@@ -0,0 +1,404 @@
+/*
+    - A LOGICAL PAGE THAT CAN HOLD ARBITRARY SIZES. EVERY BLOCK ( FREE OR USED ) STARTS WITH A 16 BYTE ALLOCATION HEADER WHICH HOLDS ITS SIZE AND ITS PHYSICAL PREDECESSOR'S SIZE.
+      ( BOUNDARY TAGS ) SO THAT NEIGHBOURS CAN BE FOUND IN CONSTANT TIME.
+
+    - FREE BLOCKS ARE KEPT IN SIZE SEGREGATED DOUBLY LINKED FREELISTS. EACH FREELIST BIN HOLDS BLOCKS WITHIN A POWER OF TWO RANGE :
+
+                bin0 : [32, 64)  bin1 : [64, 128) ... bin13 : [256KB, 512KB)  bin14 : 512KB and above
+
+      A BITMAP OF NON-EMPTY BINS IS MAINTAINED SO THAT SEARCHES SKIP EMPTY BINS WITH A SINGLE COUNT-TRAILING-ZEROES INSTRUCTION.
+
+    - GOOD FIT : SEARCH STARTS FROM THE BIN OF THE REQUESTED SIZE AND DOES FIRST FIT WITHIN THAT BIN. IF NOTHING FITS THERE, THE HEAD OF THE NEXT NON-EMPTY BIN IS USED
+      AS ANY BLOCK IN A GREATER BIN IS GUARANTEED TO BE BIG ENOUGH.
+
+    - SPLITS BLOCKS DURING ALLOCATIONS IF THE REMAINDER CAN FORM A MINIMUM SIZED BLOCK. OTHERWISE THE REMAINDER IS GIVEN TO THE ALLOCATION.
+      COALESCES WITH BOTH PHYSICAL NEIGHBOURS DURING DEALLOCATIONS.
+
+    - SUPPORTS ALIGNMENT : allocate_aligned CARVES THE ALIGNED PAYLOAD OUT OF A FREE BLOCK AND GIVES THE LEADING GAP BACK AS A FREE BLOCK.
+      THEREFORE RETURNED POINTERS ARE NEVER PADDED AND DEALLOCATIONS DON'T NEED TO UNPAD THEM. DON'T USE HeapBase::allocate_aligned WITH THIS LOGICAL PAGE.
+
+    - MINIMUM ALLOCATION ALIGNMENT IS 16 BYTES. MINIMUM BLOCK SIZE IS 32 BYTES : 16 BYTES HEADER + 16 BYTES FOR FREELIST NEXT & PREV POINTERS WHEN THE BLOCK IS FREE
+
+    - METADATA USAGE : 64 BYTES (PAGE HEADER) + 128 BYTES (FREELIST BIN HEADS AND BITMAP) PER LOGICAL PAGE AND 16 BYTES PER ALLOCATION
+*/
+#ifndef __LOGICAL_PAGE_ANY_SIZE_H__
+#define __LOGICAL_PAGE_ANY_SIZE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include "compiler/unused.h"
+#include "compiler/packed.h"
+#include "compiler/builtin_functions.h"
+#include "compiler/hints_hot_code.h"
+#include "compiler/hints_branch_predictor.h"
+#include "cpu/alignment_constants.h"
+#include "utilities/alignment_checks.h"
+#include "utilities/log2_utilities.h"
+#include "utilities/multiple_utilities.h"
+#include "logical_page_base.h"
+
+#ifdef UNIT_TEST // VOLTRON_EXCLUDE
+#include <string>
+#endif // VOLTRON_EXCLUDE
+
+struct LogicalPageAnySizeConstants
+{
+    static constexpr inline std::size_t ALLOCATION_HEADER_SIZE = 16;
+    static constexpr inline std::size_t MINIMUM_BLOCK_SIZE = 32;            // Header + next & prev pointers of a free block
+    static constexpr inline std::size_t BLOCK_SIZE_GRANULARITY = 16;        // To guarantee 16 byte alignment for all payloads
+    static constexpr inline std::size_t FREELIST_BIN_COUNT = 15;
+    static constexpr inline std::size_t FREELIST_TABLE_SIZE = 128;           // Bitmap + bin heads
+    static constexpr inline std::size_t MAXIMUM_BUFFER_SIZE = 0xFFFFFFFF;   // Block sizes are stored in 32 bits
+};
+
+PACKED
+(
+    struct LogicalPageAnySizeNode      // No private members to stay as POD+PACKED
+    {
+        // ALLOCATION HEADER , 16 BYTES
+        uint32_t m_block_size;              // Including the allocation header
+        uint32_t m_previous_block_size;     // Size of the physically previous block, 0 if this is the first block of the page
+        uint32_t m_is_used;
+        char m_padding_bytes[4];
+        // ONLY VALID WHEN THE BLOCK IS FREE , WHEN ALLOCATED THEY ARE PART OF THE PAYLOAD
+        LogicalPageAnySizeNode* m_next;
+        LogicalPageAnySizeNode* m_prev;
+
+        std::size_t get_block_size() const { return static_cast<std::size_t>(m_block_size); }
+        void* get_payload() { return reinterpret_cast<void*>(reinterpret_cast<std::size_t>(this) + LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE); }
+    }
+);
+
+PACKED
+(
+    struct LogicalPageAnySizeFreelists  // Placed to the start of the logical page buffer
+    {
+        uint64_t m_non_empty_bin_bitmap;
+        LogicalPageAnySizeNode* m_bin_heads[LogicalPageAnySizeConstants::FREELIST_BIN_COUNT];
+    }
+);
+
+template <typename NodeType = LogicalPageAnySizeNode>
+class LogicalPageAnySize : public LogicalPageBase<LogicalPageAnySize<NodeType>, NodeType>
+{
+    public:
+        LogicalPageAnySize() {}
+        ~LogicalPageAnySize() {}
+
+        LogicalPageAnySize(const LogicalPageAnySize& other) = delete;
+        LogicalPageAnySize& operator= (const LogicalPageAnySize& other) = delete;
+        LogicalPageAnySize(LogicalPageAnySize&& other) = delete;
+        LogicalPageAnySize& operator=(LogicalPageAnySize&& other) = delete;
+
+        // Size class parameter is only stored in the page header for upper layers , blocks can be any size
+        [[nodiscard]] bool create(void* buffer, const std::size_t buffer_size, uint32_t size_class = 0)
+        {
+            static_assert(sizeof(NodeType) == LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE);
+            static_assert(sizeof(LogicalPageAnySizeFreelists) == LogicalPageAnySizeConstants::FREELIST_TABLE_SIZE);
+
+            if (buffer == nullptr || buffer_size < get_metadata_size() + LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE || buffer_size > LogicalPageAnySizeConstants::MAXIMUM_BUFFER_SIZE)
+            {
+                return false;
+            }
+
+            void* buffer_start_including_header = reinterpret_cast<void*>(reinterpret_cast<std::size_t>(buffer) - sizeof(*this)); // See LogicalPage::create for the 2 use cases
+
+            if (!AlignmentChecks::is_address_page_allocation_granularity_aligned(buffer) && !AlignmentChecks::is_address_page_allocation_granularity_aligned(buffer_start_including_header))
+            {
+                return false;
+            }
+
+            this->m_page_header.initialise();
+            this->m_page_header.m_size_class = size_class;
+            this->m_page_header.m_logical_page_start_address = reinterpret_cast<uint64_t>(buffer);
+            this->m_page_header.m_logical_page_size = static_cast<uint32_t>(buffer_size);
+            this->m_page_header.m_head = reinterpret_cast<uint64_t>(buffer);  // Points to the freelist table
+
+            auto freelists = get_freelists();
+            freelists->m_non_empty_bin_bitmap = 0;
+
+            for (std::size_t i = 0; i < LogicalPageAnySizeConstants::FREELIST_BIN_COUNT; i++)
+            {
+                freelists->m_bin_heads[i] = nullptr;
+            }
+
+            // Initially the whole page is one free block
+            std::size_t first_block_size = (buffer_size - get_metadata_size()) & ~(LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY - 1);
+            NodeType* first_block = reinterpret_cast<NodeType*>(get_first_block_address());
+            first_block->m_block_size = static_cast<uint32_t>(first_block_size);
+            first_block->m_previous_block_size = 0;
+            first_block->m_is_used = 0;
+
+            insert_to_freelist(first_block);
+
+            return true;
+        }
+
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        void* allocate(const std::size_t size)
+        {
+            return allocate_aligned(size, LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY);
+        }
+
+        // Alignment has to be a power of two
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        void* allocate_aligned(const std::size_t size, std::size_t alignment)
+        {
+            alignment = alignment < LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY ? LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY : alignment;
+
+            if (unlikely(size == 0 || size > this->m_page_header.m_logical_page_size))
+            {
+                return nullptr;
+            }
+
+            std::size_t required_block_size = get_required_block_size(size);
+            std::size_t gap = 0;
+
+            NodeType* free_block = search(required_block_size, alignment, gap);
+
+            if (unlikely(free_block == nullptr))
+            {
+                return nullptr;
+            }
+
+            NodeType* allocated_block = carve(free_block, required_block_size, gap);
+            this->m_page_header.m_used_size += allocated_block->m_block_size;
+
+            return allocated_block->get_payload();
+        }
+
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        void deallocate(void* ptr)
+        {
+            if (unlikely(this->owns_pointer(ptr) == false))
+            {
+                return;
+            }
+
+            NodeType* block = get_block_from_payload(ptr);
+
+            if (unlikely(block->m_is_used == 0))
+            {
+                return;
+            }
+
+            this->m_page_header.m_used_size -= block->m_block_size;
+            block->m_is_used = 0;
+
+            // COALESCE WITH THE NEXT BLOCK
+            NodeType* next = get_next_physical_block(block);
+
+            if (next != nullptr && next->m_is_used == 0)
+            {
+                remove_from_freelist(next);
+                block->m_block_size += next->m_block_size;
+            }
+
+            // COALESCE WITH THE PREVIOUS BLOCK
+            if (block->m_previous_block_size != 0)
+            {
+                NodeType* previous = reinterpret_cast<NodeType*>(reinterpret_cast<std::size_t>(block) - block->m_previous_block_size);
+
+                if (previous->m_is_used == 0)
+                {
+                    remove_from_freelist(previous);
+                    previous->m_block_size += block->m_block_size;
+                    block = previous;
+                }
+            }
+
+            update_next_physical_block_link(block);
+            insert_to_freelist(block);
+        }
+
+        std::size_t get_usable_size(void* ptr)
+        {
+            return get_block_from_payload(ptr)->get_block_size() - LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE;
+        }
+
+        static constexpr bool supports_any_size() { return true; }
+
+        // Per page bytes which can't be used by allocations, excluding the page header
+        static constexpr std::size_t get_metadata_size() { return LogicalPageAnySizeConstants::FREELIST_TABLE_SIZE; }
+
+        // Largest payload that an empty page with the given buffer size can serve
+        static constexpr std::size_t get_max_allocation_size(std::size_t buffer_size)
+        {
+            return ((buffer_size - get_metadata_size()) & ~(LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY - 1)) - LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE;
+        }
+
+        // Total bytes that a payload of the given size will consume in the page
+        static std::size_t get_required_block_size(std::size_t size)
+        {
+            std::size_t required_block_size = MultipleUtilities::get_next_pow2_multiple_of(size + LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE, LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY);
+            return required_block_size < LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE ? LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE : required_block_size;
+        }
+
+        #ifdef UNIT_TEST
+        const std::string get_type_name() const { return "LogicalPageAnySize"; }
+        std::size_t get_free_block_count()
+        {
+            std::size_t count = 0;
+            auto freelists = get_freelists();
+
+            for (std::size_t i = 0; i < LogicalPageAnySizeConstants::FREELIST_BIN_COUNT; i++)
+            {
+                for (NodeType* iter = freelists->m_bin_heads[i]; iter != nullptr; iter = iter->m_next)
+                {
+                    count++;
+                }
+            }
+
+            return count;
+        }
+        #endif
+
+    private:
+        FORCE_INLINE LogicalPageAnySizeFreelists* get_freelists() { return reinterpret_cast<LogicalPageAnySizeFreelists*>(this->m_page_header.m_head); }
+        FORCE_INLINE std::size_t get_first_block_address() const { return static_cast<std::size_t>(this->m_page_header.m_logical_page_start_address) + get_metadata_size(); }
+        FORCE_INLINE std::size_t get_blocks_end_address() const { return get_first_block_address() + ((static_cast<std::size_t>(this->m_page_header.m_logical_page_size) - get_metadata_size()) & ~(LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY - 1)); }
+        FORCE_INLINE NodeType* get_block_from_payload(void* ptr) { return reinterpret_cast<NodeType*>(reinterpret_cast<std::size_t>(ptr) - LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE); }
+
+        FORCE_INLINE NodeType* get_next_physical_block(NodeType* block)
+        {
+            std::size_t next_address = reinterpret_cast<std::size_t>(block) + block->m_block_size;
+            return next_address < get_blocks_end_address() ? reinterpret_cast<NodeType*>(next_address) : nullptr;
+        }
+
+        FORCE_INLINE void update_next_physical_block_link(NodeType* block)
+        {
+            NodeType* next = get_next_physical_block(block);
+
+            if (next != nullptr)
+            {
+                next->m_previous_block_size = block->m_block_size;
+            }
+        }
+
+        static std::size_t get_bin_index(std::size_t block_size)
+        {
+            std::size_t index = Log2Utilities::log2_power_of_two(block_size) - Log2Utilities::compile_time_log2(LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE);
+            return index >= LogicalPageAnySizeConstants::FREELIST_BIN_COUNT ? LogicalPageAnySizeConstants::FREELIST_BIN_COUNT - 1 : index;
+        }
+
+        // Returns the number of bytes needed in front of the block so that its payload will be aligned
+        // It is either 0 or at least a minimum block as the leading part will be given back as a free block
+        static std::size_t get_alignment_gap(NodeType* block, std::size_t alignment)
+        {
+            std::size_t payload_address = reinterpret_cast<std::size_t>(block) + LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE;
+            std::size_t gap = MultipleUtilities::get_next_pow2_multiple_of(payload_address, alignment) - payload_address;
+
+            while (gap != 0 && gap < LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE)
+            {
+                gap += alignment;
+            }
+
+            return gap;
+        }
+
+        NodeType* search(std::size_t required_block_size, std::size_t alignment, std::size_t& gap)
+        {
+            auto freelists = get_freelists();
+            uint64_t candidate_bins = freelists->m_non_empty_bin_bitmap & ~((static_cast<uint64_t>(1) << get_bin_index(required_block_size)) - 1);
+
+            while (candidate_bins)
+            {
+                std::size_t bin_index = static_cast<std::size_t>(builtin_ctzl(candidate_bins));
+
+                for (NodeType* iter = freelists->m_bin_heads[bin_index]; iter != nullptr; iter = iter->m_next)
+                {
+                    gap = alignment > LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY ? get_alignment_gap(iter, alignment) : 0;
+
+                    if (iter->m_block_size >= required_block_size + gap)
+                    {
+                        return iter;
+                    }
+                }
+
+                candidate_bins &= candidate_bins - 1;
+            }
+
+            return nullptr;
+        }
+
+        // Takes the block out of its freelist , gives leading gap and trailing remainder back to freelists and returns the used part
+        NodeType* carve(NodeType* block, std::size_t required_block_size, std::size_t gap)
+        {
+            remove_from_freelist(block);
+
+            if (gap > 0)
+            {
+                NodeType* aligned_block = reinterpret_cast<NodeType*>(reinterpret_cast<std::size_t>(block) + gap);
+                aligned_block->m_block_size = block->m_block_size - static_cast<uint32_t>(gap);
+                aligned_block->m_previous_block_size = static_cast<uint32_t>(gap);
+                block->m_block_size = static_cast<uint32_t>(gap);
+                insert_to_freelist(block);
+                block = aligned_block;
+            }
+
+            std::size_t remainder = block->m_block_size - required_block_size;
+
+            if (remainder >= LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE)
+            {
+                NodeType* remainder_block = reinterpret_cast<NodeType*>(reinterpret_cast<std::size_t>(block) + required_block_size);
+                remainder_block->m_block_size = static_cast<uint32_t>(remainder);
+                remainder_block->m_previous_block_size = static_cast<uint32_t>(required_block_size);
+                remainder_block->m_is_used = 0;
+                block->m_block_size = static_cast<uint32_t>(required_block_size);
+                update_next_physical_block_link(remainder_block);
+                insert_to_freelist(remainder_block);
+            }
+            else
+            {
+                update_next_physical_block_link(block);
+            }
+
+            block->m_is_used = 1;
+            return block;
+        }
+
+        FORCE_INLINE void insert_to_freelist(NodeType* block)
+        {
+            auto freelists = get_freelists();
+            std::size_t bin_index = get_bin_index(block->m_block_size);
+
+            block->m_is_used = 0;
+            block->m_prev = nullptr;
+            block->m_next = freelists->m_bin_heads[bin_index];
+
+            if (block->m_next)
+            {
+                block->m_next->m_prev = block;
+            }
+
+            freelists->m_bin_heads[bin_index] = block;
+            freelists->m_non_empty_bin_bitmap |= (static_cast<uint64_t>(1) << bin_index);
+        }
+
+        FORCE_INLINE void remove_from_freelist(NodeType* block)
+        {
+            auto freelists = get_freelists();
+            std::size_t bin_index = get_bin_index(block->m_block_size);
+
+            if (block->m_prev)
+            {
+                block->m_prev->m_next = block->m_next;
+            }
+            else
+            {
+                freelists->m_bin_heads[bin_index] = block->m_next;
+            }
+
+            if (block->m_next)
+            {
+                block->m_next->m_prev = block->m_prev;
+            }
+
+            if (freelists->m_bin_heads[bin_index] == nullptr)
+            {
+                freelists->m_non_empty_bin_bitmap &= ~(static_cast<uint64_t>(1) << bin_index);
+            }
+        }
+};
+
+#endif
@@ -43,6 +43,7 @@ class LogicalPageBase
 
         void mark_as_locked() { m_page_header.set_flag<LogicalPageHeaderFlags::IS_LOCKED>(); }
         void mark_as_non_locked() { m_page_header.clear_flag<LogicalPageHeaderFlags::IS_LOCKED>(); }
+        bool is_locked() const { return m_page_header.get_flag<LogicalPageHeaderFlags::IS_LOCKED>(); }
 
         uint64_t get_used_size() const { return m_page_header.m_used_size; }
         uint32_t get_size_class() { return m_page_header.m_size_class; }
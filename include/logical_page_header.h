@@ -4,8 +4,10 @@
 
     WE USE 2 BYTES FOR PADDING AS THIS IS TO ENSURE THAT ALL ALLOCATIONS WILL BE AT LEAST 16-BIT ALIGNED
 
+    8 BYTE MEMBERS COME FIRST SO THAT THEY ARE NATURALLY ALIGNED EVEN THOUGH THE STRUCT IS PACKED. ( m_thread_free_head IS UPDATED WITH ATOMIC INSTRUCTIONS )
+
     PAHOLE OUTPUT :
-                            size: 64, cachelines: 1, members: 10
+                            size: 64, cachelines: 1, members: 11
                             last cacheline: 64 bytes
 */
 #ifndef __LOGICAL_PAGE_HEADER_H__
@@ -35,18 +37,20 @@ PACKED
             uint64_t m_next_logical_page_ptr;  // To be used by an upper layer abstraction (ex: segment span etc ) to navigate between logical pages
             // 8 BYTES
             uint64_t m_prev_logical_page_ptr;  // Same as above
-            // 2 BYTES
-            uint16_t m_page_flags;               // See enum class LogicalPageHeaderFlags
-            // 4 BYTES
-            uint32_t m_size_class;               // Used to distinguish non-big size class pages    , since logical pages won't be holding objects > page size, 2 bytes will be sufficient
-            // 8 BYTES
-            uint64_t m_used_size;
             // 8 BYTES
             uint64_t m_logical_page_start_address;
             // 8 BYTES
-            uint64_t m_logical_page_size;
+            uint64_t m_thread_free_head;        // Freelist that non-owner threads push to with CAS. Kept 8 byte aligned as it is accessed atomically
             // 8 BYTES
-            uint64_t m_last_used_node;
+            uint64_t m_size_class_reciprocal;   // ceil(2^64 / size class) , to find chunk starts with a multiplication instead of a division , see DivisionUtilities
+            // 4 BYTES
+            uint32_t m_used_size;                // Logical pages are limited to 4GB
+            // 4 BYTES
+            uint32_t m_logical_page_size;
+            // 4 BYTES
+            uint32_t m_size_class;               // Used to distinguish non-big size class pages    , since logical pages won't be holding objects > page size, 2 bytes will be sufficient
+            // 2 BYTES
+            uint16_t m_page_flags;               // See enum class LogicalPageHeaderFlags
             // 2 BYTES
             char m_padding_bytes[2];
 
@@ -58,12 +62,13 @@ PACKED
                 m_head = 0;
                 m_next_logical_page_ptr = 0;
                 m_prev_logical_page_ptr = 0;
-                m_page_flags = 0;
-                m_size_class = 0;
-                m_used_size = 0;
                 m_logical_page_start_address = 0;
+                m_thread_free_head = 0;
+                m_size_class_reciprocal = 0;
+                m_used_size = 0;
                 m_logical_page_size = 0;
-                m_last_used_node = 0;
+                m_size_class = 0;
+                m_page_flags = 0;
             }
 
             template<LogicalPageHeaderFlags flag>
@@ -0,0 +1,146 @@
+/*
+    POOL OF FREE LOGICAL PAGE SLOTS SHARED BY SEGMENTS OF A BOUNDED HEAP
+
+    - BOUNDED SEGMENTS TAKE LOGICAL PAGES FROM IT WHEN THEY RUN OUT AND GIVE THEIR EMPTY PAGES BACK ,
+      SO THAT A BIN WHICH IS IN DEMAND CAN USE PAGES THAT OTHER BINS DON'T NEED , INSTEAD OF FIXED PER BIN PARTITIONS
+
+    - SLOTS ARE IN THE HEAP'S BUFFER OR IN ITS EXTRA REGIONS ( SEE HeapBase::add_extra_region ) , THEREFORE CHECKING POINTER OWNERSHIP BY RANGES STILL WORKS
+
+    - IT IS INTRUSIVE : FIRST 8 BYTES OF EACH FREE SLOT HOLD THE NEXT POINTER. THEREFORE IT DOESN'T ALLOCATE ANY MEMORY
+
+    - IT IS LOCKED AS HEAPS OF OTHER THREADS CAN STEAL FREE SLOTS ( SEE ScalableAllocator::set_page_stealing ). THAT IS CHEAP AS SEGMENTS ACCESS IT ONLY WHEN THEY CREATE OR RECYCLE LOGICAL PAGES
+*/
+#ifndef __LOGICAL_PAGE_POOL__
+#define __LOGICAL_PAGE_POOL__
+
+#include <cstddef>
+#include <cstdint>
+#include "utilities/lockable.h"
+
+class LogicalPagePool : public Lockable<LockPolicy::USERSPACE_LOCK>
+{
+    public:
+
+        LogicalPagePool() = default;
+        ~LogicalPagePool() = default;
+
+        LogicalPagePool(const LogicalPagePool& other) = delete;
+        LogicalPagePool& operator= (const LogicalPagePool& other) = delete;
+        LogicalPagePool(LogicalPagePool&& other) = delete;
+        LogicalPagePool& operator=(LogicalPagePool&& other) = delete;
+
+        void create(char* buffer, std::size_t slot_size, std::size_t slot_count)
+        {
+            m_slot_size = slot_size;
+            adopt_buffer(buffer, slot_count);
+        }
+
+        // Adds all slots of a buffer to the heap's capacity , for ex when the heap grows by an extra region
+        void adopt_buffer(char* buffer, std::size_t slot_count)
+        {
+            this->enter_concurrent_context();
+
+            // Pushing in reverse so that slots are handed out from the start of the buffer
+            for (std::size_t i = slot_count; i > 0; i--)
+            {
+                push_internal(buffer + ((i - 1) * m_slot_size));
+                m_capacity++;
+            }
+
+            this->leave_concurrent_context();
+        }
+
+        // Pop and push are for segments of the owner heap , the slot stays in the heap's capacity
+        [[nodiscard]] void* pop()
+        {
+            this->enter_concurrent_context();
+            void* ret = pop_internal(0);
+            this->leave_concurrent_context();
+            return ret;
+        }
+
+        void push(void* slot)
+        {
+            this->enter_concurrent_context();
+            push_internal(slot);
+            this->leave_concurrent_context();
+        }
+
+        // Takes a slot out of the heap's capacity , only if more than 'reserved_slot_count' slots are free , so that the owner heap keeps some for itself
+        [[nodiscard]] void* steal(std::size_t reserved_slot_count)
+        {
+            this->enter_concurrent_context();
+            void* ret = pop_internal(reserved_slot_count);
+
+            if (ret != nullptr)
+            {
+                m_capacity--;
+            }
+
+            this->leave_concurrent_context();
+            return ret;
+        }
+
+        // Adds a slot to the heap's capacity
+        void adopt(void* slot)
+        {
+            this->enter_concurrent_context();
+            push_internal(slot);
+            m_capacity++;
+            this->leave_concurrent_context();
+        }
+
+        // Gives free slots back to the system except 'reserved_slot_count' of them. Returns the number of released slots
+        template <typename ArenaType>
+        std::size_t release_free_slots(ArenaType* arena, std::size_t reserved_slot_count = 0)
+        {
+            std::size_t released_slot_count = 0;
+            void* slot = nullptr;
+
+            while ((slot = steal(reserved_slot_count)) != nullptr)
+            {
+                arena->release_to_system(slot, m_slot_size);
+                released_slot_count++;
+            }
+
+            return released_slot_count;
+        }
+
+        std::size_t get_free_slot_count() const { return m_free_slot_count; }
+        std::size_t get_capacity() const { return m_capacity; }           // Number of slots which belong to the heap , either free or used by its segments
+        std::size_t get_slot_size() const { return m_slot_size; } // 0 means that the pool is not created
+
+    private:
+        struct SlotNode
+        {
+            SlotNode* m_next;
+        };
+
+        SlotNode* m_head = nullptr;
+        std::size_t m_free_slot_count = 0;
+        std::size_t m_capacity = 0;
+        std::size_t m_slot_size = 0;
+
+        void* pop_internal(std::size_t reserved_slot_count)
+        {
+            if (m_free_slot_count <= reserved_slot_count)
+            {
+                return nullptr;
+            }
+
+            SlotNode* ret = m_head;
+            m_head = ret->m_next;
+            m_free_slot_count--;
+            return ret;
+        }
+
+        void push_internal(void* slot)
+        {
+            SlotNode* new_node = static_cast<SlotNode*>(slot);
+            new_node->m_next = m_head;
+            m_head = new_node;
+            m_free_slot_count++;
+        }
+};
+
+#endif
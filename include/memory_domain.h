@@ -0,0 +1,172 @@
+/*
+    ISOLATED ALLOCATOR INSTANCE , FOR EX FOR A TENANT OR A REQUEST CLASS. UNLIKE SCALABLE ALLOCATOR , IT IS NOT A SINGLETON
+
+    - EACH DOMAIN HAS ITS OWN REGION ( SEE DomainArena ) , HEAP CONFIGURATION AND STATS
+
+    - THE DOMAIN OF A POINTER IS FOUND IN O(1) : REGIONS ARE ALIGNED TO THEIR SIZES AND THE FIRST BYTES OF EACH REGION POINT TO THE OWNER DOMAIN. SEE get_domain_of
+
+    - release_all RELEASES ALL OBJECTS OF THE DOMAIN AT ONCE WITHOUT DEALLOCATING THEM ONE BY ONE : THE HEAP IS REBUILT AND THE REGION GOES BACK TO THE SYSTEM
+
+    - THE HEAP SHOULD USE DomainArena AS ITS ARENA. FOR DOMAINS SHARED BY THREADS , IT SHOULD BE A CENTRAL HEAP
+
+    - ALLOCATIONS BIGGER THAN THE HEAP'S MAX ALLOCATION SIZE ARE NOT SERVED
+*/
+#ifndef __MEMORY_DOMAIN_H__
+#define __MEMORY_DOMAIN_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <new>
+#include "compiler/hints_branch_predictor.h"
+#include "utilities/lockable.h"
+#include "arena_base.h"
+#include "domain_arena.h"
+
+template <typename HeapType, typename ArenaType = DomainArena<>>
+class MemoryDomain : public Lockable<LockPolicy::USERSPACE_LOCK>
+{
+public:
+
+    MemoryDomain()
+    {
+        static_assert(std::is_base_of<ArenaBase<ArenaType>, ArenaType>::value);
+    }
+
+    ~MemoryDomain()
+    {
+        destroy_heap(); // Before the region goes away
+    }
+
+    MemoryDomain(const MemoryDomain& other) = delete;
+    MemoryDomain& operator= (const MemoryDomain& other) = delete;
+    MemoryDomain(MemoryDomain&& other) = delete;
+    MemoryDomain& operator=(MemoryDomain&& other) = delete;
+
+    [[nodiscard]] bool create(const typename HeapType::HeapCreationParams& params, std::size_t page_alignment = 65536)
+    {
+        if (m_arena.create(page_alignment) == false)
+        {
+            return false;
+        }
+
+        m_heap_creation_params = params;
+        return build();
+    }
+
+    [[nodiscard]] void* allocate(std::size_t size)
+    {
+        if (unlikely(size > get_heap()->get_max_allocation_size()))
+        {
+            return nullptr;
+        }
+
+        void* ret = get_heap()->allocate(size);
+
+        if (likely(ret != nullptr))
+        {
+            m_allocation_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return ret;
+    }
+
+    [[nodiscard]] void* allocate_aligned(std::size_t size, std::size_t alignment)
+    {
+        if (unlikely(size + alignment > get_heap()->get_max_allocation_size()))
+        {
+            return nullptr;
+        }
+
+        void* ret = get_heap()->allocate_aligned(size, alignment);
+
+        if (likely(ret != nullptr))
+        {
+            m_allocation_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return ret;
+    }
+
+    void deallocate(void* ptr)
+    {
+        if (unlikely(ptr == nullptr))
+        {
+            return;
+        }
+
+        get_heap()->deallocate(ptr);
+        m_deallocation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Releases all objects of the domain. No other thread should be using the domain meanwhile
+    // Its region is given back to the system and the domain starts again with an empty heap. Returns false if the system is out of memory
+    [[nodiscard]] bool release_all()
+    {
+        this->enter_concurrent_context();
+        //////////////////////////////////////////////////
+        destroy_heap(); // Gives only logical pages back to the arena , not objects
+
+        bool ret = m_arena.reset();
+
+        if (ret)
+        {
+            ret = build();
+        }
+
+        m_allocation_count.store(0, std::memory_order_relaxed);
+        m_deallocation_count.store(0, std::memory_order_relaxed);
+        //////////////////////////////////////////////////
+        this->leave_concurrent_context();
+
+        return ret;
+    }
+
+    // O(1) , 'ptr' should be allocated by a domain of the same type
+    static MemoryDomain* get_domain_of(void* ptr)
+    {
+        return reinterpret_cast<RegionHeader*>(ArenaType::get_region_of(ptr))->m_domain;
+    }
+
+    bool owns_pointer(void* ptr) const { return m_arena.owns_pointer(ptr); }
+
+    std::size_t get_allocation_count() const { return m_allocation_count.load(std::memory_order_relaxed); }
+    std::size_t get_deallocation_count() const { return m_deallocation_count.load(std::memory_order_relaxed); }
+    std::size_t get_used_region_size() const { return m_arena.get_used_size(); }    // Bytes taken from the region by the heap , including the header
+    HeapType* get_heap() { return reinterpret_cast<HeapType*>(m_heap_storage); }
+
+private:
+    struct RegionHeader
+    {
+        MemoryDomain* m_domain;
+    };
+
+    ArenaType m_arena;
+    alignas(HeapType) char m_heap_storage[sizeof(HeapType)]; // The heap is rebuilt in place by release_all
+    bool m_heap_constructed = false;
+    typename HeapType::HeapCreationParams m_heap_creation_params;
+    std::atomic<std::size_t> m_allocation_count = 0;
+    std::atomic<std::size_t> m_deallocation_count = 0;
+
+    bool build()
+    {
+        reinterpret_cast<RegionHeader*>(m_arena.get_region())->m_domain = this;
+
+        new(m_heap_storage) HeapType(); // Placement new , does not invoke memory allocation
+        m_heap_constructed = true;
+
+        return get_heap()->create(m_heap_creation_params, &m_arena);
+    }
+
+    void destroy_heap()
+    {
+        if (m_heap_constructed)
+        {
+            get_heap()->~HeapType();
+            m_heap_constructed = false;
+        }
+    }
+};
+
+#endif
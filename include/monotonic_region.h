@@ -0,0 +1,269 @@
+/*
+    MONOTONIC REGION ALLOCATOR FOR REQUEST SCOPED WORK
+
+    - ALLOCATIONS BUMP A POINTER IN THE CURRENT CHUNK. DEALLOCATIONS DO NOTHING , ALL OBJECTS ARE RELEASED AT ONCE BY reset OR release
+
+    - CHUNKS COME FROM AN ARENA AND ARE CHAINED THROUGH THEIR HEADERS. ALLOCATIONS BIGGER THAN A CHUNK GET THEIR OWN OVERSIZED CHUNKS
+
+    - reset KEEPS REGULAR CHUNKS FOR THE NEXT REQUEST AND GIVES ONLY OVERSIZED ONES BACK TO THE ARENA , THEREFORE IT IS O(CHUNKS).
+      release GIVES ALL CHUNKS BACK
+
+    - IT IS NOT THREAD SAFE , LIKE SINGLE THREAD HEAPS. AN ARENA WITH LockPolicy::NO_LOCK CAN BE USED IF THE ARENA IS NOT SHARED
+
+    - MonotonicRegionResource ADAPTS IT TO std::pmr::memory_resource , SO THAT PMR CONTAINERS CAN USE IT. IT DOESN'T NEED RTTI AND ON ALLOCATION FAILURES IT FOLLOWS OPERATOR NEW :
+      IT CALLS THE NEW HANDLER IF THERE IS ONE , OTHERWISE IT THROWS std::bad_alloc OR ABORTS IF EXCEPTIONS ARE DISABLED
+*/
+#ifndef __MONOTONIC_REGION_H__
+#define __MONOTONIC_REGION_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <memory_resource>
+#include "compiler/hints_branch_predictor.h"
+#include "compiler/hints_hot_code.h"
+#include "compiler/unused.h"
+#include "cpu/alignment_constants.h"
+#include "utilities/multiple_utilities.h"
+#include "utilities/pow2_utilities.h"
+#include "arena.h"
+
+template <typename ArenaType = Arena<>>
+class MonotonicRegion
+{
+    public:
+
+        static constexpr inline std::size_t MINIMUM_ALIGNMENT = 16;
+
+        MonotonicRegion() = default;
+
+        ~MonotonicRegion()
+        {
+            release();
+        }
+
+        MonotonicRegion(const MonotonicRegion& other) = delete;
+        MonotonicRegion& operator= (const MonotonicRegion& other) = delete;
+        MonotonicRegion(MonotonicRegion&& other) = delete;
+        MonotonicRegion& operator=(MonotonicRegion&& other) = delete;
+
+        // 'chunk_size' will be rounded up to a multiple of the arena's page alignment
+        [[nodiscard]] bool create(std::size_t chunk_size, ArenaType* arena)
+        {
+            if (arena == nullptr || chunk_size <= sizeof(ChunkHeader))
+            {
+                return false;
+            }
+
+            m_arena = arena;
+            m_chunk_size = MultipleUtilities::get_next_pow2_multiple_of(chunk_size, m_arena->page_alignment());
+            return true;
+        }
+
+        // Alignment has to be a power of two
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        FORCE_INLINE void* allocate(std::size_t size, std::size_t alignment = MINIMUM_ALIGNMENT)
+        {
+            uint64_t address = MultipleUtilities::get_next_pow2_multiple_of(m_current, alignment);
+
+            if (likely(address + size <= m_end))
+            {
+                m_current = address + size;
+                return reinterpret_cast<void*>(address);
+            }
+
+            return allocate_from_next_chunk(size, alignment);
+        }
+
+        void deallocate(void* ptr)
+        {
+            UNUSED(ptr); // Objects are released by reset or release
+        }
+
+        // Releases all objects. Regular chunks are kept for the next allocations , oversized chunks go back to the arena
+        void reset()
+        {
+            release_chunks(m_oversized_head);
+            m_oversized_head = nullptr;
+
+            m_current_chunk = nullptr;
+            m_current = 0;
+            m_end = 0;
+
+            if (m_head != nullptr)
+            {
+                start_chunk(m_head);
+            }
+        }
+
+        // Releases all objects and gives all chunks back to the arena
+        void release()
+        {
+            release_chunks(m_oversized_head);
+            release_chunks(m_head);
+            m_oversized_head = nullptr;
+            m_head = nullptr;
+            m_current_chunk = nullptr;
+            m_current = 0;
+            m_end = 0;
+            m_chunk_count = 0;
+        }
+
+        std::size_t get_chunk_count() const { return m_chunk_count; }       // Regular chunks
+        std::size_t get_chunk_size() const { return m_chunk_size; }
+
+    private:
+        struct ChunkHeader
+        {
+            ChunkHeader* m_next;
+            std::size_t m_size;
+        };
+
+        uint64_t m_current = 0;        // Bump pointer
+        uint64_t m_end = 0;
+        ChunkHeader* m_current_chunk = nullptr;
+        ChunkHeader* m_head = nullptr;              // Regular chunks , kept by reset
+        ChunkHeader* m_oversized_head = nullptr;
+        ArenaType* m_arena = nullptr;
+        std::size_t m_chunk_size = 0;
+        std::size_t m_chunk_count = 0;
+
+        FORCE_INLINE void start_chunk(ChunkHeader* chunk)
+        {
+            m_current_chunk = chunk;
+            m_current = reinterpret_cast<uint64_t>(chunk) + sizeof(ChunkHeader);
+            m_end = reinterpret_cast<uint64_t>(chunk) + chunk->m_size;
+        }
+
+        ChunkHeader* create_chunk(std::size_t size)
+        {
+            ChunkHeader* chunk = reinterpret_cast<ChunkHeader*>(m_arena->allocate(size));
+
+            if (chunk != nullptr)
+            {
+                chunk->m_next = nullptr;
+                chunk->m_size = size;
+            }
+
+            return chunk;
+        }
+
+        void* allocate_from_next_chunk(std::size_t size, std::size_t alignment)
+        {
+            if (m_arena == nullptr)
+            {
+                return nullptr;
+            }
+
+            std::size_t required_size = sizeof(ChunkHeader) + size + alignment;
+
+            if (required_size > m_chunk_size)
+            {
+                // Oversized chunks don't become the current chunk , so the rest of the current chunk is still used
+                ChunkHeader* chunk = create_chunk(MultipleUtilities::get_next_pow2_multiple_of(required_size, m_arena->page_alignment()));
+
+                if (chunk == nullptr)
+                {
+                    return nullptr;
+                }
+
+                chunk->m_next = m_oversized_head;
+                m_oversized_head = chunk;
+                return reinterpret_cast<void*>(MultipleUtilities::get_next_pow2_multiple_of(reinterpret_cast<uint64_t>(chunk) + sizeof(ChunkHeader), alignment));
+            }
+
+            // Chunks kept by reset are reused before creating new ones
+            ChunkHeader* next_chunk = m_current_chunk != nullptr ? m_current_chunk->m_next : m_head;
+
+            if (next_chunk == nullptr)
+            {
+                next_chunk = create_chunk(m_chunk_size);
+
+                if (next_chunk == nullptr)
+                {
+                    return nullptr;
+                }
+
+                if (m_current_chunk != nullptr)
+                {
+                    m_current_chunk->m_next = next_chunk;
+                }
+                else
+                {
+                    m_head = next_chunk;
+                }
+
+                m_chunk_count++;
+            }
+
+            start_chunk(next_chunk);
+            return allocate(size, alignment);
+        }
+
+        void release_chunks(ChunkHeader* chunk)
+        {
+            while (chunk != nullptr)
+            {
+                ChunkHeader* next = chunk->m_next;
+                m_arena->release_to_system(chunk, chunk->m_size);
+                chunk = next;
+            }
+        }
+};
+
+template <typename ArenaType = Arena<>>
+class MonotonicRegionResource : public std::pmr::memory_resource
+{
+    public:
+
+        explicit MonotonicRegionResource(MonotonicRegion<ArenaType>* region) : m_region(region) {}
+
+    private:
+        MonotonicRegion<ArenaType>* m_region = nullptr;
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            alignment = alignment < MonotonicRegion<ArenaType>::MINIMUM_ALIGNMENT ? MonotonicRegion<ArenaType>::MINIMUM_ALIGNMENT : alignment;
+            void* ret = m_region->allocate(bytes, alignment);
+
+            while (unlikely(ret == nullptr))
+            {
+                handle_allocation_failure();
+                ret = m_region->allocate(bytes, alignment);
+            }
+
+            return ret;
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+        {
+            UNUSED(bytes);
+            UNUSED(alignment);
+            m_region->deallocate(p);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other; // Without RTTI , other resources can't be checked for their regions
+        }
+
+        static void handle_allocation_failure()
+        {
+            std::new_handler handler = std::get_new_handler();
+
+            if (handler != nullptr)
+            {
+                handler();
+                return;
+            }
+
+            #if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+            throw std::bad_alloc();
+            #else
+            std::abort();
+            #endif
+        }
+};
+
+#endif
@@ -0,0 +1,216 @@
+/*
+    TYPED OBJECT POOL FOR FIXED SIZE HOT OBJECTS , FOR EX ORDERS OR NODES
+
+    - THE SIZE CLASS IS FIXED AT COMPILE TIME : sizeof(T) ROUNDED UP TO A MULTIPLE OF 16. THERE IS NO SIZE TO BIN LOOKUP ON ANY PATH
+
+    - REUSES A SINGLE SEGMENT OF LOGICAL PAGES. LOGICAL PAGES ARE ALIGNED TO THEIR SIZES SO DEALLOCATIONS FIND THEIR PAGES BY MASKING
+
+    - ALLOCATIONS POP FROM AN INTRUSIVE CACHE. WHEN THE CACHE IS EMPTY IT IS REFILLED WITH A BATCH FROM THE SEGMENT ( SEE Segment::allocate_batch ).
+      WHEN IT GROWS BEYOND 2 BATCHES , A BATCH GOES BACK TO THE SEGMENT SO THAT LOGICAL PAGES CAN STILL BE RECYCLED
+
+    - SINGLE_THREAD : ONLY ONE THREAD USES THE POOL. THE SEGMENT GROWS FROM THE ARENA WHEN ITS PAGES RUN OUT
+
+    - THREAD_LOCAL : ONLY THE OWNER THREAD ALLOCATES AND IT DEALLOCATES WITH deallocate_from_owner. OTHER THREADS USE deallocate WHICH GOES TO THE SEGMENT'S
+      REMOTE DEALLOCATION PATH. THE SEGMENT IS BOUNDED BY ITS INITIAL LOGICAL PAGE COUNT
+
+    - construct AND destroy CONSTRUCT AND DESTROY OBJECTS IN PLACE
+*/
+#ifndef __OBJECT_POOL_H__
+#define __OBJECT_POOL_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include "compiler/hints_branch_predictor.h"
+#include "compiler/hints_hot_code.h"
+#include "cpu/alignment_constants.h"
+#include "arena.h"
+#include "logical_page.h"
+#include "segment.h"
+
+struct ObjectPoolCreationParams
+{
+    std::size_t m_logical_page_size = 65536;     // Arena page alignment should be the same
+    std::size_t m_logical_page_count = 1;
+    std::size_t m_batch_size = 32;               // Number of objects moved between the cache and the segment at once
+    std::size_t m_logical_page_recycling_threshold = 0; // Free logical pages are kept while the segment has no more than that. THREAD_LOCAL pools can't grow back
+    double m_segment_grow_coefficient = 1.0;
+    std::size_t m_segment_deallocation_queue_drain_budget = 128; // Applies to THREAD_LOCAL , 0 means no limit
+};
+
+template <
+            typename T,
+            ConcurrencyPolicy concurrency_policy = ConcurrencyPolicy::SINGLE_THREAD,
+            typename ArenaType = Arena<>,
+            PageRecyclingPolicy page_recycling_policy = PageRecyclingPolicy::IMMEDIATE,
+            typename LogicalPageType = LogicalPage<>
+        >
+class ObjectPool
+{
+    public:
+
+        static_assert(concurrency_policy == ConcurrencyPolicy::SINGLE_THREAD || concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL);
+        static_assert(alignof(T) <= 16); // Chunks are 16 byte aligned as size classes are multiples of 16
+
+        static constexpr inline std::size_t SIZE_CLASS = sizeof(T) < 16 ? 16 : ((sizeof(T) + 15) & ~static_cast<std::size_t>(15));
+
+        using SegmentType = Segment<concurrency_policy, LogicalPageType, ArenaType, page_recycling_policy, true>; // true as logical pages are placed at "logical page size" aligned addresses
+
+        ObjectPool() = default;
+
+        ~ObjectPool()
+        {
+            // Cached chunks keep their logical pages in use , they should go back before the segment is destroyed
+            while (m_cache_head != nullptr)
+            {
+                m_segment.deallocate_from_owner(pop_from_cache());
+            }
+        }
+
+        ObjectPool(const ObjectPool& other) = delete;
+        ObjectPool& operator= (const ObjectPool& other) = delete;
+        ObjectPool(ObjectPool&& other) = delete;
+        ObjectPool& operator=(ObjectPool&& other) = delete;
+
+        [[nodiscard]] bool create(const ObjectPoolCreationParams& params, ArenaType* arena)
+        {
+            if (arena == nullptr || params.m_batch_size == 0 || params.m_logical_page_count == 0 || arena->page_alignment() != params.m_logical_page_size)
+            {
+                return false;
+            }
+
+            if (SIZE_CLASS > params.m_logical_page_size - sizeof(LogicalPageHeader))
+            {
+                return false;
+            }
+
+            char* buffer = arena->allocate(params.m_logical_page_count * params.m_logical_page_size);
+
+            if (buffer == nullptr)
+            {
+                return false;
+            }
+
+            SegmentCreationParameters segment_params;
+            segment_params.m_size_class = static_cast<uint32_t>(SIZE_CLASS);
+            segment_params.m_logical_page_count = params.m_logical_page_count;
+            segment_params.m_logical_page_size = params.m_logical_page_size;
+            segment_params.m_page_recycling_threshold = params.m_logical_page_recycling_threshold;
+            segment_params.m_grow_coefficient = params.m_segment_grow_coefficient;
+            segment_params.m_deallocation_queue_drain_budget = params.m_segment_deallocation_queue_drain_budget;
+
+            m_batch_size = params.m_batch_size;
+            return m_segment.create(buffer, arena, segment_params);
+        }
+
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        FORCE_INLINE void* allocate()
+        {
+            if (unlikely(m_cache_head == nullptr) && refill() == false)
+            {
+                return nullptr;
+            }
+
+            return pop_from_cache();
+        }
+
+        // SINGLE_THREAD pools and the owner thread of THREAD_LOCAL pools
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        FORCE_INLINE void deallocate_from_owner(void* ptr)
+        {
+            push_to_cache(ptr);
+
+            if (unlikely(m_cache_count > m_batch_size * 2))
+            {
+                flush(m_batch_size);
+            }
+        }
+
+        // Can be called by any thread in THREAD_LOCAL case
+        void deallocate(void* ptr)
+        {
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                m_segment.deallocate(ptr);
+            }
+            else
+            {
+                deallocate_from_owner(ptr);
+            }
+        }
+
+        template <typename... Args>
+        [[nodiscard]] T* construct(Args&&... args)
+        {
+            void* ptr = allocate();
+
+            if (unlikely(ptr == nullptr))
+            {
+                return nullptr;
+            }
+
+            return new(ptr) T(std::forward<Args>(args)...); // Placement new , does not invoke memory allocation
+        }
+
+        void destroy_from_owner(T* object)
+        {
+            object->~T();
+            deallocate_from_owner(object);
+        }
+
+        void destroy(T* object)
+        {
+            object->~T();
+            deallocate(object);
+        }
+
+        std::size_t get_cached_count() const { return m_cache_count; }
+        std::size_t get_logical_page_count() const { return m_segment.get_logical_page_count(); }
+
+    private:
+        void* m_cache_head = nullptr;     // Chunks are linked through their first 8 bytes
+        std::size_t m_cache_count = 0;
+        std::size_t m_batch_size = 0;
+        SegmentType m_segment;
+
+        FORCE_INLINE void* pop_from_cache()
+        {
+            void* ret = m_cache_head;
+            m_cache_head = *reinterpret_cast<void**>(ret);
+            m_cache_count--;
+            return ret;
+        }
+
+        FORCE_INLINE void push_to_cache(void* ptr)
+        {
+            *reinterpret_cast<void**>(ptr) = m_cache_head;
+            m_cache_head = ptr;
+            m_cache_count++;
+        }
+
+        bool refill()
+        {
+            void* first = nullptr;
+            std::size_t count = m_segment.allocate_batch(m_batch_size, &first);
+
+            if (count == 0)
+            {
+                return false;
+            }
+
+            m_cache_head = first;
+            m_cache_count = count;
+            return true;
+        }
+
+        void flush(std::size_t count)
+        {
+            for (std::size_t i = 0; i < count && m_cache_head != nullptr; i++)
+            {
+                m_segment.deallocate_from_owner(pop_from_cache());
+            }
+        }
+};
+
+#endif
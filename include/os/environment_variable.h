@@ -50,22 +50,24 @@ class EnvironmentVariable
         }
 
         // Utility function when handling csv numeric parameters from environment variables, does not allocate memory
-        static void set_numeric_array_from_comma_separated_value_string(std::size_t* target_array, const char* str)
+        // Values beyond the array length are ignored , elements without values keep their current values
+        template <std::size_t array_length>
+        static void set_numeric_array_from_comma_separated_value_string(std::size_t (&target_array)[array_length], const char* str)
         {
             auto len = strlen(str);
 
-            constexpr std::size_t MAX_STRING_LEN = 64;
+            constexpr std::size_t MAX_STRING_LEN = 512; // Enough for page counts of heaps with many bins , for ex 40 bins of SimpleHeapFineGrained
             constexpr std::size_t MAX_TOKEN_LEN = 8;
             std::size_t start = 0;
             std::size_t end = 0;
             std::size_t counter = 0;
 
-            while (end <= len && end < MAX_STRING_LEN - 1)
+            while (end <= len && end < MAX_STRING_LEN - 1 && counter < array_length)
             {
                 if (str[end] == ',' || (end > start && end == len))
                 {
                     char token[MAX_TOKEN_LEN];
-                    std::size_t token_len = end - start;
+                    std::size_t token_len = end - start < MAX_TOKEN_LEN - 1 ? end - start : MAX_TOKEN_LEN - 1;
 
                     #ifdef __linux__
                     strncpy(token, str + start, token_len);
@@ -50,6 +50,7 @@
 #endif
 
 #include "../compiler/builtin_functions.h"
+#include "../compiler/unused.h"
 
 class VirtualMemory
 {
@@ -362,6 +363,38 @@ class VirtualMemory
             return ret;
         }
 
+        // Unlike allocate , it doesn't populate pages. For big regions which may stay mostly unused
+        // On Linux pages are backed by physical memory when they are touched. On Windows they are only reserved , they have to be committed before they are touched , see commit
+        static void* reserve(std::size_t size)
+        {
+            void* ret = nullptr;
+            #ifdef __linux__
+            ret = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+            if (ret == MAP_FAILED)
+            {
+                ret = nullptr;
+            }
+            #elif _WIN32
+            ret = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS); // Doesn't charge the commit limit
+            #endif
+            return ret;
+        }
+
+        // For reserved pages , see reserve. Committed pages get physical memory on first access
+        static bool commit(void* address, std::size_t size)
+        {
+            bool ret{ false };
+            #ifdef __linux__
+            UNUSED(address);
+            UNUSED(size);
+            ret = true; // Reserved pages are already accessible
+            #elif _WIN32
+            ret = VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr ? true : false;
+            #endif
+            return ret;
+        }
+
         static bool deallocate(void* address, std::size_t size)
         {
             bool ret{ false };
@@ -0,0 +1,130 @@
+/*
+    PER THREAD BUFFERS FOR DEALLOCATIONS TARGETING HEAPS OF OTHER THREADS
+
+    - EACH ENTRY COLLECTS CHUNKS OF ONE SIZE CLASS OF ONE DESTINATION HEAP AND HANDS THEM TO THE HEAP AS ONE BATCH WHEN IT IS FULL.
+      THEREFORE A DESTINATION DEALLOCATION QUEUE SEES A SINGLE PUSH PER BATCH INSTEAD OF ONE PER CHUNK
+
+    - IT IS INTRUSIVE : FIRST 8 BYTES OF EACH BUFFERED CHUNK HOLD THE NEXT POINTER , IN THE SAME WAY AS DEALLOCATION QUEUES.
+      SO A BATCH CAN BE PUSHED TO A DEALLOCATION QUEUE AS IS
+
+    - ALL ENTRIES ARE FLUSHED AFTER EVERY 'flush_interval' BUFFERED DEALLOCATIONS , SO THAT CHUNKS OF RARELY USED ENTRIES DON'T STAY FOR LONG.
+      WHEN ALL ENTRIES ARE IN USE , ENTRIES ARE EVICTED IN ROUND ROBIN
+
+    - IT IS NOT THREAD SAFE , IT IS SUPPOSED TO BE USED ONLY BY ITS OWNER THREAD
+
+    - DESTINATION HEAPS NEED TO IMPLEMENT 'void deallocate_batch(void* first, void* last)'
+*/
+#ifndef __REMOTE_DEALLOCATION_CACHE__
+#define __REMOTE_DEALLOCATION_CACHE__
+
+#include <cstddef>
+#include <cstdint>
+#include "compiler/hints_branch_predictor.h"
+#include "compiler/hints_hot_code.h"
+
+template <typename HeapType, std::size_t entry_count = 8>
+class RemoteDeallocationCache
+{
+    public:
+
+        RemoteDeallocationCache() = default;
+        ~RemoteDeallocationCache() = default;
+
+        RemoteDeallocationCache(const RemoteDeallocationCache& other) = delete;
+        RemoteDeallocationCache& operator= (const RemoteDeallocationCache& other) = delete;
+        RemoteDeallocationCache(RemoteDeallocationCache&& other) = delete;
+        RemoteDeallocationCache& operator=(RemoteDeallocationCache&& other) = delete;
+
+        // 'flush_interval' 0 means no periodic flushes
+        FORCE_INLINE void add(HeapType* destination, uint32_t size_class, void* pointer, std::size_t batch_size, std::size_t flush_interval)
+        {
+            Entry* target = nullptr;
+            Entry* empty_entry = nullptr;
+
+            for (std::size_t i = 0; i < entry_count; i++)
+            {
+                if (m_entries[i].m_destination == destination && m_entries[i].m_size_class == size_class)
+                {
+                    target = &m_entries[i];
+                    break;
+                }
+
+                if (empty_entry == nullptr && m_entries[i].m_destination == nullptr)
+                {
+                    empty_entry = &m_entries[i];
+                }
+            }
+
+            if (unlikely(target == nullptr))
+            {
+                if (empty_entry == nullptr)
+                {
+                    empty_entry = &m_entries[m_next_evicted_entry_index];
+                    m_next_evicted_entry_index = (m_next_evicted_entry_index + 1) % entry_count;
+                    flush_entry(empty_entry);
+                }
+
+                target = empty_entry;
+                target->m_destination = destination;
+                target->m_size_class = size_class;
+                target->m_last = pointer;
+            }
+
+            *reinterpret_cast<void**>(pointer) = target->m_first;
+            target->m_first = pointer;
+            target->m_count++;
+
+            if (target->m_count >= batch_size)
+            {
+                flush_entry(target);
+            }
+
+            m_buffered_count_since_last_flush++;
+
+            if (flush_interval != 0 && m_buffered_count_since_last_flush >= flush_interval)
+            {
+                flush();
+            }
+        }
+
+        void flush()
+        {
+            for (std::size_t i = 0; i < entry_count; i++)
+            {
+                flush_entry(&m_entries[i]);
+            }
+
+            m_buffered_count_since_last_flush = 0;
+        }
+
+    private:
+
+        struct Entry
+        {
+            HeapType* m_destination = nullptr;
+            void* m_first = nullptr;
+            void* m_last = nullptr;
+            uint32_t m_size_class = 0;
+            uint32_t m_count = 0;
+        };
+
+        Entry m_entries[entry_count];
+        std::size_t m_next_evicted_entry_index = 0;
+        std::size_t m_buffered_count_since_last_flush = 0;
+
+        void flush_entry(Entry* entry)
+        {
+            if (entry->m_destination != nullptr)
+            {
+                entry->m_destination->deallocate_batch(entry->m_first, entry->m_last);
+            }
+
+            entry->m_destination = nullptr;
+            entry->m_first = nullptr;
+            entry->m_last = nullptr;
+            entry->m_size_class = 0;
+            entry->m_count = 0;
+        }
+};
+
+#endif
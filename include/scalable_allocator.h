@@ -6,14 +6,42 @@
     - USES CONFIGURABLE METADATA ( DEFAULT 128KB ) TO STORE LOCAL HEAPS. ALSO INITIALLY USES 64KB METADATA TO STORE VERY BIG SIZED ALLOCATIONS
 
     - YOU HAVE TO MAKE SURE THAT METADATA SIZE WILL BE ABLE TO HANDLE NUMBER OF THREADS IN YOUR APPLICATION.
+
+    - DEALLOCATIONS TARGETING OTHER THREADS' HEAPS ARE BUFFERED PER DESTINATION HEAP AND SIZE CLASS IN THE CALLING THREAD , AND HANDED OVER IN BATCHES.
+      SEE RemoteDeallocationCache AND set_remote_deallocation_batching
+
+    - WHEN A LOCAL HEAP IS EXHAUSTED FOR A SIZE CLASS , THE CALLING THREAD'S TRANSFER CACHE TAKES CHUNKS FROM THE CENTRAL HEAP IN BATCHES
+      AND RETURNS DEALLOCATED CENTRAL CHUNKS IN BATCHES. SEE TransferCache AND set_transfer_batch_size
+
+    - OPTIONALLY , BEFORE GOING TO THE CENTRAL HEAP , AN EXHAUSTED LOCAL HEAP CAN STEAL FREE LOGICAL PAGES FROM THE LOGICAL PAGE POOLS OF OTHER LOCAL HEAPS ,
+      INCLUDING HEAPS OF EXITED THREADS. SEE set_page_stealing
+
+    - rebalance_thread_local_heaps MOVES FREE LOGICAL PAGES FROM IDLE LOCAL HEAPS TO THE ONES WHICH WERE EXHAUSTED SINCE ITS PREVIOUS CALL. SEE set_heap_rebalancing
+
+    - LOCAL HEAPS OF LONG LIVING IDLE THREADS CAN GIVE THEIR FREE LOGICAL PAGES BACK WITH flush_thread_cache AND release_idle_thread_caches
+
+    - HOT THREADS ARE SERVED WITHOUT SYSCALLS WHILE replenish KEEPS THEIR LOGICAL PAGE POOLS AND THE ARENA CACHE ABOVE LOW WATERMARKS. SEE set_hot_thread_watermarks
+
+    - prewarm_current_thread CREATES THE CALLING THREAD'S LOCAL HEAP AHEAD OF TIME AND FILLS ITS FREE LISTS WITH FAULTED IN CHUNKS. IT CAN ALSO LOCK THEIR LOGICAL PAGES ,
+      WHICH unlock_pages_of_current_thread UNDOES
+
+    - IT IS A PROCESS WIDE SINGLETON , FOR ISOLATED ALLOCATOR INSTANCES SEE MemoryDomain
+
+    - LOCAL HEAPS CAN BE SELECTED BY A CONTEXT KEY SUCH AS A WORKER OR FIBER ID INSTEAD OF THREAD LOCAL STORAGE. SEE heap_selector.h AND set_context_key_count
+
+    - DEALLOCATIONS OF VERY BIG OBJECTS AND RELEASES OF LOGICAL PAGES CAN BE HANDED TO A HELPER THREAD THROUGH LOCKFREE QUEUES. SEE set_deallocation_offload
+
+    - FOR SIZES KNOWN AT COMPILE TIME , allocate<size> AND deallocate<size> RESOLVE BINS AT COMPILE TIME IF HEAPS SUPPORT IT. SEE metamalloc_new
 */
 #ifndef __SCALABLE_ALLOCATOR__H__
 #define __SCALABLE_ALLOCATOR__H__
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <type_traits>
 #include <new> // std::get_new_handler
+#include <utility>
 #include "compiler/builtin_functions.h"
 #include "compiler/hints_hot_code.h"
 #include "compiler/hints_branch_predictor.h"
@@ -24,7 +52,11 @@
 #include "utilities/dictionary.h"
 #include "utilities/userspace_spinlock.h"
 #include "arena_base.h"
+#include "deallocation_queue.h"
 #include "heap_base.h"
+#include "heap_selector.h"
+#include "remote_deallocation_cache.h"
+#include "transfer_cache.h"
 
 #ifdef ENABLE_DEFAULT_MALLOC // VOLTRON_EXCLUDE
 #include "compiler/builtin_functions.h"
@@ -47,7 +79,8 @@
 template <
             typename CentralHeapType,
             typename LocalHeapType,
-            typename ArenaType = Arena<>
+            typename ArenaType = Arena<>,
+            typename HeapSelectorType = ThreadLocalHeapSelector
          >
 class ScalableAllocator : public Lockable<LockPolicy::USERSPACE_LOCK>
 {
@@ -128,579 +161,1726 @@ public:
     {
         m_cached_thread_local_heap_count = count;
     }
+
+    // Remote deallocations will be handed to their heaps when 'batch_size' of them accumulate for a heap and size class , 1 means no batching
+    // Also all buffered ones will be handed over after every 'flush_interval' remote deallocations , 0 means no periodic flushes
+    // Local heaps need to implement 'void deallocate_batch(void* first, void* last)'
+    void set_remote_deallocation_batching(std::size_t batch_size, std::size_t flush_interval)
+    {
+        m_remote_deallocation_batch_size = batch_size;
+        m_remote_deallocation_flush_interval = flush_interval;
+    }
     
-    void enable_fast_shutdown() 
+    // Number of chunks transfer caches take from and return to the central heap at once , 1 means no transfer caches
+    // Central heaps need to implement 'std::size_t get_size_class_from_size(std::size_t size)' , 'allocate_batch' and 'deallocate_batch'
+    void set_transfer_batch_size(std::size_t batch_size)
     {
-        m_fast_shutdown = true;
+        m_transfer_batch_size = batch_size;
     }
 
-    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
-    void* allocate(const std::size_t size)
+    // Should be called before 'create'. An exhausted local heap will take a free logical page from another local heap's logical page pool before going to the central heap ,
+    // as long as that heap keeps 'reserved_slot_count' free slots. Heaps of exited threads keep their free slots for that , otherwise they give them back to the system
+    // A stolen logical page moves to the stealing heap for good. As it is still in the address range of the original heap , deallocations look stolen pages up first ,
+    // therefore 'max_stolen_logical_page_count' also bounds that lookup. 0 means no page stealing
+    // Local heaps need to use logical page pools , see SimpleHeapPow2::HeapCreationParams::m_use_shared_logical_page_pool
+    void set_page_stealing(std::size_t max_stolen_logical_page_count, std::size_t reserved_slot_count = 1)
     {
-        #ifndef ENABLE_DEFAULT_MALLOC
-        if (unlikely( size > m_central_heap.get_max_allocation_size()))
+        m_max_stolen_logical_page_count = max_stolen_logical_page_count;
+        m_page_stealing_reserved_slot_count = reserved_slot_count;
+    }
+
+    // Number of logical pages which moved between local heaps and are still in use , their entries are removed when they go back to the system
+    std::size_t get_stolen_logical_page_count() const { return m_stolen_logical_page_count.load(std::memory_order_acquire) - m_free_stolen_logical_page_entry_count.load(std::memory_order_relaxed); }
+
+    // Rebalancing moves logical pages from idle thread local heaps to hot ones , see rebalance_thread_local_heaps
+    // A hot heap gets up to 'max_grow_count' logical pages per rebalancing. Pages released by idle heaps are given first. New pages are taken from the arena
+    // only while rebalancing hasn't taken 'logical_page_budget' more pages than it released , so 0 means that hot heaps grow only by what idle ones give up
+    // Idle heaps keep 'idle_heap_reserved_slot_count' free logical pages , heaps of exited threads keep none
+    // Growing hot heaps uses the stolen logical page table , therefore it also needs page stealing , see set_page_stealing
+    void set_heap_rebalancing(std::size_t logical_page_budget, std::size_t idle_heap_reserved_slot_count = 1, std::size_t max_grow_count = 8)
+    {
+        m_rebalancing_logical_page_budget = static_cast<int64_t>(logical_page_budget);
+        m_rebalancing_idle_heap_reserved_slot_count = idle_heap_reserved_slot_count;
+        m_rebalancing_max_grow_count = max_grow_count;
+    }
+
+    // Should be called periodically , for ex from a maintenance thread. A heap is hot if allocations of its thread couldn't be served by it since the previous call.
+    // Otherwise it is idle and its free logical pages above the reserved count are given to hot heaps or back to the system. Returns the number of logical pages given to hot heaps
+    // Local heaps need to use logical page pools , see SimpleHeapPow2::HeapCreationParams::m_use_shared_logical_page_pool
+    std::size_t rebalance_thread_local_heaps()
+    {
+        if (m_local_heap_activities == nullptr || m_active_local_heap_count == 0)
         {
-            auto ptr = VirtualMemory::allocate<false>(size);
-            m_very_big_object_allocation_lock.lock();
-            m_very_big_object_dict.insert( reinterpret_cast<uint64_t>(ptr), size);
-            m_very_big_object_allocation_lock.unlock();
-            return ptr;
+            return 0;
         }
-        
-        void* ret{ nullptr };
-        auto local_heap = get_thread_local_heap();
 
-        if (local_heap != nullptr)
+        // All local heaps are created with the same parameters , any ready one gives the slot size
+        std::size_t slot_size = 0;
+        std::size_t active_local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0; i < active_local_heap_count && slot_size == 0; i++)
         {
-            ret = local_heap->allocate(size);
+            LocalHeapType* local_heap = get_ready_local_heap(i);
+
+            if (local_heap != nullptr)
+            {
+                slot_size = local_heap->get_logical_page_pool_slot_size();
+            }
         }
 
-        if (ret == nullptr)
+        if (slot_size == 0)
         {
-            #ifdef ENABLE_STATS
-            m_central_heap_hit_count++;
-            #endif
+            return 0;
+        }
 
-            #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
-            m_central_heap_hit_count++;
-            fprintf(stderr, "scalable allocator , central heap hit count=%zu\n", m_central_heap_hit_count);
-            #endif
+        this->enter_concurrent_context();
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 1. MEASURE DEMAND AND COLLECT FREE LOGICAL PAGES OF IDLE HEAPS , COLLECTED ONES ARE LINKED THROUGH THEIR FIRST 8 BYTES
+        void* collected_slots = nullptr;
+        std::size_t local_heap_count = m_active_local_heap_count;
 
-            //If the local one is exhausted , failover to the central one
-            ret = m_central_heap.allocate(size);
-        }
+        for (std::size_t i = 0; i < local_heap_count; i++)
+        {
+            LocalHeapType* local_heap = get_ready_local_heap(i);
 
-        #ifdef ENABLE_REPORT_INVALID_POINTERS
-        m_invalid_ptr_detection_lock.lock();
-        m_invalid_ptr_detection_dict.insert( reinterpret_cast<uint64_t>(ret), size);
-        m_invalid_ptr_detection_lock.unlock();
-        #endif
+            if (local_heap == nullptr)
+            {
+                continue;
+            }
 
-        return ret;
-        #else
-        return builtin_aligned_alloc(size, AlignmentConstants::MINIMUM_VECTORISATION_WIDTH);
-        #endif
-    }
+            LocalHeapActivity* activity = m_local_heap_activities + i;
+            activity->m_latest_exhaustion_count = activity->m_exhaustion_count.exchange(0, std::memory_order_relaxed);
 
-    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
-    void* allocate_aligned(std::size_t size, std::size_t alignment)
-    {
-        #ifndef ENABLE_DEFAULT_MALLOC
-        if (unlikely( size > m_central_heap.get_max_allocation_size()))
-        {
-            auto ptr = VirtualMemory::allocate<false>(size);
-            m_very_big_object_allocation_lock.lock();
-            m_very_big_object_dict.insert( reinterpret_cast<uint64_t>(ptr), size);
-            m_very_big_object_allocation_lock.unlock();
-            return ptr;
-        }
-        
-        void* ret{ nullptr };
-        auto local_heap = get_thread_local_heap();
+            bool exited = activity->m_exited.load(std::memory_order_acquire);
 
-        if (local_heap != nullptr)
-        {
-            ret = local_heap->allocate_aligned(size, alignment);
+            if (activity->m_latest_exhaustion_count == 0 || exited)
+            {
+                std::size_t reserved_slot_count = exited ? 0 : m_rebalancing_idle_heap_reserved_slot_count;
+                void* slot = nullptr;
+
+                while ((slot = local_heap->steal_logical_page_pool_slot(reserved_slot_count)) != nullptr)
+                {
+                    *reinterpret_cast<void**>(slot) = collected_slots;
+                    collected_slots = slot;
+                }
+            }
         }
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 2. GROW HOT HEAPS
+        std::size_t given_slot_count = 0;
 
-        if (ret == nullptr)
+        for (std::size_t i = 0; i < local_heap_count && m_stolen_logical_pages != nullptr; i++)
         {
-            #ifdef ENABLE_STATS
-            m_central_heap_hit_count++;
-            #endif
+            LocalHeapType* local_heap = get_ready_local_heap(i);
 
-            #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
-            m_central_heap_hit_count++;
-            fprintf(stderr, "scalable allocator , central heap hit count=%zu\n", m_central_heap_hit_count);
-            #endif
+            if (local_heap == nullptr)
+            {
+                continue;
+            }
 
-            //If the local one is exhausted , failover to the central one
-            ret = m_central_heap.allocate_aligned(size, alignment);
-        }
+            LocalHeapActivity* activity = m_local_heap_activities + i;
 
-        #ifdef ENABLE_REPORT_INVALID_POINTERS
-        m_invalid_ptr_detection_lock.lock();
-        m_invalid_ptr_detection_dict.insert( reinterpret_cast<uint64_t>(ret), size);
-        m_invalid_ptr_detection_lock.unlock();
-        #endif
+            if (activity->m_latest_exhaustion_count == 0 || activity->m_exited.load(std::memory_order_acquire))
+            {
+                continue;
+            }
 
-        return ret;
-        #else
-        return builtin_aligned_alloc(size, alignment);
-        #endif
-    }
+            std::size_t grow_count = activity->m_latest_exhaustion_count < m_rebalancing_max_grow_count ? activity->m_latest_exhaustion_count : m_rebalancing_max_grow_count;
 
-    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
-    void deallocate(void* ptr)
-    {
-        if (unlikely(ptr == nullptr))
-        {
-            return;
+            for (std::size_t j = 0; j < grow_count; j++)
+            {
+                void* slot = collected_slots;
+
+                if (slot != nullptr)
+                {
+                    collected_slots = *reinterpret_cast<void**>(slot);
+                }
+                else if (m_rebalancing_net_logical_page_count < m_rebalancing_logical_page_budget)
+                {
+                    slot = m_objects_arena.allocate(slot_size);
+
+                    if (slot == nullptr)
+                    {
+                        break;
+                    }
+
+                    m_rebalancing_net_logical_page_count++;
+                }
+                else
+                {
+                    break;
+                }
+
+                if (register_moved_logical_page(slot, local_heap, slot_size) == false)
+                {
+                    // The stolen logical page table is full , it will be released below
+                    *reinterpret_cast<void**>(slot) = collected_slots;
+                    collected_slots = slot;
+                    break;
+                }
+
+                local_heap->adopt_logical_page_pool_slot(slot);
+                given_slot_count++;
+            }
         }
-        #ifndef ENABLE_DEFAULT_MALLOC
-        
-        #ifdef ENABLE_REPORT_INVALID_POINTERS
-        if(m_invalid_ptr_detection_dict.has_key(reinterpret_cast<uint64_t>(ptr)) == false )
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 3. RELEASE THE REST
+        while (collected_slots != nullptr)
         {
-            append_to_invalid_pointer_report("deallocate");
+            void* next = *reinterpret_cast<void**>(collected_slots);
+            release_logical_page_pool_slot(collected_slots, slot_size);
+            m_rebalancing_net_logical_page_count--;
+            collected_slots = next;
         }
-        #endif
-        
-        if (unlikely( m_very_big_object_dict.has_key( reinterpret_cast<uint64_t>(ptr) ) ))
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        this->leave_concurrent_context();
+
+        return given_slot_count;
+    }
+
+    // Returns what the calling thread's local heap caches : buffered remote deallocations , transfer cache chunks and queued deallocations are handed over
+    // and free logical page pool slots go back to the system. Returns the number of released logical pages
+    // Pages only move to the central heap when threads exit , this one is for long living but mostly idle threads , for ex before a timer thread goes to sleep
+    // Local heaps need to implement 'std::size_t drain(std::size_t budget)'
+    std::size_t flush_thread_cache()
+    {
+        auto thread_local_heap = get_current_local_heap();
+
+        if (thread_local_heap == nullptr)
         {
-            std::size_t big_size = 0;
-            m_very_big_object_dict.get(reinterpret_cast<uint64_t>(ptr), big_size);
-            VirtualMemory::deallocate( ptr, big_size);
-            return;
+            return 0;
         }
-        
-        // LINEAR SEARCH HOWEVER owns_pointer CHECK IS FAST IN BOUNDED LOCAL HEAPS
-        // THEY DON'T DO ANOTHER INTERNAL LINEAR SEARCH THROUGH FREELISTS
-        // SO THERE IS NO NESTED LINEAR SEARCHES BUT JUST ONE
-        for (std::size_t i = 0; i < m_active_local_heap_count; i++)
-        {
-            LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
 
-            if (local_heap->owns_pointer(ptr))
-            {
-                local_heap->deallocate(ptr);
-                return;
-            }
-        }
-        // If we are here, ptr belongs to the central heap
-        m_central_heap.deallocate(ptr);
-        #else
-        builtin_aligned_free(ptr);
-        #endif
+        get_remote_deallocation_cache(thread_local_heap)->flush();
+        get_transfer_cache(thread_local_heap)->flush(&m_central_heap);
+        thread_local_heap->drain(0); // With immediate page recycling , logical pages which become empty go back to the pool
 
+        this->enter_concurrent_context();
+        std::size_t released_slot_count = release_logical_page_pool_slots(thread_local_heap);
+        this->leave_concurrent_context();
+
+        return released_slot_count;
     }
 
-    std::size_t get_usable_size(void* ptr)
+    // Can be called periodically by a background thread. Local heaps which didn't allocate for 'idle_ns' nanoseconds and heaps of exited threads
+    // give their free logical page pool slots back to the system. Returns the number of released logical pages
+    // Activity is sampled by the calls , so a heap is considered active from the last call which saw it allocating
+    // Caches which only their owner threads can access are left to flush_thread_cache
+    std::size_t release_idle_thread_caches(uint64_t idle_ns)
     {
-        if (ptr == nullptr) return 0;
-        
-        #ifdef ENABLE_REPORT_INVALID_POINTERS
-        if(m_invalid_ptr_detection_dict.has_key(reinterpret_cast<uint64_t>(ptr)) == false )
+        if (m_local_heap_activities == nullptr)
         {
-            append_to_invalid_pointer_report("get_usable_size");
+            return 0;
         }
-        #endif
 
-        for (std::size_t i = 0; i < m_active_local_heap_count; i++)
+        uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        std::size_t released_slot_count = 0;
+
+        this->enter_concurrent_context();
+
+        uint64_t epoch = m_activity_epoch.load(std::memory_order_relaxed);
+        std::size_t local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0; i < local_heap_count; i++)
         {
-            LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
+            LocalHeapType* local_heap = get_ready_local_heap(i);
 
-            if (local_heap->owns_pointer(ptr))
+            if (local_heap == nullptr)
             {
-                return local_heap->get_usable_size(ptr);
+                continue;
+            }
+
+            LocalHeapActivity* activity = m_local_heap_activities + i;
+
+            if (activity->m_active_epoch.load(std::memory_order_relaxed) == epoch || activity->m_last_activity_ns == 0)
+            {
+                activity->m_last_activity_ns = now; // Allocated since the previous call or seen for the first time
+            }
+
+            if (activity->m_exited.load(std::memory_order_acquire) || now - activity->m_last_activity_ns >= idle_ns)
+            {
+                released_slot_count += release_logical_page_pool_slots(local_heap);
             }
         }
-        // If we are here, ptr belongs to the central heap
-        return m_central_heap.get_usable_size(ptr);
+
+        m_activity_epoch.store(epoch + 1, std::memory_order_relaxed);
+
+        this->leave_concurrent_context();
+
+        return released_slot_count;
     }
 
-    CentralHeapType* get_central_heap() { return &m_central_heap; }
+    // Hot threads are latency sensitive threads which shouldn't make syscalls in allocations and deallocations. Their local heaps serve them from logical page pools ,
+    // and replenish , called periodically by a background thread , keeps the pools between low and high watermarks.
+    // Pool slots beyond 'free_logical_page_high_watermark' go back to the system in replenish instead of hot threads. 0 means no high watermark
+    // replenish also keeps at least 'arena_low_watermark' bytes in the arena cache , so that heaps growing by extra regions don't build the cache
+    // Giving logical pages to heaps uses the stolen logical page table , therefore it also needs page stealing , see set_page_stealing
+    void set_hot_thread_watermarks(std::size_t arena_low_watermark, std::size_t free_logical_page_low_watermark, std::size_t free_logical_page_high_watermark = 0)
+    {
+        m_hot_thread_arena_low_watermark = arena_low_watermark;
+        m_hot_thread_free_logical_page_low_watermark = free_logical_page_low_watermark;
+        m_hot_thread_free_logical_page_high_watermark = free_logical_page_high_watermark;
+    }
 
-    #ifdef UNIT_TEST
-    std::size_t get_observed_unique_thread_count() const { return m_observed_unique_thread_count; }
-    #endif
+    // Should be called by the hot thread before its latency sensitive part , as it creates the thread's local heap if it doesn't have one
+    // Returns false if the thread has no local heap or its heap doesn't use a logical page pool , see SimpleHeapPow2::HeapCreationParams::m_use_shared_logical_page_pool
+    bool set_current_thread_hot(bool hot = true)
+    {
+        auto local_heap = get_thread_local_heap();
 
-    #ifdef ENABLE_STATS
-    bool save_stats_to_file(const std::string_view file_name)
+        if (local_heap == nullptr || local_heap->get_logical_page_pool_slot_size() == 0)
+        {
+            return false;
+        }
+
+        get_local_heap_activity(local_heap)->m_hot.store(hot, std::memory_order_relaxed);
+        return true;
+    }
+
+    struct PrewarmProfile
     {
-        std::ofstream outfile(file_name.data());
+        static constexpr inline std::size_t MAX_SIZE_COUNT = 16;
+        std::size_t m_sizes[MAX_SIZE_COUNT] = {};
+        std::size_t m_free_chunk_counts[MAX_SIZE_COUNT] = {};   // Target number of free chunks for each size
+        std::size_t m_size_count = 0;
+        bool m_lock_pages = false;                              // Locks logical pages of the bins in memory so that they won't be swapped out , see unlock_pages_of_current_thread
+    };
+
+    // Should be called by a latency sensitive thread before its latency sensitive part. It creates the thread's local heap if it doesn't have one ,
+    // then for each size it allocates the target number of chunks from the local heap , touches them so that their pages are faulted in ,
+    // and deallocates them so that they wait in free lists. Deferred logical page recycling should be used as immediate recycling would give empty pages back.
+    // If the profile locks pages , logical pages of each bin are locked once they are allocated , with one call per logical page. They stay locked until
+    // unlock_pages_of_current_thread is called or they are recycled , and they count towards the process' locked memory limit ( RLIMIT_MEMLOCK on Linux ).
+    // Also resets the calling thread's slow path count , see get_slow_path_count_of_current_thread.
+    // Returns false if there is no local heap , the local heap can't hold the targets or pages can't be locked
+    bool prewarm_current_thread(const PrewarmProfile& profile)
+    {
+        auto local_heap = get_thread_local_heap();
 
-        if (outfile.is_open())
+        if (local_heap == nullptr || profile.m_size_count > PrewarmProfile::MAX_SIZE_COUNT)
         {
-            outfile << "Central heap hit count = " << m_central_heap_hit_count << "\n";
-            outfile << "Created thread local heap count = " << m_used_thread_local_heap_count << "\n\n";
+            return false;
+        }
 
-            auto arena_stats = m_objects_arena.get_stats();
-            outfile << "Virtual memory latest usage = " << SizeUtilities::get_human_readible_size(arena_stats.m_latest_used_size) << "\n";
-            outfile << "Virtual memory allocation count = " << arena_stats.m_vm_allocation_count << "\n";
+        bool success = true;
 
-            for(std::size_t i=0; i< arena_stats.m_vm_allocation_count; i++)
-            {
-                outfile << "\tVirtual memory allocation size = " << SizeUtilities::get_human_readible_size(arena_stats.m_vm_allocation_sizes[i]) << "\n";
-            }
+        for (std::size_t i = 0; i < profile.m_size_count && success; i++)
+        {
+            std::size_t size = profile.m_sizes[i] < sizeof(void*) ? sizeof(void*) : profile.m_sizes[i];
+            void* chunks = nullptr; // Chunks are linked through their first 8 bytes until they are deallocated
 
-            auto process_heap_stats = [&] (LocalHeapType* heap, const char* name)
+            for (std::size_t j = 0; j < profile.m_free_chunk_counts[i]; j++)
             {
-                auto heap_segments_stats = heap->get_stats();
-                auto heap_segment_count = heap_segments_stats.size();
-
-                outfile << "--------------------------------------------------------------\n";
-                outfile << name << "\n\n";
+                void* chunk = local_heap->allocate(size);
 
-                for (std::size_t i = 0; i < heap_segment_count; i++)
+                if (chunk == nullptr)
                 {
-                    outfile << "Heap segment sizeclass = " << heap_segments_stats[i].m_size_class << "\n";
-                    outfile << "\t\tLatest logical page count = " << heap_segments_stats[i].m_latest_logical_page_count << "\n";
-                    outfile << "\t\tRecycle count = " << heap_segments_stats[i].m_recycle_count << "\n";
-                    outfile << "\t\tGrow count = " << heap_segments_stats[i].m_grow_size_count << "\n";
-
-                    for (std::size_t j = 0; j < heap_segments_stats[i].m_grow_size_count; j++)
-                    {
-                        outfile << "\t\t\t\tGrow size = " << heap_segments_stats[i].m_grow_sizes[j] << "\n";
-                    }
+                    success = false;
+                    break;
                 }
 
-                outfile << "--------------------------------------------------------------\n\n";
-            };
-
-
-            process_heap_stats(reinterpret_cast<LocalHeapType*>(&m_central_heap), "CENTRAL HEAP");
-
-            std::size_t local_heap_count = m_active_local_heap_count;
+                builtin_memset(chunk, 0, size);
+                *reinterpret_cast<void**>(chunk) = chunks;
+                chunks = chunk;
+            }
 
-            if(m_cached_thread_local_heap_count > local_heap_count )
+            if (success && profile.m_lock_pages && profile.m_free_chunk_counts[i] > 0 && local_heap->lock_pages(size) == false)
             {
-                local_heap_count = m_cached_thread_local_heap_count;
+                success = false;
             }
 
-            for (std::size_t i = 0; i < local_heap_count; i++)
+            while (chunks != nullptr)
             {
-                LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
-                process_heap_stats(local_heap, "LOCAL HEAP");
+                void* next = *reinterpret_cast<void**>(chunks);
+                local_heap->deallocate_from_owner(chunks);
+                chunks = next;
+            }
+        }
+
+        get_local_heap_activity(local_heap)->m_slow_path_count.store(0, std::memory_order_relaxed);
+        return success;
+    }
+
+    // Undoes page locking of prewarm_current_thread. Returns false if the calling thread has no local heap
+    bool unlock_pages_of_current_thread()
+    {
+        auto thread_local_heap = get_current_local_heap();
+
+        if (thread_local_heap == nullptr)
+        {
+            return false;
+        }
+
+        thread_local_heap->unlock_pages();
+        return true;
+    }
+
+    // Number of times the calling thread's local heap couldn't serve an allocation , plus allocations and deallocations of very big objects which make syscalls
+    std::size_t get_slow_path_count_of_current_thread()
+    {
+        auto thread_local_heap = get_current_local_heap();
+        return thread_local_heap == nullptr ? 0 : get_local_heap_activity(thread_local_heap)->m_slow_path_count.load(std::memory_order_relaxed);
+    }
+
+    // Number of times hot threads had to leave their logical page pools : exhausted local heaps , which go to other heaps or the central heap ,
+    // and allocations or deallocations of very big objects which always make syscalls
+    std::size_t get_hot_thread_fallback_count() const { return m_hot_thread_fallback_count.load(std::memory_order_relaxed); }
+
+    // Background work for hot threads , see set_hot_thread_watermarks. Returns the number of logical pages given to hot heaps
+    std::size_t replenish()
+    {
+        std::size_t given_slot_count = 0;
+
+        this->enter_concurrent_context();
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 1. KEEP FREE LOGICAL PAGES OF HOT HEAPS BETWEEN THE WATERMARKS
+        std::size_t local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0; i < local_heap_count && m_local_heap_activities != nullptr; i++)
+        {
+            LocalHeapType* local_heap = get_ready_local_heap(i);
+
+            if (local_heap == nullptr)
+            {
+                continue;
+            }
+
+            LocalHeapActivity* activity = m_local_heap_activities + i;
+
+            if (activity->m_hot.load(std::memory_order_relaxed) == false || activity->m_exited.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            std::size_t slot_size = local_heap->get_logical_page_pool_slot_size();
+            std::size_t free_slot_count = local_heap->get_free_logical_page_pool_slot_count();
+
+            while (free_slot_count < m_hot_thread_free_logical_page_low_watermark && m_stolen_logical_pages != nullptr)
+            {
+                void* slot = m_objects_arena.allocate(slot_size);
+
+                if (slot == nullptr)
+                {
+                    break;
+                }
+
+                if (register_moved_logical_page(slot, local_heap, slot_size) == false)
+                {
+                    m_objects_arena.release_to_system(slot, slot_size); // The stolen logical page table is full
+                    break;
+                }
+
+                local_heap->adopt_logical_page_pool_slot(slot);
+                given_slot_count++;
+                free_slot_count++;
+            }
+
+            if (m_hot_thread_free_logical_page_high_watermark > 0 && free_slot_count > m_hot_thread_free_logical_page_high_watermark)
+            {
+                release_logical_page_pool_slots(local_heap, m_hot_thread_free_logical_page_high_watermark);
+            }
+        }
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 2. REFILL THE ARENA CACHE , AFTER THE STEP ABOVE AS IT ALSO USES THE ARENA
+        if (m_hot_thread_arena_low_watermark > 0)
+        {
+            (void)m_objects_arena.replenish_cache(m_hot_thread_arena_low_watermark);
+        }
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        this->leave_concurrent_context();
+
+        return given_slot_count;
+    }
+
+    // When enabled , deallocations of very big objects don't unmap them but push them to a lockfree queue , and process_offloaded_deallocations unmaps them.
+    // 'offload_logical_page_releases' does the same for logical pages which heaps give back to the system , for ex with RecyclingPolicy::IMMEDIATE
+    // Should be called before create
+    void set_deallocation_offload(bool offload_very_big_objects, bool offload_logical_page_releases = false)
+    {
+        m_offload_very_big_object_deallocations = offload_very_big_objects;
+        m_objects_arena.set_deferred_release(offload_logical_page_releases);
+    }
+
+    // Should be called periodically by only one helper thread at a time , see set_deallocation_offload. Returns the number of unmapped buffers
+    std::size_t process_offloaded_deallocations()
+    {
+        std::size_t processed_count = 0;
+        void* ptr = nullptr;
+
+        while ((ptr = m_offloaded_very_big_objects.pop()) != nullptr)
+        {
+            VirtualMemory::deallocate(ptr, reinterpret_cast<std::size_t*>(ptr)[1]);
+            processed_count++;
+        }
+
+        processed_count += m_objects_arena.process_deferred_releases();
+        return processed_count;
+    }
+
+    // Context keys in [0 , 'context_key_count') select their own local heaps , see heap_selector.h. Other keys fall back to thread local heaps
+    // A context heap is created on the first allocation of its key , in the metadata buffer like thread local heaps , and it is never handed to the central heap
+    // Needs a heap selector which uses context keys. Should be called before create
+    void set_context_key_count(std::size_t context_key_count)
+    {
+        static_assert(HeapSelectorType::USES_CONTEXT_KEY, "Context keys need a heap selector which provides them");
+        m_context_key_count = context_key_count;
+    }
+
+    // Number of logical pages which belong to the calling thread's local heap , 0 if it doesn't have one
+    std::size_t get_thread_local_heap_logical_page_capacity()
+    {
+        auto thread_local_heap = get_current_local_heap();
+        return thread_local_heap == nullptr ? 0 : thread_local_heap->get_logical_page_pool_capacity();
+    }
+
+    void enable_fast_shutdown() 
+    {
+        m_fast_shutdown = true;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+    void* allocate(const std::size_t size)
+    {
+        #ifndef ENABLE_DEFAULT_MALLOC
+        if (unlikely( size > m_central_heap.get_max_allocation_size()))
+        {
+            count_slow_path_of_calling_thread();
+            auto ptr = VirtualMemory::allocate<false>(size);
+            m_very_big_object_allocation_lock.lock();
+            m_very_big_object_dict.insert( reinterpret_cast<uint64_t>(ptr), size);
+            m_very_big_object_allocation_lock.unlock();
+            return ptr;
+        }
+        
+        void* ret{ nullptr };
+        auto local_heap = get_thread_local_heap();
+
+        if (local_heap != nullptr)
+        {
+            ret = local_heap->allocate(size);
+
+            // Heaps injected by specialising get_thread_local_heap are outside the metadata buffer , therefore they don't have activities or caches
+            if (likely(is_managed_local_heap(local_heap)))
+            {
+                mark_local_heap_active(local_heap);
+
+                if (ret == nullptr)
+                {
+                    LocalHeapActivity* activity = get_local_heap_activity(local_heap);
+                    activity->m_exhaustion_count.fetch_add(1, std::memory_order_relaxed);
+                    count_slow_path(activity);
+                }
+
+                if (ret == nullptr && m_max_stolen_logical_page_count > 0 && steal_logical_page(local_heap))
+                {
+                    ret = local_heap->allocate(size);
+                }
+
+                if (ret == nullptr && m_transfer_batch_size > 1)
+                {
+                    // If the local one is exhausted , try the calling thread's transfer cache which takes chunks from the central one in batches
+                    ret = allocate_from_transfer_cache(local_heap, size);
+                }
+            }
+        }
+
+        if (ret == nullptr)
+        {
+            #ifdef ENABLE_STATS
+            m_central_heap_hit_count++;
+            #endif
+
+            #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
+            m_central_heap_hit_count++;
+            fprintf(stderr, "scalable allocator , central heap hit count=%zu\n", m_central_heap_hit_count);
+            #endif
+
+            //If the local one is exhausted , failover to the central one
+            ret = m_central_heap.allocate(size);
+        }
+
+        #ifdef ENABLE_REPORT_INVALID_POINTERS
+        m_invalid_ptr_detection_lock.lock();
+        m_invalid_ptr_detection_dict.insert( reinterpret_cast<uint64_t>(ret), size);
+        m_invalid_ptr_detection_lock.unlock();
+        #endif
+
+        return ret;
+        #else
+        return builtin_aligned_alloc(size, AlignmentConstants::MINIMUM_VECTORISATION_WIDTH);
+        #endif
+    }
+
+    // For sizes known at compile time , for ex sizeof(T). If both heaps have compile time bins ( see HasCompileTimeBins ) , the very big object check
+    // and the bin lookup happen at compile time and the fast path is a local heap lookup plus a logical page freelist pop
+    // Exhausted local heaps and other cases go through the runtime allocate
+    template <std::size_t size>
+    [[nodiscard]] FORCE_INLINE void* allocate()
+    {
+        #if !defined(ENABLE_DEFAULT_MALLOC) && !defined(ENABLE_REPORT_INVALID_POINTERS)
+        if constexpr (has_compile_time_bin<size>())
+        {
+            auto local_heap = get_thread_local_heap();
+
+            if (likely(local_heap != nullptr))
+            {
+                void* ret = local_heap->template allocate<size>();
+
+                if (likely(ret != nullptr))
+                {
+                    if (likely(is_managed_local_heap(local_heap)))
+                    {
+                        mark_local_heap_active(local_heap);
+                    }
+
+                    return ret;
+                }
+            }
+        }
+        #endif
+
+        return allocate(size);
+    }
+
+    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+    void* allocate_aligned(std::size_t size, std::size_t alignment)
+    {
+        #ifndef ENABLE_DEFAULT_MALLOC
+        if (unlikely( size > m_central_heap.get_max_allocation_size()))
+        {
+            count_slow_path_of_calling_thread();
+            auto ptr = VirtualMemory::allocate<false>(size);
+            m_very_big_object_allocation_lock.lock();
+            m_very_big_object_dict.insert( reinterpret_cast<uint64_t>(ptr), size);
+            m_very_big_object_allocation_lock.unlock();
+            return ptr;
+        }
+        
+        void* ret{ nullptr };
+        auto local_heap = get_thread_local_heap();
+
+        if (local_heap != nullptr)
+        {
+            ret = local_heap->allocate_aligned(size, alignment);
+
+            if (likely(is_managed_local_heap(local_heap)))
+            {
+                mark_local_heap_active(local_heap);
+
+                if (ret == nullptr)
+                {
+                    LocalHeapActivity* activity = get_local_heap_activity(local_heap);
+                    activity->m_exhaustion_count.fetch_add(1, std::memory_order_relaxed);
+                    count_slow_path(activity);
+                }
+
+                if (ret == nullptr && m_max_stolen_logical_page_count > 0 && steal_logical_page(local_heap))
+                {
+                    ret = local_heap->allocate_aligned(size, alignment);
+                }
+            }
+        }
+
+        if (ret == nullptr)
+        {
+            #ifdef ENABLE_STATS
+            m_central_heap_hit_count++;
+            #endif
+
+            #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
+            m_central_heap_hit_count++;
+            fprintf(stderr, "scalable allocator , central heap hit count=%zu\n", m_central_heap_hit_count);
+            #endif
+
+            //If the local one is exhausted , failover to the central one
+            ret = m_central_heap.allocate_aligned(size, alignment);
+        }
+
+        #ifdef ENABLE_REPORT_INVALID_POINTERS
+        m_invalid_ptr_detection_lock.lock();
+        m_invalid_ptr_detection_dict.insert( reinterpret_cast<uint64_t>(ret), size);
+        m_invalid_ptr_detection_lock.unlock();
+        #endif
+
+        return ret;
+        #else
+        return builtin_aligned_alloc(size, alignment);
+        #endif
+    }
+
+    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+    void deallocate(void* ptr)
+    {
+        if (unlikely(ptr == nullptr))
+        {
+            return;
+        }
+        #ifndef ENABLE_DEFAULT_MALLOC
+        
+        #ifdef ENABLE_REPORT_INVALID_POINTERS
+        if(m_invalid_ptr_detection_dict.has_key(reinterpret_cast<uint64_t>(ptr)) == false )
+        {
+            append_to_invalid_pointer_report("deallocate");
+        }
+        #endif
+        
+        if (unlikely( m_very_big_object_dict.has_key( reinterpret_cast<uint64_t>(ptr) ) ))
+        {
+            std::size_t big_size = 0;
+            m_very_big_object_dict.get(reinterpret_cast<uint64_t>(ptr), big_size);
+
+            if (m_offload_very_big_object_deallocations)
+            {
+                // The object is not in use anymore , so it holds its own queue node and size
+                reinterpret_cast<std::size_t*>(ptr)[1] = big_size;
+                m_offloaded_very_big_objects.push(ptr);
+                return;
+            }
+
+            count_slow_path_of_calling_thread();
+            VirtualMemory::deallocate( ptr, big_size);
+            return;
+        }
+        
+        // OWNER THREAD FAST PATH : NO LINEAR SEARCH AND THE CHUNK GOES STRAIGHT BACK TO ITS LOGICAL PAGE
+        // ONLY TRULY REMOTE DEALLOCATIONS GO THROUGH DEALLOCATION QUEUES OR THREAD FREE LISTS
+        // Local heaps need to implement 'void deallocate_from_owner(void* ptr)'
+        auto thread_local_heap = get_current_local_heap();
+
+        // STOLEN LOGICAL PAGES ARE IN ADDRESS RANGES OF THEIR ORIGINAL HEAPS , SO THEY ARE LOOKED UP FIRST
+        LocalHeapType* owner_heap = find_owner_of_stolen_logical_page(ptr);
+
+        if (owner_heap == nullptr)
+        {
+            if (thread_local_heap != nullptr && thread_local_heap->owns_pointer(ptr))
+            {
+                thread_local_heap->deallocate_from_owner(ptr);
+                return;
+            }
+
+            // LINEAR SEARCH HOWEVER owns_pointer CHECK IS FAST IN BOUNDED LOCAL HEAPS
+            // THEY DON'T DO ANOTHER INTERNAL LINEAR SEARCH THROUGH FREELISTS
+            // SO THERE IS NO NESTED LINEAR SEARCHES BUT JUST ONE
+            std::size_t local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
+
+            for (std::size_t i = 0; i < local_heap_count; i++)
+            {
+                LocalHeapType* local_heap = get_ready_local_heap(i);
+
+                if (local_heap != nullptr && local_heap != thread_local_heap && local_heap->owns_pointer(ptr))
+                {
+                    owner_heap = local_heap;
+                    break;
+                }
+            }
+        }
+        else if (owner_heap == thread_local_heap)
+        {
+            thread_local_heap->deallocate_from_owner(ptr);
+            return;
+        }
+
+        if (owner_heap != nullptr)
+        {
+            // Threads without a local heap don't have a remote deallocation cache either
+            if (thread_local_heap != nullptr && m_remote_deallocation_batch_size > 1)
+            {
+                get_remote_deallocation_cache(thread_local_heap)->add(owner_heap, static_cast<uint32_t>(owner_heap->get_usable_size(ptr)), ptr, m_remote_deallocation_batch_size, m_remote_deallocation_flush_interval);
+            }
+            else
+            {
+                owner_heap->deallocate(ptr);
+            }
+
+            return;
+        }
+        // If we are here, ptr belongs to the central heap
+        if (thread_local_heap != nullptr && m_transfer_batch_size > 1)
+        {
+            get_transfer_cache(thread_local_heap)->deallocate(&m_central_heap, m_central_heap.get_usable_size(ptr), ptr, m_transfer_batch_size);
+        }
+        else
+        {
+            m_central_heap.deallocate(ptr);
+        }
+        #else
+        builtin_aligned_free(ptr);
+        #endif
+
+    }
+
+    // 'ptr' should be allocated with the same size , either by allocate<size> or allocate
+    // Such sizes can't be very big objects , so only the calling context's own chunks need to be told apart from others
+    template <std::size_t size>
+    FORCE_INLINE void deallocate(void* ptr)
+    {
+        #if !defined(ENABLE_DEFAULT_MALLOC) && !defined(ENABLE_REPORT_INVALID_POINTERS)
+        if constexpr (has_compile_time_bin<size>())
+        {
+            auto thread_local_heap = get_current_local_heap();
+
+            // Stolen logical pages are in address ranges of their original heaps , see deallocate
+            if (likely(thread_local_heap != nullptr && find_owner_of_stolen_logical_page(ptr) == nullptr && thread_local_heap->owns_pointer(ptr)))
+            {
+                thread_local_heap->template deallocate_from_owner<size>(ptr);
+                return;
+            }
+        }
+        #endif
+
+        deallocate(ptr);
+    }
+
+    std::size_t get_usable_size(void* ptr)
+    {
+        if (ptr == nullptr) return 0;
+        
+        #ifdef ENABLE_REPORT_INVALID_POINTERS
+        if(m_invalid_ptr_detection_dict.has_key(reinterpret_cast<uint64_t>(ptr)) == false )
+        {
+            append_to_invalid_pointer_report("get_usable_size");
+        }
+        #endif
+
+        LocalHeapType* owner_heap = find_owner_of_stolen_logical_page(ptr);
+
+        if (owner_heap != nullptr)
+        {
+            return owner_heap->get_usable_size(ptr);
+        }
+
+        std::size_t local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0; i < local_heap_count; i++)
+        {
+            LocalHeapType* local_heap = get_ready_local_heap(i);
+
+            if (local_heap != nullptr && local_heap->owns_pointer(ptr))
+            {
+                return local_heap->get_usable_size(ptr);
+            }
+        }
+        // If we are here, ptr belongs to the central heap
+        return m_central_heap.get_usable_size(ptr);
+    }
+
+    CentralHeapType* get_central_heap() { return &m_central_heap; }
+
+    // Processes up to 'budget' remote deallocations queued to the calling thread's heap , 0 means all of them. Returns the number of processed deallocations
+    // Allocations already drain a bounded number of them , this one is for doing it at idle points of the calling thread, for ex in an event loop
+    // Local heaps need to implement 'std::size_t drain(std::size_t budget)'
+    std::size_t drain_thread_local_heap(std::size_t budget = 0)
+    {
+        auto thread_local_heap = get_current_local_heap();
+
+        if (thread_local_heap == nullptr)
+        {
+            return 0;
+        }
+
+        return thread_local_heap->drain(budget);
+    }
+
+    // Hands all remote deallocations buffered by the calling thread to their heaps
+    // It is called automatically when threads exit , this one is for doing it earlier , for ex before a producer thread drains its heap
+    void flush_remote_deallocations()
+    {
+        auto thread_local_heap = get_current_local_heap();
+
+        if (thread_local_heap != nullptr)
+        {
+            get_remote_deallocation_cache(thread_local_heap)->flush();
+        }
+    }
+
+    #ifdef UNIT_TEST
+    std::size_t get_observed_unique_thread_count() const { return m_observed_unique_thread_count.load(); }
+    std::size_t get_transfer_cache_refill_count() const { return m_transfer_cache_refill_count.load(); }
+    #endif
+
+    #ifdef ENABLE_STATS
+    bool save_stats_to_file(const std::string_view file_name)
+    {
+        std::ofstream outfile(file_name.data());
+
+        if (outfile.is_open())
+        {
+            outfile << "Central heap hit count = " << m_central_heap_hit_count << "\n";
+            outfile << "Created thread local heap count = " << m_used_thread_local_heap_count.load() << "\n";
+            outfile << "Stolen logical page count = " << m_stolen_logical_page_count.load() << "\n\n";
+
+            auto arena_stats = m_objects_arena.get_stats();
+            outfile << "Virtual memory latest usage = " << SizeUtilities::get_human_readible_size(arena_stats.m_latest_used_size) << "\n";
+            outfile << "Virtual memory allocation count = " << arena_stats.m_vm_allocation_count << "\n";
+
+            for(std::size_t i=0; i< arena_stats.m_vm_allocation_count; i++)
+            {
+                outfile << "\tVirtual memory allocation size = " << SizeUtilities::get_human_readible_size(arena_stats.m_vm_allocation_sizes[i]) << "\n";
+            }
+
+            auto process_heap_stats = [&] (LocalHeapType* heap, const char* name)
+            {
+                auto heap_segments_stats = heap->get_stats();
+                auto heap_segment_count = heap_segments_stats.size();
+
+                outfile << "--------------------------------------------------------------\n";
+                outfile << name << "\n\n";
+
+                for (std::size_t i = 0; i < heap_segment_count; i++)
+                {
+                    outfile << "Heap segment sizeclass = " << heap_segments_stats[i].m_size_class << "\n";
+                    outfile << "\t\tLatest logical page count = " << heap_segments_stats[i].m_latest_logical_page_count << "\n";
+                    outfile << "\t\tRecycle count = " << heap_segments_stats[i].m_recycle_count << "\n";
+                    outfile << "\t\tGrow count = " << heap_segments_stats[i].m_grow_size_count << "\n";
+
+                    for (std::size_t j = 0; j < heap_segments_stats[i].m_grow_size_count; j++)
+                    {
+                        outfile << "\t\t\t\tGrow size = " << heap_segments_stats[i].m_grow_sizes[j] << "\n";
+                    }
+                }
+
+                outfile << "--------------------------------------------------------------\n\n";
+            };
+
+
+            process_heap_stats(reinterpret_cast<LocalHeapType*>(&m_central_heap), "CENTRAL HEAP");
+
+            std::size_t local_heap_count = m_active_local_heap_count;
+
+            if(m_cached_thread_local_heap_count > local_heap_count )
+            {
+                local_heap_count = m_cached_thread_local_heap_count;
+            }
+
+            for (std::size_t i = 0; i < local_heap_count; i++)
+            {
+                if (is_local_heap_constructed(i) == false || m_local_heap_activities[i].m_state.load(std::memory_order_acquire) == LocalHeapState::DEAD)
+                {
+                    continue;
+                }
+
+                LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
+                outfile << "Local heap " << i << " logical page capacity = " << local_heap->get_logical_page_pool_capacity() << " , free = " << local_heap->get_free_logical_page_pool_slot_count()
+                        << " , latest exhaustion count = " << m_local_heap_activities[i].m_latest_exhaustion_count << "\n";
+                process_heap_stats(local_heap, "LOCAL HEAP");
             }
 
             outfile.close();
             return true;
         }
-        return false;
+        return false;
+    }
+    #endif
+    
+    #ifdef ENABLE_REPORT_INVALID_POINTERS
+    void append_to_invalid_pointer_report(const char* operation)
+    {
+        FILE* report = nullptr;
+        report = fopen("invalid_pointers.txt", "a+"); // does not allocate memory
+
+        if (report) 
+        {
+            fprintf(report, "Invalid pointer ( a pointer which was not allocated by this allocator ) detected during %s call\n", operation);
+            fclose(report);
+        }
+        else
+        {
+            fprintf(stderr, "Failed to open invalid_pointers.txt for writing\n"); // does not allocate memory
+        }
+    }
+    #endif
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // WRAPPER METHODS FOR MALLOC REPLACEMENT/INTEGRATION
+    [[nodiscard]] void* operator_new(std::size_t size)
+    {
+        void* ret = allocate(size);
+
+        if( unlikely(ret==nullptr) )
+        {
+            handle_operator_new_failure();
+        }
+
+        return ret;
+    }
+
+    [[nodiscard]] void* operator_new_aligned(std::size_t size, std::size_t alignment)
+    {
+        void* ret = allocate_aligned(size, alignment);
+
+        if( unlikely(ret==nullptr) )
+        {
+            handle_operator_new_failure();
+        }
+
+        return ret;
+    }
+
+    void handle_operator_new_failure()
+    {
+        std::new_handler handler;
+
+        this->enter_concurrent_context();
+        ///////////////////////////////////////
+        handler = std::get_new_handler();
+        ///////////////////////////////////////
+        this->leave_concurrent_context();
+
+        if(handler != nullptr)
+        {
+            handler();
+        }
+        else
+        {
+            throw std::bad_alloc();
+        }
+    }
+
+    [[nodiscard]] void* allocate_and_zero_memory(std::size_t num, std::size_t size)
+    {
+        auto total_size = num * size;
+        void* ret = allocate(total_size);
+
+        if (ret != nullptr)
+        {
+            builtin_memset(ret, 0, total_size);
+        }
+
+        return ret;
+    }
+
+    [[nodiscard]] void* reallocate(void* ptr, std::size_t size)
+    {
+        if (ptr == nullptr)
+        {
+            return  allocate(size);
+        }
+
+        if (size == 0)
+        {
+            deallocate(ptr);
+            return nullptr;
+        }
+        
+        std::size_t old_size = get_usable_size(ptr);
+        
+        if(size <= old_size)
+        {
+            return ptr;
+        }
+
+        void* new_ptr = allocate(size);
+
+        if (new_ptr != nullptr)
+        {
+            builtin_memcpy(new_ptr, ptr, old_size);
+            deallocate(ptr);
+        }
+
+        return new_ptr;
+    }
+
+    [[nodiscard]] void* aligned_reallocate(void* ptr, std::size_t size, std::size_t alignment)
+    {
+        if (ptr == nullptr)
+        {
+            return  allocate_aligned(size, alignment);
+        }
+
+        if (size == 0)
+        {
+            deallocate(ptr);
+            return nullptr;
+        }
+        
+        std::size_t old_size = get_usable_size(ptr);
+        
+        if(size <= old_size)
+        {
+            return ptr;
+        }
+
+        void* new_ptr = allocate_aligned(size, alignment);
+
+        if (new_ptr != nullptr)
+        {
+            
+            builtin_memcpy(new_ptr, ptr, old_size);
+            deallocate(ptr);
+        }
+
+        return new_ptr;
+    }
+
+    [[nodiscard]]void* reallocate_and_zero_memory(void *ptr, std::size_t num, std::size_t size)
+    {
+        auto total_size = num*size;
+        auto ret = reallocate(ptr, total_size);
+
+        if(ret != nullptr)
+        {
+            builtin_memset(ret, 0, total_size);
+        }
+
+        return ret;
     }
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+private:
+    using RemoteDeallocationCacheType = RemoteDeallocationCache<LocalHeapType>;
+    using TransferCacheType = TransferCache<CentralHeapType>;
+
+    CentralHeapType m_central_heap;
+    ArenaType m_objects_arena;
+    char* m_metadata_buffer = nullptr;
+    std::size_t m_metadata_buffer_size = 131072;       // Default 128KB
+    RemoteDeallocationCacheType* m_remote_deallocation_caches = nullptr; // One for each local heap , used by the thread which owns the heap
+    std::size_t m_remote_deallocation_batch_size = 32;
+    std::size_t m_remote_deallocation_flush_interval = 1024;
+    TransferCacheType* m_transfer_caches = nullptr; // One for each local heap , used by the thread which owns the heap
+    std::size_t m_transfer_batch_size = 32;
+
+    struct StolenLogicalPage
+    {
+        uint64_t m_address = 0;
+        LocalHeapType* m_owner_heap = nullptr;
+    };
+
+    StolenLogicalPage* m_stolen_logical_pages = nullptr;    // Entries are published by incrementing m_stolen_logical_page_count , entries of released logical pages are reused
+    std::atomic<std::size_t> m_stolen_logical_page_count = 0;
+    std::atomic<std::size_t> m_free_stolen_logical_page_entry_count = 0;
+    std::size_t m_max_stolen_logical_page_count = 0;
+    std::size_t m_page_stealing_reserved_slot_count = 1;
+    std::size_t m_logical_page_pool_slot_size = 0;
+
+    enum class LocalHeapState : uint8_t
+    {
+        NOT_READY,      // Not claimed yet or still being built
+        READY,          // Built and published , other threads can iterate it
+        DEAD            // Its creation failed , it is never iterated
+    };
+
+    struct LocalHeapActivity
+    {
+        std::atomic<LocalHeapState> m_state = LocalHeapState::NOT_READY;  // Set by the thread which claimed the heap , see acquire_local_heap
+        std::atomic<std::size_t> m_exhaustion_count = 0;  // Incremented by the owner thread whenever its heap can't serve an allocation
+        std::size_t m_latest_exhaustion_count = 0;         // Exhaustions measured by the latest rebalancing
+        std::atomic<bool> m_exited = false;
+        std::atomic<bool> m_hot = false;                  // See set_current_thread_hot
+        std::atomic<std::size_t> m_slow_path_count = 0;   // Exhaustions and syscalls of very big objects , reset by prewarm_current_thread
+        std::atomic<uint64_t> m_active_epoch = 0;          // Set to the activity epoch by the owner thread when it allocates , see mark_local_heap_active
+        uint64_t m_last_activity_ns = 0;                   // Updated by release_idle_thread_caches
+    };
+
+    std::atomic<uint64_t> m_activity_epoch = 0;         // Advanced by every release_idle_thread_caches call
+    std::size_t m_hot_thread_arena_low_watermark = 0;
+    std::size_t m_hot_thread_free_logical_page_low_watermark = 0;
+    std::size_t m_hot_thread_free_logical_page_high_watermark = 0;
+    std::atomic<std::size_t> m_hot_thread_fallback_count = 0;
+
+    LocalHeapActivity* m_local_heap_activities = nullptr;  // One for each local heap
+    int64_t m_rebalancing_logical_page_budget = 0;
+    int64_t m_rebalancing_net_logical_page_count = 0;  // Logical pages taken from the arena minus logical pages released by rebalancing
+    std::size_t m_rebalancing_idle_heap_reserved_slot_count = 1;
+    std::size_t m_rebalancing_max_grow_count = 8;
+    std::atomic<std::size_t> m_active_local_heap_count = 0;   // High water mark of published heaps , iterations skip heaps up to it which are not ready , see get_ready_local_heap
+    std::atomic<std::size_t> m_claimed_local_heap_count = 0;  // Some claimed heaps may still be under construction
+    std::size_t m_max_thread_local_heap_count = 0;    // Used for only thread local heaps
+    std::size_t m_cached_thread_local_heap_count = 0; // Used for only thread local heaps , its number of available passive heaps
+    std::atomic<LocalHeapType*>* m_context_heaps = nullptr;  // One for each context key , see heap_selector.h
+    std::size_t m_context_key_count = 0;
+    bool m_fast_shutdown = false;
+    typename LocalHeapType::HeapCreationParams m_local_heap_creation_params;
+
+    static inline std::atomic<bool> m_initialised_successfully = false;
+    static inline std::atomic<bool> m_shutdown_started = false;
+    
+    Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator> m_very_big_object_dict;
+    UserspaceSpinlock<> m_very_big_object_allocation_lock;
+    DeallocationQueue m_offloaded_very_big_objects;     // See set_deallocation_offload
+    bool m_offload_very_big_object_deallocations = false;
+
+    #ifdef UNIT_TEST
+    std::atomic<std::size_t> m_observed_unique_thread_count = 0;
+    std::atomic<std::size_t> m_transfer_cache_refill_count = 0;
+    #endif
+
+    #ifdef ENABLE_STATS
+    std::size_t m_central_heap_hit_count = 0;
+    std::atomic<std::size_t> m_used_thread_local_heap_count =0 ;
+    #endif
+
+    #ifdef ENABLE_PERF_TRACES
+    std::size_t m_central_heap_hit_count = 0;
     #endif
     
     #ifdef ENABLE_REPORT_INVALID_POINTERS
-    void append_to_invalid_pointer_report(const char* operation)
+    Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator> m_invalid_ptr_detection_dict;
+    UserspaceSpinlock<> m_invalid_ptr_detection_lock;
+    #endif
+
+    ScalableAllocator()
     {
-        FILE* report = nullptr;
-        report = fopen("invalid_pointers.txt", "a+"); // does not allocate memory
+        static_assert(std::is_base_of<HeapBase<CentralHeapType, ConcurrencyPolicy::CENTRAL>, CentralHeapType>::value);
+        static_assert(std::is_base_of<HeapBase<LocalHeapType, ConcurrencyPolicy::THREAD_LOCAL>, LocalHeapType>::value || std::is_base_of<HeapBase<LocalHeapType, ConcurrencyPolicy::SINGLE_THREAD>, LocalHeapType>::value);
+        static_assert(std::is_base_of<ArenaBase<ArenaType>, ArenaType>::value);
+    }
 
-        if (report) 
+    ~ScalableAllocator()
+    {
+        #ifdef ENABLE_STATS
+        save_stats_to_file("metamalloc_stats.txt");
+        #endif
+        
+        #ifndef ENABLE_REPORT_LEAKS
+        if(m_fast_shutdown)
         {
-            fprintf(report, "Invalid pointer ( a pointer which was not allocated by this allocator ) detected during %s call\n", operation);
-            fclose(report);
+            return;
         }
-        else
+        #endif
+
+        if(m_initialised_successfully.load() == true )
         {
-            fprintf(stderr, "Failed to open invalid_pointers.txt for writing\n"); // does not allocate memory
+            // We call it here it in case not called earlier and there are still running threads which are not destructed , no need to move logical pages between heaps
+            m_shutdown_started.store(true);
+
+            process_offloaded_deallocations();
+            destroy_heaps();
+
+            ThreadLocalStorage::get_instance().destroy();
         }
     }
-    #endif
 
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////
-    // WRAPPER METHODS FOR MALLOC REPLACEMENT/INTEGRATION
-    [[nodiscard]] void* operator_new(std::size_t size)
+    ScalableAllocator(const ScalableAllocator& other) = delete;
+    ScalableAllocator& operator= (const ScalableAllocator& other) = delete;
+    ScalableAllocator(ScalableAllocator&& other) = delete;
+    ScalableAllocator& operator=(ScalableAllocator&& other) = delete;
+
+    static void thread_specific_destructor(void* arg)
     {
-        void* ret = allocate(size);
+        if( m_initialised_successfully.load() == true && m_shutdown_started.load() == false )
+        {
+            auto thread_local_heap = reinterpret_cast<LocalHeapType*>(arg);
 
-        if( unlikely(ret==nullptr) )
+            if(thread_local_heap) // Thread local arg is not supposed to be nullptr by OS specs but just to be safe
+            {
+                get_instance().get_remote_deallocation_cache(thread_local_heap)->flush();
+                get_instance().get_transfer_cache(thread_local_heap)->flush(get_instance().get_central_heap());
+
+                auto central_heap = get_instance().get_central_heap();
+                central_heap->transfer_logical_pages_from(reinterpret_cast<CentralHeapType*>(thread_local_heap));
+
+                if (get_instance().m_max_stolen_logical_page_count == 0)
+                {
+                    thread_local_heap->release_free_logical_page_pool_slots(); // Otherwise other heaps can still steal them
+                }
+
+                get_instance().get_local_heap_activity(thread_local_heap)->m_exited.store(true, std::memory_order_release);
+            }
+        }
+    }
+
+    std::size_t get_created_heap_count()
+    {
+        std::size_t active_local_heap_count = m_active_local_heap_count.load();
+        auto heap_count = m_cached_thread_local_heap_count > active_local_heap_count ? m_cached_thread_local_heap_count : active_local_heap_count;
+        return heap_count;
+    }
+
+    void destroy_heaps()
+    {
+        if (m_metadata_buffer)
         {
-            handle_operator_new_failure();
+            auto heap_count = get_created_heap_count();
+
+            for (std::size_t i = 0; i < heap_count; i++)
+            {
+                if (is_local_heap_constructed(i) == false)
+                {
+                    continue;
+                }
+
+                LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
+                local_heap->~LocalHeapType();
+            }
         }
+    }
 
-        return ret;
+    LocalHeapType* get_thread_local_heap()
+    {
+        if constexpr (HeapSelectorType::USES_CONTEXT_KEY)
+        {
+            std::size_t context_key = HeapSelectorType::get_context_key();
+
+            if (context_key < m_context_key_count)
+            {
+                auto context_heap = m_context_heaps[context_key].load(std::memory_order_acquire);
+                return likely(context_heap != nullptr) ? context_heap : create_context_heap(context_key);
+            }
+        }
+
+        return get_thread_local_heap_internal();
     }
 
-    [[nodiscard]] void* operator_new_aligned(std::size_t size, std::size_t alignment)
+    // Local heap of the calling context , without creating one
+    FORCE_INLINE LocalHeapType* get_current_local_heap()
     {
-        void* ret = allocate_aligned(size, alignment);
+        if constexpr (HeapSelectorType::USES_CONTEXT_KEY)
+        {
+            std::size_t context_key = HeapSelectorType::get_context_key();
 
-        if( unlikely(ret==nullptr) )
+            if (context_key < m_context_key_count)
+            {
+                return m_context_heaps[context_key].load(std::memory_order_acquire);
+            }
+        }
+
+        return reinterpret_cast<LocalHeapType*>(ThreadLocalStorage::get_instance().get());
+    }
+
+    // Happens only once for each context key. Only the context which has the key creates its heap , so there is no race on the table entry
+    LocalHeapType* create_context_heap(std::size_t context_key)
+    {
+        LocalHeapType* context_heap = acquire_local_heap();
+
+        if (context_heap != nullptr)
         {
-            handle_operator_new_failure();
+            m_context_heaps[context_key].store(context_heap, std::memory_order_release);
         }
 
-        return ret;
+        return context_heap;
     }
 
-    void handle_operator_new_failure()
+    FORCE_INLINE LocalHeapType* get_thread_local_heap_internal()
     {
-        std::new_handler handler;
+        auto thread_local_heap = reinterpret_cast<LocalHeapType*>(ThreadLocalStorage::get_instance().get());
 
-        this->enter_concurrent_context();
-        ///////////////////////////////////////
-        handler = std::get_new_handler();
-        ///////////////////////////////////////
-        this->leave_concurrent_context();
+        if (thread_local_heap == nullptr)
+        {
+            // HAPPENS ONLY ONCE FOR EACH THREAD , AT THEIR START. IT DOESN'T TAKE THE ALLOCATOR LOCK , SEE acquire_local_heap
+            #ifdef UNIT_TEST
+            m_observed_unique_thread_count.fetch_add(1, std::memory_order_relaxed);
+            #endif
 
-        if(handler != nullptr)
+            thread_local_heap = acquire_local_heap();
+
+            if (thread_local_heap == nullptr)
+            {
+                return nullptr;
+            }
+
+            ThreadLocalStorage::get_instance().set(thread_local_heap);
+        }
+
+        return thread_local_heap;
+    }
+
+    // Claims a heap slot with a CAS and builds the heap without any shared lock , so that threads starting together don't wait for each other's page faults
+    LocalHeapType* acquire_local_heap()
+    {
+        #ifdef ENABLE_STATS
+        m_used_thread_local_heap_count.fetch_add(1, std::memory_order_relaxed);
+        #endif
+
+        LocalHeapType* local_heap = nullptr;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 1. CLAIM A SLOT
+        std::size_t metadata_buffer_index = m_claimed_local_heap_count.load(std::memory_order_relaxed);
+
+        do
         {
-            handler();
+            if (metadata_buffer_index + 1 >= m_max_thread_local_heap_count)
+            {
+                // If we are here , it means that metadata buffer size is not sufficient to handle all threads of the application
+                return nullptr;
+            }
+        } while (m_claimed_local_heap_count.compare_exchange_weak(metadata_buffer_index, metadata_buffer_index + 1, std::memory_order_relaxed) == false);
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 2. BUILD THE HEAP , THE ARENA HAS ITS OWN LOCK ONLY FOR CARVING THE HEAP BUFFER
+        if (metadata_buffer_index >= m_cached_thread_local_heap_count)
+        {
+            local_heap = create_local_heap(metadata_buffer_index);
         }
         else
         {
-            throw std::bad_alloc();
+            local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (metadata_buffer_index * sizeof(LocalHeapType)));
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 3. PUBLISH IT
+        // Each slot is published on its own , so a thread doesn't wait for threads which claimed earlier slots and are still building their heaps.
+        // The active count is only a high water mark , iterations skip slots up to it which are not ready
+        m_local_heap_activities[metadata_buffer_index].m_state.store(local_heap != nullptr ? LocalHeapState::READY : LocalHeapState::DEAD, std::memory_order_release);
+
+        std::size_t active_count = m_active_local_heap_count.load(std::memory_order_relaxed);
+
+        while (active_count < metadata_buffer_index + 1 && m_active_local_heap_count.compare_exchange_weak(active_count, metadata_buffer_index + 1, std::memory_order_release, std::memory_order_relaxed) == false)
+        {
+        }
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        return local_heap;
+    }
+
+    bool create_heaps()
+    {
+        m_max_thread_local_heap_count = m_metadata_buffer_size / sizeof(LocalHeapType);
+
+        if (m_max_thread_local_heap_count == 0)
+        {
+            return false;
+        }
+
+        if (m_max_thread_local_heap_count < m_cached_thread_local_heap_count)
+        {
+            m_cached_thread_local_heap_count = m_max_thread_local_heap_count;
+        }
+
+        // Separate from the metadata buffer , so that the number of heaps it can hold doesn't change
+        m_remote_deallocation_caches = reinterpret_cast<RemoteDeallocationCacheType*>(ArenaType::MetadataAllocator::allocate(m_max_thread_local_heap_count * sizeof(RemoteDeallocationCacheType)));
+
+        if (m_remote_deallocation_caches == nullptr)
+        {
+            return false;
+        }
+
+        m_transfer_caches = reinterpret_cast<TransferCacheType*>(ArenaType::MetadataAllocator::allocate(m_max_thread_local_heap_count * sizeof(TransferCacheType)));
+
+        if (m_transfer_caches == nullptr)
+        {
+            return false;
+        }
+
+        m_local_heap_activities = reinterpret_cast<LocalHeapActivity*>(ArenaType::MetadataAllocator::allocate(m_max_thread_local_heap_count * sizeof(LocalHeapActivity)));
+
+        if (m_local_heap_activities == nullptr)
+        {
+            return false;
+        }
+
+        for (std::size_t i{ 0 }; i < m_max_thread_local_heap_count; i++)
+        {
+            new(m_remote_deallocation_caches + i) RemoteDeallocationCacheType();    // Placement new , does not invoke memory allocation
+            new(m_transfer_caches + i) TransferCacheType();
+            new(m_local_heap_activities + i) LocalHeapActivity();
+        }
+
+        if constexpr (HeapSelectorType::USES_CONTEXT_KEY)
+        {
+            if (m_context_key_count > 0)
+            {
+                m_context_heaps = reinterpret_cast<std::atomic<LocalHeapType*>*>(ArenaType::MetadataAllocator::allocate(m_context_key_count * sizeof(std::atomic<LocalHeapType*>)));
+
+                if (m_context_heaps == nullptr)
+                {
+                    return false;
+                }
+
+                for (std::size_t i{ 0 }; i < m_context_key_count; i++)
+                {
+                    new(m_context_heaps + i) std::atomic<LocalHeapType*>(nullptr);
+                }
+            }
+        }
+
+        if (m_max_stolen_logical_page_count > 0)
+        {
+            m_stolen_logical_pages = reinterpret_cast<StolenLogicalPage*>(ArenaType::MetadataAllocator::allocate(m_max_stolen_logical_page_count * sizeof(StolenLogicalPage)));
+
+            if (m_stolen_logical_pages == nullptr)
+            {
+                return false;
+            }
+        }
+
+        for (std::size_t i{ 0 }; i < m_cached_thread_local_heap_count; i++)
+        {
+            auto local_heap = create_local_heap(i);
+            if (!local_heap) return false;
         }
+
+        return true;
+    }
+
+    FORCE_INLINE std::size_t get_metadata_buffer_index(LocalHeapType* local_heap)
+    {
+        return static_cast<std::size_t>(reinterpret_cast<char*>(local_heap) - m_metadata_buffer) / sizeof(LocalHeapType);
+    }
+
+    template <std::size_t size>
+    static constexpr bool has_compile_time_bin()
+    {
+        return CentralHeapType::template has_compile_time_bin<size>() && LocalHeapType::template has_compile_time_bin<size>();
     }
 
-    [[nodiscard]] void* allocate_and_zero_memory(std::size_t num, std::size_t size)
+    FORCE_INLINE bool is_managed_local_heap(LocalHeapType* local_heap)
     {
-        auto total_size = num * size;
-        void* ret = allocate(total_size);
+        return get_metadata_buffer_index(local_heap) < m_max_thread_local_heap_count; // Addresses below the buffer wrap around
+    }
 
-        if (ret != nullptr)
-        {
-            builtin_memset(ret, 0, total_size);
-        }
+    FORCE_INLINE RemoteDeallocationCacheType* get_remote_deallocation_cache(LocalHeapType* local_heap)
+    {
+        return m_remote_deallocation_caches + get_metadata_buffer_index(local_heap);
+    }
 
-        return ret;
+    FORCE_INLINE TransferCacheType* get_transfer_cache(LocalHeapType* local_heap)
+    {
+        return m_transfer_caches + get_metadata_buffer_index(local_heap);
     }
 
-    [[nodiscard]] void* reallocate(void* ptr, std::size_t size)
+    FORCE_INLINE LocalHeapActivity* get_local_heap_activity(LocalHeapType* local_heap)
     {
-        if (ptr == nullptr)
-        {
-            return  allocate(size);
-        }
+        return m_local_heap_activities + get_metadata_buffer_index(local_heap);
+    }
 
-        if (size == 0)
+    // Returns nullptr if the heap in that slot is still being built or its creation failed
+    FORCE_INLINE LocalHeapType* get_ready_local_heap(std::size_t metadata_buffer_index)
+    {
+        if (m_local_heap_activities[metadata_buffer_index].m_state.load(std::memory_order_acquire) != LocalHeapState::READY)
         {
-            deallocate(ptr);
             return nullptr;
         }
-        
-        std::size_t old_size = get_usable_size(ptr);
-        
-        if(size <= old_size)
-        {
-            return ptr;
-        }
 
-        void* new_ptr = allocate(size);
-
-        if (new_ptr != nullptr)
-        {
-            builtin_memcpy(new_ptr, ptr, old_size);
-            deallocate(ptr);
-        }
+        return reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (metadata_buffer_index * sizeof(LocalHeapType)));
+    }
 
-        return new_ptr;
+    // Cached heaps are built up front , others are built by threads which claim them
+    bool is_local_heap_constructed(std::size_t metadata_buffer_index)
+    {
+        return metadata_buffer_index < m_cached_thread_local_heap_count || m_local_heap_activities[metadata_buffer_index].m_state.load(std::memory_order_acquire) != LocalHeapState::NOT_READY;
     }
 
-    [[nodiscard]] void* aligned_reallocate(void* ptr, std::size_t size, std::size_t alignment)
+    FORCE_INLINE void count_slow_path(LocalHeapActivity* activity)
     {
-        if (ptr == nullptr)
-        {
-            return  allocate_aligned(size, alignment);
-        }
+        activity->m_slow_path_count.store(activity->m_slow_path_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); // Only the owner thread writes
 
-        if (size == 0)
+        if (activity->m_hot.load(std::memory_order_relaxed))
         {
-            deallocate(ptr);
-            return nullptr;
+            m_hot_thread_fallback_count.fetch_add(1, std::memory_order_relaxed);
         }
-        
-        std::size_t old_size = get_usable_size(ptr);
-        
-        if(size <= old_size)
+    }
+
+    void count_slow_path_of_calling_thread()
+    {
+        auto thread_local_heap = get_current_local_heap();
+
+        if (thread_local_heap != nullptr)
         {
-            return ptr;
+            count_slow_path(get_local_heap_activity(thread_local_heap));
         }
+    }
 
-        void* new_ptr = allocate_aligned(size, alignment);
+    // The epoch changes only when release_idle_thread_caches runs , so the owner thread writes its activity at most once between two calls
+    FORCE_INLINE void mark_local_heap_active(LocalHeapType* local_heap)
+    {
+        uint64_t epoch = m_activity_epoch.load(std::memory_order_relaxed);
+        LocalHeapActivity* activity = get_local_heap_activity(local_heap);
 
-        if (new_ptr != nullptr)
+        if (unlikely(activity->m_active_epoch.load(std::memory_order_relaxed) != epoch))
         {
-            
-            builtin_memcpy(new_ptr, ptr, old_size);
-            deallocate(ptr);
+            activity->m_active_epoch.store(epoch, std::memory_order_relaxed);
         }
-
-        return new_ptr;
     }
 
-    [[nodiscard]]void* reallocate_and_zero_memory(void *ptr, std::size_t num, std::size_t size)
+    // Returns true if a free logical page of another local heap is moved to the local heap
+    bool steal_logical_page(LocalHeapType* local_heap)
     {
-        auto total_size = num*size;
-        auto ret = reallocate(ptr, total_size);
+        std::size_t slot_size = local_heap->get_logical_page_pool_slot_size();
 
-        if(ret != nullptr)
+        if (slot_size == 0)
         {
-            builtin_memset(ret, 0, total_size);
+            return false; // The local heap doesn't use a logical page pool
         }
 
-        return ret;
-    }
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        void* slot = nullptr;
 
-private:
-    CentralHeapType m_central_heap;
-    ArenaType m_objects_arena;
-    char* m_metadata_buffer = nullptr;
-    std::size_t m_metadata_buffer_size = 131072;       // Default 128KB
-    std::size_t m_active_local_heap_count = 0;
-    std::size_t m_max_thread_local_heap_count = 0;    // Used for only thread local heaps
-    std::size_t m_cached_thread_local_heap_count = 0; // Used for only thread local heaps , its number of available passive heaps
-    bool m_fast_shutdown = false;
-    typename LocalHeapType::HeapCreationParams m_local_heap_creation_params;
+        // Stealing happens only after a local heap is exhausted , the allocator lock also serialises appends to the stolen logical page table
+        this->enter_concurrent_context();
 
-    static inline std::atomic<bool> m_initialised_successfully = false;
-    static inline std::atomic<bool> m_shutdown_started = false;
-    
-    Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator> m_very_big_object_dict;
-    UserspaceSpinlock<> m_very_big_object_allocation_lock;
+        std::size_t stolen_logical_page_count = m_stolen_logical_page_count.load(std::memory_order_relaxed);
 
-    #ifdef UNIT_TEST
-    std::size_t m_observed_unique_thread_count = 0;
-    #endif
+        if (stolen_logical_page_count < m_max_stolen_logical_page_count || m_free_stolen_logical_page_entry_count.load(std::memory_order_relaxed) > 0)
+        {
+            std::size_t local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
 
-    #ifdef ENABLE_STATS
-    std::size_t m_central_heap_hit_count = 0;
-    std::size_t m_used_thread_local_heap_count =0 ;
-    #endif
+            for (std::size_t i = 0; i < local_heap_count; i++)
+            {
+                LocalHeapType* victim_heap = get_ready_local_heap(i);
 
-    #ifdef ENABLE_PERF_TRACES
-    std::size_t m_central_heap_hit_count = 0;
-    #endif
-    
-    #ifdef ENABLE_REPORT_INVALID_POINTERS
-    Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator> m_invalid_ptr_detection_dict;
-    UserspaceSpinlock<> m_invalid_ptr_detection_lock;
-    #endif
+                if (victim_heap != nullptr && victim_heap != local_heap)
+                {
+                    slot = victim_heap->steal_logical_page_pool_slot(m_page_stealing_reserved_slot_count);
 
-    ScalableAllocator()
-    {
-        static_assert(std::is_base_of<HeapBase<CentralHeapType, ConcurrencyPolicy::CENTRAL>, CentralHeapType>::value);
-        static_assert(std::is_base_of<HeapBase<LocalHeapType, ConcurrencyPolicy::THREAD_LOCAL>, LocalHeapType>::value || std::is_base_of<HeapBase<LocalHeapType, ConcurrencyPolicy::SINGLE_THREAD>, LocalHeapType>::value);
-        static_assert(std::is_base_of<ArenaBase<ArenaType>, ArenaType>::value);
-    }
+                    if (slot != nullptr)
+                    {
+                        break;
+                    }
+                }
+            }
 
-    ~ScalableAllocator()
-    {
-        #ifdef ENABLE_STATS
-        save_stats_to_file("metamalloc_stats.txt");
-        #endif
-        
-        #ifndef ENABLE_REPORT_LEAKS
-        if(m_fast_shutdown)
-        {
-            return;
+            if (slot != nullptr)
+            {
+                register_moved_logical_page(slot, local_heap, slot_size); // Can't fail as there is space in the table
+            }
         }
-        #endif
-
-        if(m_initialised_successfully.load() == true )
-        {
-            // We call it here it in case not called earlier and there are still running threads which are not destructed , no need to move logical pages between heaps
-            m_shutdown_started.store(true);
 
-            destroy_heaps();
+        this->leave_concurrent_context();
 
-            ThreadLocalStorage::get_instance().destroy();
+        if (slot == nullptr)
+        {
+            return false;
         }
-    }
 
-    ScalableAllocator(const ScalableAllocator& other) = delete;
-    ScalableAllocator& operator= (const ScalableAllocator& other) = delete;
-    ScalableAllocator(ScalableAllocator&& other) = delete;
-    ScalableAllocator& operator=(ScalableAllocator&& other) = delete;
+        local_heap->adopt_logical_page_pool_slot(slot);
+        return true;
+    }
 
-    static void thread_specific_destructor(void* arg)
+    // Should be called while holding the allocator lock. Returns false if the stolen logical page table is full
+    bool register_moved_logical_page(void* slot, LocalHeapType* owner_heap, std::size_t slot_size)
     {
-        if( m_initialised_successfully.load() == true && m_shutdown_started.load() == false )
+        std::size_t stolen_logical_page_count = m_stolen_logical_page_count.load(std::memory_order_relaxed);
+
+        // A logical page which moved before may move again , lookups return the first match so its entry is updated
+        for (std::size_t i = 0; i < stolen_logical_page_count; i++)
         {
-            auto thread_local_heap = reinterpret_cast<LocalHeapType*>(arg);
+            if (m_stolen_logical_pages[i].m_address == reinterpret_cast<uint64_t>(slot))
+            {
+                builtin_atomic_exchange64(reinterpret_cast<uint64_t*>(&m_stolen_logical_pages[i].m_owner_heap), reinterpret_cast<uint64_t>(owner_heap));
+                return true;
+            }
+        }
 
-            if(thread_local_heap) // Thread local arg is not supposed to be nullptr by OS specs but just to be safe
+        m_logical_page_pool_slot_size = slot_size; // All local heaps are created with the same parameters
+
+        // Entries of logical pages which went back to the system are reused before appending
+        if (m_free_stolen_logical_page_entry_count.load(std::memory_order_relaxed) > 0)
+        {
+            for (std::size_t i = 0; i < stolen_logical_page_count; i++)
             {
-                auto central_heap = get_instance().get_central_heap();
-                central_heap->transfer_logical_pages_from(reinterpret_cast<CentralHeapType*>(thread_local_heap));
+                if (m_stolen_logical_pages[i].m_address == 0)
+                {
+                    // The owner is set first so that lookups matching the address see it
+                    builtin_atomic_exchange64(reinterpret_cast<uint64_t*>(&m_stolen_logical_pages[i].m_owner_heap), reinterpret_cast<uint64_t>(owner_heap));
+                    builtin_atomic_exchange64(&m_stolen_logical_pages[i].m_address, reinterpret_cast<uint64_t>(slot));
+                    m_free_stolen_logical_page_entry_count.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
             }
         }
-    }
 
-    std::size_t get_created_heap_count()
-    {
-        auto heap_count = m_cached_thread_local_heap_count > m_active_local_heap_count ? m_cached_thread_local_heap_count : m_active_local_heap_count;
-        return heap_count;
+        if (stolen_logical_page_count >= m_max_stolen_logical_page_count)
+        {
+            return false;
+        }
+
+        m_stolen_logical_pages[stolen_logical_page_count].m_address = reinterpret_cast<uint64_t>(slot);
+        m_stolen_logical_pages[stolen_logical_page_count].m_owner_heap = owner_heap;
+        m_stolen_logical_page_count.store(stolen_logical_page_count + 1, std::memory_order_release);
+        return true;
     }
 
-    void destroy_heaps()
+    // Should be called while holding the allocator lock , before the logical page goes back to the system. Its entry becomes free , otherwise deallocations
+    // in the same address range would still go to the previous owner after the arena hands it out again. Free entries have address 0 which no lookup matches
+    void unregister_moved_logical_page(void* slot)
     {
-        if (m_metadata_buffer)
-        {
-            auto heap_count = get_created_heap_count();
+        std::size_t stolen_logical_page_count = m_stolen_logical_page_count.load(std::memory_order_relaxed);
 
-            for (std::size_t i = 0; i < heap_count; i++)
+        for (std::size_t i = 0; i < stolen_logical_page_count; i++)
+        {
+            if (m_stolen_logical_pages[i].m_address == reinterpret_cast<uint64_t>(slot))
             {
-                LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
-                local_heap->~LocalHeapType();
+                builtin_atomic_exchange64(&m_stolen_logical_pages[i].m_address, static_cast<uint64_t>(0));
+                builtin_atomic_exchange64(reinterpret_cast<uint64_t*>(&m_stolen_logical_pages[i].m_owner_heap), static_cast<uint64_t>(0));
+                m_free_stolen_logical_page_entry_count.fetch_add(1, std::memory_order_relaxed);
+                return;
             }
         }
     }
 
-    LocalHeapType* get_thread_local_heap()
+    // Should be called while holding the allocator lock
+    void release_logical_page_pool_slot(void* slot, std::size_t slot_size)
     {
-        return get_thread_local_heap_internal();
+        unregister_moved_logical_page(slot);
+        m_objects_arena.release_to_system(slot, slot_size);
     }
 
-    FORCE_INLINE LocalHeapType* get_thread_local_heap_internal()
+    // Should be called while holding the allocator lock. Gives free logical page pool slots of a local heap back to the system except 'reserved_slot_count' of them
+    // Returns the number of released slots
+    std::size_t release_logical_page_pool_slots(LocalHeapType* local_heap, std::size_t reserved_slot_count = 0)
     {
-        auto thread_local_heap = reinterpret_cast<LocalHeapType*>(ThreadLocalStorage::get_instance().get());
+        if (m_stolen_logical_pages == nullptr)
+        {
+            return local_heap->release_free_logical_page_pool_slots(reserved_slot_count);
+        }
 
-        if (thread_local_heap == nullptr)
+        std::size_t slot_size = local_heap->get_logical_page_pool_slot_size();
+        std::size_t released_slot_count = 0;
+        void* slot = nullptr;
+
+        while ((slot = local_heap->steal_logical_page_pool_slot(reserved_slot_count)) != nullptr)
         {
-            // LOCKING HERE WILL HAPPEN ONLY ONCE FOR EACH THREAD , AT THEIR START
-            // AS THERE ARE SHARED VARIABLES FOR THREAD-LOCAL HEAP CREATION
-            this->enter_concurrent_context();
+            release_logical_page_pool_slot(slot, slot_size);
+            released_slot_count++;
+        }
 
-            #ifdef UNIT_TEST
-            m_observed_unique_thread_count++;
-            #endif
+        return released_slot_count;
+    }
 
-            #ifdef ENABLE_STATS
-            m_used_thread_local_heap_count++;
-            #endif
+    FORCE_INLINE LocalHeapType* find_owner_of_stolen_logical_page(void* ptr)
+    {
+        std::size_t stolen_logical_page_count = m_stolen_logical_page_count.load(std::memory_order_acquire);
 
-            ///////////////////////////////////////////////////////////////////////////////////////////////////////////
-            if (m_active_local_heap_count + 1 >= m_max_thread_local_heap_count)
-            {
-                // If we are here , it means that metadata buffer size is not sufficient to handle all threads of the application
-                this->leave_concurrent_context();
-                return nullptr;
-            }
+        if (likely(stolen_logical_page_count == 0))
+        {
+            return nullptr;
+        }
 
-            if (m_active_local_heap_count >= m_cached_thread_local_heap_count)
-            {
-                thread_local_heap = create_local_heap(m_active_local_heap_count);
-            }
-            else
+        uint64_t address = reinterpret_cast<uint64_t>(ptr);
+
+        for (std::size_t i = 0; i < stolen_logical_page_count; i++)
+        {
+            if (address - m_stolen_logical_pages[i].m_address < m_logical_page_pool_slot_size) // Unsigned wrap around covers addresses below the page
             {
-                thread_local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (m_active_local_heap_count * sizeof(LocalHeapType)));
+                return m_stolen_logical_pages[i].m_owner_heap;
             }
-
-            m_active_local_heap_count++;
-            ThreadLocalStorage::get_instance().set(thread_local_heap);
-            ///////////////////////////////////////////////////////////////////////////////////////////////////////////
-            this->leave_concurrent_context();
         }
 
-        return thread_local_heap;
+        return nullptr;
     }
 
-    bool create_heaps()
+    void* allocate_from_transfer_cache(LocalHeapType* local_heap, std::size_t size)
     {
-        m_max_thread_local_heap_count = m_metadata_buffer_size / sizeof(LocalHeapType);
+        auto transfer_cache = get_transfer_cache(local_heap);
+        auto size_class = m_central_heap.get_size_class_from_size(size);
 
-        if (m_max_thread_local_heap_count == 0)
-        {
-            return false;
-        }
+        void* ret = transfer_cache->allocate(size_class);
 
-        if (m_max_thread_local_heap_count < m_cached_thread_local_heap_count)
+        if (ret == nullptr)
         {
-            m_cached_thread_local_heap_count = m_max_thread_local_heap_count;
-        }
+            #ifdef ENABLE_STATS
+            m_central_heap_hit_count++;
+            #endif
 
-        for (std::size_t i{ 0 }; i < m_cached_thread_local_heap_count; i++)
-        {
-            auto local_heap = create_local_heap(i);
-            if (!local_heap) return false;
+            #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
+            m_central_heap_hit_count++;
+            fprintf(stderr, "scalable allocator , central heap hit count=%zu\n", m_central_heap_hit_count);
+            #endif
+
+            #ifdef UNIT_TEST
+            m_transfer_cache_refill_count++;
+            #endif
+
+            // One central heap lock for the entire batch
+            if (transfer_cache->refill(&m_central_heap, size, size_class, m_transfer_batch_size) > 0)
+            {
+                ret = transfer_cache->allocate(size_class);
+            }
         }
 
-        return true;
+        return ret;
     }
 
     LocalHeapType* create_local_heap(std::size_t metadata_buffer_index)
@@ -716,4 +1896,47 @@ private:
     }
 };
 
+// Constructs a T with memory of a ScalableAllocator , its size is resolved at compile time. See ScalableAllocator::allocate<size>
+template <typename T, typename AllocatorType, typename... Args>
+[[nodiscard]] T* metamalloc_new(Args&&... args)
+{
+    void* ptr = nullptr;
+
+    if constexpr (alignof(T) > AlignmentConstants::MINIMUM_VECTORISATION_WIDTH)
+    {
+        ptr = AllocatorType::get_instance().allocate_aligned(sizeof(T), alignof(T));
+    }
+    else
+    {
+        ptr = AllocatorType::get_instance().template allocate<sizeof(T)>();
+    }
+
+    if (unlikely(ptr == nullptr))
+    {
+        return nullptr;
+    }
+
+    return new(ptr) T(std::forward<Args>(args)...); // Placement new , does not invoke memory allocation
+}
+
+template <typename T, typename AllocatorType>
+void metamalloc_delete(T* object)
+{
+    if (object == nullptr)
+    {
+        return;
+    }
+
+    object->~T();
+
+    if constexpr (alignof(T) > AlignmentConstants::MINIMUM_VECTORISATION_WIDTH)
+    {
+        AllocatorType::get_instance().deallocate(object);
+    }
+    else
+    {
+        AllocatorType::get_instance().template deallocate<sizeof(T)>(object);
+    }
+}
+
 #endif
\ No newline at end of file
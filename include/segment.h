@@ -12,6 +12,15 @@
 
     - IT WILL PLACE A LOGICAL PAGE HEADER TO INITIAL 64 BYTES OF EVERY LOGICAL PAGE.
 
+    - LOGICAL PAGES CAN BE GROUPED IN BLOCKS WHICH ARE BIGGER THAN THEIR SIZES ( SEE m_logical_page_alignment ). IN THAT CASE LOGICAL PAGES ARE PLACED BACK TO BACK IN BLOCKS
+      ALIGNED TO THE BLOCK SIZE AND THE SEGMENT GROWS BY WHOLE BLOCKS , SO THAT HEAPS CAN HAVE BINS WITH DIFFERENT LOGICAL PAGE SIZES AND STILL REACH THE SIZE CLASS BY MASKING WITH THE BIGGEST ONE.
+      THE MASK FINDS THE HEADER OF A BLOCK'S FIRST LOGICAL PAGE , THEREFORE THAT LOGICAL PAGE STAYS IN PLACE AND IS NOT RECYCLED WHILE THE SEGMENT LIVES
+
+    - BOUNDED SEGMENTS OF A HEAP CAN SHARE A POOL OF LOGICAL PAGE SLOTS INSTEAD OF FIXED PARTITIONS ( SEE LogicalPagePool ). THEY TAKE A LOGICAL PAGE FROM THE POOL WHEN THEIR PAGES
+      RUN OUT AND RECYCLING PUTS FREE LOGICAL PAGES BACK TO THE POOL INSTEAD OF GIVING THEM BACK TO THE SYSTEM
+
+    - THREAD LOCAL SEGMENTS RECEIVE DEALLOCATIONS FROM MULTIPLE THREADS. THEY EITHER QUEUE THEM OR PUSH THEM TO PER LOGICAL PAGE THREAD FREE LISTS. SEE RemoteDeallocationPolicy
+
     - METADATA USAGE : PAGE HEADERS IN METAMALLOC ARE 64 BYTES THEREFORE FOR METADATA, WE WILL USE 64 BYTES PER EACH LOGICAL PAGE.
       IF SELECTED PAGE SIZE 4096 BYTES , 64 BYTES IN 4096 IS 0.78%
 */
@@ -33,8 +42,11 @@
 #include "utilities/size_utilities.h"
 #include "utilities/modulo_utilities.h"
 #include "utilities/multiple_utilities.h"
+#include "utilities/pow2_utilities.h"
 #include "utilities/lockable.h"
 #include "deallocation_queue.h"
+#include "tagged_free_list.h"
+#include "logical_page_pool.h"
 #include "arena_base.h"
 #include "logical_page_header.h"
 
@@ -48,20 +60,46 @@ enum class ConcurrencyPolicy
 {
                         // BOUNDEDNESS                    DESCRIPTION
 
-    THREAD_LOCAL,       // Bounded , can't grow           Partial locking needed. Deallocates just push ptrs to a spinlock based q and they quit, as they can come from multiple threads.
-                        //                                Allocs will come from only one thread and they do actual deallocation by consuming dealloc q.
+    THREAD_LOCAL,       // Bounded , can't grow           No locks for deallocations. Deallocates push ptrs to the lockfree intrusive deallocation queue or to thread free lists of logical pages and they quit,
+                        //                                as they can come from multiple threads. Allocs will come from only one thread and they do actual deallocations by consuming them.
+                        //                                See RemoteDeallocationPolicy
     CENTRAL,            // Unbounded, can grow            Segment level locking needed
     SINGLE_THREAD       // Unbounded, can grow            No locks
 };
 
+enum class RemoteDeallocationPolicy
+{
+    DEALLOCATION_QUEUE,     // THREAD LOCAL SEGMENTS PUSH ALL DEALLOCATIONS TO A LOCKFREE INTRUSIVE DEALLOCATION QUEUE, OWNER THREAD CONSUMES IT ON ALLOCATIONS
+    THREAD_FREE_LIST        // DEALLOCATIONS ARE CAS-PUSHED TO THREAD FREE LISTS OF LOGICAL PAGES, OWNER THREAD COLLECTS A PAGE'S LIST WITH A SINGLE ATOMIC EXCHANGE WHEN THE PAGE RUNS OUT
+                            // NO DEALLOCATION QUEUE IS ALLOCATED AND NO LOCKS ARE TAKEN. REQUIRES LOGICAL PAGES ALIGNED TO LOGICAL PAGE SIZE
+};
+
+enum class CentralFreeListPolicy
+{
+    LOCKED,                 // CENTRAL SEGMENTS ARE LOCKED FOR EVERY ALLOCATION AND DEALLOCATION
+    LOCKFREE                // CENTRAL SEGMENTS PUSH DEALLOCATED CHUNKS TO A LOCKFREE ABA-SAFE STACK AND ALLOCATIONS POP FROM IT. THE SEGMENT IS LOCKED ONLY WHEN THE STACK IS EMPTY,
+                            // TO ALLOCATE FROM LOGICAL PAGES OR TO GROW. PERIODICALLY AND ON "drain" CALLS , THE STACK IS EMPTIED BACK TO LOGICAL PAGES UNDER THE SEGMENT LOCK
+                            // SO THAT EMPTY LOGICAL PAGES CAN BE RECYCLED. SEE m_central_free_list_drain_interval
+                            // REQUIRES FIXED SIZE CLASS LOGICAL PAGES ALIGNED TO LOGICAL PAGE SIZE
+};
+
 struct SegmentCreationParameters
 {
     std::size_t m_logical_page_size= 0;
     std::size_t m_logical_page_count = 0;
+    std::size_t m_logical_page_alignment = 0;              // 0 means that logical pages are independent. Otherwise logical pages are placed back to back in blocks of that size and alignment ,
+                                                           // so the header of a block's first logical page is found by masking with the block size. That allows heaps to use different
+                                                           // logical page sizes per bin while still finding size classes of all logical pages with a single mask. Logical page counts should
+                                                           // be multiples of logical pages per block , and the first logical page of a block is not recycled while the segment lives
     std::size_t m_page_recycling_threshold = 0;
-    std::size_t m_deallocation_queue_initial_capacity = 65536;
+    std::size_t m_deallocation_queue_drain_budget = 128;  // Max number of queued remote deallocations processed per allocation in thread-local segments, 0 means no limit
+    std::size_t m_central_free_list_drain_interval = 4096; // Applies to central segments with lockfree free lists. Roughly every that many deallocations ( rounded up to a power of two ) ,
+                                                           // the free list goes back to logical pages under the segment lock. 0 means that only drain and recycle_free_logical_pages do it
     uint32_t m_size_class = 0;                             // 0 means that that segment will hold arbitrary size. Otherwise it will be for only 1 sizeclass.
     double m_grow_coefficient = 0.0;                     // 0 means that we will be growing by allocating only required amount
+    LogicalPagePool* m_logical_page_pool = nullptr;       // Applies to thread local segments. If set , logical page count can be 0 and the segment takes logical pages from the pool on demand
+                                                           // Pool slots should be as big as logical page slots. Segment::owns_pointer can't be used in that case as pages are not contiguous ,
+                                                           // heaps should check ownership against the whole pool buffer instead
 };
 
 #ifdef ENABLE_STATS
@@ -87,7 +125,9 @@ template <
             typename LogicalPageType,
             typename ArenaType,
             PageRecyclingPolicy page_recycling_policy = PageRecyclingPolicy::IMMEDIATE,
-            bool buffer_aligned_to_logical_page_size = false
+            bool buffer_aligned_to_logical_page_size = false,
+            RemoteDeallocationPolicy remote_deallocation_policy = RemoteDeallocationPolicy::DEALLOCATION_QUEUE,
+            CentralFreeListPolicy central_free_list_policy = CentralFreeListPolicy::LOCKED
         >
 class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
 {
@@ -98,6 +138,20 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             static_assert(std::is_base_of<ArenaBase<ArenaType>, ArenaType>::value);
             m_logical_page_object_size = sizeof(LogicalPageType);
             assert( m_logical_page_object_size == sizeof(LogicalPageHeader) );
+
+            if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
+            {
+                // Deallocating threads find the logical page by masking , and thread free lists hold only fixed size chunks
+                static_assert(buffer_aligned_to_logical_page_size == true);
+                static_assert(LogicalPageType::supports_any_size() == false);
+            }
+
+            if constexpr (LOCKFREE_CENTRAL)
+            {
+                // Deallocations find chunk starts by masking
+                static_assert(buffer_aligned_to_logical_page_size == true);
+                static_assert(LogicalPageType::supports_any_size() == false);
+            }
         }
 
         ~Segment()
@@ -112,30 +166,61 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
 
         [[nodiscard]] bool create(char* external_buffer, ArenaType* arena_ptr, const SegmentCreationParameters& params)
         {
+            bool uses_logical_page_pool = params.m_logical_page_pool != nullptr;
+
             if (params.m_size_class < 0 || params.m_logical_page_size <= 0 || MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(params.m_logical_page_size) == false
-                || params.m_logical_page_count <= 0 || params.m_logical_page_size <= m_logical_page_object_size || !external_buffer || !arena_ptr)
+                || params.m_logical_page_size <= m_logical_page_object_size || !arena_ptr)
             {
                 return false;
             }
 
-            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            if (uses_logical_page_pool == false && (params.m_logical_page_count <= 0 || !external_buffer))
             {
-                if (m_deallocation_queue.create(params.m_deallocation_queue_initial_capacity/sizeof(PointerPage), ArenaType::MetadataAllocator::allocate(params.m_deallocation_queue_initial_capacity)) == false)
-                {
-                    return false;
-                }
+                return false;
+            }
 
-                m_deallocation_queue_processing_lock.initialise();
+            if (uses_logical_page_pool && concurrency_policy != ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                return false; // Only bounded segments take pages from a pool , unbounded ones grow from the arena
+            }
+
+            if (params.m_logical_page_alignment != 0 && (params.m_logical_page_alignment < params.m_logical_page_size || ModuloUtilities::modulo(params.m_logical_page_alignment, params.m_logical_page_size) != 0))
+            {
+                return false;
             }
 
             m_arena = arena_ptr;
             m_logical_page_size = params.m_logical_page_size;
+            m_logical_pages_per_block = params.m_logical_page_alignment == 0 ? 1 : params.m_logical_page_alignment / params.m_logical_page_size;
             m_max_object_size = m_logical_page_size - sizeof(LogicalPageHeader);
+
+            if (Pow2Utilities::is_power_of_two(m_logical_pages_per_block) == false)
+            {
+                return false;
+            }
+
+            if (uses_logical_page_pool && m_logical_pages_per_block != 1)
+            {
+                return false; // Pooled slots are shared by segments , therefore they can't be split to smaller logical pages
+            }
+
+            if (ModuloUtilities::modulo(params.m_logical_page_count, m_logical_pages_per_block) != 0)
+            {
+                return false; // Blocks should be full , see m_logical_page_alignment
+            }
+
+            if constexpr (LogicalPageType::supports_any_size())
+            {
+                m_max_object_size = LogicalPageType::get_max_allocation_size(m_max_object_size); // Any size pages also use per page freelist metadata and per allocation headers
+            }
             m_size_class = params.m_size_class;
             m_page_recycling_threshold = params.m_page_recycling_threshold;
             m_grow_coefficient = params.m_grow_coefficient;
+            m_deallocation_queue_drain_budget = params.m_deallocation_queue_drain_budget;
+            m_central_free_list_drain_mask = params.m_central_free_list_drain_interval == 0 ? ~static_cast<uint64_t>(0) : Pow2Utilities::get_first_pow2_of(params.m_central_free_list_drain_interval) - 1;
+            m_logical_page_pool = params.m_logical_page_pool;
 
-            if (grow(external_buffer, params.m_logical_page_count) == nullptr)
+            if (params.m_logical_page_count > 0 && grow(external_buffer, params.m_logical_page_count) == nullptr)
             {
                 return false;
             }
@@ -156,27 +241,41 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
             {
                 // THREAD LOCAL
-                if constexpr (LogicalPageType::supports_any_size()==false) // Underyling type should be used for same size class
+                if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
                 {
-                    void* pointer = process_deallocation_queue<true>(); // While pointers in the deallocation queue are deallocated ,one of them will be returned to the allocation requestor
+                    return allocate_internal(size); // Thread free lists are collected page by page when local freelists run out
+                }
+                else if constexpr (LogicalPageType::supports_any_size()==false) // Underyling type should be used for same size class
+                {
+                    // While pointers in the deallocation queue are deallocated ,one of them will be returned to the allocation requestor
+                    // At most m_deallocation_queue_drain_budget pointers are processed so that allocation latency doesn't depend on the queue depth
+                    void* pointer = process_deallocation_queue<true>(m_deallocation_queue_drain_budget);
 
                     if (pointer)
                     {
                         return pointer;
                     }
-                    else
-                    {
-                        return allocate_internal(size);
-                    }
+
+                    return allocate_internal_after_draining(size);
                 }
                 else
                 {
-                    process_deallocation_queue<false>();
-                    return allocate_internal(size);
+                    process_deallocation_queue<false>(m_deallocation_queue_drain_budget);
+                    return allocate_internal_after_draining(size);
                 }
             }
             else if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
             {
+                if constexpr (LOCKFREE_CENTRAL)
+                {
+                    void* pointer = m_central_free_list.pop();
+
+                    if (likely(pointer != nullptr))
+                    {
+                        return pointer;
+                    }
+                }
+
                 // CENTRAL , we are locking the entire segment
                 this->enter_concurrent_context();
                 auto ret = allocate_internal(size);
@@ -190,6 +289,31 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             }
         }
 
+        // Applies only to logical pages which support any size, as they carve aligned blocks without padding bytes
+        // For fixed size class logical pages, use HeapBase::allocate_aligned which pads and LogicalPage which unpads
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        void* allocate_aligned(std::size_t size, std::size_t alignment)
+        {
+            static_assert(LogicalPageType::supports_any_size());
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                process_deallocation_queue<false>(m_deallocation_queue_drain_budget);
+                return allocate_internal_after_draining(size, alignment);
+            }
+            else if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            {
+                this->enter_concurrent_context();
+                auto ret = allocate_internal(size, alignment);
+                this->leave_concurrent_context();
+                return ret;
+            }
+            else
+            {
+                return allocate_internal(size, alignment);
+            }
+        }
+
         ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
         void deallocate(void* ptr)
         {
@@ -198,7 +322,24 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
             {
                 // THREAD LOCAL
-                m_deallocation_queue.push(ptr); // Q is thread safe
+                if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
+                {
+                    get_logical_page_from_address(ptr, m_logical_page_size)->deallocate_to_thread_free_list(ptr); // Lockfree, only touches the page header
+                }
+                else
+                {
+                    m_deallocation_queue.push(ptr); // Lockfree , Q is intrusive so it doesn't allocate
+                }
+            }
+            else if constexpr (LOCKFREE_CENTRAL)
+            {
+                // CENTRAL WITH LOCKFREE FREE LIST , pointers may have been padded by HeapBase::allocate_aligned
+                uint64_t tag = m_central_free_list.push(get_logical_page_from_address(ptr, m_logical_page_size)->get_chunk_start(ptr));
+
+                if (unlikely((tag & m_central_free_list_drain_mask) == 0))
+                {
+                    drain();
+                }
             }
             else if constexpr(concurrency_policy == ConcurrencyPolicy::CENTRAL)
             {
@@ -214,6 +355,145 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             }
         }
 
+        // Allocates up to 'count' chunks of m_size_class and links them through their first 8 bytes , the last one pointing to nullptr
+        // Returns the number of allocated chunks. In central case , the segment lock is taken only once for the entire batch. See TransferCache
+        std::size_t allocate_batch(std::size_t count, void** first)
+        {
+            static_assert(LogicalPageType::supports_any_size() == false);
+
+            std::size_t allocated_count = 0;
+            void* head = nullptr;
+
+            if constexpr (LOCKFREE_CENTRAL)
+            {
+                while (allocated_count < count)
+                {
+                    void* pointer = m_central_free_list.pop();
+
+                    if (pointer == nullptr)
+                    {
+                        break;
+                    }
+
+                    TaggedFreeList::set_next(pointer, head); // A pop which started before ours may still be reading the first 8 bytes
+                    head = pointer;
+                    allocated_count++;
+                }
+
+                if (allocated_count == count)
+                {
+                    *first = head;
+                    return allocated_count;
+                }
+            }
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            {
+                this->enter_concurrent_context();
+            }
+
+            while (allocated_count < count)
+            {
+                void* pointer = nullptr;
+
+                if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+                {
+                    pointer = allocate();
+                }
+                else
+                {
+                    pointer = allocate_internal(0);
+                }
+
+                if (pointer == nullptr)
+                {
+                    break;
+                }
+
+                *reinterpret_cast<void**>(pointer) = head;
+                head = pointer;
+                allocated_count++;
+            }
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            {
+                this->leave_concurrent_context();
+            }
+
+            *first = head;
+            return allocated_count;
+        }
+
+        // Chunks from 'first' to 'last' should be linked through their first 8 bytes. See RemoteDeallocationCache and TransferCache
+        // In thread local case with deallocation queues , the entire list is pushed to the queue at once
+        // In central case , the segment lock is taken only once for the entire batch
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        void deallocate_batch(void* first, void* last)
+        {
+            if( m_head == nullptr ) { return;}
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL && remote_deallocation_policy == RemoteDeallocationPolicy::DEALLOCATION_QUEUE)
+            {
+                m_deallocation_queue.push_batch(first, last); // Lockfree , single CAS for the entire batch
+            }
+            else if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                for_each_linked_chunk(first, last, [this](void* chunk) { deallocate(chunk); });
+            }
+            else if constexpr (LOCKFREE_CENTRAL)
+            {
+                // Relinking unpadded chunk starts , then a single CAS for the entire batch
+                void* new_first = nullptr;
+                void* new_last = nullptr;
+
+                for_each_linked_chunk(first, last, [&](void* chunk)
+                {
+                    void* chunk_start = get_logical_page_from_address(chunk, m_logical_page_size)->get_chunk_start(chunk);
+                    TaggedFreeList::set_next(chunk_start, new_first);
+                    new_first = chunk_start;
+                    new_last = new_last == nullptr ? chunk_start : new_last;
+                });
+
+                uint64_t tag = m_central_free_list.push_batch(new_first, new_last);
+
+                if (unlikely((tag & m_central_free_list_drain_mask) == 0))
+                {
+                    drain();
+                }
+            }
+            else
+            {
+                if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+                {
+                    this->enter_concurrent_context();
+                }
+
+                for_each_linked_chunk(first, last, [this](void* chunk) { deallocate_internal(chunk); });
+
+                if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+                {
+                    this->leave_concurrent_context();
+                }
+            }
+        }
+
+        // Should be called only by the owner thread of a thread-local segment
+        // Returns the chunk straight to its logical page, bypassing the deallocation queue or the thread free list of the page
+        // Other concurrency policies don't distinguish owners , therefore they fall back to deallocate
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        void deallocate_from_owner(void* ptr)
+        {
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                if( m_head == nullptr ) { return;}
+                deallocate_internal(ptr); // No synchronisation needed as only the owner thread touches page freelists
+            }
+            else
+            {
+                deallocate(ptr);
+            }
+        }
+
         // MAY BE CALLED FROM HEAP DEALLOCATION METHODS. IN CASE OF THREAD LOCAL OR CENTRAL HEAP , THAT MEANS MULTIPLE THREADS
         ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
         bool owns_pointer(void* ptr)
@@ -280,16 +560,21 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
 
             this->enter_concurrent_context();
             ///////////////////////////////////////////////////////////////////
+            if constexpr (LOCKFREE_CENTRAL)
+            {
+                drain_central_free_list();
+            }
+
             auto num_logical_pages_to_recycle = m_logical_page_count - m_page_recycling_threshold;
             LogicalPageType* iter = m_head;
             LogicalPageType* iter_previous = nullptr;
 
-            while (num_logical_pages_to_recycle)
+            while (num_logical_pages_to_recycle && iter != nullptr)
             {
-                if (iter->can_be_recycled())
+                if (iter->can_be_recycled() && is_recyclable(iter))
                 {
                     recycle_logical_page(iter); // This method will update iter_previous's next ptr
-                    iter = reinterpret_cast<LogicalPageType*>(iter_previous->get_next_logical_page());
+                    iter = iter_previous != nullptr ? reinterpret_cast<LogicalPageType*>(iter_previous->get_next_logical_page()) : m_head;
                     num_logical_pages_to_recycle--;
                 }
                 else
@@ -313,8 +598,13 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             {
                 LogicalPageType* iter_next = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
 
-                add_logical_page(iter); // Will also update iter's next ptr
-                from.remove_logical_page(iter);
+                if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
+                {
+                    iter->collect_thread_free_list(); // Late remote deallocations can still arrive after the transfer, allocate_internal will collect them
+                }
+
+                from.remove_logical_page(iter); // Before adding , as adding overwrites iter's previous and next ptrs
+                add_logical_page(iter);
 
                 iter = iter_next;
             }
@@ -371,20 +661,62 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             return target_logical_page->get_size_class();
         }
 
-        void lock_pages()
+        // Should be called only by the owner thread of a thread-local segment, for ex when it is idle
+        // Processes up to 'budget' queued remote deallocations , 0 means all of them. Returns the number of processed deallocations
+        // Central segments with lockfree free lists can be drained by any thread , all chunks in the free list go back to their logical pages regardless of 'budget'
+        std::size_t drain(std::size_t budget = 0)
+        {
+            std::size_t processed_count = 0;
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL && remote_deallocation_policy == RemoteDeallocationPolicy::DEALLOCATION_QUEUE)
+            {
+                process_deallocation_queue<false>(budget, &processed_count);
+            }
+            else if constexpr (LOCKFREE_CENTRAL)
+            {
+                UNUSED(budget);
+                this->enter_concurrent_context();
+                processed_count = drain_central_free_list();
+                this->leave_concurrent_context();
+            }
+            else
+            {
+                UNUSED(budget);
+            }
+
+            return processed_count;
+        }
+
+        // Locks each logical page with a single call. Already locked ones are skipped. Locked logical pages are unlocked by unlock_pages or when they are recycled
+        // Returns false if any of them can't be locked
+        bool lock_pages()
         {
+            bool success = true;
+
             this->enter_concurrent_context();
             ///////////////////////////////////////////////////////////////////
             LogicalPageType* iter = m_head;
 
             while (iter)
             {
-                VirtualMemory::lock(reinterpret_cast<void*>(iter), m_logical_page_size);
-                iter->mark_as_locked();
+                if (iter->is_locked() == false)
+                {
+                    if (VirtualMemory::lock(reinterpret_cast<void*>(iter), m_logical_page_size))
+                    {
+                        iter->mark_as_locked();
+                    }
+                    else
+                    {
+                        success = false;
+                    }
+                }
+
                 iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
             }
             ///////////////////////////////////////////////////////////////////
             this->leave_concurrent_context();
+
+            return success;
         }
 
         void unlock_pages()
@@ -395,8 +727,12 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
 
             while (iter)
             {
-                VirtualMemory::unlock(reinterpret_cast<void*>(iter), m_logical_page_size);
-                iter->mark_as_non_locked();
+                if (iter->is_locked())
+                {
+                    VirtualMemory::unlock(reinterpret_cast<void*>(iter), m_logical_page_size);
+                    iter->mark_as_non_locked();
+                }
+
                 iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
             }
             ///////////////////////////////////////////////////////////////////
@@ -419,6 +755,7 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
     private:
         uint32_t m_size_class = 0;                    // if m_size_class is zero that means, underlying logical page can hold any size
         std::size_t m_logical_page_size = 0;            // It includes also m_logical_page_object_size
+        std::size_t m_logical_pages_per_block = 1;      // More than 1 if logical pages are grouped in blocks of a bigger alignment , see SegmentCreationParameters::m_logical_page_alignment
         std::size_t m_max_object_size = 0;
         std::size_t m_logical_page_object_size = 0;
         std::size_t m_logical_page_count = 0;
@@ -429,9 +766,14 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
         std::size_t m_page_recycling_threshold = 0; // In auto page recycling mode, if a logical page is free after deallocation ,
                                                     // it will be given back to system if free l.page count is over that threshold
         double m_grow_coefficient = 1.0;            // Applies to unbounded segments
-        DeallocationQueue<typename ArenaType::MetadataAllocator> m_deallocation_queue;
+        std::size_t m_deallocation_queue_drain_budget = 0; // 0 means no limit
+        uint64_t m_central_free_list_drain_mask = ~static_cast<uint64_t>(0); // Free list tags which have none of these bits set trigger drains
+        DeallocationQueue m_deallocation_queue;
+        TaggedFreeList m_central_free_list;         // Exists in all segments so that layouts don't depend on policies, as thread local heaps are transferred to central heaps
+        LogicalPagePool* m_logical_page_pool = nullptr; // Not owned , applies to bounded segments
         ArenaType* m_arena = nullptr;
-        UserspaceSpinlock<> m_deallocation_queue_processing_lock;
+
+        static constexpr inline bool LOCKFREE_CENTRAL = concurrency_policy == ConcurrencyPolicy::CENTRAL && central_free_list_policy == CentralFreeListPolicy::LOCKFREE;
 
         #ifdef ENABLE_STATS
         SegmentStats m_stats;
@@ -457,7 +799,6 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
                 }
 
                 iter_page->mark_as_used();
-
                 m_logical_page_count++;
 
                 return true;
@@ -504,11 +845,32 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             return first_new_logical_page;
         }
 
+        // The first logical page of a block holds the header which size class lookups of the whole block find , see SegmentCreationParameters::m_logical_page_alignment
+        bool is_recyclable(LogicalPageType* logical_page) const
+        {
+            return m_logical_pages_per_block == 1 || ModuloUtilities::modulo_pow2(reinterpret_cast<uint64_t>(logical_page), m_logical_page_size * m_logical_pages_per_block) != 0;
+        }
+
         void recycle_logical_page(LogicalPageType* affected)
         {
             remove_logical_page(affected);
+
+            if (affected->is_locked())
+            {
+                // Otherwise the pool slot would stay locked for its next user and releasing it to the system could fail
+                VirtualMemory::unlock(reinterpret_cast<void*>(affected), m_logical_page_size);
+            }
+
             affected->~LogicalPageType();
-            m_arena->release_to_system(affected, m_logical_page_size);
+
+            if (m_logical_page_pool != nullptr)
+            {
+                m_logical_page_pool->push(affected); // Another segment of the same heap can use it
+            }
+            else
+            {
+                m_arena->release_to_system(affected, m_logical_page_size);
+            }
             #ifdef ENABLE_STATS
             m_stats.m_recycle_count++;
             #endif
@@ -570,26 +932,45 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             else
             {
                 m_head = logical_page;
-                m_tail = logical_page;
+                logical_page->set_previous_logical_page(nullptr);
             }
 
+            m_tail = logical_page;
             logical_page->set_next_logical_page(nullptr);
             m_logical_page_count++;
         }
 
         void destroy()
         {
-            if constexpr (concurrency_policy==ConcurrencyPolicy::THREAD_LOCAL)
+            if constexpr (concurrency_policy==ConcurrencyPolicy::THREAD_LOCAL && remote_deallocation_policy == RemoteDeallocationPolicy::DEALLOCATION_QUEUE)
             {
                 process_deallocation_queue();
             }
 
+            if constexpr (LOCKFREE_CENTRAL)
+            {
+                // No other thread is supposed to be using the segment anymore , chunks can go back to their logical pages
+                void* pointer = m_central_free_list.pop_all();
+
+                while (pointer != nullptr)
+                {
+                    void* next = TaggedFreeList::get_next(pointer);
+                    get_logical_page_from_address(pointer, m_logical_page_size)->deallocate(pointer);
+                    pointer = next;
+                }
+            }
+
             LogicalPageType* iter = m_head;
             LogicalPageType* next = nullptr;
 
             while (iter)
             {
                 next = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+
+                if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
+                {
+                    iter->collect_thread_free_list();
+                }
                 /////////////////////////////////////////////////////////////////////////////
                 #ifdef ENABLE_REPORT_LEAKS
                 if (iter->get_used_size() != 0)
@@ -637,15 +1018,16 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             m_tail = nullptr;
         }
 
-        // DEALLOCATES ALL POINTERS IN THE DEALLOCATION QUEUE
+        // DEALLOCATES POINTERS IN THE DEALLOCATION QUEUE , AT MOST 'budget' OF THEM IF BUDGET IS NOT ZERO
         // IF THE CALLER IS ALLOCATOR INITIAL POINTER WON'T BE DEALLOCATED BUT INSTEAD RETURNED TO THE CALLER
         // TO SERVE ALLOCATIONS AS FAST AS POSSIBLE
         template <bool return_initial_pointer=false>
-        void* process_deallocation_queue()
+        void* process_deallocation_queue(std::size_t budget = 0, std::size_t* processed_count = nullptr)
         {
             void* ret = nullptr;
+            std::size_t count = 0;
 
-            while (true)
+            while (budget == 0 || count < budget)
             {
                 auto pointer = m_deallocation_queue.pop();
 
@@ -654,6 +1036,8 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
                     break;
                 }
 
+                count++;
+
                 if constexpr (return_initial_pointer)
                 {
                     if (likely(ret != nullptr))
@@ -671,10 +1055,58 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
                 }
             }
 
+            if (processed_count)
+            {
+                *processed_count = count;
+            }
+
             return ret;
         }
 
-        [[nodiscard]] void* allocate_internal(std::size_t size)
+        // Thread local segments can't grow , therefore before failing an allocation we drain the rest of the deallocation queue and retry
+        void* allocate_internal_after_draining(std::size_t size, std::size_t alignment = 0)
+        {
+            void* ret = allocate_internal(size, alignment);
+
+            if (unlikely(ret == nullptr))
+            {
+                std::size_t processed_count = 0;
+                process_deallocation_queue<false>(0, &processed_count);
+
+                if (processed_count > 0)
+                {
+                    ret = allocate_internal(size, alignment);
+                }
+            }
+
+            return ret;
+        }
+
+        FORCE_INLINE void* allocate_from_logical_page(LogicalPageType* logical_page, std::size_t size, std::size_t alignment)
+        {
+            if constexpr (LogicalPageType::supports_any_size())
+            {
+                return logical_page->allocate_aligned(size, alignment);
+            }
+            else
+            {
+                UNUSED(alignment);
+                void* ret = logical_page->allocate(size);
+
+                if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
+                {
+                    // Local freelist is exhausted, take over all deallocations which other threads made on this page and retry
+                    if (ret == nullptr && logical_page->collect_thread_free_list() > 0)
+                    {
+                        ret = logical_page->allocate(size);
+                    }
+                }
+
+                return ret;
+            }
+        }
+
+        [[nodiscard]] void* allocate_internal(std::size_t size, std::size_t alignment = 0)
         {
 
             if (unlikely(size > m_max_object_size))
@@ -689,7 +1121,7 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
 
             while (iter)
             {
-                ret = iter->allocate(size);
+                ret = allocate_from_logical_page(iter, size, alignment);
 
                 if (ret != nullptr)
                 {
@@ -708,7 +1140,7 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
 
                 while (iter != m_last_used)
                 {
-                    ret = iter->allocate(size);
+                    ret = allocate_from_logical_page(iter, size, alignment);
 
                     if (ret != nullptr)
                     {
@@ -722,18 +1154,42 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             }
             ///////////////////////////////////////////////////////////////////
             // If we reached here , it means that we need to allocate more memory
-            if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL || concurrency_policy == ConcurrencyPolicy::SINGLE_THREAD) // Only unbounded concurrecy policies can grow
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL) // Bounded segments can only take a logical page from their heap's pool
+            {
+                if (m_logical_page_pool != nullptr)
+                {
+                    char* slot = static_cast<char*>(m_logical_page_pool->pop());
+
+                    if (slot != nullptr)
+                    {
+                        auto new_logical_page = grow(slot, 1);
+
+                        if (new_logical_page)
+                        {
+                            ret = allocate_from_logical_page(new_logical_page, size, alignment);
+
+                            if (ret != nullptr)
+                            {
+                                m_last_used = new_logical_page;
+                                return ret;
+                            }
+                        }
+                    }
+                }
+            }
+            else if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL || concurrency_policy == ConcurrencyPolicy::SINGLE_THREAD) // Only unbounded concurrecy policies can grow
             {
                 std::size_t new_logical_page_count = 0;
                 std::size_t minimum_new_logical_page_count = 0;
-                calculate_quantities(size, new_logical_page_count, minimum_new_logical_page_count);
+                calculate_quantities(size + alignment, new_logical_page_count, minimum_new_logical_page_count);
 
                 char* new_buffer = nullptr;
                 new_buffer = static_cast<char*>(m_arena->allocate(m_logical_page_size * new_logical_page_count));
 
                 if (new_buffer == nullptr && new_logical_page_count > minimum_new_logical_page_count)  // Meeting grow_coefficient is not possible so lower the new_logical_page_count
                 {
-                    new_buffer = static_cast<char*>(m_arena->allocate(m_logical_page_size * minimum_new_logical_page_count));
+                    new_logical_page_count = minimum_new_logical_page_count;
+                    new_buffer = static_cast<char*>(m_arena->allocate(m_logical_page_size * new_logical_page_count));
                 }
 
                 if (!new_buffer)
@@ -757,7 +1213,7 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
 
                 if (first_new_logical_page)
                 {
-                    ret = first_new_logical_page->allocate(size);
+                    ret = allocate_from_logical_page(first_new_logical_page, size, alignment);
 
                     if (ret != nullptr)
                     {
@@ -797,6 +1253,54 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
             {
                 desired_new_logical_page_count = minimum_new_logical_page_count;
             }
+
+            if (m_logical_pages_per_block > 1)
+            {
+                // Grows are made of full blocks
+                minimum_new_logical_page_count = MultipleUtilities::get_next_pow2_multiple_of(minimum_new_logical_page_count, m_logical_pages_per_block);
+                desired_new_logical_page_count = MultipleUtilities::get_next_pow2_multiple_of(desired_new_logical_page_count, m_logical_pages_per_block);
+            }
+        }
+
+        template <typename Function>
+        static void for_each_linked_chunk(void* first, void* last, Function function)
+        {
+            void* iter = first;
+
+            while (true)
+            {
+                // Deallocations overwrite the first 8 bytes of chunks therefore the next pointer needs to be read before
+                void* next = *reinterpret_cast<void**>(iter);
+                bool is_last = iter == last;
+
+                function(iter);
+
+                if (is_last)
+                {
+                    break;
+                }
+
+                iter = next;
+            }
+        }
+
+        // Segment lock should be held. Chunks in the lockfree free list go back to their logical pages , so that empty logical pages can be recycled
+        std::size_t drain_central_free_list()
+        {
+            void* chunk = m_central_free_list.pop_all();
+            m_central_free_list.wait_for_pops(); // Pops which started before pop_all may still be reading next pointers of these chunks
+
+            std::size_t count = 0;
+
+            while (chunk != nullptr)
+            {
+                void* next = TaggedFreeList::get_next(chunk); // Deallocations overwrite the first 8 bytes of chunks therefore the next pointer needs to be read before
+                deallocate_internal(chunk);
+                chunk = next;
+                count++;
+            }
+
+            return count;
         }
 
         void deallocate_internal(void* ptr)
@@ -825,7 +1329,7 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
 
                 if constexpr (page_recycling_policy == PageRecyclingPolicy::IMMEDIATE)
                 {
-                    if (m_logical_page_count > m_page_recycling_threshold)
+                    if (m_logical_page_count > m_page_recycling_threshold && is_recyclable(affected))
                     {
                         recycle_logical_page(affected);
                     }
@@ -854,7 +1358,7 @@ class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
 
                         if constexpr (page_recycling_policy == PageRecyclingPolicy::IMMEDIATE)
                         {
-                            if (m_logical_page_count > m_page_recycling_threshold)
+                            if (m_logical_page_count > m_page_recycling_threshold && is_recyclable(iter))
                             {
                                 recycle_logical_page(iter);
                             }
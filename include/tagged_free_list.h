@@ -0,0 +1,164 @@
+/*
+    LOCKFREE MULTI PRODUCER MULTI CONSUMER STACK FOR STORING FREE MEMORY CHUNKS
+
+    - IT IS INTRUSIVE : FIRST 8 BYTES OF EACH PUSHED CHUNK HOLD THE NEXT POINTER. THEREFORE IT DOESN'T ALLOCATE ANY MEMORY
+
+    - AS BOTH PUSHES AND POPS HAPPEN CONCURRENTLY , THE HEAD IS TAGGED AGAINST THE ABA PROBLEM :
+      THE HEAD IS 16 BYTES , A POINTER AND A 64 BIT COUNTER WHICH IS INCREMENTED BY EVERY SUCCESSFUL OPERATION. IT IS UPDATED WITH A 128 BIT CAS ( cmpxchg16b ),
+      SO THE COUNTER DOESN'T WRAP AROUND IN PRACTICE
+
+    - A POP MAY READ THE NEXT POINTER OF A CHUNK WHICH HAS JUST BEEN POPPED BY ANOTHER THREAD. THAT READ IS DISCARDED BY THE FAILING CAS.
+      NEXT POINTERS ARE READ AND WRITTEN ATOMICALLY , USE set_next TO LINK CHUNKS WHICH MAY HAVE BEEN IN THE STACK
+
+    - pop_all DETACHES ALL CHUNKS AT ONCE. POPS WHICH STARTED BEFORE IT MAY STILL READ NEXT POINTERS OF DETACHED CHUNKS ,
+      THEREFORE wait_for_pops SHOULD BE CALLED BEFORE GIVING THE MEMORY OF DETACHED CHUNKS BACK TO THE SYSTEM.
+      POPS ARE COUNTED PER GENERATION , SO THAT wait_for_pops WAITS ONLY FOR THE POPS WHICH STARTED BEFORE IT. ONLY ONE THREAD SHOULD CALL IT AT A TIME
+
+    - METADATA USAGE : 32 BYTES
+*/
+#ifndef __TAGGED_FREE_LIST__
+#define __TAGGED_FREE_LIST__
+
+#include <cstddef>
+#include <cstdint>
+#include "compiler/builtin_functions.h"
+#include "compiler/hints_branch_predictor.h"
+#include "compiler/hints_hot_code.h"
+#include "cpu/pause.h"
+
+class alignas(16) TaggedFreeList
+{
+    public:
+
+        TaggedFreeList() = default;
+        ~TaggedFreeList() = default;
+
+        TaggedFreeList(const TaggedFreeList& other) = delete;
+        TaggedFreeList& operator= (const TaggedFreeList& other) = delete;
+        TaggedFreeList(TaggedFreeList&& other) = delete;
+        TaggedFreeList& operator=(TaggedFreeList&& other) = delete;
+
+        FORCE_INLINE uint64_t push(void* pointer)
+        {
+            return push_batch(pointer, pointer);
+        }
+
+        // Pushes a list of chunks which are already linked through their first 8 bytes , with a single CAS
+        // Returns the new tag , callers can use it as an operation counter
+        FORCE_INLINE uint64_t push_batch(void* first, void* last)
+        {
+            uint64_t expected_head[2];
+            load_head(expected_head);
+
+            while (true)
+            {
+                set_next(last, reinterpret_cast<void*>(expected_head[0]));
+
+                if (likely(builtin_cas128(m_head, expected_head, reinterpret_cast<uint64_t>(first), expected_head[1] + 1)))
+                {
+                    return expected_head[1] + 1;
+                }
+            }
+        }
+
+        FORCE_INLINE [[nodiscard]] void* pop()
+        {
+            uint32_t* pops_in_flight = begin_pop();
+
+            uint64_t expected_head[2];
+            load_head(expected_head);
+            void* ret = nullptr;
+
+            while (expected_head[0] != 0)
+            {
+                // If another thread popped the head meanwhile , the tag will be different and the CAS below will fail
+                Node* head_node = reinterpret_cast<Node*>(expected_head[0]);
+                uint64_t next = builtin_atomic_load64(&head_node->m_next);
+
+                if (likely(builtin_cas128(m_head, expected_head, next, expected_head[1] + 1)))
+                {
+                    ret = head_node;
+                    break;
+                }
+            }
+
+            builtin_atomic_fetch_add32(pops_in_flight, static_cast<uint32_t>(-1));
+            return ret;
+        }
+
+        // Detaches all chunks with a single CAS and returns the first one , they are linked through their first 8 bytes
+        [[nodiscard]] void* pop_all()
+        {
+            uint64_t expected_head[2];
+            load_head(expected_head);
+
+            while (builtin_cas128(m_head, expected_head, 0, expected_head[1] + 1) == false)
+            {
+            }
+
+            return reinterpret_cast<void*>(expected_head[0]);
+        }
+
+        // Returns when no pop can read next pointers of the chunks detached by the previous pop_all
+        void wait_for_pops()
+        {
+            uint32_t generation = builtin_atomic_fetch_add32(&m_pop_generation, 1);
+
+            while (builtin_atomic_load32(&m_pops_in_flight[generation & 1]) != 0)
+            {
+                pause(100);
+            }
+        }
+
+        bool is_empty()
+        {
+            return builtin_atomic_load64(&m_head[0]) == 0;
+        }
+
+        static FORCE_INLINE void* get_next(void* chunk)
+        {
+            return reinterpret_cast<void*>(builtin_atomic_load64(&static_cast<Node*>(chunk)->m_next));
+        }
+
+        static FORCE_INLINE void set_next(void* chunk, void* next)
+        {
+            builtin_atomic_store64(&static_cast<Node*>(chunk)->m_next, reinterpret_cast<uint64_t>(next));
+        }
+
+    private:
+        struct Node
+        {
+            uint64_t m_next;
+        };
+
+        uint64_t m_head[2] = {0, 0};            // Pointer and tag , updated together with 128 bit CAS
+        uint32_t m_pops_in_flight[2] = {0, 0};  // Per pop generation
+        uint32_t m_pop_generation = 0;
+
+        FORCE_INLINE void load_head(uint64_t* head)
+        {
+            // A torn read is harmless as the CAS compares both halves
+            head[1] = builtin_atomic_load64(&m_head[1]);
+            head[0] = builtin_atomic_load64(&m_head[0]);
+        }
+
+        // Counts the pop in the current generation. If the generation changes meanwhile , wait_for_pops may have missed the count so it is retried
+        FORCE_INLINE uint32_t* begin_pop()
+        {
+            while (true)
+            {
+                uint32_t generation = builtin_atomic_load32(&m_pop_generation);
+                uint32_t* pops_in_flight = &m_pops_in_flight[generation & 1];
+                builtin_atomic_fetch_add32(pops_in_flight, 1);
+
+                if (likely(builtin_atomic_load32(&m_pop_generation) == generation))
+                {
+                    return pops_in_flight;
+                }
+
+                builtin_atomic_fetch_add32(pops_in_flight, static_cast<uint32_t>(-1));
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,173 @@
+/*
+    PER THREAD CACHE BETWEEN A CENTRAL HEAP AND A THREAD LOCAL HEAP
+
+    - USED AFTER A LOCAL HEAP IS EXHAUSTED FOR A SIZE CLASS. INSTEAD OF LOCKING THE CENTRAL HEAP FOR EACH ALLOCATION ,
+      IT TAKES A BATCH OF CHUNKS FROM THE CENTRAL HEAP IN ONE GO AND SERVES ALLOCATIONS FROM THEM
+
+    - DEALLOCATED CENTRAL HEAP CHUNKS ARE COLLECTED AND RETURNED TO THE CENTRAL HEAP IN BATCHES IN THE SAME WAY.
+      THEY ARE NOT REUSED FOR ALLOCATIONS AS THEY MAY BE PADDED POINTERS OF ALIGNED ALLOCATIONS , HEAPS KNOW HOW TO UNPAD THEM
+
+    - EACH ENTRY IS FOR ONE SIZE CLASS. WHEN ALL ENTRIES ARE IN USE , ENTRIES ARE EVICTED IN ROUND ROBIN
+
+    - IT IS INTRUSIVE : FIRST 8 BYTES OF CACHED CHUNKS HOLD NEXT POINTERS. THEREFORE IT DOESN'T ALLOCATE ANY MEMORY
+
+    - IT IS NOT THREAD SAFE , IT IS SUPPOSED TO BE USED ONLY BY ITS OWNER THREAD
+
+    - HEAPS NEED TO IMPLEMENT 'std::size_t allocate_batch(std::size_t size, std::size_t count, void** first)' AND 'void deallocate_batch(void* first, void* last)'
+*/
+#ifndef __TRANSFER_CACHE__
+#define __TRANSFER_CACHE__
+
+#include <cstddef>
+#include <cstdint>
+#include "compiler/hints_branch_predictor.h"
+#include "compiler/hints_hot_code.h"
+
+template <typename HeapType, std::size_t entry_count = 8>
+class TransferCache
+{
+    public:
+
+        TransferCache() = default;
+        ~TransferCache() = default;
+
+        TransferCache(const TransferCache& other) = delete;
+        TransferCache& operator= (const TransferCache& other) = delete;
+        TransferCache(TransferCache&& other) = delete;
+        TransferCache& operator=(TransferCache&& other) = delete;
+
+        // Returns nullptr if there is no cached chunk for the size class , then 'refill' should be called
+        FORCE_INLINE [[nodiscard]] void* allocate(std::size_t size_class)
+        {
+            Entry* entry = find_entry(size_class);
+
+            if (entry == nullptr || entry->m_free_head == nullptr)
+            {
+                return nullptr;
+            }
+
+            void* ret = entry->m_free_head;
+            entry->m_free_head = *reinterpret_cast<void**>(ret);
+            return ret;
+        }
+
+        // Takes up to 'batch_size' chunks from the heap with a single call. Returns the number of taken chunks
+        std::size_t refill(HeapType* heap, std::size_t size, std::size_t size_class, std::size_t batch_size)
+        {
+            Entry* entry = get_or_create_entry(heap, size_class);
+
+            // Called only after 'allocate' returned nullptr , so the entry has no free chunks
+            return heap->allocate_batch(size, batch_size, &entry->m_free_head);
+        }
+
+        // Collects a deallocated chunk of the heap , returns collected ones to the heap when 'batch_size' of them accumulate
+        FORCE_INLINE void deallocate(HeapType* heap, std::size_t size_class, void* pointer, std::size_t batch_size)
+        {
+            Entry* entry = get_or_create_entry(heap, size_class);
+
+            if (entry->m_returned_first == nullptr)
+            {
+                entry->m_returned_last = pointer;
+            }
+
+            *reinterpret_cast<void**>(pointer) = entry->m_returned_first;
+            entry->m_returned_first = pointer;
+            entry->m_returned_count++;
+
+            if (entry->m_returned_count >= batch_size)
+            {
+                return_collected_chunks(heap, entry);
+            }
+        }
+
+        // Returns all cached chunks to the heap
+        void flush(HeapType* heap)
+        {
+            for (std::size_t i = 0; i < entry_count; i++)
+            {
+                flush_entry(heap, &m_entries[i]);
+            }
+        }
+
+    private:
+
+        struct Entry
+        {
+            void* m_free_head = nullptr;
+            void* m_returned_first = nullptr;
+            void* m_returned_last = nullptr;
+            uint32_t m_size_class = 0;      // 0 means that the entry is not in use
+            uint32_t m_returned_count = 0;
+        };
+
+        Entry m_entries[entry_count];
+        std::size_t m_next_evicted_entry_index = 0;
+
+        FORCE_INLINE Entry* find_entry(std::size_t size_class)
+        {
+            for (std::size_t i = 0; i < entry_count; i++)
+            {
+                if (m_entries[i].m_size_class == size_class)
+                {
+                    return &m_entries[i];
+                }
+            }
+
+            return nullptr;
+        }
+
+        Entry* get_or_create_entry(HeapType* heap, std::size_t size_class)
+        {
+            Entry* entry = find_entry(size_class);
+
+            if (likely(entry != nullptr))
+            {
+                return entry;
+            }
+
+            entry = find_entry(0);
+
+            if (entry == nullptr)
+            {
+                entry = &m_entries[m_next_evicted_entry_index];
+                m_next_evicted_entry_index = (m_next_evicted_entry_index + 1) % entry_count;
+                flush_entry(heap, entry);
+            }
+
+            entry->m_size_class = static_cast<uint32_t>(size_class);
+            return entry;
+        }
+
+        void return_collected_chunks(HeapType* heap, Entry* entry)
+        {
+            if (entry->m_returned_first != nullptr)
+            {
+                heap->deallocate_batch(entry->m_returned_first, entry->m_returned_last);
+            }
+
+            entry->m_returned_first = nullptr;
+            entry->m_returned_last = nullptr;
+            entry->m_returned_count = 0;
+        }
+
+        void flush_entry(HeapType* heap, Entry* entry)
+        {
+            if (entry->m_free_head != nullptr)
+            {
+                void* last = entry->m_free_head;
+
+                while (*reinterpret_cast<void**>(last) != nullptr)
+                {
+                    last = *reinterpret_cast<void**>(last);
+                }
+
+                heap->deallocate_batch(entry->m_free_head, last);
+                entry->m_free_head = nullptr;
+            }
+
+            return_collected_chunks(heap, entry);
+            entry->m_size_class = 0;
+        }
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef __DIVISION_UTILITIES_H__
+#define __DIVISION_UTILITIES_H__
+
+#include <cassert>
+#include <cstdint>
+#include "../compiler/builtin_functions.h"
+
+class DivisionUtilities
+{
+    public:
+
+        // Precomputed once per divisor. Reference : Lemire, Kaser, Kurz - Faster Remainder by Direct Computation
+        static uint64_t get_reciprocal(uint32_t divisor)
+        {
+            assert(divisor > 1);
+            return UINT64_MAX / divisor + 1;
+        }
+
+        // Exact for all 32 bit dividends and divisors , replaces a division with a multiplication
+        static uint32_t divide_by_reciprocal(uint32_t dividend, uint64_t reciprocal)
+        {
+            return static_cast<uint32_t>(builtin_mulhi64(reciprocal, static_cast<uint64_t>(dividend)));
+        }
+};
+
+#endif
@@ -31,6 +31,19 @@ class Pow2Utilities
             return input + 1;
         }
 
+        // For sizes known at compile time , for ex sizeof(T)
+        static constexpr std::size_t compile_time_first_pow2_of(std::size_t input)
+        {
+            std::size_t ret = 1;
+
+            while (ret < input)
+            {
+                ret <<= 1;
+            }
+
+            return ret;
+        }
+
         static bool is_power_of_two(std::size_t input)
         {
             if (input == 0)
@@ -28,6 +28,14 @@ class SizeUtilities
             return index;
         }
 
+        // Same as above for sizes known at compile time
+        template <std::size_t MINIMUM_SIZE_CLASS, std::size_t MAX_BIN_INDEX>
+        static constexpr std::size_t compile_time_get_pow2_bin_index_from_size(std::size_t size)
+        {
+            std::size_t index = Log2Utilities::compile_time_log2(static_cast<unsigned int>(size)) - Log2Utilities::compile_time_log2(MINIMUM_SIZE_CLASS);
+            return index > MAX_BIN_INDEX ? MAX_BIN_INDEX : index;
+        }
+
         static std::size_t get_required_page_count_for_allocation(std::size_t page_size, std::size_t page_header_size, std::size_t object_size, std::size_t object_count)
         {
             std::size_t object_count_per_page = static_cast<std::size_t>(std::ceil( (page_size - page_header_size) / object_size));
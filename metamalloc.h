@@ -42,6 +42,9 @@ SOFTWARE.
 #include <string_view>
 #include <new>
 #include <iterator>
+#include <chrono>
+#include <memory_resource>
+#include <utility>
 // CPU INTRINSICS
 #include <immintrin.h>
 #if defined(_MSC_VER)
@@ -206,6 +209,71 @@ inline int builtin_clz(unsigned long value) // Implementation is for 32-bit only
 #define builtin_cas(pointer, old_value, new_value) _InterlockedCompareExchange(reinterpret_cast<long*>(pointer), new_value, old_value)
 #endif
 
+//////////////////////////////////////////////////////////////////////
+// 64 bit compare and swap, exchange and load. For lockfree lists embedded in packed headers
+#if defined(__GNUC__)
+#define builtin_cas64(pointer, old_value, new_value) __sync_val_compare_and_swap(pointer, old_value, new_value)
+#define builtin_atomic_exchange64(pointer, new_value) __atomic_exchange_n(pointer, new_value, __ATOMIC_ACQ_REL)
+#define builtin_atomic_load64(pointer) __atomic_load_n(pointer, __ATOMIC_ACQUIRE)
+#elif defined(_MSC_VER)
+#define builtin_cas64(pointer, old_value, new_value) static_cast<uint64_t>(_InterlockedCompareExchange64(reinterpret_cast<volatile long long*>(pointer), static_cast<long long>(new_value), static_cast<long long>(old_value)))
+#define builtin_atomic_exchange64(pointer, new_value) static_cast<uint64_t>(_InterlockedExchange64(reinterpret_cast<volatile long long*>(pointer), static_cast<long long>(new_value)))
+#define builtin_atomic_load64(pointer) (*reinterpret_cast<volatile uint64_t*>(pointer))
+#endif
+
+#if defined(__GNUC__)
+#define builtin_atomic_store64(pointer, new_value) __atomic_store_n(pointer, new_value, __ATOMIC_RELEASE)
+#elif defined(_MSC_VER)
+#define builtin_atomic_store64(pointer, new_value) (*reinterpret_cast<volatile uint64_t*>(pointer) = static_cast<uint64_t>(new_value))
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// 32 bit fetch-add and load with sequential consistency. For counters which are read by other threads right after a CAS
+#if defined(__GNUC__)
+#define builtin_atomic_fetch_add32(pointer, value) __atomic_fetch_add(pointer, value, __ATOMIC_SEQ_CST)
+#define builtin_atomic_load32(pointer) __atomic_load_n(pointer, __ATOMIC_SEQ_CST)
+#elif defined(_MSC_VER)
+#define builtin_atomic_fetch_add32(pointer, value) static_cast<uint32_t>(_InterlockedExchangeAdd(reinterpret_cast<volatile long*>(pointer), static_cast<long>(value)))
+#define builtin_atomic_load32(pointer) (*reinterpret_cast<volatile uint32_t*>(pointer))
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// 128 bit compare and swap ( cmpxchg16b ). 'pointer' should be 16 byte aligned , 'expected' holds the low and the high 64 bits
+// Returns true on success. On failure 'expected' is updated to the current value
+// Inline assembly is used with GCC as __sync and __atomic 128 bit builtins need -mcx16 or libatomic
+#if defined(__GNUC__)
+inline bool builtin_cas128(uint64_t* pointer, uint64_t* expected, uint64_t new_low, uint64_t new_high)
+{
+#if defined(__SANITIZE_THREAD__)
+    // Thread sanitizer can't see inline assembly
+    unsigned __int128 desired = (static_cast<unsigned __int128>(new_high) << 64) | new_low;
+    return __atomic_compare_exchange_n(reinterpret_cast<unsigned __int128*>(pointer), reinterpret_cast<unsigned __int128*>(expected), desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#else
+    bool result;
+    __asm__ __volatile__
+    (
+        "lock cmpxchg16b %1\n\t"
+        "setz %0"
+        : "=q"(result), "+m"(*reinterpret_cast<volatile unsigned __int128*>(pointer)), "+a"(expected[0]), "+d"(expected[1])
+        : "b"(new_low), "c"(new_high)
+        : "cc", "memory"
+    );
+    return result;
+#endif
+
+}
+#elif defined(_MSC_VER)
+#define builtin_cas128(pointer, expected, new_low, new_high) (_InterlockedCompareExchange128(reinterpret_cast<volatile long long*>(pointer), static_cast<long long>(new_high), static_cast<long long>(new_low), reinterpret_cast<long long*>(expected)) != 0)
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// High 64 bits of 64bit x 64bit multiplication
+#if defined(__GNUC__)
+#define builtin_mulhi64(first, second)  static_cast<uint64_t>((static_cast<unsigned __int128>(first) * static_cast<unsigned __int128>(second)) >> 64)
+#elif defined(_MSC_VER)
+#define builtin_mulhi64(first, second)  __umulh(first, second)
+#endif
+
 //////////////////////////////////////////////////////////////////////
 // memcpy
 #if defined(__GNUC__)
@@ -857,6 +925,40 @@ class VirtualMemory
             return ret;
         }
 
+        // Unlike allocate , it doesn't populate pages. For big regions which may stay mostly unused
+        // On Linux pages are backed by physical memory when they are touched. On Windows they are only reserved , they have to be committed before they are touched , see commit
+        static void* reserve(std::size_t size)
+        {
+            void* ret = nullptr;
+            #ifdef __linux__
+            ret = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+            if (ret == MAP_FAILED)
+            {
+                ret = nullptr;
+            }
+            #elif _WIN32
+            ret = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS); // Doesn't charge the commit limit
+            #endif
+
+            return ret;
+        }
+
+        // For reserved pages , see reserve. Committed pages get physical memory on first access
+        static bool commit(void* address, std::size_t size)
+        {
+            bool ret{ false };
+            #ifdef __linux__
+            UNUSED(address);
+            UNUSED(size);
+            ret = true; // Reserved pages are already accessible
+            #elif _WIN32
+            ret = VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr ? true : false;
+            #endif
+
+            return ret;
+        }
+
         static bool deallocate(void* address, std::size_t size)
         {
             bool ret{ false };
@@ -1439,22 +1541,24 @@ class EnvironmentVariable
         }
 
         // Utility function when handling csv numeric parameters from environment variables, does not allocate memory
-        static void set_numeric_array_from_comma_separated_value_string(std::size_t* target_array, const char* str)
+        // Values beyond the array length are ignored , elements without values keep their current values
+        template <std::size_t array_length>
+        static void set_numeric_array_from_comma_separated_value_string(std::size_t (&target_array)[array_length], const char* str)
         {
             auto len = strlen(str);
 
-            constexpr std::size_t MAX_STRING_LEN = 64;
+            constexpr std::size_t MAX_STRING_LEN = 512; // Enough for page counts of heaps with many bins , for ex 40 bins of SimpleHeapFineGrained
             constexpr std::size_t MAX_TOKEN_LEN = 8;
             std::size_t start = 0;
             std::size_t end = 0;
             std::size_t counter = 0;
 
-            while (end <= len && end < MAX_STRING_LEN - 1)
+            while (end <= len && end < MAX_STRING_LEN - 1 && counter < array_length)
             {
                 if (str[end] == ',' || (end > start && end == len))
                 {
                     char token[MAX_TOKEN_LEN];
-                    std::size_t token_len = end - start;
+                    std::size_t token_len = end - start < MAX_TOKEN_LEN - 1 ? end - start : MAX_TOKEN_LEN - 1;
 
                     #ifdef __linux__
                     strncpy(token, str + start, token_len);
@@ -1601,6 +1705,19 @@ class Pow2Utilities
             return input + 1;
         }
 
+        // For sizes known at compile time , for ex sizeof(T)
+        static constexpr std::size_t compile_time_first_pow2_of(std::size_t input)
+        {
+            std::size_t ret = 1;
+
+            while (ret < input)
+            {
+                ret <<= 1;
+            }
+
+            return ret;
+        }
+
         static bool is_power_of_two(std::size_t input)
         {
             if (input == 0)
@@ -1640,6 +1757,29 @@ class ModuloUtilities
 };
 
 #endif
+#ifndef __DIVISION_UTILITIES_H__
+#define __DIVISION_UTILITIES_H__
+
+class DivisionUtilities
+{
+    public:
+
+        // Precomputed once per divisor. Reference : Lemire, Kaser, Kurz - Faster Remainder by Direct Computation
+        static uint64_t get_reciprocal(uint32_t divisor)
+        {
+            assert(divisor > 1);
+            return UINT64_MAX / divisor + 1;
+        }
+
+        // Exact for all 32 bit dividends and divisors , replaces a division with a multiplication
+        static uint32_t divide_by_reciprocal(uint32_t dividend, uint64_t reciprocal)
+        {
+            return static_cast<uint32_t>(builtin_mulhi64(reciprocal, static_cast<uint64_t>(dividend)));
+        }
+};
+
+#endif
+
 #ifndef __MULTIPLE_UTILITIES_H__
 #define __MULTIPLE_UTILITIES_H__
 
@@ -1683,6 +1823,14 @@ class SizeUtilities
             return index;
         }
 
+        // Same as above for sizes known at compile time
+        template <std::size_t MINIMUM_SIZE_CLASS, std::size_t MAX_BIN_INDEX>
+        static constexpr std::size_t compile_time_get_pow2_bin_index_from_size(std::size_t size)
+        {
+            std::size_t index = Log2Utilities::compile_time_log2(static_cast<unsigned int>(size)) - Log2Utilities::compile_time_log2(MINIMUM_SIZE_CLASS);
+            return index > MAX_BIN_INDEX ? MAX_BIN_INDEX : index;
+        }
+
         static std::size_t get_required_page_count_for_allocation(std::size_t page_size, std::size_t page_header_size, std::size_t object_size, std::size_t object_count)
         {
             std::size_t object_count_per_page = static_cast<std::size_t>(std::ceil( (page_size - page_header_size) / object_size));
@@ -2256,6 +2404,113 @@ class ArenaBase
 };
 
 #endif
+/*
+    LOCKFREE MULTI PRODUCER SINGLE CONSUMER QUEUE FOR STORING POINTERS OF DEALLOCATED MEMORY CHUNKS
+
+    - IT IS INTRUSIVE : FIRST 8 BYTES OF EACH PUSHED CHUNK HOLD THE NEXT POINTER. THEREFORE IT DOESN'T ALLOCATE ANY MEMORY
+      AND ITS MEMORY USAGE DOESN'T DEPEND ON ITS DEPTH. PUSHED POINTERS SHOULD POINT TO AT LEAST 8 BYTES WHICH ARE NOT IN USE ANYMORE
+
+    - PRODUCERS CAS-PUSH TO THE SHARED HEAD. THE CONSUMER TAKES THE ENTIRE SHARED LIST WITH A SINGLE ATOMIC EXCHANGE
+      AND POPS FROM ITS PRIVATE LIST. AS ONLY PUSHES HAPPEN CONCURRENTLY , THERE IS NO ABA PROBLEM
+
+    - POP ORDER IS LIFO WITHIN EACH TAKEN LIST
+
+    - METADATA USAGE : 16 BYTES. IT IS NOT CACHE LINE PADDED AS THREAD LOCAL HEAPS AND THEIR SEGMENTS ARE PLACED IN A FIXED SIZE METADATA BUFFER
+*/
+#ifndef __DEALLOCATION_QUEUE__
+#define __DEALLOCATION_QUEUE__
+
+class DeallocationQueue
+{
+    public:
+
+        DeallocationQueue() = default;
+        ~DeallocationQueue() = default;
+
+        DeallocationQueue(const DeallocationQueue& other) = delete;
+        DeallocationQueue& operator= (const DeallocationQueue& other) = delete;
+        DeallocationQueue(DeallocationQueue&& other) = delete;
+        DeallocationQueue& operator=(DeallocationQueue&& other) = delete;
+
+        // Can be called from any thread
+        FORCE_INLINE void push(void* pointer)
+        {
+            QueueNode* new_node = static_cast<QueueNode*>(pointer);
+            uint64_t expected_head = builtin_atomic_load64(&m_shared_head);
+
+            while (true)
+            {
+                new_node->m_next = reinterpret_cast<QueueNode*>(expected_head);
+
+                uint64_t previous_head = builtin_cas64(&m_shared_head, expected_head, reinterpret_cast<uint64_t>(new_node));
+
+                if (likely(previous_head == expected_head))
+                {
+                    break;
+                }
+
+                expected_head = previous_head;
+            }
+        }
+
+        // Can be called from any thread
+        // Pushes a list of chunks which are already linked through their first 8 bytes , with a single CAS
+        FORCE_INLINE void push_batch(void* first, void* last)
+        {
+            QueueNode* first_node = static_cast<QueueNode*>(first);
+            QueueNode* last_node = static_cast<QueueNode*>(last);
+            uint64_t expected_head = builtin_atomic_load64(&m_shared_head);
+
+            while (true)
+            {
+                last_node->m_next = reinterpret_cast<QueueNode*>(expected_head);
+
+                uint64_t previous_head = builtin_cas64(&m_shared_head, expected_head, reinterpret_cast<uint64_t>(first_node));
+
+                if (likely(previous_head == expected_head))
+                {
+                    break;
+                }
+
+                expected_head = previous_head;
+            }
+        }
+
+        // Should be called only by the consumer
+        FORCE_INLINE [[nodiscard]] void* pop()
+        {
+            if (m_consumer_head == nullptr)
+            {
+                if (builtin_atomic_load64(&m_shared_head) == 0)
+                {
+                    return nullptr;
+                }
+
+                m_consumer_head = reinterpret_cast<QueueNode*>(builtin_atomic_exchange64(&m_shared_head, static_cast<uint64_t>(0)));
+
+                if (unlikely(m_consumer_head == nullptr))
+                {
+                    return nullptr;
+                }
+            }
+
+            QueueNode* ret = m_consumer_head;
+            m_consumer_head = ret->m_next;
+            return ret;
+        }
+
+    private:
+        struct QueueNode
+        {
+            QueueNode* m_next;
+        };
+
+        uint64_t m_shared_head = 0;
+        QueueNode* m_consumer_head = nullptr;
+};
+
+#endif
+
 /*
     - ARENA ABSTRACTION REDUCES SYSCALLS BY CACHING AND SERVING VIRTUAL MEMORY PAGES.
       ( SOME ALLOCATORS LIKE JEMALLOC USES THE ARENA TERM DIFFERENTLY : AS THE HIGHEST LAYER ALLOCATOR WHICH OWNS MULTIPLE HEAPS.
@@ -2269,6 +2524,8 @@ class ArenaBase
 
     - SUPPORTS NO LOCKING AND LOCKING (EITHER OS_LOCK OR USERSPACE_SPINLOCK) SO THAT IT CAN BE USED BY A SINGLE HEAP OR SHARED BY MULTIPLE HEAPS
 
+    - RELEASES CAN BE DEFERRED TO A HELPER THREAD ( SEE set_deferred_release ) , SO THAT CALLERS DON'T STALL IN MUNMAP AND ITS TLB SHOOTDOWNS
+
     - lock_pages & unlock_pages METHODS CAN BE USED SO THAT THE SYSTEM WILL NOT SWAP PAGES TO THE PAGING FILE
 
     - LINUX ALLOCATION GRANULARITY IS 4KB (4096) , OTH IT IS 64KB ( 16 * 4096 ) ON WINDOWS .
@@ -2312,6 +2569,7 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
 
         ~Arena()
         {
+            process_deferred_releases();
             destroy();
         }
 
@@ -2330,6 +2588,7 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
             this->enter_concurrent_context();
             //////////////////////////////////////////////////
             m_page_alignment = page_alignment;
+            m_cache_capacity = cache_capacity;
             auto ret =  build_cache(cache_capacity);
             //////////////////////////////////////////////////
             this->leave_concurrent_context();
@@ -2345,9 +2604,10 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
                 std::size_t release_start_address = reinterpret_cast<std::size_t>(m_cache_buffer + m_cache_used_size);
                 std::size_t release_end_address = reinterpret_cast<std::size_t>(m_cache_buffer + m_cache_size);
 
+                // Not deferred as writing the size into them would touch never-requested pages
                 for (; release_start_address < release_end_address; release_start_address += m_vm_page_size)
                 {
-                    release_to_system(reinterpret_cast<void *>(release_start_address), m_vm_page_size);
+                    VirtualMemory::deallocate(reinterpret_cast<void *>(release_start_address), m_vm_page_size);
                 }
 
             }
@@ -2378,6 +2638,31 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
             return ret;
         }
 
+        // Rebuilds the cache in advance if 'low_watermark' bytes can't be served from it , so that allocations after it don't need to build the cache
+        // It is for calling from a background thread. Returns false if the system is out of memory
+        [[nodiscard]] bool replenish_cache(std::size_t low_watermark)
+        {
+            bool ret = true;
+
+            this->enter_concurrent_context();
+            //////////////////////////////////////////////////
+            // Same check as allocate
+            if (low_watermark + m_page_alignment > (m_cache_size - m_cache_used_size))
+            {
+                destroy();
+
+                std::size_t required_size = MultipleUtilities::get_next_pow2_multiple_of(low_watermark + m_page_alignment, m_page_alignment);
+                ret = build_cache(required_size > m_cache_capacity ? required_size : m_cache_capacity);
+            }
+            //////////////////////////////////////////////////
+            this->leave_concurrent_context();
+
+            return ret;
+        }
+
+        // Bytes which can be served without building the cache
+        std::size_t get_available_cache_size() const { return m_cache_size > m_cache_used_size ? m_cache_size - m_cache_used_size : 0; }
+
         std::size_t page_size()const { return m_vm_page_size; }
         std::size_t page_alignment() const { return m_page_alignment; }
 
@@ -2427,9 +2712,35 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
 
         void release_to_system(void* address, std::size_t size)
         {
+            if (m_deferred_release)
+            {
+                // Released pages are not in use anymore , so they hold their own queue node and size
+                reinterpret_cast<std::size_t*>(address)[1] = size;
+                m_deferred_release_queue.push(address);
+                return;
+            }
+
             VirtualMemory::deallocate(address, size);
         }
 
+        // When enabled , release_to_system only queues pages with a lockfree push and process_deferred_releases gives them back to the system
+        void set_deferred_release(bool deferred_release) { m_deferred_release = deferred_release; }
+
+        // Should be called by only one thread at a time , for ex a helper thread. Returns the number of released buffers
+        std::size_t process_deferred_releases()
+        {
+            std::size_t released_count = 0;
+            void* address = nullptr;
+
+            while ((address = m_deferred_release_queue.pop()) != nullptr)
+            {
+                VirtualMemory::deallocate(address, reinterpret_cast<std::size_t*>(address)[1]);
+                released_count++;
+            }
+
+            return released_count;
+        }
+
         class MetadataAllocator
         {
             public:
@@ -2452,8 +2763,11 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
         std::size_t m_vm_page_size = 0;
         std::size_t m_page_alignment = 0;
         char* m_cache_buffer = nullptr;
+        std::size_t m_cache_capacity = 0; // Size passed to create , used when the cache is replenished
         std::size_t m_cache_size = 0;
         std::size_t m_cache_used_size = 0;
+        bool m_deferred_release = false;
+        DeallocationQueue m_deferred_release_queue;
 
         #ifdef ENABLE_STATS
         ArenaStats m_stats;
@@ -2495,8 +2809,10 @@ class Arena : public Lockable<lock_policy>, public ArenaBase<Arena<lock_policy,
 
     WE USE 2 BYTES FOR PADDING AS THIS IS TO ENSURE THAT ALL ALLOCATIONS WILL BE AT LEAST 16-BIT ALIGNED
 
+    8 BYTE MEMBERS COME FIRST SO THAT THEY ARE NATURALLY ALIGNED EVEN THOUGH THE STRUCT IS PACKED. ( m_thread_free_head IS UPDATED WITH ATOMIC INSTRUCTIONS )
+
     PAHOLE OUTPUT :
-                            size: 64, cachelines: 1, members: 10
+                            size: 64, cachelines: 1, members: 11
                             last cacheline: 64 bytes
 */
 #ifndef __LOGICAL_PAGE_HEADER_H__
@@ -2520,18 +2836,20 @@ PACKED
             uint64_t m_next_logical_page_ptr;  // To be used by an upper layer abstraction (ex: segment span etc ) to navigate between logical pages
             // 8 BYTES
             uint64_t m_prev_logical_page_ptr;  // Same as above
-            // 2 BYTES
-            uint16_t m_page_flags;               // See enum class LogicalPageHeaderFlags
-            // 4 BYTES
-            uint32_t m_size_class;               // Used to distinguish non-big size class pages    , since logical pages won't be holding objects > page size, 2 bytes will be sufficient
-            // 8 BYTES
-            uint64_t m_used_size;
             // 8 BYTES
             uint64_t m_logical_page_start_address;
             // 8 BYTES
-            uint64_t m_logical_page_size;
+            uint64_t m_thread_free_head;        // Freelist that non-owner threads push to with CAS. Kept 8 byte aligned as it is accessed atomically
             // 8 BYTES
-            uint64_t m_last_used_node;
+            uint64_t m_size_class_reciprocal;   // ceil(2^64 / size class) , to find chunk starts with a multiplication instead of a division , see DivisionUtilities
+            // 4 BYTES
+            uint32_t m_used_size;                // Logical pages are limited to 4GB
+            // 4 BYTES
+            uint32_t m_logical_page_size;
+            // 4 BYTES
+            uint32_t m_size_class;               // Used to distinguish non-big size class pages    , since logical pages won't be holding objects > page size, 2 bytes will be sufficient
+            // 2 BYTES
+            uint16_t m_page_flags;               // See enum class LogicalPageHeaderFlags
             // 2 BYTES
             char m_padding_bytes[2];
 
@@ -2543,12 +2861,13 @@ PACKED
                 m_head = 0;
                 m_next_logical_page_ptr = 0;
                 m_prev_logical_page_ptr = 0;
-                m_page_flags = 0;
-                m_size_class = 0;
-                m_used_size = 0;
                 m_logical_page_start_address = 0;
+                m_thread_free_head = 0;
+                m_size_class_reciprocal = 0;
+                m_used_size = 0;
                 m_logical_page_size = 0;
-                m_last_used_node = 0;
+                m_size_class = 0;
+                m_page_flags = 0;
             }
 
             template<LogicalPageHeaderFlags flag>
@@ -2612,6 +2931,7 @@ class LogicalPageBase
 
         void mark_as_locked() { m_page_header.set_flag<LogicalPageHeaderFlags::IS_LOCKED>(); }
         void mark_as_non_locked() { m_page_header.clear_flag<LogicalPageHeaderFlags::IS_LOCKED>(); }
+        bool is_locked() const { return m_page_header.get_flag<LogicalPageHeaderFlags::IS_LOCKED>(); }
 
         uint64_t get_used_size() const { return m_page_header.m_used_size; }
         uint32_t get_size_class() { return m_page_header.m_size_class; }
@@ -2635,6 +2955,9 @@ class LogicalPageBase
 /*
     - IT IS A FIRST-IN-LAST-OUT FREELIST IMPLEMENTATION. IT CAN HOLD ONLY ONE SIZE CLASS. ALLOCATE METHOD WILL IGNORE THE SIZE PARAMETER
 
+    - SIZE CLASSES DON'T NEED TO BE POWER OF TWO. DEALLOCATIONS OF PADDED POINTERS ARE MAPPED TO CHUNK STARTS WITH A PRECOMPUTED RECIPROCAL MULTIPLICATION
+      SIZE CLASSES SHOULD BE MULTIPLES OF 16 IN ORDER TO KEEP THE MINIMUM ALIGNMENT GUARANTEE. MAXIMUM BUFFER SIZE IS 4GB
+
     - IF THE PASSED BUFFER IS START OF A VIRTUAL PAGE AND THE PASSED SIZE IS A VM PAGE SIZE , THEN IT WILL BE CORRESPONDING TO AN ACTUAL VM PAGE
       IDEAL USE CASE IS ITS CORRESPONDING TO A VM PAGE / BEING VM PAGE ALIGNED. SO THAT A SINGLE PAYLOAD WILL NOT SPREAD TO DIFFERENT VM PAGES
 
@@ -2645,6 +2968,9 @@ class LogicalPageBase
     - DOESN'T SUPPORT ALIGNMENT. ALLOCATE METHOD WILL IGNORE THE ALIGNMENT PARAMETER
 
     - METADATA USAGE : 64 BYTES (PAGE HEADER) PER LOGICAL PAGE
+
+    - HAS 2 FREELISTS LIKE MIMALLOC PAGES : THE LOCAL FREELIST WHICH IS ACCESSED ONLY BY THE OWNER AND THE THREAD FREE LIST WHICH OTHER THREADS PUSH TO ATOMICALLY.
+      THE OWNER MOVES THE ENTIRE THREAD FREE LIST TO THE LOCAL FREELIST WITH A SINGLE ATOMIC EXCHANGE. SEE collect_thread_free_list
 */
 #ifndef __LOGICAL_PAGE_H__
 #define __LOGICAL_PAGE_H__
@@ -2674,7 +3000,7 @@ class LogicalPage : public LogicalPageBase<LogicalPage<adjust_padded_pointers, N
         [[nodiscard]] bool create(void* buffer, const std::size_t buffer_size, uint32_t size_class)
         {
             // Chunk size can't be smaller than a 'next' pointer-or-offset which is 64bit
-            if (buffer == nullptr || buffer_size < size_class || size_class < sizeof(uint64_t))
+            if (buffer == nullptr || buffer_size < size_class || size_class < sizeof(uint64_t) || buffer_size > UINT32_MAX)
             {
                 return false;
             }
@@ -2696,8 +3022,9 @@ class LogicalPage : public LogicalPageBase<LogicalPage<adjust_padded_pointers, N
 
             this->m_page_header.initialise();
             this->m_page_header.m_size_class = size_class;
+            this->m_page_header.m_size_class_reciprocal = DivisionUtilities::get_reciprocal(size_class);
             this->m_page_header.m_logical_page_start_address = reinterpret_cast<uint64_t>(buffer);
-            this->m_page_header.m_logical_page_size = buffer_size;
+            this->m_page_header.m_logical_page_size = static_cast<uint32_t>(buffer_size);
 
             grow(buffer, buffer_size);
 
@@ -2731,10 +3058,83 @@ class LogicalPage : public LogicalPageBase<LogicalPage<adjust_padded_pointers, N
             }
             
             this->m_page_header.m_used_size -= this->m_page_header.m_size_class;
-            
+
+            push(static_cast<NodeType*>(get_chunk_start(ptr)));
+        }
+
+        // Can be called from any thread. Non-owner threads CAS-push to the thread free list and quit,
+        // they don't touch the local freelist or the used size. Only pushes happen concurrently, the owner takes the whole list at once, hence no ABA
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        void deallocate_to_thread_free_list(void* ptr)
+        {
+            if( unlikely(this->owns_pointer(ptr) == false) )
+            {
+                return;
+            }
+
+            NodeType* new_node = static_cast<NodeType*>(get_chunk_start(ptr));
+            uint64_t expected_head = builtin_atomic_load64(&this->m_page_header.m_thread_free_head);
+
+            while (true)
+            {
+                new_node->m_next = reinterpret_cast<NodeType*>(expected_head);
+
+                uint64_t previous_head = builtin_cas64(&this->m_page_header.m_thread_free_head, expected_head, reinterpret_cast<uint64_t>(new_node));
+
+                if (likely(previous_head == expected_head))
+                {
+                    break;
+                }
+
+                expected_head = previous_head;
+            }
+        }
+
+        // Should be called only by the owner. Swaps out the entire thread free list with one atomic exchange and appends it to the local freelist
+        // Returns the number of reclaimed chunks
+        std::size_t collect_thread_free_list()
+        {
+            if (builtin_atomic_load64(&this->m_page_header.m_thread_free_head) == 0)
+            {
+                return 0;
+            }
+
+            uint64_t collected_head = builtin_atomic_exchange64(&this->m_page_header.m_thread_free_head, static_cast<uint64_t>(0));
+
+            if (unlikely(collected_head == 0))
+            {
+                return 0;
+            }
+
+            NodeType* collected_tail = reinterpret_cast<NodeType*>(collected_head);
+            std::size_t collected_count = 1;
+
+            while (collected_tail->m_next)
+            {
+                collected_tail = collected_tail->m_next;
+                collected_count++;
+            }
+
+            collected_tail->m_next = reinterpret_cast<NodeType*>(this->m_page_header.m_head);
+            this->m_page_header.m_head = collected_head;
+            this->m_page_header.m_used_size -= static_cast<uint32_t>(collected_count) * this->m_page_header.m_size_class;
+
+            return collected_count;
+        }
+
+        std::size_t get_usable_size(void* ptr) { return  static_cast<std::size_t>(this->m_page_header.m_size_class); }
+        static constexpr bool supports_any_size() { return false; }
+
+        #ifdef UNIT_TEST
+        const std::string get_type_name() const { return "LogicalPage"; }
+        #endif
+
+        // Finds the start of the chunk which holds ptr , ptr may have been padded for an aligned allocation
+        FORCE_INLINE void* get_chunk_start(void* ptr)
+        {
             if constexpr(adjust_padded_pointers == false)
             {
-                push(static_cast<NodeType*>(ptr));
+                return ptr;
             }
             else
             {
@@ -2746,28 +3146,17 @@ class LogicalPage : public LogicalPageBase<LogicalPage<adjust_padded_pointers, N
                 However if the freed ptr was not adjusted, this formula will not change the ptr which is being freed :
                 
                     correct address =  base address + (  sizeclass *  floor(   (freed address - base address) / sizeclass  )  )
-                                    or
-                    void* actual_ptr = reinterpret_cast<void*>( this->m_page_header.m_logical_page_start_address + (  (reinterpret_cast<uint64_t>(ptr) - this->m_page_header.m_logical_page_start_address) / this->m_page_header.m_size_class) * this->m_page_header.m_size_class );
                     
-                Basically we find out the highest multiple of a pow2 sizeclass which is less than the passed pointer with start address offset which is not guaranteed to be pow2
+                Size classes are not necessarily power of two , therefore instead of a mask we use a precomputed reciprocal
+                so that the division above becomes a multiplication
                     
                 */
-                uint64_t offset = reinterpret_cast<uint64_t>(ptr) - this->m_page_header.m_logical_page_start_address;
-                uint64_t mask = ~( static_cast<uint64_t>(this->m_page_header.m_size_class) - 1);
-                uint64_t unpadded_offset = offset & mask;
-                void* actual_ptr = reinterpret_cast<void*>(this->m_page_header.m_logical_page_start_address + unpadded_offset);
-                
-                push(static_cast<NodeType*>(actual_ptr));
+                uint32_t offset = static_cast<uint32_t>(reinterpret_cast<uint64_t>(ptr) - this->m_page_header.m_logical_page_start_address);
+                uint32_t chunk_index = DivisionUtilities::divide_by_reciprocal(offset, this->m_page_header.m_size_class_reciprocal);
+                return reinterpret_cast<void*>(this->m_page_header.m_logical_page_start_address + static_cast<uint64_t>(chunk_index) * this->m_page_header.m_size_class);
             }
         }
 
-        std::size_t get_usable_size(void* ptr) { return  static_cast<std::size_t>(this->m_page_header.m_size_class); }
-        static constexpr bool supports_any_size() { return false; }
-
-        #ifdef UNIT_TEST
-        const std::string get_type_name() const { return "LogicalPage"; }
-        #endif
-
     private:
 
         void grow(void* buffer, std::size_t buffer_size)
@@ -2802,1775 +3191,5314 @@ class LogicalPage : public LogicalPageBase<LogicalPage<adjust_padded_pointers, N
 
 #endif
 /*
-    UNBOUNDED THREAD SAFE QUEUE FOR STORING 64 BIT POINTERS
-    STORES THEM IN A DOUBLY LINKED LIST OF 64KB "POINTER PAGE"S
-*/
-#ifndef __DEALLOCATION_QUEUE__
-#define __DEALLOCATION_QUEUE__
+    - A LOGICAL PAGE THAT CAN HOLD ARBITRARY SIZES. EVERY BLOCK ( FREE OR USED ) STARTS WITH A 16 BYTE ALLOCATION HEADER WHICH HOLDS ITS SIZE AND ITS PHYSICAL PREDECESSOR'S SIZE.
+      ( BOUNDARY TAGS ) SO THAT NEIGHBOURS CAN BE FOUND IN CONSTANT TIME.
 
-// FIRST 16 BYTES OF EACH PAGE IS "next" and "prev" PTRS
-// THE REST WILL BE USED TO STORE POINTERS
-PACKED
-(
-    struct PointerPage
+    - FREE BLOCKS ARE KEPT IN SIZE SEGREGATED DOUBLY LINKED FREELISTS. EACH FREELIST BIN HOLDS BLOCKS WITHIN A POWER OF TWO RANGE :
+
+                bin0 : [32, 64)  bin1 : [64, 128) ... bin13 : [256KB, 512KB)  bin14 : 512KB and above
+
+      A BITMAP OF NON-EMPTY BINS IS MAINTAINED SO THAT SEARCHES SKIP EMPTY BINS WITH A SINGLE COUNT-TRAILING-ZEROES INSTRUCTION.
+
+    - GOOD FIT : SEARCH STARTS FROM THE BIN OF THE REQUESTED SIZE AND DOES FIRST FIT WITHIN THAT BIN. IF NOTHING FITS THERE, THE HEAD OF THE NEXT NON-EMPTY BIN IS USED
+      AS ANY BLOCK IN A GREATER BIN IS GUARANTEED TO BE BIG ENOUGH.
+
+    - SPLITS BLOCKS DURING ALLOCATIONS IF THE REMAINDER CAN FORM A MINIMUM SIZED BLOCK. OTHERWISE THE REMAINDER IS GIVEN TO THE ALLOCATION.
+      COALESCES WITH BOTH PHYSICAL NEIGHBOURS DURING DEALLOCATIONS.
+
+    - SUPPORTS ALIGNMENT : allocate_aligned CARVES THE ALIGNED PAYLOAD OUT OF A FREE BLOCK AND GIVES THE LEADING GAP BACK AS A FREE BLOCK.
+      THEREFORE RETURNED POINTERS ARE NEVER PADDED AND DEALLOCATIONS DON'T NEED TO UNPAD THEM. DON'T USE HeapBase::allocate_aligned WITH THIS LOGICAL PAGE.
+
+    - MINIMUM ALLOCATION ALIGNMENT IS 16 BYTES. MINIMUM BLOCK SIZE IS 32 BYTES : 16 BYTES HEADER + 16 BYTES FOR FREELIST NEXT & PREV POINTERS WHEN THE BLOCK IS FREE
+
+    - METADATA USAGE : 64 BYTES (PAGE HEADER) + 128 BYTES (FREELIST BIN HEADS AND BITMAP) PER LOGICAL PAGE AND 16 BYTES PER ALLOCATION
+*/
+#ifndef __LOGICAL_PAGE_ANY_SIZE_H__
+#define __LOGICAL_PAGE_ANY_SIZE_H__
+
+struct LogicalPageAnySizeConstants
+{
+    static constexpr inline std::size_t ALLOCATION_HEADER_SIZE = 16;
+    static constexpr inline std::size_t MINIMUM_BLOCK_SIZE = 32;            // Header + next & prev pointers of a free block
+    static constexpr inline std::size_t BLOCK_SIZE_GRANULARITY = 16;        // To guarantee 16 byte alignment for all payloads
+    static constexpr inline std::size_t FREELIST_BIN_COUNT = 15;
+    static constexpr inline std::size_t FREELIST_TABLE_SIZE = 128;           // Bitmap + bin heads
+    static constexpr inline std::size_t MAXIMUM_BUFFER_SIZE = 0xFFFFFFFF;   // Block sizes are stored in 32 bits
+};
+
+PACKED
+(
+    struct LogicalPageAnySizeNode      // No private members to stay as POD+PACKED
+    {
+        // ALLOCATION HEADER , 16 BYTES
+        uint32_t m_block_size;              // Including the allocation header
+        uint32_t m_previous_block_size;     // Size of the physically previous block, 0 if this is the first block of the page
+        uint32_t m_is_used;
+        char m_padding_bytes[4];
+        // ONLY VALID WHEN THE BLOCK IS FREE , WHEN ALLOCATED THEY ARE PART OF THE PAYLOAD
+        LogicalPageAnySizeNode* m_next;
+        LogicalPageAnySizeNode* m_prev;
+
+        std::size_t get_block_size() const { return static_cast<std::size_t>(m_block_size); }
+        void* get_payload() { return reinterpret_cast<void*>(reinterpret_cast<std::size_t>(this) + LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE); }
+    }
+);
+
+PACKED
+(
+    struct LogicalPageAnySizeFreelists  // Placed to the start of the logical page buffer
     {
-        static constexpr std::size_t POINTER_CAPACITY = 8190; // 8190=(65536-(2*8))/8
-        PointerPage* m_next = nullptr;
-        PointerPage* m_prev = nullptr;
-        uint64_t m_pointers[POINTER_CAPACITY] = { 0 };
+        uint64_t m_non_empty_bin_bitmap;
+        LogicalPageAnySizeNode* m_bin_heads[LogicalPageAnySizeConstants::FREELIST_BIN_COUNT];
     }
 );
 
-template <typename AllocatorType>
-class DeallocationQueue : public Lockable<LockPolicy::USERSPACE_LOCK>
+template <typename NodeType = LogicalPageAnySizeNode>
+class LogicalPageAnySize : public LogicalPageBase<LogicalPageAnySize<NodeType>, NodeType>
 {
     public:
+        LogicalPageAnySize() {}
+        ~LogicalPageAnySize() {}
 
-        DeallocationQueue() = default;
+        LogicalPageAnySize(const LogicalPageAnySize& other) = delete;
+        LogicalPageAnySize& operator= (const LogicalPageAnySize& other) = delete;
+        LogicalPageAnySize(LogicalPageAnySize&& other) = delete;
+        LogicalPageAnySize& operator=(LogicalPageAnySize&& other) = delete;
 
-        ~DeallocationQueue()
+        // Size class parameter is only stored in the page header for upper layers , blocks can be any size
+        [[nodiscard]] bool create(void* buffer, const std::size_t buffer_size, uint32_t size_class = 0)
         {
-            this->enter_concurrent_context();
-            auto iter = m_head;
-            while (iter)
+            static_assert(sizeof(NodeType) == LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE);
+            static_assert(sizeof(LogicalPageAnySizeFreelists) == LogicalPageAnySizeConstants::FREELIST_TABLE_SIZE);
+
+            if (buffer == nullptr || buffer_size < get_metadata_size() + LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE || buffer_size > LogicalPageAnySizeConstants::MAXIMUM_BUFFER_SIZE)
             {
-                auto next = iter->m_next;
-                AllocatorType::deallocate(iter, sizeof(PointerPage));
-                iter = next;
+                return false;
             }
-            this->leave_concurrent_context();
-        }
 
-        [[nodiscard]] bool create(std::size_t initial_pointer_page_count, void* external_buffer = nullptr)
-        {
-            if (!initial_pointer_page_count) { return false; }
-
-            PointerPage* buffer = nullptr;
-
-            if (external_buffer == nullptr)
-            {
-                buffer = reinterpret_cast<PointerPage*>(AllocatorType::allocate(initial_pointer_page_count * sizeof(PointerPage)));
+            void* buffer_start_including_header = reinterpret_cast<void*>(reinterpret_cast<std::size_t>(buffer) - sizeof(*this)); // See LogicalPage::create for the 2 use cases
 
-                if (buffer == nullptr)
-                {
-                    return false;
-                }
-            }
-            else
+            if (!AlignmentChecks::is_address_page_allocation_granularity_aligned(buffer) && !AlignmentChecks::is_address_page_allocation_granularity_aligned(buffer_start_including_header))
             {
-                buffer = reinterpret_cast<PointerPage*>(external_buffer);
+                return false;
             }
 
-            builtin_memset(reinterpret_cast<void*>(buffer), 0, initial_pointer_page_count * sizeof(PointerPage));
-
-            m_head = buffer;
-            m_head->m_next = nullptr;
-            m_head->m_prev = nullptr;
+            this->m_page_header.initialise();
+            this->m_page_header.m_size_class = size_class;
+            this->m_page_header.m_logical_page_start_address = reinterpret_cast<uint64_t>(buffer);
+            this->m_page_header.m_logical_page_size = static_cast<uint32_t>(buffer_size);
+            this->m_page_header.m_head = reinterpret_cast<uint64_t>(buffer);  // Points to the freelist table
 
-            auto iter = m_head;
+            auto freelists = get_freelists();
+            freelists->m_non_empty_bin_bitmap = 0;
 
-            for (std::size_t i = 0; i < initial_pointer_page_count; i++)
+            for (std::size_t i = 0; i < LogicalPageAnySizeConstants::FREELIST_BIN_COUNT; i++)
             {
-                if (i + 1 < initial_pointer_page_count)
-                {
-                    auto* next = &(buffer[i + 1]);
-                    iter->m_next = next;
-                    next->m_prev = iter;
-                }
-                else
-                {
-                    iter->m_next = nullptr;
-                }
+                freelists->m_bin_heads[i] = nullptr;
             }
 
-            m_active_page = m_head;
+            // Initially the whole page is one free block
+            std::size_t first_block_size = (buffer_size - get_metadata_size()) & ~(LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY - 1);
+            NodeType* first_block = reinterpret_cast<NodeType*>(get_first_block_address());
+            first_block->m_block_size = static_cast<uint32_t>(first_block_size);
+            first_block->m_previous_block_size = 0;
+            first_block->m_is_used = 0;
+
+            insert_to_freelist(first_block);
 
             return true;
         }
 
-        FORCE_INLINE void push(void* pointer)
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        void* allocate(const std::size_t size)
         {
-            this->enter_concurrent_context();
-            ////////////////////////////////////
-            if (unlikely(m_active_page_used_count == PointerPage::POINTER_CAPACITY))
-            {
-                // We need to start using a new page
-
-                if (m_active_page->m_next == nullptr)
-                {
-                    #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
-                    fprintf(stderr, "deallocation queue grow\n");
-                    #endif
-
-                    // We need to allocate a new page
-                    auto new_page = reinterpret_cast<PointerPage*>(AllocatorType::allocate(sizeof(PointerPage)));
-                    new_page->m_next = nullptr;
-
-                    m_active_page->m_next = new_page;
-                    new_page->m_prev = m_active_page;
-                    m_active_page = new_page;
-                }
-                else
-                {
-                    m_active_page = m_active_page->m_next;
-                }
-
-                m_active_page_used_count = 0;
-            }
-
-            m_active_page->m_pointers[m_active_page_used_count] = reinterpret_cast<uint64_t>(pointer);
-            m_active_page_used_count++;
-            ////////////////////////////////////
-            this->leave_concurrent_context();
+            return allocate_aligned(size, LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY);
         }
 
-        FORCE_INLINE [[nodiscard]] void* pop()
+        // Alignment has to be a power of two
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        void* allocate_aligned(const std::size_t size, std::size_t alignment)
         {
-            void* ret = nullptr;
-            this->enter_concurrent_context();
-            ////////////////////////////////////
-            if (m_active_page_used_count == 0)
+            alignment = alignment < LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY ? LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY : alignment;
+
+            if (unlikely(size == 0 || size > this->m_page_header.m_logical_page_size))
             {
-                if (m_head == m_active_page)
-                {
-                    this->leave_concurrent_context();
-                    return nullptr;
-                }
-                else
-                {
-                    m_active_page = m_active_page->m_prev;
-                    m_active_page_used_count = PointerPage::POINTER_CAPACITY;
-                }
+                return nullptr;
             }
 
-            ret = reinterpret_cast<void*>(m_active_page->m_pointers[m_active_page_used_count - 1]);
-            m_active_page_used_count--;
+            std::size_t required_block_size = get_required_block_size(size);
+            std::size_t gap = 0;
 
-            ////////////////////////////////////
-            this->leave_concurrent_context();
-            return ret;
-        }
-
-        DeallocationQueue(const DeallocationQueue& other) = delete;
-        DeallocationQueue& operator= (const DeallocationQueue& other) = delete;
-        DeallocationQueue(DeallocationQueue&& other) = delete;
-        DeallocationQueue& operator=(DeallocationQueue&& other) = delete;
+            NodeType* free_block = search(required_block_size, alignment, gap);
 
-    private:
-        PointerPage* m_head = nullptr;
-        PointerPage* m_active_page = nullptr;
-        std::size_t m_active_page_used_count = 0;
-};
+            if (unlikely(free_block == nullptr))
+            {
+                return nullptr;
+            }
 
-#endif
-/*
-    - A SEGMENT IS A COLLECTION OF LOGICAL PAGES. IT MAKES IT EASIER TO MANAGE MULTIPLE LOGICAL_PAGES :
+            NodeType* allocated_block = carve(free_block, required_block_size, gap);
+            this->m_page_header.m_used_size += allocated_block->m_block_size;
 
-                1. AS FOR ALLOCATIONS, WHEN MEMORY CONSUMPTION IS HIGH , SEQUENTIAL SEARCH FROM STARTING PAGE CAN BE VERY SLOW FOR. IT UTILISES "NEXT FIT" SO SEARCHES START FROM THE LOGICAL PAGE WHICH WAS THE LAST ALLOCATOR
+            return allocated_block->get_payload();
+        }
 
-                2. WE CAN GIVE COMPLETELY FREE PAGES BACK TO SYSTEM IF WE WILL NOT FALL UNDER "MINIMUM_LOGICAL_PAGES" THRESHOLD . OTHERWISE MEMORY CONSUMPTION OF ALLOCATOR WILL NEVER GO DOWN
-                  ( WE LIMIT LOGICAL PAGES TO VM PAGE SIZES MORE EASILY SO THAT OBJECT DON'T END UP IN MULTIPLE PAGES )
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        void deallocate(void* ptr)
+        {
+            if (unlikely(this->owns_pointer(ptr) == false))
+            {
+                return;
+            }
 
-    - INITIALLY HAS CONTIGIOUS LOGICAL PAGES LIKE SPANS/PAGE RUNS. HOWEVER THAT CAN CHANGE IF IT IS AN UNBOUNDED SEGMENT.
+            NodeType* block = get_block_from_payload(ptr);
 
-    - MINIMUM LOGICAL PAGE SIZE FOR LINUX IS 4KB/4096 ON LINUX AND 64KB/65536 ON WINDOWS. LOGICAL PAGE SIZE ALSO HAS TO BE A MULTIPLE OF VIRTUAL MEMORY PAGE ALLOCATION GRANULARITY.
+            if (unlikely(block->m_is_used == 0))
+            {
+                return;
+            }
 
-    - IT WILL PLACE A LOGICAL PAGE HEADER TO INITIAL 64 BYTES OF EVERY LOGICAL PAGE.
+            this->m_page_header.m_used_size -= block->m_block_size;
+            block->m_is_used = 0;
 
-    - METADATA USAGE : PAGE HEADERS IN METAMALLOC ARE 64 BYTES THEREFORE FOR METADATA, WE WILL USE 64 BYTES PER EACH LOGICAL PAGE.
-      IF SELECTED PAGE SIZE 4096 BYTES , 64 BYTES IN 4096 IS 0.78%
-*/
-#ifndef __SEGMENT_H__
-#define __SEGMENT_H__
+            // COALESCE WITH THE NEXT BLOCK
+            NodeType* next = get_next_physical_block(block);
 
-enum class PageRecyclingPolicy
-{
-    IMMEDIATE,    // IF LOGICAL PAGE COUNT > PAGE RECYCLING THRESHOLD VALUE, RECYCLING DONE AT THE END OF DEALLOCATIONS.
-    DEFERRED    // USER HAS TO CALL "recycle_free_logical_pages"
-};
+            if (next != nullptr && next->m_is_used == 0)
+            {
+                remove_from_freelist(next);
+                block->m_block_size += next->m_block_size;
+            }
 
-enum class ConcurrencyPolicy
-{
-                        // BOUNDEDNESS                    DESCRIPTION
+            // COALESCE WITH THE PREVIOUS BLOCK
+            if (block->m_previous_block_size != 0)
+            {
+                NodeType* previous = reinterpret_cast<NodeType*>(reinterpret_cast<std::size_t>(block) - block->m_previous_block_size);
 
-    THREAD_LOCAL,       // Bounded , can't grow           Partial locking needed. Deallocates just push ptrs to a spinlock based q and they quit, as they can come from multiple threads.
-                        //                                Allocs will come from only one thread and they do actual deallocation by consuming dealloc q.
-    CENTRAL,            // Unbounded, can grow            Segment level locking needed
-    SINGLE_THREAD       // Unbounded, can grow            No locks
-};
+                if (previous->m_is_used == 0)
+                {
+                    remove_from_freelist(previous);
+                    previous->m_block_size += block->m_block_size;
+                    block = previous;
+                }
+            }
 
-struct SegmentCreationParameters
-{
-    std::size_t m_logical_page_size= 0;
-    std::size_t m_logical_page_count = 0;
-    std::size_t m_page_recycling_threshold = 0;
-    std::size_t m_deallocation_queue_initial_capacity = 65536;
-    uint32_t m_size_class = 0;                             // 0 means that that segment will hold arbitrary size. Otherwise it will be for only 1 sizeclass.
-    double m_grow_coefficient = 0.0;                     // 0 means that we will be growing by allocating only required amount
-};
+            update_next_physical_block_link(block);
+            insert_to_freelist(block);
+        }
 
-#ifdef ENABLE_STATS
-static inline constexpr std::size_t MAX_GROW_STAT_COUNT = 32;
+        std::size_t get_usable_size(void* ptr)
+        {
+            return get_block_from_payload(ptr)->get_block_size() - LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE;
+        }
 
-struct SegmentStats
-{
-    std::size_t m_size_class = 0;
-    std::size_t m_latest_logical_page_count = 0;
-    std::size_t m_recycle_count =0;
-    std::size_t m_grow_size_count = 0;
-    std::array<std::size_t, MAX_GROW_STAT_COUNT> m_grow_sizes {0};
-};
-#endif
+        static constexpr bool supports_any_size() { return true; }
 
-template <
-            ConcurrencyPolicy concurrency_policy,
-            typename LogicalPageType,
-            typename ArenaType,
-            PageRecyclingPolicy page_recycling_policy = PageRecyclingPolicy::IMMEDIATE,
-            bool buffer_aligned_to_logical_page_size = false
-        >
-class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
-{
-    public:
+        // Per page bytes which can't be used by allocations, excluding the page header
+        static constexpr std::size_t get_metadata_size() { return LogicalPageAnySizeConstants::FREELIST_TABLE_SIZE; }
 
-        Segment()
+        // Largest payload that an empty page with the given buffer size can serve
+        static constexpr std::size_t get_max_allocation_size(std::size_t buffer_size)
         {
-            static_assert(std::is_base_of<ArenaBase<ArenaType>, ArenaType>::value);
-            m_logical_page_object_size = sizeof(LogicalPageType);
-            assert( m_logical_page_object_size == sizeof(LogicalPageHeader) );
+            return ((buffer_size - get_metadata_size()) & ~(LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY - 1)) - LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE;
         }
 
-        ~Segment()
+        // Total bytes that a payload of the given size will consume in the page
+        static std::size_t get_required_block_size(std::size_t size)
         {
-            destroy();
+            std::size_t required_block_size = MultipleUtilities::get_next_pow2_multiple_of(size + LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE, LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY);
+            return required_block_size < LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE ? LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE : required_block_size;
         }
 
-        Segment(const Segment& other) = delete;
-        Segment& operator= (const Segment& other) = delete;
-        Segment(Segment&& other) = delete;
-        Segment& operator=(Segment&& other) = delete;
-
-        [[nodiscard]] bool create(char* external_buffer, ArenaType* arena_ptr, const SegmentCreationParameters& params)
+        #ifdef UNIT_TEST
+        const std::string get_type_name() const { return "LogicalPageAnySize"; }
+        std::size_t get_free_block_count()
         {
-            if (params.m_size_class < 0 || params.m_logical_page_size <= 0 || MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(params.m_logical_page_size) == false
-                || params.m_logical_page_count <= 0 || params.m_logical_page_size <= m_logical_page_object_size || !external_buffer || !arena_ptr)
-            {
-                return false;
-            }
+            std::size_t count = 0;
+            auto freelists = get_freelists();
 
-            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            for (std::size_t i = 0; i < LogicalPageAnySizeConstants::FREELIST_BIN_COUNT; i++)
             {
-                if (m_deallocation_queue.create(params.m_deallocation_queue_initial_capacity/sizeof(PointerPage), ArenaType::MetadataAllocator::allocate(params.m_deallocation_queue_initial_capacity)) == false)
+                for (NodeType* iter = freelists->m_bin_heads[i]; iter != nullptr; iter = iter->m_next)
                 {
-                    return false;
+                    count++;
                 }
-
-                m_deallocation_queue_processing_lock.initialise();
             }
 
-            m_arena = arena_ptr;
-            m_logical_page_size = params.m_logical_page_size;
-            m_max_object_size = m_logical_page_size - sizeof(LogicalPageHeader);
-            m_size_class = params.m_size_class;
-            m_page_recycling_threshold = params.m_page_recycling_threshold;
-            m_grow_coefficient = params.m_grow_coefficient;
+            return count;
+        }
+        #endif
+
+    private:
+        FORCE_INLINE LogicalPageAnySizeFreelists* get_freelists() { return reinterpret_cast<LogicalPageAnySizeFreelists*>(this->m_page_header.m_head); }
+        FORCE_INLINE std::size_t get_first_block_address() const { return static_cast<std::size_t>(this->m_page_header.m_logical_page_start_address) + get_metadata_size(); }
+        FORCE_INLINE std::size_t get_blocks_end_address() const { return get_first_block_address() + ((static_cast<std::size_t>(this->m_page_header.m_logical_page_size) - get_metadata_size()) & ~(LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY - 1)); }
+        FORCE_INLINE NodeType* get_block_from_payload(void* ptr) { return reinterpret_cast<NodeType*>(reinterpret_cast<std::size_t>(ptr) - LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE); }
+
+        FORCE_INLINE NodeType* get_next_physical_block(NodeType* block)
+        {
+            std::size_t next_address = reinterpret_cast<std::size_t>(block) + block->m_block_size;
+            return next_address < get_blocks_end_address() ? reinterpret_cast<NodeType*>(next_address) : nullptr;
+        }
+
+        FORCE_INLINE void update_next_physical_block_link(NodeType* block)
+        {
+            NodeType* next = get_next_physical_block(block);
 
-            if (grow(external_buffer, params.m_logical_page_count) == nullptr)
+            if (next != nullptr)
             {
-                return false;
+                next->m_previous_block_size = block->m_block_size;
             }
+        }
 
-            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+        static std::size_t get_bin_index(std::size_t block_size)
+        {
+            std::size_t index = Log2Utilities::log2_power_of_two(block_size) - Log2Utilities::compile_time_log2(LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE);
+            return index >= LogicalPageAnySizeConstants::FREELIST_BIN_COUNT ? LogicalPageAnySizeConstants::FREELIST_BIN_COUNT - 1 : index;
+        }
+
+        // Returns the number of bytes needed in front of the block so that its payload will be aligned
+        // It is either 0 or at least a minimum block as the leading part will be given back as a free block
+        static std::size_t get_alignment_gap(NodeType* block, std::size_t alignment)
+        {
+            std::size_t payload_address = reinterpret_cast<std::size_t>(block) + LogicalPageAnySizeConstants::ALLOCATION_HEADER_SIZE;
+            std::size_t gap = MultipleUtilities::get_next_pow2_multiple_of(payload_address, alignment) - payload_address;
+
+            while (gap != 0 && gap < LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE)
             {
-                // We are bounded , we want to know our buffer limit
-                m_buffer_length = m_logical_page_size * params.m_logical_page_count;
+                gap += alignment;
             }
 
-            return true;
+            return gap;
         }
 
-        // size=0 means that underlying logical page can hold only one size which is 'm_size_class' which is set by create
-        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
-        void* allocate(std::size_t size = 0)
+        NodeType* search(std::size_t required_block_size, std::size_t alignment, std::size_t& gap)
         {
-            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            auto freelists = get_freelists();
+            uint64_t candidate_bins = freelists->m_non_empty_bin_bitmap & ~((static_cast<uint64_t>(1) << get_bin_index(required_block_size)) - 1);
+
+            while (candidate_bins)
             {
-                // THREAD LOCAL
-                if constexpr (LogicalPageType::supports_any_size()==false) // Underyling type should be used for same size class
+                std::size_t bin_index = static_cast<std::size_t>(builtin_ctzl(candidate_bins));
+
+                for (NodeType* iter = freelists->m_bin_heads[bin_index]; iter != nullptr; iter = iter->m_next)
                 {
-                    void* pointer = process_deallocation_queue<true>(); // While pointers in the deallocation queue are deallocated ,one of them will be returned to the allocation requestor
+                    gap = alignment > LogicalPageAnySizeConstants::BLOCK_SIZE_GRANULARITY ? get_alignment_gap(iter, alignment) : 0;
 
-                    if (pointer)
-                    {
-                        return pointer;
-                    }
-                    else
+                    if (iter->m_block_size >= required_block_size + gap)
                     {
-                        return allocate_internal(size);
+                        return iter;
                     }
                 }
-                else
-                {
-                    process_deallocation_queue<false>();
-                    return allocate_internal(size);
-                }
+
+                candidate_bins &= candidate_bins - 1;
             }
-            else if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+
+            return nullptr;
+        }
+
+        // Takes the block out of its freelist , gives leading gap and trailing remainder back to freelists and returns the used part
+        NodeType* carve(NodeType* block, std::size_t required_block_size, std::size_t gap)
+        {
+            remove_from_freelist(block);
+
+            if (gap > 0)
             {
-                // CENTRAL , we are locking the entire segment
-                this->enter_concurrent_context();
-                auto ret = allocate_internal(size);
-                this->leave_concurrent_context();
-                return ret;
+                NodeType* aligned_block = reinterpret_cast<NodeType*>(reinterpret_cast<std::size_t>(block) + gap);
+                aligned_block->m_block_size = block->m_block_size - static_cast<uint32_t>(gap);
+                aligned_block->m_previous_block_size = static_cast<uint32_t>(gap);
+                block->m_block_size = static_cast<uint32_t>(gap);
+                insert_to_freelist(block);
+                block = aligned_block;
+            }
+
+            std::size_t remainder = block->m_block_size - required_block_size;
+
+            if (remainder >= LogicalPageAnySizeConstants::MINIMUM_BLOCK_SIZE)
+            {
+                NodeType* remainder_block = reinterpret_cast<NodeType*>(reinterpret_cast<std::size_t>(block) + required_block_size);
+                remainder_block->m_block_size = static_cast<uint32_t>(remainder);
+                remainder_block->m_previous_block_size = static_cast<uint32_t>(required_block_size);
+                remainder_block->m_is_used = 0;
+                block->m_block_size = static_cast<uint32_t>(required_block_size);
+                update_next_physical_block_link(remainder_block);
+                insert_to_freelist(remainder_block);
             }
             else
             {
-                // SINGLE THREADED, NO LOCKS NEEDED
-                return allocate_internal(size);
+                update_next_physical_block_link(block);
             }
+
+            block->m_is_used = 1;
+            return block;
         }
 
-        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
-        void deallocate(void* ptr)
+        FORCE_INLINE void insert_to_freelist(NodeType* block)
         {
-            if( m_head == nullptr ) { return;}
+            auto freelists = get_freelists();
+            std::size_t bin_index = get_bin_index(block->m_block_size);
 
-            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            block->m_is_used = 0;
+            block->m_prev = nullptr;
+            block->m_next = freelists->m_bin_heads[bin_index];
+
+            if (block->m_next)
             {
-                // THREAD LOCAL
-                m_deallocation_queue.push(ptr); // Q is thread safe
+                block->m_next->m_prev = block;
             }
-            else if constexpr(concurrency_policy == ConcurrencyPolicy::CENTRAL)
-            {
-                // CENTRAL , we are locking entire segment
-                this->enter_concurrent_context();
-                deallocate_internal(ptr);
-                this->leave_concurrent_context();
+
+            freelists->m_bin_heads[bin_index] = block;
+            freelists->m_non_empty_bin_bitmap |= (static_cast<uint64_t>(1) << bin_index);
+        }
+
+        FORCE_INLINE void remove_from_freelist(NodeType* block)
+        {
+            auto freelists = get_freelists();
+            std::size_t bin_index = get_bin_index(block->m_block_size);
+
+            if (block->m_prev)
+            {
+                block->m_prev->m_next = block->m_next;
             }
             else
             {
-                // SINGLE THREADED , NO LOCKS NEEDED
-                deallocate_internal(ptr);
+                freelists->m_bin_heads[bin_index] = block->m_next;
             }
-        }
 
-        // MAY BE CALLED FROM HEAP DEALLOCATION METHODS. IN CASE OF THREAD LOCAL OR CENTRAL HEAP , THAT MEANS MULTIPLE THREADS
-        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
-        bool owns_pointer(void* ptr)
-        {
-            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL || concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            if (block->m_next)
             {
-                this->enter_concurrent_context();
+                block->m_next->m_prev = block->m_prev;
             }
 
-            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            if (freelists->m_bin_heads[bin_index] == nullptr)
             {
-                // BOUNDED BUFFER
-                uint64_t address_in_question = reinterpret_cast<uint64_t>(ptr);
-
-                if (address_in_question >= reinterpret_cast<uint64_t>(m_head) && address_in_question < (reinterpret_cast<uint64_t>(m_head) + m_buffer_length))
-                {
-                    if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL || concurrency_policy == ConcurrencyPolicy::CENTRAL)
-                    {
-                        this->leave_concurrent_context();
-                    }
-                    return true;
-                }
+                freelists->m_non_empty_bin_bitmap &= ~(static_cast<uint64_t>(1) << bin_index);
             }
-            else
-            {
-                // UNBOUNDED BUFFER , WE NEED A SEARCH
-                std::size_t address = reinterpret_cast<std::size_t>(ptr);
+        }
+};
 
-                LogicalPageType* iter = m_head;
+#endif
 
-                while (iter != nullptr)
-                {
-                    std::size_t start = reinterpret_cast<std::size_t>(iter);
-                    std::size_t end = start + m_logical_page_size;
+/*
+    LOCKFREE MULTI PRODUCER MULTI CONSUMER STACK FOR STORING FREE MEMORY CHUNKS
 
-                    if (address >= start && address < end)
-                    {
-                        if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL || concurrency_policy == ConcurrencyPolicy::CENTRAL)
-                        {
-                            this->leave_concurrent_context();
-                        }
-                        return true;
-                    }
+    - IT IS INTRUSIVE : FIRST 8 BYTES OF EACH PUSHED CHUNK HOLD THE NEXT POINTER. THEREFORE IT DOESN'T ALLOCATE ANY MEMORY
 
-                    iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
-                }
+    - AS BOTH PUSHES AND POPS HAPPEN CONCURRENTLY , THE HEAD IS TAGGED AGAINST THE ABA PROBLEM :
+      THE HEAD IS 16 BYTES , A POINTER AND A 64 BIT COUNTER WHICH IS INCREMENTED BY EVERY SUCCESSFUL OPERATION. IT IS UPDATED WITH A 128 BIT CAS ( cmpxchg16b ),
+      SO THE COUNTER DOESN'T WRAP AROUND IN PRACTICE
 
-            }
+    - A POP MAY READ THE NEXT POINTER OF A CHUNK WHICH HAS JUST BEEN POPPED BY ANOTHER THREAD. THAT READ IS DISCARDED BY THE FAILING CAS.
+      NEXT POINTERS ARE READ AND WRITTEN ATOMICALLY , USE set_next TO LINK CHUNKS WHICH MAY HAVE BEEN IN THE STACK
 
-            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL || concurrency_policy == ConcurrencyPolicy::CENTRAL)
-            {
-                this->leave_concurrent_context();
-            }
-            return false;
+    - pop_all DETACHES ALL CHUNKS AT ONCE. POPS WHICH STARTED BEFORE IT MAY STILL READ NEXT POINTERS OF DETACHED CHUNKS ,
+      THEREFORE wait_for_pops SHOULD BE CALLED BEFORE GIVING THE MEMORY OF DETACHED CHUNKS BACK TO THE SYSTEM.
+      POPS ARE COUNTED PER GENERATION , SO THAT wait_for_pops WAITS ONLY FOR THE POPS WHICH STARTED BEFORE IT. ONLY ONE THREAD SHOULD CALL IT AT A TIME
+
+    - METADATA USAGE : 32 BYTES
+*/
+#ifndef __TAGGED_FREE_LIST__
+#define __TAGGED_FREE_LIST__
+
+class alignas(16) TaggedFreeList
+{
+    public:
+
+        TaggedFreeList() = default;
+        ~TaggedFreeList() = default;
+
+        TaggedFreeList(const TaggedFreeList& other) = delete;
+        TaggedFreeList& operator= (const TaggedFreeList& other) = delete;
+        TaggedFreeList(TaggedFreeList&& other) = delete;
+        TaggedFreeList& operator=(TaggedFreeList&& other) = delete;
+
+        FORCE_INLINE uint64_t push(void* pointer)
+        {
+            return push_batch(pointer, pointer);
         }
 
-        void recycle_free_logical_pages()
+        // Pushes a list of chunks which are already linked through their first 8 bytes , with a single CAS
+        // Returns the new tag , callers can use it as an operation counter
+        FORCE_INLINE uint64_t push_batch(void* first, void* last)
         {
-            // Should be called only when using deferred recycling
-            if constexpr (page_recycling_policy == PageRecyclingPolicy::IMMEDIATE)
+            uint64_t expected_head[2];
+            load_head(expected_head);
+
+            while (true)
             {
-                assert(0 == 1);
+                set_next(last, reinterpret_cast<void*>(expected_head[0]));
+
+                if (likely(builtin_cas128(m_head, expected_head, reinterpret_cast<uint64_t>(first), expected_head[1] + 1)))
+                {
+                    return expected_head[1] + 1;
+                }
             }
+        }
 
-            this->enter_concurrent_context();
-            ///////////////////////////////////////////////////////////////////
-            auto num_logical_pages_to_recycle = m_logical_page_count - m_page_recycling_threshold;
-            LogicalPageType* iter = m_head;
-            LogicalPageType* iter_previous = nullptr;
+        FORCE_INLINE [[nodiscard]] void* pop()
+        {
+            uint32_t* pops_in_flight = begin_pop();
+
+            uint64_t expected_head[2];
+            load_head(expected_head);
+            void* ret = nullptr;
 
-            while (num_logical_pages_to_recycle)
+            while (expected_head[0] != 0)
             {
-                if (iter->can_be_recycled())
-                {
-                    recycle_logical_page(iter); // This method will update iter_previous's next ptr
-                    iter = reinterpret_cast<LogicalPageType*>(iter_previous->get_next_logical_page());
-                    num_logical_pages_to_recycle--;
-                }
-                else
+                // If another thread popped the head meanwhile , the tag will be different and the CAS below will fail
+                Node* head_node = reinterpret_cast<Node*>(expected_head[0]);
+                uint64_t next = builtin_atomic_load64(&head_node->m_next);
+
+                if (likely(builtin_cas128(m_head, expected_head, next, expected_head[1] + 1)))
                 {
-                    iter_previous = iter;
-                    iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+                    ret = head_node;
+                    break;
                 }
             }
 
-            ///////////////////////////////////////////////////////////////////
-            this->leave_concurrent_context();
+            builtin_atomic_fetch_add32(pops_in_flight, static_cast<uint32_t>(-1));
+            return ret;
         }
 
-        void transfer_logical_pages_from(Segment& from)
+        // Detaches all chunks with a single CAS and returns the first one , they are linked through their first 8 bytes
+        [[nodiscard]] void* pop_all()
         {
-            this->enter_concurrent_context();
-            ///////////////////////////////////////////////////////////////////
-            LogicalPageType* iter = from.m_head;
+            uint64_t expected_head[2];
+            load_head(expected_head);
 
-            while (iter)
+            while (builtin_cas128(m_head, expected_head, 0, expected_head[1] + 1) == false)
             {
-                LogicalPageType* iter_next = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
-
-                add_logical_page(iter); // Will also update iter's next ptr
-                from.remove_logical_page(iter);
-
-                iter = iter_next;
             }
-            ///////////////////////////////////////////////////////////////////
-            this->leave_concurrent_context();
+
+            return reinterpret_cast<void*>(expected_head[0]);
         }
 
-        std::size_t get_usable_size(void* ptr)
+        // Returns when no pop can read next pointers of the chunks detached by the previous pop_all
+        void wait_for_pops()
         {
-            if constexpr (LogicalPageType::supports_any_size() == false)
+            uint32_t generation = builtin_atomic_fetch_add32(&m_pop_generation, 1);
+
+            while (builtin_atomic_load32(&m_pops_in_flight[generation & 1]) != 0)
             {
-                return m_size_class;
+                pause(100);
             }
-            else
-            {
-                LogicalPageType* iter = m_head;
-                std::size_t address = reinterpret_cast<std::size_t>(ptr);
+        }
 
-                while (iter != nullptr)
-                {
-                    std::size_t start = reinterpret_cast<std::size_t>(iter);
-                    std::size_t end = start + m_logical_page_size;
+        bool is_empty()
+        {
+            return builtin_atomic_load64(&m_head[0]) == 0;
+        }
 
-                    if (address >= start && address < end)
-                    {
-                        return iter->get_usable_size(ptr);
-                    }
+        static FORCE_INLINE void* get_next(void* chunk)
+        {
+            return reinterpret_cast<void*>(builtin_atomic_load64(&static_cast<Node*>(chunk)->m_next));
+        }
 
-                    iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
-                }
+        static FORCE_INLINE void set_next(void* chunk, void* next)
+        {
+            builtin_atomic_store64(&static_cast<Node*>(chunk)->m_next, reinterpret_cast<uint64_t>(next));
+        }
 
-                return 0;
-            }
+    private:
+        struct Node
+        {
+            uint64_t m_next;
+        };
+
+        uint64_t m_head[2] = {0, 0};            // Pointer and tag , updated together with 128 bit CAS
+        uint32_t m_pops_in_flight[2] = {0, 0};  // Per pop generation
+        uint32_t m_pop_generation = 0;
+
+        FORCE_INLINE void load_head(uint64_t* head)
+        {
+            // A torn read is harmless as the CAS compares both halves
+            head[1] = builtin_atomic_load64(&m_head[1]);
+            head[0] = builtin_atomic_load64(&m_head[0]);
         }
 
-        // Constant time logical page look up method for finding logical pages if their start addresses are aligned to logical page size
-        static LogicalPageType* get_logical_page_from_address(void* ptr, std::size_t logical_page_size)
+        // Counts the pop in the current generation. If the generation changes meanwhile , wait_for_pops may have missed the count so it is retried
+        FORCE_INLINE uint32_t* begin_pop()
         {
-            static_assert(buffer_aligned_to_logical_page_size == true);
-            
-            uint64_t orig_ptr = reinterpret_cast<uint64_t>(ptr);
-            // Masking below is equivalent of -> orig_ptr - ModuloUtilities::modulo(orig_ptr, logical_page_size);
-            uint64_t target_page_address = orig_ptr & ~(logical_page_size - 1);
-            LogicalPageType* target_logical_page = reinterpret_cast<LogicalPageType*>(target_page_address);
-            return target_logical_page;
+            while (true)
+            {
+                uint32_t generation = builtin_atomic_load32(&m_pop_generation);
+                uint32_t* pops_in_flight = &m_pops_in_flight[generation & 1];
+                builtin_atomic_fetch_add32(pops_in_flight, 1);
+
+                if (likely(builtin_atomic_load32(&m_pop_generation) == generation))
+                {
+                    return pops_in_flight;
+                }
+
+                builtin_atomic_fetch_add32(pops_in_flight, static_cast<uint32_t>(-1));
+            }
         }
+};
 
-        // Constant time size_class look up method for finding logical pages if their start addresses are aligned to logical page size
-        static uint32_t get_size_class_from_address(void* ptr, std::size_t logical_page_size)
+#endif
+
+/*
+    POOL OF FREE LOGICAL PAGE SLOTS SHARED BY SEGMENTS OF A BOUNDED HEAP
+
+    - BOUNDED SEGMENTS TAKE LOGICAL PAGES FROM IT WHEN THEY RUN OUT AND GIVE THEIR EMPTY PAGES BACK ,
+      SO THAT A BIN WHICH IS IN DEMAND CAN USE PAGES THAT OTHER BINS DON'T NEED , INSTEAD OF FIXED PER BIN PARTITIONS
+
+    - SLOTS ARE IN THE HEAP'S BUFFER OR IN ITS EXTRA REGIONS ( SEE HeapBase::add_extra_region ) , THEREFORE CHECKING POINTER OWNERSHIP BY RANGES STILL WORKS
+
+    - IT IS INTRUSIVE : FIRST 8 BYTES OF EACH FREE SLOT HOLD THE NEXT POINTER. THEREFORE IT DOESN'T ALLOCATE ANY MEMORY
+
+    - IT IS LOCKED AS HEAPS OF OTHER THREADS CAN STEAL FREE SLOTS ( SEE ScalableAllocator::set_page_stealing ). THAT IS CHEAP AS SEGMENTS ACCESS IT ONLY WHEN THEY CREATE OR RECYCLE LOGICAL PAGES
+*/
+#ifndef __LOGICAL_PAGE_POOL__
+#define __LOGICAL_PAGE_POOL__
+
+class LogicalPagePool : public Lockable<LockPolicy::USERSPACE_LOCK>
+{
+    public:
+
+        LogicalPagePool() = default;
+        ~LogicalPagePool() = default;
+
+        LogicalPagePool(const LogicalPagePool& other) = delete;
+        LogicalPagePool& operator= (const LogicalPagePool& other) = delete;
+        LogicalPagePool(LogicalPagePool&& other) = delete;
+        LogicalPagePool& operator=(LogicalPagePool&& other) = delete;
+
+        void create(char* buffer, std::size_t slot_size, std::size_t slot_count)
         {
-            static_assert(buffer_aligned_to_logical_page_size == true);
-            
-            LogicalPageType* target_logical_page = get_logical_page_from_address(ptr, logical_page_size);
-            return target_logical_page->get_size_class();
+            m_slot_size = slot_size;
+            adopt_buffer(buffer, slot_count);
         }
 
-        void lock_pages()
+        // Adds all slots of a buffer to the heap's capacity , for ex when the heap grows by an extra region
+        void adopt_buffer(char* buffer, std::size_t slot_count)
         {
             this->enter_concurrent_context();
-            ///////////////////////////////////////////////////////////////////
-            LogicalPageType* iter = m_head;
 
-            while (iter)
+            // Pushing in reverse so that slots are handed out from the start of the buffer
+            for (std::size_t i = slot_count; i > 0; i--)
             {
-                VirtualMemory::lock(reinterpret_cast<void*>(iter), m_logical_page_size);
-                iter->mark_as_locked();
-                iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+                push_internal(buffer + ((i - 1) * m_slot_size));
+                m_capacity++;
             }
-            ///////////////////////////////////////////////////////////////////
+
             this->leave_concurrent_context();
         }
 
-        void unlock_pages()
+        // Pop and push are for segments of the owner heap , the slot stays in the heap's capacity
+        [[nodiscard]] void* pop()
         {
             this->enter_concurrent_context();
-            ///////////////////////////////////////////////////////////////////
-            LogicalPageType* iter = m_head;
+            void* ret = pop_internal(0);
+            this->leave_concurrent_context();
+            return ret;
+        }
 
-            while (iter)
+        void push(void* slot)
+        {
+            this->enter_concurrent_context();
+            push_internal(slot);
+            this->leave_concurrent_context();
+        }
+
+        // Takes a slot out of the heap's capacity , only if more than 'reserved_slot_count' slots are free , so that the owner heap keeps some for itself
+        [[nodiscard]] void* steal(std::size_t reserved_slot_count)
+        {
+            this->enter_concurrent_context();
+            void* ret = pop_internal(reserved_slot_count);
+
+            if (ret != nullptr)
             {
-                VirtualMemory::unlock(reinterpret_cast<void*>(iter), m_logical_page_size);
-                iter->mark_as_non_locked();
-                iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+                m_capacity--;
             }
-            ///////////////////////////////////////////////////////////////////
+
             this->leave_concurrent_context();
+            return ret;
         }
 
-        #ifdef UNIT_TEST
-        std::size_t get_logical_page_count() const { return m_logical_page_count; }
-        #endif
-
-        #ifdef ENABLE_STATS
-        SegmentStats get_stats() { m_stats.m_latest_logical_page_count = m_logical_page_count; return m_stats; }
-        #endif
+        // Adds a slot to the heap's capacity
+        void adopt(void* slot)
+        {
+            this->enter_concurrent_context();
+            push_internal(slot);
+            m_capacity++;
+            this->leave_concurrent_context();
+        }
 
-        
-        std::size_t get_size_class() const
+        // Gives free slots back to the system except 'reserved_slot_count' of them. Returns the number of released slots
+        template <typename ArenaType>
+        std::size_t release_free_slots(ArenaType* arena, std::size_t reserved_slot_count = 0)
         {
-            return m_size_class;
+            std::size_t released_slot_count = 0;
+            void* slot = nullptr;
+
+            while ((slot = steal(reserved_slot_count)) != nullptr)
+            {
+                arena->release_to_system(slot, m_slot_size);
+                released_slot_count++;
+            }
+
+            return released_slot_count;
         }
 
+        std::size_t get_free_slot_count() const { return m_free_slot_count; }
+        std::size_t get_capacity() const { return m_capacity; }           // Number of slots which belong to the heap , either free or used by its segments
+        std::size_t get_slot_size() const { return m_slot_size; } // 0 means that the pool is not created
+
     private:
-        uint32_t m_size_class = 0;                    // if m_size_class is zero that means, underlying logical page can hold any size
-        std::size_t m_logical_page_size = 0;            // It includes also m_logical_page_object_size
-        std::size_t m_max_object_size = 0;
-        std::size_t m_logical_page_object_size = 0;
-        std::size_t m_logical_page_count = 0;
-        std::size_t m_buffer_length = 0;  // Applies to only bounded segments
-        LogicalPageType* m_head = nullptr;
-        LogicalPageType* m_tail = nullptr;
-        LogicalPageType* m_last_used = nullptr;
-        std::size_t m_page_recycling_threshold = 0; // In auto page recycling mode, if a logical page is free after deallocation ,
-                                                    // it will be given back to system if free l.page count is over that threshold
-        double m_grow_coefficient = 1.0;            // Applies to unbounded segments
-        DeallocationQueue<typename ArenaType::MetadataAllocator> m_deallocation_queue;
-        ArenaType* m_arena = nullptr;
-        UserspaceSpinlock<> m_deallocation_queue_processing_lock;
+        struct SlotNode
+        {
+            SlotNode* m_next;
+        };
 
-        #ifdef ENABLE_STATS
-        SegmentStats m_stats;
-        #endif
+        SlotNode* m_head = nullptr;
+        std::size_t m_free_slot_count = 0;
+        std::size_t m_capacity = 0;
+        std::size_t m_slot_size = 0;
 
-        // Returns first logical page ptr of the grow
-        [[nodiscard]] LogicalPageType* grow(char* buffer, std::size_t logical_page_count)
+        void* pop_internal(std::size_t reserved_slot_count)
         {
-            LogicalPageType* first_new_logical_page = nullptr;
-            LogicalPageType* previous_page = m_tail;
-            LogicalPageType* iter_page = nullptr;
-
-            auto create_new_logical_page = [&](char* logical_page_buffer) -> bool
+            if (m_free_slot_count <= reserved_slot_count)
             {
-                iter_page = new(logical_page_buffer) LogicalPageType();
-
-                bool success = iter_page->create(logical_page_buffer + m_logical_page_object_size, m_logical_page_size - m_logical_page_object_size, m_size_class);
+                return nullptr;
+            }
 
-                if (success == false)
+            SlotNode* ret = m_head;
+            m_head = ret->m_next;
+            m_free_slot_count--;
+            return ret;
+        }
+
+        void push_internal(void* slot)
+        {
+            SlotNode* new_node = static_cast<SlotNode*>(slot);
+            new_node->m_next = m_head;
+            m_head = new_node;
+            m_free_slot_count++;
+        }
+};
+
+#endif
+
+/*
+    - A SEGMENT IS A COLLECTION OF LOGICAL PAGES. IT MAKES IT EASIER TO MANAGE MULTIPLE LOGICAL_PAGES :
+
+                1. AS FOR ALLOCATIONS, WHEN MEMORY CONSUMPTION IS HIGH , SEQUENTIAL SEARCH FROM STARTING PAGE CAN BE VERY SLOW FOR. IT UTILISES "NEXT FIT" SO SEARCHES START FROM THE LOGICAL PAGE WHICH WAS THE LAST ALLOCATOR
+
+                2. WE CAN GIVE COMPLETELY FREE PAGES BACK TO SYSTEM IF WE WILL NOT FALL UNDER "MINIMUM_LOGICAL_PAGES" THRESHOLD . OTHERWISE MEMORY CONSUMPTION OF ALLOCATOR WILL NEVER GO DOWN
+                  ( WE LIMIT LOGICAL PAGES TO VM PAGE SIZES MORE EASILY SO THAT OBJECT DON'T END UP IN MULTIPLE PAGES )
+
+    - INITIALLY HAS CONTIGIOUS LOGICAL PAGES LIKE SPANS/PAGE RUNS. HOWEVER THAT CAN CHANGE IF IT IS AN UNBOUNDED SEGMENT.
+
+    - MINIMUM LOGICAL PAGE SIZE FOR LINUX IS 4KB/4096 ON LINUX AND 64KB/65536 ON WINDOWS. LOGICAL PAGE SIZE ALSO HAS TO BE A MULTIPLE OF VIRTUAL MEMORY PAGE ALLOCATION GRANULARITY.
+
+    - IT WILL PLACE A LOGICAL PAGE HEADER TO INITIAL 64 BYTES OF EVERY LOGICAL PAGE.
+
+    - LOGICAL PAGES CAN BE GROUPED IN BLOCKS WHICH ARE BIGGER THAN THEIR SIZES ( SEE m_logical_page_alignment ). IN THAT CASE LOGICAL PAGES ARE PLACED BACK TO BACK IN BLOCKS
+      ALIGNED TO THE BLOCK SIZE AND THE SEGMENT GROWS BY WHOLE BLOCKS , SO THAT HEAPS CAN HAVE BINS WITH DIFFERENT LOGICAL PAGE SIZES AND STILL REACH THE SIZE CLASS BY MASKING WITH THE BIGGEST ONE.
+      THE MASK FINDS THE HEADER OF A BLOCK'S FIRST LOGICAL PAGE , THEREFORE THAT LOGICAL PAGE STAYS IN PLACE AND IS NOT RECYCLED WHILE THE SEGMENT LIVES
+
+    - BOUNDED SEGMENTS OF A HEAP CAN SHARE A POOL OF LOGICAL PAGE SLOTS INSTEAD OF FIXED PARTITIONS ( SEE LogicalPagePool ). THEY TAKE A LOGICAL PAGE FROM THE POOL WHEN THEIR PAGES
+      RUN OUT AND RECYCLING PUTS FREE LOGICAL PAGES BACK TO THE POOL INSTEAD OF GIVING THEM BACK TO THE SYSTEM
+
+    - THREAD LOCAL SEGMENTS RECEIVE DEALLOCATIONS FROM MULTIPLE THREADS. THEY EITHER QUEUE THEM OR PUSH THEM TO PER LOGICAL PAGE THREAD FREE LISTS. SEE RemoteDeallocationPolicy
+
+    - METADATA USAGE : PAGE HEADERS IN METAMALLOC ARE 64 BYTES THEREFORE FOR METADATA, WE WILL USE 64 BYTES PER EACH LOGICAL PAGE.
+      IF SELECTED PAGE SIZE 4096 BYTES , 64 BYTES IN 4096 IS 0.78%
+*/
+#ifndef __SEGMENT_H__
+#define __SEGMENT_H__
+
+enum class PageRecyclingPolicy
+{
+    IMMEDIATE,    // IF LOGICAL PAGE COUNT > PAGE RECYCLING THRESHOLD VALUE, RECYCLING DONE AT THE END OF DEALLOCATIONS.
+    DEFERRED    // USER HAS TO CALL "recycle_free_logical_pages"
+};
+
+enum class ConcurrencyPolicy
+{
+                        // BOUNDEDNESS                    DESCRIPTION
+
+    THREAD_LOCAL,       // Bounded , can't grow           No locks for deallocations. Deallocates push ptrs to the lockfree intrusive deallocation queue or to thread free lists of logical pages and they quit,
+                        //                                as they can come from multiple threads. Allocs will come from only one thread and they do actual deallocations by consuming them.
+                        //                                See RemoteDeallocationPolicy
+    CENTRAL,            // Unbounded, can grow            Segment level locking needed
+    SINGLE_THREAD       // Unbounded, can grow            No locks
+};
+
+enum class RemoteDeallocationPolicy
+{
+    DEALLOCATION_QUEUE,     // THREAD LOCAL SEGMENTS PUSH ALL DEALLOCATIONS TO A LOCKFREE INTRUSIVE DEALLOCATION QUEUE, OWNER THREAD CONSUMES IT ON ALLOCATIONS
+    THREAD_FREE_LIST        // DEALLOCATIONS ARE CAS-PUSHED TO THREAD FREE LISTS OF LOGICAL PAGES, OWNER THREAD COLLECTS A PAGE'S LIST WITH A SINGLE ATOMIC EXCHANGE WHEN THE PAGE RUNS OUT
+                            // NO DEALLOCATION QUEUE IS ALLOCATED AND NO LOCKS ARE TAKEN. REQUIRES LOGICAL PAGES ALIGNED TO LOGICAL PAGE SIZE
+};
+
+enum class CentralFreeListPolicy
+{
+    LOCKED,                 // CENTRAL SEGMENTS ARE LOCKED FOR EVERY ALLOCATION AND DEALLOCATION
+    LOCKFREE                // CENTRAL SEGMENTS PUSH DEALLOCATED CHUNKS TO A LOCKFREE ABA-SAFE STACK AND ALLOCATIONS POP FROM IT. THE SEGMENT IS LOCKED ONLY WHEN THE STACK IS EMPTY,
+                            // TO ALLOCATE FROM LOGICAL PAGES OR TO GROW. PERIODICALLY AND ON "drain" CALLS , THE STACK IS EMPTIED BACK TO LOGICAL PAGES UNDER THE SEGMENT LOCK
+                            // SO THAT EMPTY LOGICAL PAGES CAN BE RECYCLED. SEE m_central_free_list_drain_interval
+                            // REQUIRES FIXED SIZE CLASS LOGICAL PAGES ALIGNED TO LOGICAL PAGE SIZE
+};
+
+struct SegmentCreationParameters
+{
+    std::size_t m_logical_page_size= 0;
+    std::size_t m_logical_page_count = 0;
+    std::size_t m_logical_page_alignment = 0;              // 0 means that logical pages are independent. Otherwise logical pages are placed back to back in blocks of that size and alignment ,
+                                                           // so the header of a block's first logical page is found by masking with the block size. That allows heaps to use different
+                                                           // logical page sizes per bin while still finding size classes of all logical pages with a single mask. Logical page counts should
+                                                           // be multiples of logical pages per block , and the first logical page of a block is not recycled while the segment lives
+    std::size_t m_page_recycling_threshold = 0;
+    std::size_t m_deallocation_queue_drain_budget = 128;  // Max number of queued remote deallocations processed per allocation in thread-local segments, 0 means no limit
+    std::size_t m_central_free_list_drain_interval = 4096; // Applies to central segments with lockfree free lists. Roughly every that many deallocations ( rounded up to a power of two ) ,
+                                                           // the free list goes back to logical pages under the segment lock. 0 means that only drain and recycle_free_logical_pages do it
+    uint32_t m_size_class = 0;                             // 0 means that that segment will hold arbitrary size. Otherwise it will be for only 1 sizeclass.
+    double m_grow_coefficient = 0.0;                     // 0 means that we will be growing by allocating only required amount
+    LogicalPagePool* m_logical_page_pool = nullptr;       // Applies to thread local segments. If set , logical page count can be 0 and the segment takes logical pages from the pool on demand
+                                                           // Pool slots should be as big as logical page slots. Segment::owns_pointer can't be used in that case as pages are not contiguous ,
+                                                           // heaps should check ownership against the whole pool buffer instead
+};
+
+#ifdef ENABLE_STATS
+static inline constexpr std::size_t MAX_GROW_STAT_COUNT = 32;
+
+struct SegmentStats
+{
+    std::size_t m_size_class = 0;
+    std::size_t m_latest_logical_page_count = 0;
+    std::size_t m_recycle_count =0;
+    std::size_t m_grow_size_count = 0;
+    std::array<std::size_t, MAX_GROW_STAT_COUNT> m_grow_sizes {0};
+};
+#endif
+
+template <
+            ConcurrencyPolicy concurrency_policy,
+            typename LogicalPageType,
+            typename ArenaType,
+            PageRecyclingPolicy page_recycling_policy = PageRecyclingPolicy::IMMEDIATE,
+            bool buffer_aligned_to_logical_page_size = false,
+            RemoteDeallocationPolicy remote_deallocation_policy = RemoteDeallocationPolicy::DEALLOCATION_QUEUE,
+            CentralFreeListPolicy central_free_list_policy = CentralFreeListPolicy::LOCKED
+        >
+class Segment : public Lockable<LockPolicy::USERSPACE_LOCK>
+{
+    public:
+
+        Segment()
+        {
+            static_assert(std::is_base_of<ArenaBase<ArenaType>, ArenaType>::value);
+            m_logical_page_object_size = sizeof(LogicalPageType);
+            assert( m_logical_page_object_size == sizeof(LogicalPageHeader) );
+
+            if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
+            {
+                // Deallocating threads find the logical page by masking , and thread free lists hold only fixed size chunks
+                static_assert(buffer_aligned_to_logical_page_size == true);
+                static_assert(LogicalPageType::supports_any_size() == false);
+            }
+
+            if constexpr (LOCKFREE_CENTRAL)
+            {
+                // Deallocations find chunk starts by masking
+                static_assert(buffer_aligned_to_logical_page_size == true);
+                static_assert(LogicalPageType::supports_any_size() == false);
+            }
+        }
+
+        ~Segment()
+        {
+            destroy();
+        }
+
+        Segment(const Segment& other) = delete;
+        Segment& operator= (const Segment& other) = delete;
+        Segment(Segment&& other) = delete;
+        Segment& operator=(Segment&& other) = delete;
+
+        [[nodiscard]] bool create(char* external_buffer, ArenaType* arena_ptr, const SegmentCreationParameters& params)
+        {
+            bool uses_logical_page_pool = params.m_logical_page_pool != nullptr;
+
+            if (params.m_size_class < 0 || params.m_logical_page_size <= 0 || MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(params.m_logical_page_size) == false
+                || params.m_logical_page_size <= m_logical_page_object_size || !arena_ptr)
+            {
+                return false;
+            }
+
+            if (uses_logical_page_pool == false && (params.m_logical_page_count <= 0 || !external_buffer))
+            {
+                return false;
+            }
+
+            if (uses_logical_page_pool && concurrency_policy != ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                return false; // Only bounded segments take pages from a pool , unbounded ones grow from the arena
+            }
+
+            if (params.m_logical_page_alignment != 0 && (params.m_logical_page_alignment < params.m_logical_page_size || ModuloUtilities::modulo(params.m_logical_page_alignment, params.m_logical_page_size) != 0))
+            {
+                return false;
+            }
+
+            m_arena = arena_ptr;
+            m_logical_page_size = params.m_logical_page_size;
+            m_logical_pages_per_block = params.m_logical_page_alignment == 0 ? 1 : params.m_logical_page_alignment / params.m_logical_page_size;
+            m_max_object_size = m_logical_page_size - sizeof(LogicalPageHeader);
+
+            if (Pow2Utilities::is_power_of_two(m_logical_pages_per_block) == false)
+            {
+                return false;
+            }
+
+            if (uses_logical_page_pool && m_logical_pages_per_block != 1)
+            {
+                return false; // Pooled slots are shared by segments , therefore they can't be split to smaller logical pages
+            }
+
+            if (ModuloUtilities::modulo(params.m_logical_page_count, m_logical_pages_per_block) != 0)
+            {
+                return false; // Blocks should be full , see m_logical_page_alignment
+            }
+
+            if constexpr (LogicalPageType::supports_any_size())
+            {
+                m_max_object_size = LogicalPageType::get_max_allocation_size(m_max_object_size); // Any size pages also use per page freelist metadata and per allocation headers
+            }
+            m_size_class = params.m_size_class;
+            m_page_recycling_threshold = params.m_page_recycling_threshold;
+            m_grow_coefficient = params.m_grow_coefficient;
+            m_deallocation_queue_drain_budget = params.m_deallocation_queue_drain_budget;
+            m_central_free_list_drain_mask = params.m_central_free_list_drain_interval == 0 ? ~static_cast<uint64_t>(0) : Pow2Utilities::get_first_pow2_of(params.m_central_free_list_drain_interval) - 1;
+            m_logical_page_pool = params.m_logical_page_pool;
+
+            if (params.m_logical_page_count > 0 && grow(external_buffer, params.m_logical_page_count) == nullptr)
+            {
+                return false;
+            }
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                // We are bounded , we want to know our buffer limit
+                m_buffer_length = m_logical_page_size * params.m_logical_page_count;
+            }
+
+            return true;
+        }
+
+        // size=0 means that underlying logical page can hold only one size which is 'm_size_class' which is set by create
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        void* allocate(std::size_t size = 0)
+        {
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                // THREAD LOCAL
+                if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
                 {
-                    m_arena->release_to_system(buffer, m_logical_page_size);
-                    return false;
+                    return allocate_internal(size); // Thread free lists are collected page by page when local freelists run out
                 }
+                else if constexpr (LogicalPageType::supports_any_size()==false) // Underyling type should be used for same size class
+                {
+                    // While pointers in the deallocation queue are deallocated ,one of them will be returned to the allocation requestor
+                    // At most m_deallocation_queue_drain_budget pointers are processed so that allocation latency doesn't depend on the queue depth
+                    void* pointer = process_deallocation_queue<true>(m_deallocation_queue_drain_budget);
 
-                iter_page->mark_as_used();
+                    if (pointer)
+                    {
+                        return pointer;
+                    }
 
-                m_logical_page_count++;
+                    return allocate_internal_after_draining(size);
+                }
+                else
+                {
+                    process_deallocation_queue<false>(m_deallocation_queue_drain_budget);
+                    return allocate_internal_after_draining(size);
+                }
+            }
+            else if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            {
+                if constexpr (LOCKFREE_CENTRAL)
+                {
+                    void* pointer = m_central_free_list.pop();
 
-                return true;
-            };
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // FIRST PAGE
-            if (unlikely(create_new_logical_page(buffer) == false))
+                    if (likely(pointer != nullptr))
+                    {
+                        return pointer;
+                    }
+                }
+
+                // CENTRAL , we are locking the entire segment
+                this->enter_concurrent_context();
+                auto ret = allocate_internal(size);
+                this->leave_concurrent_context();
+                return ret;
+            }
+            else
             {
-                return nullptr;
+                // SINGLE THREADED, NO LOCKS NEEDED
+                return allocate_internal(size);
             }
+        }
 
-            first_new_logical_page = iter_page;
+        // Applies only to logical pages which support any size, as they carve aligned blocks without padding bytes
+        // For fixed size class logical pages, use HeapBase::allocate_aligned which pads and LogicalPage which unpads
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        void* allocate_aligned(std::size_t size, std::size_t alignment)
+        {
+            static_assert(LogicalPageType::supports_any_size());
 
-            if (m_head == nullptr)
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
             {
-                // The very first page
-                m_head = iter_page;
-                m_tail = iter_page;
+                process_deallocation_queue<false>(m_deallocation_queue_drain_budget);
+                return allocate_internal_after_draining(size, alignment);
+            }
+            else if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            {
+                this->enter_concurrent_context();
+                auto ret = allocate_internal(size, alignment);
+                this->leave_concurrent_context();
+                return ret;
             }
             else
             {
-                previous_page->set_next_logical_page(iter_page);
-                iter_page->set_previous_logical_page(previous_page);
+                return allocate_internal(size, alignment);
+            }
+        }
+
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        void deallocate(void* ptr)
+        {
+            if( m_head == nullptr ) { return;}
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                // THREAD LOCAL
+                if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
+                {
+                    get_logical_page_from_address(ptr, m_logical_page_size)->deallocate_to_thread_free_list(ptr); // Lockfree, only touches the page header
+                }
+                else
+                {
+                    m_deallocation_queue.push(ptr); // Lockfree , Q is intrusive so it doesn't allocate
+                }
+            }
+            else if constexpr (LOCKFREE_CENTRAL)
+            {
+                // CENTRAL WITH LOCKFREE FREE LIST , pointers may have been padded by HeapBase::allocate_aligned
+                uint64_t tag = m_central_free_list.push(get_logical_page_from_address(ptr, m_logical_page_size)->get_chunk_start(ptr));
+
+                if (unlikely((tag & m_central_free_list_drain_mask) == 0))
+                {
+                    drain();
+                }
+            }
+            else if constexpr(concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            {
+                // CENTRAL , we are locking entire segment
+                this->enter_concurrent_context();
+                deallocate_internal(ptr);
+                this->leave_concurrent_context();
+            }
+            else
+            {
+                // SINGLE THREADED , NO LOCKS NEEDED
+                deallocate_internal(ptr);
             }
+        }
+
+        // Allocates up to 'count' chunks of m_size_class and links them through their first 8 bytes , the last one pointing to nullptr
+        // Returns the number of allocated chunks. In central case , the segment lock is taken only once for the entire batch. See TransferCache
+        std::size_t allocate_batch(std::size_t count, void** first)
+        {
+            static_assert(LogicalPageType::supports_any_size() == false);
+
+            std::size_t allocated_count = 0;
+            void* head = nullptr;
+
+            if constexpr (LOCKFREE_CENTRAL)
+            {
+                while (allocated_count < count)
+                {
+                    void* pointer = m_central_free_list.pop();
+
+                    if (pointer == nullptr)
+                    {
+                        break;
+                    }
+
+                    TaggedFreeList::set_next(pointer, head); // A pop which started before ours may still be reading the first 8 bytes
+                    head = pointer;
+                    allocated_count++;
+                }
+
+                if (allocated_count == count)
+                {
+                    *first = head;
+                    return allocated_count;
+                }
+            }
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            {
+                this->enter_concurrent_context();
+            }
+
+            while (allocated_count < count)
+            {
+                void* pointer = nullptr;
+
+                if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+                {
+                    pointer = allocate();
+                }
+                else
+                {
+                    pointer = allocate_internal(0);
+                }
+
+                if (pointer == nullptr)
+                {
+                    break;
+                }
+
+                *reinterpret_cast<void**>(pointer) = head;
+                head = pointer;
+                allocated_count++;
+            }
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            {
+                this->leave_concurrent_context();
+            }
+
+            *first = head;
+            return allocated_count;
+        }
+
+        // Chunks from 'first' to 'last' should be linked through their first 8 bytes. See RemoteDeallocationCache and TransferCache
+        // In thread local case with deallocation queues , the entire list is pushed to the queue at once
+        // In central case , the segment lock is taken only once for the entire batch
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        void deallocate_batch(void* first, void* last)
+        {
+            if( m_head == nullptr ) { return;}
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL && remote_deallocation_policy == RemoteDeallocationPolicy::DEALLOCATION_QUEUE)
+            {
+                m_deallocation_queue.push_batch(first, last); // Lockfree , single CAS for the entire batch
+            }
+            else if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                for_each_linked_chunk(first, last, [this](void* chunk) { deallocate(chunk); });
+            }
+            else if constexpr (LOCKFREE_CENTRAL)
+            {
+                // Relinking unpadded chunk starts , then a single CAS for the entire batch
+                void* new_first = nullptr;
+                void* new_last = nullptr;
+
+                for_each_linked_chunk(first, last, [&](void* chunk)
+                {
+                    void* chunk_start = get_logical_page_from_address(chunk, m_logical_page_size)->get_chunk_start(chunk);
+                    TaggedFreeList::set_next(chunk_start, new_first);
+                    new_first = chunk_start;
+                    new_last = new_last == nullptr ? chunk_start : new_last;
+                });
+
+                uint64_t tag = m_central_free_list.push_batch(new_first, new_last);
+
+                if (unlikely((tag & m_central_free_list_drain_mask) == 0))
+                {
+                    drain();
+                }
+            }
+            else
+            {
+                if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+                {
+                    this->enter_concurrent_context();
+                }
+
+                for_each_linked_chunk(first, last, [this](void* chunk) { deallocate_internal(chunk); });
+
+                if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL)
+                {
+                    this->leave_concurrent_context();
+                }
+            }
+        }
+
+        // Should be called only by the owner thread of a thread-local segment
+        // Returns the chunk straight to its logical page, bypassing the deallocation queue or the thread free list of the page
+        // Other concurrency policies don't distinguish owners , therefore they fall back to deallocate
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        void deallocate_from_owner(void* ptr)
+        {
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                if( m_head == nullptr ) { return;}
+                deallocate_internal(ptr); // No synchronisation needed as only the owner thread touches page freelists
+            }
+            else
+            {
+                deallocate(ptr);
+            }
+        }
+
+        // MAY BE CALLED FROM HEAP DEALLOCATION METHODS. IN CASE OF THREAD LOCAL OR CENTRAL HEAP , THAT MEANS MULTIPLE THREADS
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        bool owns_pointer(void* ptr)
+        {
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL || concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            {
+                this->enter_concurrent_context();
+            }
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                // BOUNDED BUFFER
+                uint64_t address_in_question = reinterpret_cast<uint64_t>(ptr);
+
+                if (address_in_question >= reinterpret_cast<uint64_t>(m_head) && address_in_question < (reinterpret_cast<uint64_t>(m_head) + m_buffer_length))
+                {
+                    if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL || concurrency_policy == ConcurrencyPolicy::CENTRAL)
+                    {
+                        this->leave_concurrent_context();
+                    }
+                    return true;
+                }
+            }
+            else
+            {
+                // UNBOUNDED BUFFER , WE NEED A SEARCH
+                std::size_t address = reinterpret_cast<std::size_t>(ptr);
+
+                LogicalPageType* iter = m_head;
+
+                while (iter != nullptr)
+                {
+                    std::size_t start = reinterpret_cast<std::size_t>(iter);
+                    std::size_t end = start + m_logical_page_size;
+
+                    if (address >= start && address < end)
+                    {
+                        if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL || concurrency_policy == ConcurrencyPolicy::CENTRAL)
+                        {
+                            this->leave_concurrent_context();
+                        }
+                        return true;
+                    }
+
+                    iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+                }
+
+            }
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL || concurrency_policy == ConcurrencyPolicy::CENTRAL)
+            {
+                this->leave_concurrent_context();
+            }
+            return false;
+        }
+
+        void recycle_free_logical_pages()
+        {
+            // Should be called only when using deferred recycling
+            if constexpr (page_recycling_policy == PageRecyclingPolicy::IMMEDIATE)
+            {
+                assert(0 == 1);
+            }
+
+            this->enter_concurrent_context();
+            ///////////////////////////////////////////////////////////////////
+            if constexpr (LOCKFREE_CENTRAL)
+            {
+                drain_central_free_list();
+            }
+
+            auto num_logical_pages_to_recycle = m_logical_page_count - m_page_recycling_threshold;
+            LogicalPageType* iter = m_head;
+            LogicalPageType* iter_previous = nullptr;
+
+            while (num_logical_pages_to_recycle && iter != nullptr)
+            {
+                if (iter->can_be_recycled() && is_recyclable(iter))
+                {
+                    recycle_logical_page(iter); // This method will update iter_previous's next ptr
+                    iter = iter_previous != nullptr ? reinterpret_cast<LogicalPageType*>(iter_previous->get_next_logical_page()) : m_head;
+                    num_logical_pages_to_recycle--;
+                }
+                else
+                {
+                    iter_previous = iter;
+                    iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+                }
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            this->leave_concurrent_context();
+        }
+
+        void transfer_logical_pages_from(Segment& from)
+        {
+            this->enter_concurrent_context();
+            ///////////////////////////////////////////////////////////////////
+            LogicalPageType* iter = from.m_head;
+
+            while (iter)
+            {
+                LogicalPageType* iter_next = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+
+                if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
+                {
+                    iter->collect_thread_free_list(); // Late remote deallocations can still arrive after the transfer, allocate_internal will collect them
+                }
+
+                from.remove_logical_page(iter); // Before adding , as adding overwrites iter's previous and next ptrs
+                add_logical_page(iter);
+
+                iter = iter_next;
+            }
+            ///////////////////////////////////////////////////////////////////
+            this->leave_concurrent_context();
+        }
+
+        std::size_t get_usable_size(void* ptr)
+        {
+            if constexpr (LogicalPageType::supports_any_size() == false)
+            {
+                return m_size_class;
+            }
+            else
+            {
+                LogicalPageType* iter = m_head;
+                std::size_t address = reinterpret_cast<std::size_t>(ptr);
+
+                while (iter != nullptr)
+                {
+                    std::size_t start = reinterpret_cast<std::size_t>(iter);
+                    std::size_t end = start + m_logical_page_size;
+
+                    if (address >= start && address < end)
+                    {
+                        return iter->get_usable_size(ptr);
+                    }
+
+                    iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+                }
+
+                return 0;
+            }
+        }
+
+        // Constant time logical page look up method for finding logical pages if their start addresses are aligned to logical page size
+        static LogicalPageType* get_logical_page_from_address(void* ptr, std::size_t logical_page_size)
+        {
+            static_assert(buffer_aligned_to_logical_page_size == true);
+            
+            uint64_t orig_ptr = reinterpret_cast<uint64_t>(ptr);
+            // Masking below is equivalent of -> orig_ptr - ModuloUtilities::modulo(orig_ptr, logical_page_size);
+            uint64_t target_page_address = orig_ptr & ~(logical_page_size - 1);
+            LogicalPageType* target_logical_page = reinterpret_cast<LogicalPageType*>(target_page_address);
+            return target_logical_page;
+        }
+
+        // Constant time size_class look up method for finding logical pages if their start addresses are aligned to logical page size
+        static uint32_t get_size_class_from_address(void* ptr, std::size_t logical_page_size)
+        {
+            static_assert(buffer_aligned_to_logical_page_size == true);
+            
+            LogicalPageType* target_logical_page = get_logical_page_from_address(ptr, logical_page_size);
+            return target_logical_page->get_size_class();
+        }
+
+        // Should be called only by the owner thread of a thread-local segment, for ex when it is idle
+        // Processes up to 'budget' queued remote deallocations , 0 means all of them. Returns the number of processed deallocations
+        // Central segments with lockfree free lists can be drained by any thread , all chunks in the free list go back to their logical pages regardless of 'budget'
+        std::size_t drain(std::size_t budget = 0)
+        {
+            std::size_t processed_count = 0;
+
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL && remote_deallocation_policy == RemoteDeallocationPolicy::DEALLOCATION_QUEUE)
+            {
+                process_deallocation_queue<false>(budget, &processed_count);
+            }
+            else if constexpr (LOCKFREE_CENTRAL)
+            {
+                UNUSED(budget);
+                this->enter_concurrent_context();
+                processed_count = drain_central_free_list();
+                this->leave_concurrent_context();
+            }
+            else
+            {
+                UNUSED(budget);
+            }
+
+            return processed_count;
+        }
+
+        // Locks each logical page with a single call. Already locked ones are skipped. Locked logical pages are unlocked by unlock_pages or when they are recycled
+        // Returns false if any of them can't be locked
+        bool lock_pages()
+        {
+            bool success = true;
+
+            this->enter_concurrent_context();
+            ///////////////////////////////////////////////////////////////////
+            LogicalPageType* iter = m_head;
+
+            while (iter)
+            {
+                if (iter->is_locked() == false)
+                {
+                    if (VirtualMemory::lock(reinterpret_cast<void*>(iter), m_logical_page_size))
+                    {
+                        iter->mark_as_locked();
+                    }
+                    else
+                    {
+                        success = false;
+                    }
+                }
+
+                iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+            }
+            ///////////////////////////////////////////////////////////////////
+            this->leave_concurrent_context();
+
+            return success;
+        }
+
+        void unlock_pages()
+        {
+            this->enter_concurrent_context();
+            ///////////////////////////////////////////////////////////////////
+            LogicalPageType* iter = m_head;
+
+            while (iter)
+            {
+                if (iter->is_locked())
+                {
+                    VirtualMemory::unlock(reinterpret_cast<void*>(iter), m_logical_page_size);
+                    iter->mark_as_non_locked();
+                }
+
+                iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+            }
+            ///////////////////////////////////////////////////////////////////
+            this->leave_concurrent_context();
+        }
+
+        #ifdef UNIT_TEST
+        std::size_t get_logical_page_count() const { return m_logical_page_count; }
+        #endif
+
+        #ifdef ENABLE_STATS
+        SegmentStats get_stats() { m_stats.m_latest_logical_page_count = m_logical_page_count; return m_stats; }
+        #endif
+
+        
+        std::size_t get_size_class() const
+        {
+            return m_size_class;
+        }
+
+    private:
+        uint32_t m_size_class = 0;                    // if m_size_class is zero that means, underlying logical page can hold any size
+        std::size_t m_logical_page_size = 0;            // It includes also m_logical_page_object_size
+        std::size_t m_logical_pages_per_block = 1;      // More than 1 if logical pages are grouped in blocks of a bigger alignment , see SegmentCreationParameters::m_logical_page_alignment
+        std::size_t m_max_object_size = 0;
+        std::size_t m_logical_page_object_size = 0;
+        std::size_t m_logical_page_count = 0;
+        std::size_t m_buffer_length = 0;  // Applies to only bounded segments
+        LogicalPageType* m_head = nullptr;
+        LogicalPageType* m_tail = nullptr;
+        LogicalPageType* m_last_used = nullptr;
+        std::size_t m_page_recycling_threshold = 0; // In auto page recycling mode, if a logical page is free after deallocation ,
+                                                    // it will be given back to system if free l.page count is over that threshold
+        double m_grow_coefficient = 1.0;            // Applies to unbounded segments
+        std::size_t m_deallocation_queue_drain_budget = 0; // 0 means no limit
+        uint64_t m_central_free_list_drain_mask = ~static_cast<uint64_t>(0); // Free list tags which have none of these bits set trigger drains
+        DeallocationQueue m_deallocation_queue;
+        TaggedFreeList m_central_free_list;         // Exists in all segments so that layouts don't depend on policies, as thread local heaps are transferred to central heaps
+        LogicalPagePool* m_logical_page_pool = nullptr; // Not owned , applies to bounded segments
+        ArenaType* m_arena = nullptr;
+
+        static constexpr inline bool LOCKFREE_CENTRAL = concurrency_policy == ConcurrencyPolicy::CENTRAL && central_free_list_policy == CentralFreeListPolicy::LOCKFREE;
+
+        #ifdef ENABLE_STATS
+        SegmentStats m_stats;
+        #endif
+
+        // Returns first logical page ptr of the grow
+        [[nodiscard]] LogicalPageType* grow(char* buffer, std::size_t logical_page_count)
+        {
+            LogicalPageType* first_new_logical_page = nullptr;
+            LogicalPageType* previous_page = m_tail;
+            LogicalPageType* iter_page = nullptr;
+
+            auto create_new_logical_page = [&](char* logical_page_buffer) -> bool
+            {
+                iter_page = new(logical_page_buffer) LogicalPageType();
+
+                bool success = iter_page->create(logical_page_buffer + m_logical_page_object_size, m_logical_page_size - m_logical_page_object_size, m_size_class);
+
+                if (success == false)
+                {
+                    m_arena->release_to_system(buffer, m_logical_page_size);
+                    return false;
+                }
+
+                iter_page->mark_as_used();
+                m_logical_page_count++;
+
+                return true;
+            };
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // FIRST PAGE
+            if (unlikely(create_new_logical_page(buffer) == false))
+            {
+                return nullptr;
+            }
+
+            first_new_logical_page = iter_page;
+
+            if (m_head == nullptr)
+            {
+                // The very first page
+                m_head = iter_page;
+                m_tail = iter_page;
+            }
+            else
+            {
+                previous_page->set_next_logical_page(iter_page);
+                iter_page->set_previous_logical_page(previous_page);
+            }
+
+            previous_page = iter_page;
+
+            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+            // REST OF THE PAGES
+            for (std::size_t i = 1; i < logical_page_count; i++)
+            {
+                if (create_new_logical_page(buffer + (i * m_logical_page_size)) == false)
+                {
+                    return nullptr;
+                }
+
+                previous_page->set_next_logical_page(iter_page);
+                iter_page->set_previous_logical_page(previous_page);
+                previous_page = iter_page;
+            }
+
+            m_tail = iter_page;
+
+            return first_new_logical_page;
+        }
+
+        // The first logical page of a block holds the header which size class lookups of the whole block find , see SegmentCreationParameters::m_logical_page_alignment
+        bool is_recyclable(LogicalPageType* logical_page) const
+        {
+            return m_logical_pages_per_block == 1 || ModuloUtilities::modulo_pow2(reinterpret_cast<uint64_t>(logical_page), m_logical_page_size * m_logical_pages_per_block) != 0;
+        }
+
+        void recycle_logical_page(LogicalPageType* affected)
+        {
+            remove_logical_page(affected);
+
+            if (affected->is_locked())
+            {
+                // Otherwise the pool slot would stay locked for its next user and releasing it to the system could fail
+                VirtualMemory::unlock(reinterpret_cast<void*>(affected), m_logical_page_size);
+            }
+
+            affected->~LogicalPageType();
+
+            if (m_logical_page_pool != nullptr)
+            {
+                m_logical_page_pool->push(affected); // Another segment of the same heap can use it
+            }
+            else
+            {
+                m_arena->release_to_system(affected, m_logical_page_size);
+            }
+            #ifdef ENABLE_STATS
+            m_stats.m_recycle_count++;
+            #endif
+
+        }
+
+        void remove_logical_page(LogicalPageType* affected)
+        {
+            auto next = reinterpret_cast<LogicalPageType*>(affected->get_next_logical_page());
+            auto previous = reinterpret_cast<LogicalPageType*>(affected->get_previous_logical_page());
+
+            if (affected == m_last_used)
+            {
+                if (previous)
+                {
+                    m_last_used = previous;
+                }
+                else if (next)
+                {
+                    m_last_used = next;
+                }
+                else
+                {
+                    m_last_used = nullptr;
+                }
+            }
+
+            if (previous == nullptr)
+            {
+                m_head = next;
+
+                if (m_head == nullptr || m_head->get_next_logical_page() == 0)
+                {
+                    m_tail = m_head;
+                }
+            }
+            else
+            {
+                previous->set_next_logical_page(next);
+
+                if (m_tail == affected)
+                {
+                    m_tail = previous;
+                }
+            }
+
+            if (next)
+                next->set_previous_logical_page(previous);
+
+            m_logical_page_count--;
+        }
+
+        void add_logical_page(LogicalPageType* logical_page)
+        {
+            if (m_tail)
+            {
+                m_tail->set_next_logical_page(logical_page);
+                logical_page->set_previous_logical_page(m_tail);
+            }
+            else
+            {
+                m_head = logical_page;
+                logical_page->set_previous_logical_page(nullptr);
+            }
+
+            m_tail = logical_page;
+            logical_page->set_next_logical_page(nullptr);
+            m_logical_page_count++;
+        }
+
+        void destroy()
+        {
+            if constexpr (concurrency_policy==ConcurrencyPolicy::THREAD_LOCAL && remote_deallocation_policy == RemoteDeallocationPolicy::DEALLOCATION_QUEUE)
+            {
+                process_deallocation_queue();
+            }
+
+            if constexpr (LOCKFREE_CENTRAL)
+            {
+                // No other thread is supposed to be using the segment anymore , chunks can go back to their logical pages
+                void* pointer = m_central_free_list.pop_all();
+
+                while (pointer != nullptr)
+                {
+                    void* next = TaggedFreeList::get_next(pointer);
+                    get_logical_page_from_address(pointer, m_logical_page_size)->deallocate(pointer);
+                    pointer = next;
+                }
+            }
+
+            LogicalPageType* iter = m_head;
+            LogicalPageType* next = nullptr;
+
+            while (iter)
+            {
+                next = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+
+                if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
+                {
+                    iter->collect_thread_free_list();
+                }
+                /////////////////////////////////////////////////////////////////////////////
+                #ifdef ENABLE_REPORT_LEAKS
+                if (iter->get_used_size() != 0)
+                {
+                    FILE* leak_report = nullptr;
+                    leak_report = fopen("leaks.txt", "a+"); // does not allocate memory
+            
+                    if (leak_report) 
+                    {
+                        if(m_size_class!=0)
+                        {
+                            fprintf(leak_report, "Potential memory leak : sizeclass=%zu count=%zu\n", static_cast<std::size_t>(m_size_class), static_cast<std::size_t>(iter->get_used_size() / m_size_class));
+                        }
+                        else
+                        {
+                            fprintf(leak_report, "Potential memory leak : total size=%zu \n", static_cast<std::size_t>(iter->get_used_size()));
+                        }
+                        
+                        fclose(leak_report);
+                    }
+                    else
+                    {
+                        fprintf(stderr, "Failed to open leaks.txt for writing\n"); // does not allocate memory
+                    }
+                }
+                #endif
+
+                // There still maybe unloaded dynamic libraries (shared objects or DLLs) loaded by the host process
+                // Even worse there may be unloaded but memory-leaking dynamic libraries
+                // If we destroy a segment which has not been deallocated fully, we will crash, therefore this check is needed
+                // If it is not possible to destroy then OS will reclaim virtual memory pages as soon as the host process dies.
+                if (iter->get_used_size() == 0)
+                {
+                    // Invoking dtor of logical page
+                    iter->~LogicalPageType();
+                    // Release pages back to system if we are managing the arena
+                    m_arena->release_to_system(iter, m_logical_page_size);
+                }
+
+                /////////////////////////////////////////////////////////////////////////////
+                iter = next;
+            }
+
+            m_head = nullptr;
+            m_tail = nullptr;
+        }
+
+        // DEALLOCATES POINTERS IN THE DEALLOCATION QUEUE , AT MOST 'budget' OF THEM IF BUDGET IS NOT ZERO
+        // IF THE CALLER IS ALLOCATOR INITIAL POINTER WON'T BE DEALLOCATED BUT INSTEAD RETURNED TO THE CALLER
+        // TO SERVE ALLOCATIONS AS FAST AS POSSIBLE
+        template <bool return_initial_pointer=false>
+        void* process_deallocation_queue(std::size_t budget = 0, std::size_t* processed_count = nullptr)
+        {
+            void* ret = nullptr;
+            std::size_t count = 0;
+
+            while (budget == 0 || count < budget)
+            {
+                auto pointer = m_deallocation_queue.pop();
+
+                if (pointer == nullptr)
+                {
+                    break;
+                }
+
+                count++;
+
+                if constexpr (return_initial_pointer)
+                {
+                    if (likely(ret != nullptr))
+                    {
+                        deallocate_internal(pointer);
+                    }
+                    else
+                    {
+                        ret = pointer;
+                    }
+                }
+                else
+                {
+                    deallocate_internal(pointer);
+                }
+            }
+
+            if (processed_count)
+            {
+                *processed_count = count;
+            }
+
+            return ret;
+        }
+
+        // Thread local segments can't grow , therefore before failing an allocation we drain the rest of the deallocation queue and retry
+        void* allocate_internal_after_draining(std::size_t size, std::size_t alignment = 0)
+        {
+            void* ret = allocate_internal(size, alignment);
+
+            if (unlikely(ret == nullptr))
+            {
+                std::size_t processed_count = 0;
+                process_deallocation_queue<false>(0, &processed_count);
+
+                if (processed_count > 0)
+                {
+                    ret = allocate_internal(size, alignment);
+                }
+            }
+
+            return ret;
+        }
+
+        FORCE_INLINE void* allocate_from_logical_page(LogicalPageType* logical_page, std::size_t size, std::size_t alignment)
+        {
+            if constexpr (LogicalPageType::supports_any_size())
+            {
+                return logical_page->allocate_aligned(size, alignment);
+            }
+            else
+            {
+                UNUSED(alignment);
+                void* ret = logical_page->allocate(size);
+
+                if constexpr (remote_deallocation_policy == RemoteDeallocationPolicy::THREAD_FREE_LIST)
+                {
+                    // Local freelist is exhausted, take over all deallocations which other threads made on this page and retry
+                    if (ret == nullptr && logical_page->collect_thread_free_list() > 0)
+                    {
+                        ret = logical_page->allocate(size);
+                    }
+                }
+
+                return ret;
+            }
+        }
+
+        [[nodiscard]] void* allocate_internal(std::size_t size, std::size_t alignment = 0)
+        {
+
+            if (unlikely(size > m_max_object_size))
+            {
+                return nullptr;
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            // Next-fit like , we start searching from where we left if possible
+            void* ret = nullptr;
+            LogicalPageType* iter = m_last_used ? m_last_used : m_head;
+
+            while (iter)
+            {
+                ret = allocate_from_logical_page(iter, size, alignment);
+
+                if (ret != nullptr)
+                {
+                    m_last_used = iter;
+
+                    return ret;
+                }
+
+                iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+            }
+            ///////////////////////////////////////////////////////////////////
+            // If we started the search from a non-head node,  then we need one more iteration
+            if (m_last_used)
+            {
+                iter = m_head;
+
+                while (iter != m_last_used)
+                {
+                    ret = allocate_from_logical_page(iter, size, alignment);
+
+                    if (ret != nullptr)
+                    {
+                        m_last_used = iter;
+
+                        return ret;
+                    }
+
+                    iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+                }
+            }
+            ///////////////////////////////////////////////////////////////////
+            // If we reached here , it means that we need to allocate more memory
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL) // Bounded segments can only take a logical page from their heap's pool
+            {
+                if (m_logical_page_pool != nullptr)
+                {
+                    char* slot = static_cast<char*>(m_logical_page_pool->pop());
+
+                    if (slot != nullptr)
+                    {
+                        auto new_logical_page = grow(slot, 1);
+
+                        if (new_logical_page)
+                        {
+                            ret = allocate_from_logical_page(new_logical_page, size, alignment);
+
+                            if (ret != nullptr)
+                            {
+                                m_last_used = new_logical_page;
+                                return ret;
+                            }
+                        }
+                    }
+                }
+            }
+            else if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL || concurrency_policy == ConcurrencyPolicy::SINGLE_THREAD) // Only unbounded concurrecy policies can grow
+            {
+                std::size_t new_logical_page_count = 0;
+                std::size_t minimum_new_logical_page_count = 0;
+                calculate_quantities(size + alignment, new_logical_page_count, minimum_new_logical_page_count);
+
+                char* new_buffer = nullptr;
+                new_buffer = static_cast<char*>(m_arena->allocate(m_logical_page_size * new_logical_page_count));
+
+                if (new_buffer == nullptr && new_logical_page_count > minimum_new_logical_page_count)  // Meeting grow_coefficient is not possible so lower the new_logical_page_count
+                {
+                    new_logical_page_count = minimum_new_logical_page_count;
+                    new_buffer = static_cast<char*>(m_arena->allocate(m_logical_page_size * new_logical_page_count));
+                }
+
+                if (!new_buffer)
+                {
+                    return nullptr;
+                }
+
+                auto first_new_logical_page = grow(new_buffer, new_logical_page_count);
+
+                #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
+                fprintf(stderr, "segment grow size=%zu  sizeclass=%u\n", size, m_size_class);
+                #endif
+
+                #ifdef ENABLE_STATS
+                if(m_stats.m_grow_size_count<MAX_GROW_STAT_COUNT)
+                {
+                    m_stats.m_grow_sizes[m_stats.m_grow_size_count] = new_logical_page_count;
+                    m_stats.m_grow_size_count++;
+                }
+                #endif
+
+                if (first_new_logical_page)
+                {
+                    ret = allocate_from_logical_page(first_new_logical_page, size, alignment);
+
+                    if (ret != nullptr)
+                    {
+                        m_last_used = first_new_logical_page;
+
+                        return ret;
+                    }
+                }
+
+            }
+
+            // OUT OF MEMORY !
+            return nullptr;
+        }
+
+        void calculate_quantities(const std::size_t size, std::size_t& desired_new_logical_page_count, std::size_t& minimum_new_logical_page_count)
+        {
+            if constexpr (LogicalPageType::supports_any_size()) // That means size will be arbitrary therefore the size may not suffice
+            {
+                minimum_new_logical_page_count = SizeUtilities::get_required_page_count_for_allocation(m_logical_page_size, m_logical_page_object_size, size, 1);
+            }
+            else
+            {
+                minimum_new_logical_page_count = SizeUtilities::get_required_page_count_for_allocation(m_logical_page_size, m_logical_page_object_size, m_size_class, size / m_size_class);
+            }
+
+            if ( likely(m_grow_coefficient > 0))
+            {
+                desired_new_logical_page_count = static_cast<std::size_t>(m_logical_page_count * m_grow_coefficient);
+
+                if (desired_new_logical_page_count < minimum_new_logical_page_count)
+                {
+                    desired_new_logical_page_count = minimum_new_logical_page_count;
+                }
+            }
+            else
+            {
+                desired_new_logical_page_count = minimum_new_logical_page_count;
+            }
+
+            if (m_logical_pages_per_block > 1)
+            {
+                // Grows are made of full blocks
+                minimum_new_logical_page_count = MultipleUtilities::get_next_pow2_multiple_of(minimum_new_logical_page_count, m_logical_pages_per_block);
+                desired_new_logical_page_count = MultipleUtilities::get_next_pow2_multiple_of(desired_new_logical_page_count, m_logical_pages_per_block);
+            }
+        }
+
+        template <typename Function>
+        static void for_each_linked_chunk(void* first, void* last, Function function)
+        {
+            void* iter = first;
+
+            while (true)
+            {
+                // Deallocations overwrite the first 8 bytes of chunks therefore the next pointer needs to be read before
+                void* next = *reinterpret_cast<void**>(iter);
+                bool is_last = iter == last;
+
+                function(iter);
+
+                if (is_last)
+                {
+                    break;
+                }
+
+                iter = next;
+            }
+        }
+
+        // Segment lock should be held. Chunks in the lockfree free list go back to their logical pages , so that empty logical pages can be recycled
+        std::size_t drain_central_free_list()
+        {
+            void* chunk = m_central_free_list.pop_all();
+            m_central_free_list.wait_for_pops(); // Pops which started before pop_all may still be reading next pointers of these chunks
+
+            std::size_t count = 0;
+
+            while (chunk != nullptr)
+            {
+                void* next = TaggedFreeList::get_next(chunk); // Deallocations overwrite the first 8 bytes of chunks therefore the next pointer needs to be read before
+                deallocate_internal(chunk);
+                chunk = next;
+                count++;
+            }
+
+            return count;
+        }
+
+        void deallocate_internal(void* ptr)
+        {
+            if constexpr (buffer_aligned_to_logical_page_size == true)
+            {
+                deallocate_from_aligned_logical_page(ptr);
+            }
+            else
+            {
+                deallocate_by_search(ptr);
+            }
+        }
+
+        // WARNING : WHEN CALLING THIS ONE YOU HAVE TO MAKE SURE THAT ALL LOGICAL PAGES ARE
+        // PLACED AT m_logical_page_size ALIGNED ADDRESSES
+        void deallocate_from_aligned_logical_page(void* ptr)
+        {
+            auto affected = get_logical_page_from_address(ptr, m_logical_page_size);
+
+            affected->deallocate(ptr);
+
+            if (affected->get_used_size() == 0)
+            {
+                affected->mark_as_non_used();
+
+                if constexpr (page_recycling_policy == PageRecyclingPolicy::IMMEDIATE)
+                {
+                    if (m_logical_page_count > m_page_recycling_threshold && is_recyclable(affected))
+                    {
+                        recycle_logical_page(affected);
+                    }
+                }
+            }
+        }
+
+        // MAKES A LINEAR SEARCH
+        void deallocate_by_search(void* ptr)
+        {
+            std::size_t address = reinterpret_cast<std::size_t>(ptr);
+            LogicalPageType* iter = m_head;
+
+            while (iter != nullptr)
+            {
+                std::size_t start = reinterpret_cast<std::size_t>(iter);
+                std::size_t end = start + m_logical_page_size;
+
+                if (address >= start && address < end)
+                {
+                    iter->deallocate(ptr);
+
+                    if (iter->get_used_size() == 0)
+                    {
+                        iter->mark_as_non_used();
+
+                        if constexpr (page_recycling_policy == PageRecyclingPolicy::IMMEDIATE)
+                        {
+                            if (m_logical_page_count > m_page_recycling_threshold && is_recyclable(iter))
+                            {
+                                recycle_logical_page(iter);
+                            }
+                        }
+                    }
+
+                    return;
+                }
+                iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
+            }
+        }
+};
+
+#endif
+//INTERFACE FOR HEAPS WITH ONE CONCRETE IMPLEMENTATION : HeapBase::allocate_aligned
+#ifndef __HEAP_BASE_H__
+#define __HEAP_BASE_H__
+
+// Heaps which provide 'static constexpr bool has_bin_for_size(std::size_t)' resolve bins of compile time sizes. See HeapBase::allocate<size>
+template <typename HeapType, typename = void>
+struct HasCompileTimeBins : std::false_type {};
+
+template <typename HeapType>
+struct HasCompileTimeBins<HeapType, std::void_t<decltype(HeapType::has_bin_for_size(0))>> : std::true_type {};
+
+template <typename HeapImplementation, ConcurrencyPolicy concurrency_policy = ConcurrencyPolicy::SINGLE_THREAD>
+class HeapBase
+{
+    public:
+        HeapBase() = default;
+        ~HeapBase() = default;
+        HeapBase(const HeapBase& other) = delete;
+        HeapBase& operator= (const HeapBase& other) = delete;
+        HeapBase(HeapBase&& other) = delete;
+        HeapBase& operator=(HeapBase&& other) = delete;
+
+        [[nodiscard]] void* allocate(std::size_t size) { return static_cast<HeapImplementation*>(this)->allocate(size); }
+
+        /*
+            For sizes known at compile time , for ex sizeof(T)
+
+            If the heap has compile time bins ( see HasCompileTimeBins ) , it also needs to implement
+            'static constexpr std::size_t get_bin_index_from_size(std::size_t)' and 'allocate_from_bin<bin_index>' , 'deallocate_from_bin<bin_index>' , 'deallocate_from_owner_to_bin<bin_index>'
+            Then there is no size to bin lookup at runtime. Otherwise they are same as the runtime versions
+
+            Heaps which declare their own allocate/deallocate/deallocate_from_owner should bring these ones in with using declarations
+        */
+        template <std::size_t size>
+        static constexpr bool has_compile_time_bin()
+        {
+            if constexpr (HasCompileTimeBins<HeapImplementation>::value)
+            {
+                return HeapImplementation::has_bin_for_size(size);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <std::size_t size>
+        [[nodiscard]] FORCE_INLINE void* allocate()
+        {
+            if constexpr (has_compile_time_bin<size>())
+            {
+                return static_cast<HeapImplementation*>(this)->template allocate_from_bin<HeapImplementation::get_bin_index_from_size(size)>();
+            }
+            else
+            {
+                return static_cast<HeapImplementation*>(this)->allocate(size);
+            }
+        }
+
+        template <std::size_t size>
+        FORCE_INLINE void deallocate(void* ptr)
+        {
+            if constexpr (has_compile_time_bin<size>())
+            {
+                static_cast<HeapImplementation*>(this)->template deallocate_from_bin<HeapImplementation::get_bin_index_from_size(size)>(ptr);
+            }
+            else
+            {
+                static_cast<HeapImplementation*>(this)->deallocate(ptr);
+            }
+        }
+
+        template <std::size_t size>
+        FORCE_INLINE void deallocate_from_owner(void* ptr)
+        {
+            if constexpr (has_compile_time_bin<size>())
+            {
+                static_cast<HeapImplementation*>(this)->template deallocate_from_owner_to_bin<HeapImplementation::get_bin_index_from_size(size)>(ptr);
+            }
+            else
+            {
+                static_cast<HeapImplementation*>(this)->deallocate_from_owner(ptr);
+            }
+        }
+
+        /*
+            Alignment has to be a power of two
+
+            Note that if alignment sizes are too large , than memory will be wasted in unncesserily big padding bytes.
+            If that is the case , override this method in your CRTP derived heap class
+            And call this base method only if alignment size is small. Otherwise redirect it to a bin that uses logical_page_any_size ( for ex big object)
+            as also logical_page_any_size can handle alignments and it will also be minimising used padding bytes during its search in its freelist
+            
+            As for deallocations, since LogicalPage holds free chunks for only one sizeclass and since it knows it start address, it re-adjusts the pointer during deallocation
+        */
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        void* allocate_aligned(std::size_t size, std::size_t alignment)
+        {
+            if (alignment <= MINIMUM_ALIGNMENT)
+            {
+                // Framework already provides minimum 16 bit alignment
+                return allocate(size);
+            }
+
+            std::size_t adjusted_size = size + alignment; // Adding padding bytes
+            /////////////////////////////////////////////
+            auto ptr = allocate(adjusted_size);
+            /////////////////////////////////////////////
+            std::size_t offset = alignment - (ModuloUtilities::modulo_pow2((reinterpret_cast<std::uint64_t>(ptr)), alignment));
+            void* ret = reinterpret_cast<void*>(reinterpret_cast<std::uint64_t>(ptr) + offset);
+            return ret;
+        }
+
+        // Should be called only from bounded heaps as unbounded heaps may not have contigious memory
+        // Only Central and SingleThread concurrency policies are unbounded
+        // In other words owns_pointer is supposed to be called from only Thread Local or CPU Local heaps
+        // Bounded heaps can also grow by a few extra regions ( see add_extra_region ) , they are checked after the initial buffer
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        bool owns_pointer(void* ptr)
+        {
+            if constexpr (concurrency_policy != ConcurrencyPolicy::THREAD_LOCAL)
+            {
+                assert(0 == 1);
+            }
+
+            uint64_t address_in_question = reinterpret_cast<uint64_t>(ptr);
+
+            if ( address_in_question >= m_buffer_address && address_in_question < m_buffer_address + m_buffer_length )
+            {
+                return true;
+            }
+
+            // Other threads may call it while the owner thread adds a region , the count is published after the region address
+            uint64_t extra_region_count = builtin_atomic_load64(&m_extra_region_count);
+
+            for (uint64_t i = 0; i < extra_region_count; i++)
+            {
+                if ( address_in_question >= m_extra_regions->m_addresses[i] && address_in_question < m_extra_regions->m_addresses[i] + m_extra_regions->m_region_length )
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        std::size_t get_extra_region_count() { return static_cast<std::size_t>(builtin_atomic_load64(&m_extra_region_count)); }
+
+    protected:
+        static constexpr inline std::size_t MAX_EXTRA_REGION_COUNT = 8; // Keeps owns_pointer cheap
+
+        // Kept out of the heap as heaps live in ScalableAllocator's metadata , only heaps which can grow have one
+        struct ExtraRegionTable
+        {
+            std::size_t m_region_length = 0;       // All extra regions of a heap have the same length
+            std::size_t m_max_region_count = 0;
+            uint64_t m_addresses[MAX_EXTRA_REGION_COUNT] = {};
+        };
+
+        uint64_t m_buffer_address = 0;
+        std::size_t m_buffer_length = 0;
+        ExtraRegionTable* m_extra_regions = nullptr;
+        uint64_t m_extra_region_count = 0;
+
+        template <typename MetadataAllocator>
+        bool create_extra_region_table(std::size_t region_length, std::size_t max_region_count)
+        {
+            m_extra_regions = static_cast<ExtraRegionTable*>(MetadataAllocator::allocate(sizeof(ExtraRegionTable)));
+
+            if (m_extra_regions == nullptr)
+            {
+                return false;
+            }
+
+            new(m_extra_regions) ExtraRegionTable();    // Placement new , does not invoke memory allocation
+            m_extra_regions->m_region_length = region_length;
+            m_extra_regions->m_max_region_count = max_region_count;
+            return true;
+        }
+
+        template <typename MetadataAllocator>
+        void destroy_extra_region_table()
+        {
+            if (m_extra_regions != nullptr)
+            {
+                MetadataAllocator::deallocate(m_extra_regions, sizeof(ExtraRegionTable));
+                m_extra_regions = nullptr;
+            }
+        }
+
+        bool can_add_extra_region() const
+        {
+            return m_extra_regions != nullptr && m_extra_region_count < m_extra_regions->m_max_region_count;
+        }
+
+        // Should be called only by the owner thread after can_add_extra_region
+        void add_extra_region(void* address)
+        {
+            m_extra_regions->m_addresses[m_extra_region_count] = reinterpret_cast<uint64_t>(address);
+            builtin_atomic_exchange64(&m_extra_region_count, m_extra_region_count + 1);
+        }
+        static constexpr inline std::size_t MINIMUM_ALIGNMENT = 16;
+};
+
+#endif
+/*
+    PER THREAD BUFFERS FOR DEALLOCATIONS TARGETING HEAPS OF OTHER THREADS
+
+    - EACH ENTRY COLLECTS CHUNKS OF ONE SIZE CLASS OF ONE DESTINATION HEAP AND HANDS THEM TO THE HEAP AS ONE BATCH WHEN IT IS FULL.
+      THEREFORE A DESTINATION DEALLOCATION QUEUE SEES A SINGLE PUSH PER BATCH INSTEAD OF ONE PER CHUNK
+
+    - IT IS INTRUSIVE : FIRST 8 BYTES OF EACH BUFFERED CHUNK HOLD THE NEXT POINTER , IN THE SAME WAY AS DEALLOCATION QUEUES.
+      SO A BATCH CAN BE PUSHED TO A DEALLOCATION QUEUE AS IS
+
+    - ALL ENTRIES ARE FLUSHED AFTER EVERY 'flush_interval' BUFFERED DEALLOCATIONS , SO THAT CHUNKS OF RARELY USED ENTRIES DON'T STAY FOR LONG.
+      WHEN ALL ENTRIES ARE IN USE , ENTRIES ARE EVICTED IN ROUND ROBIN
+
+    - IT IS NOT THREAD SAFE , IT IS SUPPOSED TO BE USED ONLY BY ITS OWNER THREAD
+
+    - DESTINATION HEAPS NEED TO IMPLEMENT 'void deallocate_batch(void* first, void* last)'
+*/
+#ifndef __REMOTE_DEALLOCATION_CACHE__
+#define __REMOTE_DEALLOCATION_CACHE__
+
+template <typename HeapType, std::size_t entry_count = 8>
+class RemoteDeallocationCache
+{
+    public:
+
+        RemoteDeallocationCache() = default;
+        ~RemoteDeallocationCache() = default;
+
+        RemoteDeallocationCache(const RemoteDeallocationCache& other) = delete;
+        RemoteDeallocationCache& operator= (const RemoteDeallocationCache& other) = delete;
+        RemoteDeallocationCache(RemoteDeallocationCache&& other) = delete;
+        RemoteDeallocationCache& operator=(RemoteDeallocationCache&& other) = delete;
+
+        // 'flush_interval' 0 means no periodic flushes
+        FORCE_INLINE void add(HeapType* destination, uint32_t size_class, void* pointer, std::size_t batch_size, std::size_t flush_interval)
+        {
+            Entry* target = nullptr;
+            Entry* empty_entry = nullptr;
+
+            for (std::size_t i = 0; i < entry_count; i++)
+            {
+                if (m_entries[i].m_destination == destination && m_entries[i].m_size_class == size_class)
+                {
+                    target = &m_entries[i];
+                    break;
+                }
+
+                if (empty_entry == nullptr && m_entries[i].m_destination == nullptr)
+                {
+                    empty_entry = &m_entries[i];
+                }
+            }
+
+            if (unlikely(target == nullptr))
+            {
+                if (empty_entry == nullptr)
+                {
+                    empty_entry = &m_entries[m_next_evicted_entry_index];
+                    m_next_evicted_entry_index = (m_next_evicted_entry_index + 1) % entry_count;
+                    flush_entry(empty_entry);
+                }
+
+                target = empty_entry;
+                target->m_destination = destination;
+                target->m_size_class = size_class;
+                target->m_last = pointer;
+            }
+
+            *reinterpret_cast<void**>(pointer) = target->m_first;
+            target->m_first = pointer;
+            target->m_count++;
+
+            if (target->m_count >= batch_size)
+            {
+                flush_entry(target);
+            }
+
+            m_buffered_count_since_last_flush++;
+
+            if (flush_interval != 0 && m_buffered_count_since_last_flush >= flush_interval)
+            {
+                flush();
+            }
+        }
+
+        void flush()
+        {
+            for (std::size_t i = 0; i < entry_count; i++)
+            {
+                flush_entry(&m_entries[i]);
+            }
+
+            m_buffered_count_since_last_flush = 0;
+        }
+
+    private:
+
+        struct Entry
+        {
+            HeapType* m_destination = nullptr;
+            void* m_first = nullptr;
+            void* m_last = nullptr;
+            uint32_t m_size_class = 0;
+            uint32_t m_count = 0;
+        };
+
+        Entry m_entries[entry_count];
+        std::size_t m_next_evicted_entry_index = 0;
+        std::size_t m_buffered_count_since_last_flush = 0;
+
+        void flush_entry(Entry* entry)
+        {
+            if (entry->m_destination != nullptr)
+            {
+                entry->m_destination->deallocate_batch(entry->m_first, entry->m_last);
+            }
+
+            entry->m_destination = nullptr;
+            entry->m_first = nullptr;
+            entry->m_last = nullptr;
+            entry->m_size_class = 0;
+            entry->m_count = 0;
+        }
+};
+
+#endif
+
+/*
+    PER THREAD CACHE BETWEEN A CENTRAL HEAP AND A THREAD LOCAL HEAP
+
+    - USED AFTER A LOCAL HEAP IS EXHAUSTED FOR A SIZE CLASS. INSTEAD OF LOCKING THE CENTRAL HEAP FOR EACH ALLOCATION ,
+      IT TAKES A BATCH OF CHUNKS FROM THE CENTRAL HEAP IN ONE GO AND SERVES ALLOCATIONS FROM THEM
+
+    - DEALLOCATED CENTRAL HEAP CHUNKS ARE COLLECTED AND RETURNED TO THE CENTRAL HEAP IN BATCHES IN THE SAME WAY.
+      THEY ARE NOT REUSED FOR ALLOCATIONS AS THEY MAY BE PADDED POINTERS OF ALIGNED ALLOCATIONS , HEAPS KNOW HOW TO UNPAD THEM
+
+    - EACH ENTRY IS FOR ONE SIZE CLASS. WHEN ALL ENTRIES ARE IN USE , ENTRIES ARE EVICTED IN ROUND ROBIN
+
+    - IT IS INTRUSIVE : FIRST 8 BYTES OF CACHED CHUNKS HOLD NEXT POINTERS. THEREFORE IT DOESN'T ALLOCATE ANY MEMORY
+
+    - IT IS NOT THREAD SAFE , IT IS SUPPOSED TO BE USED ONLY BY ITS OWNER THREAD
+
+    - HEAPS NEED TO IMPLEMENT 'std::size_t allocate_batch(std::size_t size, std::size_t count, void** first)' AND 'void deallocate_batch(void* first, void* last)'
+*/
+#ifndef __TRANSFER_CACHE__
+#define __TRANSFER_CACHE__
+
+template <typename HeapType, std::size_t entry_count = 8>
+class TransferCache
+{
+    public:
+
+        TransferCache() = default;
+        ~TransferCache() = default;
+
+        TransferCache(const TransferCache& other) = delete;
+        TransferCache& operator= (const TransferCache& other) = delete;
+        TransferCache(TransferCache&& other) = delete;
+        TransferCache& operator=(TransferCache&& other) = delete;
+
+        // Returns nullptr if there is no cached chunk for the size class , then 'refill' should be called
+        FORCE_INLINE [[nodiscard]] void* allocate(std::size_t size_class)
+        {
+            Entry* entry = find_entry(size_class);
+
+            if (entry == nullptr || entry->m_free_head == nullptr)
+            {
+                return nullptr;
+            }
+
+            void* ret = entry->m_free_head;
+            entry->m_free_head = *reinterpret_cast<void**>(ret);
+            return ret;
+        }
+
+        // Takes up to 'batch_size' chunks from the heap with a single call. Returns the number of taken chunks
+        std::size_t refill(HeapType* heap, std::size_t size, std::size_t size_class, std::size_t batch_size)
+        {
+            Entry* entry = get_or_create_entry(heap, size_class);
+
+            // Called only after 'allocate' returned nullptr , so the entry has no free chunks
+            return heap->allocate_batch(size, batch_size, &entry->m_free_head);
+        }
+
+        // Collects a deallocated chunk of the heap , returns collected ones to the heap when 'batch_size' of them accumulate
+        FORCE_INLINE void deallocate(HeapType* heap, std::size_t size_class, void* pointer, std::size_t batch_size)
+        {
+            Entry* entry = get_or_create_entry(heap, size_class);
+
+            if (entry->m_returned_first == nullptr)
+            {
+                entry->m_returned_last = pointer;
+            }
+
+            *reinterpret_cast<void**>(pointer) = entry->m_returned_first;
+            entry->m_returned_first = pointer;
+            entry->m_returned_count++;
+
+            if (entry->m_returned_count >= batch_size)
+            {
+                return_collected_chunks(heap, entry);
+            }
+        }
+
+        // Returns all cached chunks to the heap
+        void flush(HeapType* heap)
+        {
+            for (std::size_t i = 0; i < entry_count; i++)
+            {
+                flush_entry(heap, &m_entries[i]);
+            }
+        }
+
+    private:
+
+        struct Entry
+        {
+            void* m_free_head = nullptr;
+            void* m_returned_first = nullptr;
+            void* m_returned_last = nullptr;
+            uint32_t m_size_class = 0;      // 0 means that the entry is not in use
+            uint32_t m_returned_count = 0;
+        };
+
+        Entry m_entries[entry_count];
+        std::size_t m_next_evicted_entry_index = 0;
+
+        FORCE_INLINE Entry* find_entry(std::size_t size_class)
+        {
+            for (std::size_t i = 0; i < entry_count; i++)
+            {
+                if (m_entries[i].m_size_class == size_class)
+                {
+                    return &m_entries[i];
+                }
+            }
+
+            return nullptr;
+        }
+
+        Entry* get_or_create_entry(HeapType* heap, std::size_t size_class)
+        {
+            Entry* entry = find_entry(size_class);
+
+            if (likely(entry != nullptr))
+            {
+                return entry;
+            }
+
+            entry = find_entry(0);
+
+            if (entry == nullptr)
+            {
+                entry = &m_entries[m_next_evicted_entry_index];
+                m_next_evicted_entry_index = (m_next_evicted_entry_index + 1) % entry_count;
+                flush_entry(heap, entry);
+            }
+
+            entry->m_size_class = static_cast<uint32_t>(size_class);
+            return entry;
+        }
+
+        void return_collected_chunks(HeapType* heap, Entry* entry)
+        {
+            if (entry->m_returned_first != nullptr)
+            {
+                heap->deallocate_batch(entry->m_returned_first, entry->m_returned_last);
+            }
+
+            entry->m_returned_first = nullptr;
+            entry->m_returned_last = nullptr;
+            entry->m_returned_count = 0;
+        }
+
+        void flush_entry(HeapType* heap, Entry* entry)
+        {
+            if (entry->m_free_head != nullptr)
+            {
+                void* last = entry->m_free_head;
+
+                while (*reinterpret_cast<void**>(last) != nullptr)
+                {
+                    last = *reinterpret_cast<void**>(last);
+                }
+
+                heap->deallocate_batch(entry->m_free_head, last);
+                entry->m_free_head = nullptr;
+            }
+
+            return_collected_chunks(heap, entry);
+            entry->m_size_class = 0;
+        }
+};
+
+#endif
+
+/*
+    HEAP SELECTION POLICIES OF SCALABLE ALLOCATOR
+
+    - BY DEFAULT SCALABLE ALLOCATOR SELECTS THE CALLING THREAD'S LOCAL HEAP THROUGH THREAD LOCAL STORAGE
+
+    - RUNTIMES WHICH ALREADY HAVE A DENSE CONTEXT KEY , FOR EX A WORKER ID OF A FIXED THREAD POOL OR A FIBER ID , CAN SELECT HEAPS BY THAT KEY INSTEAD.
+      A SELECTOR PASSED AS THE LAST TEMPLATE PARAMETER OF SCALABLE ALLOCATOR PROVIDES THE KEY :
+
+            struct WorkerIdHeapSelector
+            {
+                static constexpr inline bool USES_CONTEXT_KEY = true;
+                static std::size_t get_context_key() { return current_worker_id; } // Or HeapSelector::NO_CONTEXT_KEY
+            };
+
+      THEN HEAP SELECTION IS A LOAD FROM A TABLE INDEXED BY THE KEY. SEE ScalableAllocator::set_context_key_count
+
+    - A KEY SHOULD BE USED BY ONLY ONE RUNNING CONTEXT AT A TIME. CONTEXTS CAN MIGRATE BETWEEN THREADS , FOR EX COROUTINES ,
+      AS LONG AS THEY DON'T RUN CONCURRENTLY WITH ANOTHER CONTEXT WHICH HAS THE SAME KEY
+
+    - CONTEXTS WITHOUT A KEY , FOR EX THREADS OUTSIDE THE POOL , RETURN NO_CONTEXT_KEY AND USE THEIR THREAD LOCAL HEAPS
+*/
+#ifndef __HEAP_SELECTOR__
+#define __HEAP_SELECTOR__
+
+namespace HeapSelector
+{
+    constexpr std::size_t NO_CONTEXT_KEY = static_cast<std::size_t>(-1);
+}
+
+struct ThreadLocalHeapSelector
+{
+    static constexpr inline bool USES_CONTEXT_KEY = false;
+    static std::size_t get_context_key() { return HeapSelector::NO_CONTEXT_KEY; }
+};
+
+#endif
+
+/*
+    - THE ALLOCATOR WILL HAVE A CENTRAL HEAP AND ALSO THREAD OR CPU LOCAL HEAPS.
+
+    - ALLOCATIONS INITIALLY WILL BE FROM LOCAL ( EITHER THREAD LOCAL OR CPU LOCAL ) HEAPS. IF LOCAL HEAPS ARE EXHAUSTED , THEN CENTRAL HEAP WILL BE USED.
+
+    - USES CONFIGURABLE METADATA ( DEFAULT 128KB ) TO STORE LOCAL HEAPS. ALSO INITIALLY USES 64KB METADATA TO STORE VERY BIG SIZED ALLOCATIONS
+
+    - YOU HAVE TO MAKE SURE THAT METADATA SIZE WILL BE ABLE TO HANDLE NUMBER OF THREADS IN YOUR APPLICATION.
+
+    - DEALLOCATIONS TARGETING OTHER THREADS' HEAPS ARE BUFFERED PER DESTINATION HEAP AND SIZE CLASS IN THE CALLING THREAD , AND HANDED OVER IN BATCHES.
+      SEE RemoteDeallocationCache AND set_remote_deallocation_batching
+
+    - WHEN A LOCAL HEAP IS EXHAUSTED FOR A SIZE CLASS , THE CALLING THREAD'S TRANSFER CACHE TAKES CHUNKS FROM THE CENTRAL HEAP IN BATCHES
+      AND RETURNS DEALLOCATED CENTRAL CHUNKS IN BATCHES. SEE TransferCache AND set_transfer_batch_size
+
+    - OPTIONALLY , BEFORE GOING TO THE CENTRAL HEAP , AN EXHAUSTED LOCAL HEAP CAN STEAL FREE LOGICAL PAGES FROM THE LOGICAL PAGE POOLS OF OTHER LOCAL HEAPS ,
+      INCLUDING HEAPS OF EXITED THREADS. SEE set_page_stealing
+
+    - rebalance_thread_local_heaps MOVES FREE LOGICAL PAGES FROM IDLE LOCAL HEAPS TO THE ONES WHICH WERE EXHAUSTED SINCE ITS PREVIOUS CALL. SEE set_heap_rebalancing
+
+    - LOCAL HEAPS OF LONG LIVING IDLE THREADS CAN GIVE THEIR FREE LOGICAL PAGES BACK WITH flush_thread_cache AND release_idle_thread_caches
+
+    - HOT THREADS ARE SERVED WITHOUT SYSCALLS WHILE replenish KEEPS THEIR LOGICAL PAGE POOLS AND THE ARENA CACHE ABOVE LOW WATERMARKS. SEE set_hot_thread_watermarks
+
+    - prewarm_current_thread CREATES THE CALLING THREAD'S LOCAL HEAP AHEAD OF TIME AND FILLS ITS FREE LISTS WITH FAULTED IN CHUNKS. IT CAN ALSO LOCK THEIR LOGICAL PAGES ,
+      WHICH unlock_pages_of_current_thread UNDOES
+
+    - IT IS A PROCESS WIDE SINGLETON , FOR ISOLATED ALLOCATOR INSTANCES SEE MemoryDomain
+
+    - LOCAL HEAPS CAN BE SELECTED BY A CONTEXT KEY SUCH AS A WORKER OR FIBER ID INSTEAD OF THREAD LOCAL STORAGE. SEE heap_selector.h AND set_context_key_count
+
+    - DEALLOCATIONS OF VERY BIG OBJECTS AND RELEASES OF LOGICAL PAGES CAN BE HANDED TO A HELPER THREAD THROUGH LOCKFREE QUEUES. SEE set_deallocation_offload
+
+    - FOR SIZES KNOWN AT COMPILE TIME , allocate<size> AND deallocate<size> RESOLVE BINS AT COMPILE TIME IF HEAPS SUPPORT IT. SEE metamalloc_new
+*/
+#ifndef __SCALABLE_ALLOCATOR__H__
+#define __SCALABLE_ALLOCATOR__H__
+
+template <
+            typename CentralHeapType,
+            typename LocalHeapType,
+            typename ArenaType = Arena<>,
+            typename HeapSelectorType = ThreadLocalHeapSelector
+         >
+class ScalableAllocator : public Lockable<LockPolicy::USERSPACE_LOCK>
+{
+public:
+
+    // THIS CLASS IS INTENDED TO BE USED DIRECTLY IN MALLOC REPLACEMENTS
+    // SINCE THIS ONE IS A TEMPLATE CLASS , WE HAVE TO ENSURE A SINGLE ONLY STATIC VARIABLE INITIALISATION
+    static ScalableAllocator& get_instance()
+    {
+        static ScalableAllocator instance;
+        return instance;
+    }
+
+    [[nodiscard]] bool create(const typename CentralHeapType::HeapCreationParams& params_central, const typename LocalHeapType::HeapCreationParams& params_local, std::size_t arena_capacity, std::size_t arena_page_alignment = 65536, std::size_t metadata_buffer_size = 131072)
+    {
+        if (arena_capacity <= 0 || arena_page_alignment <= 0 || metadata_buffer_size <= 0 || !MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(arena_page_alignment) || !MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(metadata_buffer_size))
+        {
+            return false;
+        }
+
+        if (m_objects_arena.create(arena_capacity, arena_page_alignment) == false)
+        {
+            return false;
+        }
+
+        m_metadata_buffer_size = metadata_buffer_size;
+        m_metadata_buffer = reinterpret_cast<char*>(ArenaType::MetadataAllocator::allocate(m_metadata_buffer_size));
+
+        if (m_metadata_buffer == nullptr)
+        {
+            return false;
+        }
+
+        if (m_central_heap.create(params_central, &m_objects_arena) == false)
+        {
+            return false;
+        }
+
+        if (ThreadLocalStorage::get_instance().create(ScalableAllocator::thread_specific_destructor) == false)
+        {
+            return false;
+        }
+
+        m_local_heap_creation_params = params_local;
+
+        if (!create_heaps())
+        {
+            return false;
+        }
+        
+        if (get_thread_local_heap()->get_max_allocation_size() != m_central_heap.get_max_allocation_size())
+        {
+            return false;
+        }
+        
+        if( m_very_big_object_dict.initialise( 65536 / sizeof(typename Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator>::DictionaryNode) ) == false)
+        {
+            return false;
+        }
+        
+        m_very_big_object_allocation_lock.initialise();
+        
+        #ifdef ENABLE_REPORT_INVALID_POINTERS
+        if( m_invalid_ptr_detection_dict.initialise( 6553600 / sizeof(typename Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator>::DictionaryNode) ) == false)
+        {
+            return false;
+        }
+
+        m_invalid_ptr_detection_lock.initialise();
+        #endif
+
+        m_initialised_successfully.store(true);
+
+        return true;
+    }
+
+    void set_thread_local_heap_cache_count(std::size_t count)
+    {
+        m_cached_thread_local_heap_count = count;
+    }
+
+    // Remote deallocations will be handed to their heaps when 'batch_size' of them accumulate for a heap and size class , 1 means no batching
+    // Also all buffered ones will be handed over after every 'flush_interval' remote deallocations , 0 means no periodic flushes
+    // Local heaps need to implement 'void deallocate_batch(void* first, void* last)'
+    void set_remote_deallocation_batching(std::size_t batch_size, std::size_t flush_interval)
+    {
+        m_remote_deallocation_batch_size = batch_size;
+        m_remote_deallocation_flush_interval = flush_interval;
+    }
+    
+    // Number of chunks transfer caches take from and return to the central heap at once , 1 means no transfer caches
+    // Central heaps need to implement 'std::size_t get_size_class_from_size(std::size_t size)' , 'allocate_batch' and 'deallocate_batch'
+    void set_transfer_batch_size(std::size_t batch_size)
+    {
+        m_transfer_batch_size = batch_size;
+    }
+
+    // Should be called before 'create'. An exhausted local heap will take a free logical page from another local heap's logical page pool before going to the central heap ,
+    // as long as that heap keeps 'reserved_slot_count' free slots. Heaps of exited threads keep their free slots for that , otherwise they give them back to the system
+    // A stolen logical page moves to the stealing heap for good. As it is still in the address range of the original heap , deallocations look stolen pages up first ,
+    // therefore 'max_stolen_logical_page_count' also bounds that lookup. 0 means no page stealing
+    // Local heaps need to use logical page pools , see SimpleHeapPow2::HeapCreationParams::m_use_shared_logical_page_pool
+    void set_page_stealing(std::size_t max_stolen_logical_page_count, std::size_t reserved_slot_count = 1)
+    {
+        m_max_stolen_logical_page_count = max_stolen_logical_page_count;
+        m_page_stealing_reserved_slot_count = reserved_slot_count;
+    }
+
+    // Number of logical pages which moved between local heaps and are still in use , their entries are removed when they go back to the system
+    std::size_t get_stolen_logical_page_count() const { return m_stolen_logical_page_count.load(std::memory_order_acquire) - m_free_stolen_logical_page_entry_count.load(std::memory_order_relaxed); }
+
+    // Rebalancing moves logical pages from idle thread local heaps to hot ones , see rebalance_thread_local_heaps
+    // A hot heap gets up to 'max_grow_count' logical pages per rebalancing. Pages released by idle heaps are given first. New pages are taken from the arena
+    // only while rebalancing hasn't taken 'logical_page_budget' more pages than it released , so 0 means that hot heaps grow only by what idle ones give up
+    // Idle heaps keep 'idle_heap_reserved_slot_count' free logical pages , heaps of exited threads keep none
+    // Growing hot heaps uses the stolen logical page table , therefore it also needs page stealing , see set_page_stealing
+    void set_heap_rebalancing(std::size_t logical_page_budget, std::size_t idle_heap_reserved_slot_count = 1, std::size_t max_grow_count = 8)
+    {
+        m_rebalancing_logical_page_budget = static_cast<int64_t>(logical_page_budget);
+        m_rebalancing_idle_heap_reserved_slot_count = idle_heap_reserved_slot_count;
+        m_rebalancing_max_grow_count = max_grow_count;
+    }
+
+    // Should be called periodically , for ex from a maintenance thread. A heap is hot if allocations of its thread couldn't be served by it since the previous call.
+    // Otherwise it is idle and its free logical pages above the reserved count are given to hot heaps or back to the system. Returns the number of logical pages given to hot heaps
+    // Local heaps need to use logical page pools , see SimpleHeapPow2::HeapCreationParams::m_use_shared_logical_page_pool
+    std::size_t rebalance_thread_local_heaps()
+    {
+        if (m_local_heap_activities == nullptr || m_active_local_heap_count == 0)
+        {
+            return 0;
+        }
+
+        // All local heaps are created with the same parameters , any ready one gives the slot size
+        std::size_t slot_size = 0;
+        std::size_t active_local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0; i < active_local_heap_count && slot_size == 0; i++)
+        {
+            LocalHeapType* local_heap = get_ready_local_heap(i);
+
+            if (local_heap != nullptr)
+            {
+                slot_size = local_heap->get_logical_page_pool_slot_size();
+            }
+        }
+
+        if (slot_size == 0)
+        {
+            return 0;
+        }
+
+        this->enter_concurrent_context();
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 1. MEASURE DEMAND AND COLLECT FREE LOGICAL PAGES OF IDLE HEAPS , COLLECTED ONES ARE LINKED THROUGH THEIR FIRST 8 BYTES
+        void* collected_slots = nullptr;
+        std::size_t local_heap_count = m_active_local_heap_count;
+
+        for (std::size_t i = 0; i < local_heap_count; i++)
+        {
+            LocalHeapType* local_heap = get_ready_local_heap(i);
+
+            if (local_heap == nullptr)
+            {
+                continue;
+            }
+
+            LocalHeapActivity* activity = m_local_heap_activities + i;
+            activity->m_latest_exhaustion_count = activity->m_exhaustion_count.exchange(0, std::memory_order_relaxed);
+
+            bool exited = activity->m_exited.load(std::memory_order_acquire);
+
+            if (activity->m_latest_exhaustion_count == 0 || exited)
+            {
+                std::size_t reserved_slot_count = exited ? 0 : m_rebalancing_idle_heap_reserved_slot_count;
+                void* slot = nullptr;
+
+                while ((slot = local_heap->steal_logical_page_pool_slot(reserved_slot_count)) != nullptr)
+                {
+                    *reinterpret_cast<void**>(slot) = collected_slots;
+                    collected_slots = slot;
+                }
+            }
+        }
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 2. GROW HOT HEAPS
+        std::size_t given_slot_count = 0;
+
+        for (std::size_t i = 0; i < local_heap_count && m_stolen_logical_pages != nullptr; i++)
+        {
+            LocalHeapType* local_heap = get_ready_local_heap(i);
+
+            if (local_heap == nullptr)
+            {
+                continue;
+            }
+
+            LocalHeapActivity* activity = m_local_heap_activities + i;
+
+            if (activity->m_latest_exhaustion_count == 0 || activity->m_exited.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            std::size_t grow_count = activity->m_latest_exhaustion_count < m_rebalancing_max_grow_count ? activity->m_latest_exhaustion_count : m_rebalancing_max_grow_count;
+
+            for (std::size_t j = 0; j < grow_count; j++)
+            {
+                void* slot = collected_slots;
+
+                if (slot != nullptr)
+                {
+                    collected_slots = *reinterpret_cast<void**>(slot);
+                }
+                else if (m_rebalancing_net_logical_page_count < m_rebalancing_logical_page_budget)
+                {
+                    slot = m_objects_arena.allocate(slot_size);
+
+                    if (slot == nullptr)
+                    {
+                        break;
+                    }
+
+                    m_rebalancing_net_logical_page_count++;
+                }
+                else
+                {
+                    break;
+                }
+
+                if (register_moved_logical_page(slot, local_heap, slot_size) == false)
+                {
+                    // The stolen logical page table is full , it will be released below
+                    *reinterpret_cast<void**>(slot) = collected_slots;
+                    collected_slots = slot;
+                    break;
+                }
+
+                local_heap->adopt_logical_page_pool_slot(slot);
+                given_slot_count++;
+            }
+        }
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 3. RELEASE THE REST
+        while (collected_slots != nullptr)
+        {
+            void* next = *reinterpret_cast<void**>(collected_slots);
+            release_logical_page_pool_slot(collected_slots, slot_size);
+            m_rebalancing_net_logical_page_count--;
+            collected_slots = next;
+        }
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        this->leave_concurrent_context();
+
+        return given_slot_count;
+    }
+
+    // Returns what the calling thread's local heap caches : buffered remote deallocations , transfer cache chunks and queued deallocations are handed over
+    // and free logical page pool slots go back to the system. Returns the number of released logical pages
+    // Pages only move to the central heap when threads exit , this one is for long living but mostly idle threads , for ex before a timer thread goes to sleep
+    // Local heaps need to implement 'std::size_t drain(std::size_t budget)'
+    std::size_t flush_thread_cache()
+    {
+        auto thread_local_heap = get_current_local_heap();
+
+        if (thread_local_heap == nullptr)
+        {
+            return 0;
+        }
+
+        get_remote_deallocation_cache(thread_local_heap)->flush();
+        get_transfer_cache(thread_local_heap)->flush(&m_central_heap);
+        thread_local_heap->drain(0); // With immediate page recycling , logical pages which become empty go back to the pool
+
+        this->enter_concurrent_context();
+        std::size_t released_slot_count = release_logical_page_pool_slots(thread_local_heap);
+        this->leave_concurrent_context();
+
+        return released_slot_count;
+    }
+
+    // Can be called periodically by a background thread. Local heaps which didn't allocate for 'idle_ns' nanoseconds and heaps of exited threads
+    // give their free logical page pool slots back to the system. Returns the number of released logical pages
+    // Activity is sampled by the calls , so a heap is considered active from the last call which saw it allocating
+    // Caches which only their owner threads can access are left to flush_thread_cache
+    std::size_t release_idle_thread_caches(uint64_t idle_ns)
+    {
+        if (m_local_heap_activities == nullptr)
+        {
+            return 0;
+        }
+
+        uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        std::size_t released_slot_count = 0;
+
+        this->enter_concurrent_context();
+
+        uint64_t epoch = m_activity_epoch.load(std::memory_order_relaxed);
+        std::size_t local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0; i < local_heap_count; i++)
+        {
+            LocalHeapType* local_heap = get_ready_local_heap(i);
+
+            if (local_heap == nullptr)
+            {
+                continue;
+            }
+
+            LocalHeapActivity* activity = m_local_heap_activities + i;
+
+            if (activity->m_active_epoch.load(std::memory_order_relaxed) == epoch || activity->m_last_activity_ns == 0)
+            {
+                activity->m_last_activity_ns = now; // Allocated since the previous call or seen for the first time
+            }
+
+            if (activity->m_exited.load(std::memory_order_acquire) || now - activity->m_last_activity_ns >= idle_ns)
+            {
+                released_slot_count += release_logical_page_pool_slots(local_heap);
+            }
+        }
+
+        m_activity_epoch.store(epoch + 1, std::memory_order_relaxed);
+
+        this->leave_concurrent_context();
+
+        return released_slot_count;
+    }
+
+    // Hot threads are latency sensitive threads which shouldn't make syscalls in allocations and deallocations. Their local heaps serve them from logical page pools ,
+    // and replenish , called periodically by a background thread , keeps the pools between low and high watermarks.
+    // Pool slots beyond 'free_logical_page_high_watermark' go back to the system in replenish instead of hot threads. 0 means no high watermark
+    // replenish also keeps at least 'arena_low_watermark' bytes in the arena cache , so that heaps growing by extra regions don't build the cache
+    // Giving logical pages to heaps uses the stolen logical page table , therefore it also needs page stealing , see set_page_stealing
+    void set_hot_thread_watermarks(std::size_t arena_low_watermark, std::size_t free_logical_page_low_watermark, std::size_t free_logical_page_high_watermark = 0)
+    {
+        m_hot_thread_arena_low_watermark = arena_low_watermark;
+        m_hot_thread_free_logical_page_low_watermark = free_logical_page_low_watermark;
+        m_hot_thread_free_logical_page_high_watermark = free_logical_page_high_watermark;
+    }
+
+    // Should be called by the hot thread before its latency sensitive part , as it creates the thread's local heap if it doesn't have one
+    // Returns false if the thread has no local heap or its heap doesn't use a logical page pool , see SimpleHeapPow2::HeapCreationParams::m_use_shared_logical_page_pool
+    bool set_current_thread_hot(bool hot = true)
+    {
+        auto local_heap = get_thread_local_heap();
+
+        if (local_heap == nullptr || local_heap->get_logical_page_pool_slot_size() == 0)
+        {
+            return false;
+        }
+
+        get_local_heap_activity(local_heap)->m_hot.store(hot, std::memory_order_relaxed);
+        return true;
+    }
+
+    struct PrewarmProfile
+    {
+        static constexpr inline std::size_t MAX_SIZE_COUNT = 16;
+        std::size_t m_sizes[MAX_SIZE_COUNT] = {};
+        std::size_t m_free_chunk_counts[MAX_SIZE_COUNT] = {};   // Target number of free chunks for each size
+        std::size_t m_size_count = 0;
+        bool m_lock_pages = false;                              // Locks logical pages of the bins in memory so that they won't be swapped out , see unlock_pages_of_current_thread
+    };
+
+    // Should be called by a latency sensitive thread before its latency sensitive part. It creates the thread's local heap if it doesn't have one ,
+    // then for each size it allocates the target number of chunks from the local heap , touches them so that their pages are faulted in ,
+    // and deallocates them so that they wait in free lists. Deferred logical page recycling should be used as immediate recycling would give empty pages back.
+    // If the profile locks pages , logical pages of each bin are locked once they are allocated , with one call per logical page. They stay locked until
+    // unlock_pages_of_current_thread is called or they are recycled , and they count towards the process' locked memory limit ( RLIMIT_MEMLOCK on Linux ).
+    // Also resets the calling thread's slow path count , see get_slow_path_count_of_current_thread.
+    // Returns false if there is no local heap , the local heap can't hold the targets or pages can't be locked
+    bool prewarm_current_thread(const PrewarmProfile& profile)
+    {
+        auto local_heap = get_thread_local_heap();
+
+        if (local_heap == nullptr || profile.m_size_count > PrewarmProfile::MAX_SIZE_COUNT)
+        {
+            return false;
+        }
+
+        bool success = true;
+
+        for (std::size_t i = 0; i < profile.m_size_count && success; i++)
+        {
+            std::size_t size = profile.m_sizes[i] < sizeof(void*) ? sizeof(void*) : profile.m_sizes[i];
+            void* chunks = nullptr; // Chunks are linked through their first 8 bytes until they are deallocated
+
+            for (std::size_t j = 0; j < profile.m_free_chunk_counts[i]; j++)
+            {
+                void* chunk = local_heap->allocate(size);
+
+                if (chunk == nullptr)
+                {
+                    success = false;
+                    break;
+                }
+
+                builtin_memset(chunk, 0, size);
+                *reinterpret_cast<void**>(chunk) = chunks;
+                chunks = chunk;
+            }
+
+            if (success && profile.m_lock_pages && profile.m_free_chunk_counts[i] > 0 && local_heap->lock_pages(size) == false)
+            {
+                success = false;
+            }
+
+            while (chunks != nullptr)
+            {
+                void* next = *reinterpret_cast<void**>(chunks);
+                local_heap->deallocate_from_owner(chunks);
+                chunks = next;
+            }
+        }
+
+        get_local_heap_activity(local_heap)->m_slow_path_count.store(0, std::memory_order_relaxed);
+        return success;
+    }
+
+    // Undoes page locking of prewarm_current_thread. Returns false if the calling thread has no local heap
+    bool unlock_pages_of_current_thread()
+    {
+        auto thread_local_heap = get_current_local_heap();
+
+        if (thread_local_heap == nullptr)
+        {
+            return false;
+        }
+
+        thread_local_heap->unlock_pages();
+        return true;
+    }
+
+    // Number of times the calling thread's local heap couldn't serve an allocation , plus allocations and deallocations of very big objects which make syscalls
+    std::size_t get_slow_path_count_of_current_thread()
+    {
+        auto thread_local_heap = get_current_local_heap();
+        return thread_local_heap == nullptr ? 0 : get_local_heap_activity(thread_local_heap)->m_slow_path_count.load(std::memory_order_relaxed);
+    }
+
+    // Number of times hot threads had to leave their logical page pools : exhausted local heaps , which go to other heaps or the central heap ,
+    // and allocations or deallocations of very big objects which always make syscalls
+    std::size_t get_hot_thread_fallback_count() const { return m_hot_thread_fallback_count.load(std::memory_order_relaxed); }
+
+    // Background work for hot threads , see set_hot_thread_watermarks. Returns the number of logical pages given to hot heaps
+    std::size_t replenish()
+    {
+        std::size_t given_slot_count = 0;
+
+        this->enter_concurrent_context();
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 1. KEEP FREE LOGICAL PAGES OF HOT HEAPS BETWEEN THE WATERMARKS
+        std::size_t local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0; i < local_heap_count && m_local_heap_activities != nullptr; i++)
+        {
+            LocalHeapType* local_heap = get_ready_local_heap(i);
+
+            if (local_heap == nullptr)
+            {
+                continue;
+            }
+
+            LocalHeapActivity* activity = m_local_heap_activities + i;
+
+            if (activity->m_hot.load(std::memory_order_relaxed) == false || activity->m_exited.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            std::size_t slot_size = local_heap->get_logical_page_pool_slot_size();
+            std::size_t free_slot_count = local_heap->get_free_logical_page_pool_slot_count();
+
+            while (free_slot_count < m_hot_thread_free_logical_page_low_watermark && m_stolen_logical_pages != nullptr)
+            {
+                void* slot = m_objects_arena.allocate(slot_size);
+
+                if (slot == nullptr)
+                {
+                    break;
+                }
+
+                if (register_moved_logical_page(slot, local_heap, slot_size) == false)
+                {
+                    m_objects_arena.release_to_system(slot, slot_size); // The stolen logical page table is full
+                    break;
+                }
+
+                local_heap->adopt_logical_page_pool_slot(slot);
+                given_slot_count++;
+                free_slot_count++;
+            }
+
+            if (m_hot_thread_free_logical_page_high_watermark > 0 && free_slot_count > m_hot_thread_free_logical_page_high_watermark)
+            {
+                release_logical_page_pool_slots(local_heap, m_hot_thread_free_logical_page_high_watermark);
+            }
+        }
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 2. REFILL THE ARENA CACHE , AFTER THE STEP ABOVE AS IT ALSO USES THE ARENA
+        if (m_hot_thread_arena_low_watermark > 0)
+        {
+            (void)m_objects_arena.replenish_cache(m_hot_thread_arena_low_watermark);
+        }
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        this->leave_concurrent_context();
+
+        return given_slot_count;
+    }
+
+    // When enabled , deallocations of very big objects don't unmap them but push them to a lockfree queue , and process_offloaded_deallocations unmaps them.
+    // 'offload_logical_page_releases' does the same for logical pages which heaps give back to the system , for ex with RecyclingPolicy::IMMEDIATE
+    // Should be called before create
+    void set_deallocation_offload(bool offload_very_big_objects, bool offload_logical_page_releases = false)
+    {
+        m_offload_very_big_object_deallocations = offload_very_big_objects;
+        m_objects_arena.set_deferred_release(offload_logical_page_releases);
+    }
+
+    // Should be called periodically by only one helper thread at a time , see set_deallocation_offload. Returns the number of unmapped buffers
+    std::size_t process_offloaded_deallocations()
+    {
+        std::size_t processed_count = 0;
+        void* ptr = nullptr;
+
+        while ((ptr = m_offloaded_very_big_objects.pop()) != nullptr)
+        {
+            VirtualMemory::deallocate(ptr, reinterpret_cast<std::size_t*>(ptr)[1]);
+            processed_count++;
+        }
+
+        processed_count += m_objects_arena.process_deferred_releases();
+        return processed_count;
+    }
+
+    // Context keys in [0 , 'context_key_count') select their own local heaps , see heap_selector.h. Other keys fall back to thread local heaps
+    // A context heap is created on the first allocation of its key , in the metadata buffer like thread local heaps , and it is never handed to the central heap
+    // Needs a heap selector which uses context keys. Should be called before create
+    void set_context_key_count(std::size_t context_key_count)
+    {
+        static_assert(HeapSelectorType::USES_CONTEXT_KEY, "Context keys need a heap selector which provides them");
+        m_context_key_count = context_key_count;
+    }
+
+    // Number of logical pages which belong to the calling thread's local heap , 0 if it doesn't have one
+    std::size_t get_thread_local_heap_logical_page_capacity()
+    {
+        auto thread_local_heap = get_current_local_heap();
+        return thread_local_heap == nullptr ? 0 : thread_local_heap->get_logical_page_pool_capacity();
+    }
+
+    void enable_fast_shutdown() 
+    {
+        m_fast_shutdown = true;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+    void* allocate(const std::size_t size)
+    {
+        #ifndef ENABLE_DEFAULT_MALLOC
+        if (unlikely( size > m_central_heap.get_max_allocation_size()))
+        {
+            count_slow_path_of_calling_thread();
+            auto ptr = VirtualMemory::allocate<false>(size);
+            m_very_big_object_allocation_lock.lock();
+            m_very_big_object_dict.insert( reinterpret_cast<uint64_t>(ptr), size);
+            m_very_big_object_allocation_lock.unlock();
+            return ptr;
+        }
+        
+        void* ret{ nullptr };
+        auto local_heap = get_thread_local_heap();
+
+        if (local_heap != nullptr)
+        {
+            ret = local_heap->allocate(size);
+
+            // Heaps injected by specialising get_thread_local_heap are outside the metadata buffer , therefore they don't have activities or caches
+            if (likely(is_managed_local_heap(local_heap)))
+            {
+                mark_local_heap_active(local_heap);
+
+                if (ret == nullptr)
+                {
+                    LocalHeapActivity* activity = get_local_heap_activity(local_heap);
+                    activity->m_exhaustion_count.fetch_add(1, std::memory_order_relaxed);
+                    count_slow_path(activity);
+                }
+
+                if (ret == nullptr && m_max_stolen_logical_page_count > 0 && steal_logical_page(local_heap))
+                {
+                    ret = local_heap->allocate(size);
+                }
+
+                if (ret == nullptr && m_transfer_batch_size > 1)
+                {
+                    // If the local one is exhausted , try the calling thread's transfer cache which takes chunks from the central one in batches
+                    ret = allocate_from_transfer_cache(local_heap, size);
+                }
+            }
+        }
+
+        if (ret == nullptr)
+        {
+            #ifdef ENABLE_STATS
+            m_central_heap_hit_count++;
+            #endif
+
+            #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
+            m_central_heap_hit_count++;
+            fprintf(stderr, "scalable allocator , central heap hit count=%zu\n", m_central_heap_hit_count);
+            #endif
+
+            //If the local one is exhausted , failover to the central one
+            ret = m_central_heap.allocate(size);
+        }
+
+        #ifdef ENABLE_REPORT_INVALID_POINTERS
+        m_invalid_ptr_detection_lock.lock();
+        m_invalid_ptr_detection_dict.insert( reinterpret_cast<uint64_t>(ret), size);
+        m_invalid_ptr_detection_lock.unlock();
+        #endif
+
+        return ret;
+        #else
+        return builtin_aligned_alloc(size, AlignmentConstants::MINIMUM_VECTORISATION_WIDTH);
+        #endif
+
+    }
+
+    // For sizes known at compile time , for ex sizeof(T). If both heaps have compile time bins ( see HasCompileTimeBins ) , the very big object check
+    // and the bin lookup happen at compile time and the fast path is a local heap lookup plus a logical page freelist pop
+    // Exhausted local heaps and other cases go through the runtime allocate
+    template <std::size_t size>
+    [[nodiscard]] FORCE_INLINE void* allocate()
+    {
+        #if !defined(ENABLE_DEFAULT_MALLOC) && !defined(ENABLE_REPORT_INVALID_POINTERS)
+        if constexpr (has_compile_time_bin<size>())
+        {
+            auto local_heap = get_thread_local_heap();
+
+            if (likely(local_heap != nullptr))
+            {
+                void* ret = local_heap->template allocate<size>();
+
+                if (likely(ret != nullptr))
+                {
+                    if (likely(is_managed_local_heap(local_heap)))
+                    {
+                        mark_local_heap_active(local_heap);
+                    }
+
+                    return ret;
+                }
+            }
+        }
+        #endif
+
+        return allocate(size);
+    }
+
+    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+    void* allocate_aligned(std::size_t size, std::size_t alignment)
+    {
+        #ifndef ENABLE_DEFAULT_MALLOC
+        if (unlikely( size > m_central_heap.get_max_allocation_size()))
+        {
+            count_slow_path_of_calling_thread();
+            auto ptr = VirtualMemory::allocate<false>(size);
+            m_very_big_object_allocation_lock.lock();
+            m_very_big_object_dict.insert( reinterpret_cast<uint64_t>(ptr), size);
+            m_very_big_object_allocation_lock.unlock();
+            return ptr;
+        }
+        
+        void* ret{ nullptr };
+        auto local_heap = get_thread_local_heap();
+
+        if (local_heap != nullptr)
+        {
+            ret = local_heap->allocate_aligned(size, alignment);
+
+            if (likely(is_managed_local_heap(local_heap)))
+            {
+                mark_local_heap_active(local_heap);
+
+                if (ret == nullptr)
+                {
+                    LocalHeapActivity* activity = get_local_heap_activity(local_heap);
+                    activity->m_exhaustion_count.fetch_add(1, std::memory_order_relaxed);
+                    count_slow_path(activity);
+                }
+
+                if (ret == nullptr && m_max_stolen_logical_page_count > 0 && steal_logical_page(local_heap))
+                {
+                    ret = local_heap->allocate_aligned(size, alignment);
+                }
+            }
+        }
+
+        if (ret == nullptr)
+        {
+            #ifdef ENABLE_STATS
+            m_central_heap_hit_count++;
+            #endif
+
+            #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
+            m_central_heap_hit_count++;
+            fprintf(stderr, "scalable allocator , central heap hit count=%zu\n", m_central_heap_hit_count);
+            #endif
+
+            //If the local one is exhausted , failover to the central one
+            ret = m_central_heap.allocate_aligned(size, alignment);
+        }
+
+        #ifdef ENABLE_REPORT_INVALID_POINTERS
+        m_invalid_ptr_detection_lock.lock();
+        m_invalid_ptr_detection_dict.insert( reinterpret_cast<uint64_t>(ret), size);
+        m_invalid_ptr_detection_lock.unlock();
+        #endif
+
+        return ret;
+        #else
+        return builtin_aligned_alloc(size, alignment);
+        #endif
+
+    }
+
+    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+    void deallocate(void* ptr)
+    {
+        if (unlikely(ptr == nullptr))
+        {
+            return;
+        }
+        #ifndef ENABLE_DEFAULT_MALLOC
+        
+        #ifdef ENABLE_REPORT_INVALID_POINTERS
+        if(m_invalid_ptr_detection_dict.has_key(reinterpret_cast<uint64_t>(ptr)) == false )
+        {
+            append_to_invalid_pointer_report("deallocate");
+        }
+        #endif
+
+        
+        if (unlikely( m_very_big_object_dict.has_key( reinterpret_cast<uint64_t>(ptr) ) ))
+        {
+            std::size_t big_size = 0;
+            m_very_big_object_dict.get(reinterpret_cast<uint64_t>(ptr), big_size);
+
+            if (m_offload_very_big_object_deallocations)
+            {
+                // The object is not in use anymore , so it holds its own queue node and size
+                reinterpret_cast<std::size_t*>(ptr)[1] = big_size;
+                m_offloaded_very_big_objects.push(ptr);
+                return;
+            }
+
+            count_slow_path_of_calling_thread();
+            VirtualMemory::deallocate( ptr, big_size);
+            return;
+        }
+        
+        // OWNER THREAD FAST PATH : NO LINEAR SEARCH AND THE CHUNK GOES STRAIGHT BACK TO ITS LOGICAL PAGE
+        // ONLY TRULY REMOTE DEALLOCATIONS GO THROUGH DEALLOCATION QUEUES OR THREAD FREE LISTS
+        // Local heaps need to implement 'void deallocate_from_owner(void* ptr)'
+        auto thread_local_heap = get_current_local_heap();
+
+        // STOLEN LOGICAL PAGES ARE IN ADDRESS RANGES OF THEIR ORIGINAL HEAPS , SO THEY ARE LOOKED UP FIRST
+        LocalHeapType* owner_heap = find_owner_of_stolen_logical_page(ptr);
+
+        if (owner_heap == nullptr)
+        {
+            if (thread_local_heap != nullptr && thread_local_heap->owns_pointer(ptr))
+            {
+                thread_local_heap->deallocate_from_owner(ptr);
+                return;
+            }
+
+            // LINEAR SEARCH HOWEVER owns_pointer CHECK IS FAST IN BOUNDED LOCAL HEAPS
+            // THEY DON'T DO ANOTHER INTERNAL LINEAR SEARCH THROUGH FREELISTS
+            // SO THERE IS NO NESTED LINEAR SEARCHES BUT JUST ONE
+            std::size_t local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
+
+            for (std::size_t i = 0; i < local_heap_count; i++)
+            {
+                LocalHeapType* local_heap = get_ready_local_heap(i);
+
+                if (local_heap != nullptr && local_heap != thread_local_heap && local_heap->owns_pointer(ptr))
+                {
+                    owner_heap = local_heap;
+                    break;
+                }
+            }
+        }
+        else if (owner_heap == thread_local_heap)
+        {
+            thread_local_heap->deallocate_from_owner(ptr);
+            return;
+        }
+
+        if (owner_heap != nullptr)
+        {
+            // Threads without a local heap don't have a remote deallocation cache either
+            if (thread_local_heap != nullptr && m_remote_deallocation_batch_size > 1)
+            {
+                get_remote_deallocation_cache(thread_local_heap)->add(owner_heap, static_cast<uint32_t>(owner_heap->get_usable_size(ptr)), ptr, m_remote_deallocation_batch_size, m_remote_deallocation_flush_interval);
+            }
+            else
+            {
+                owner_heap->deallocate(ptr);
+            }
+
+            return;
+        }
+        // If we are here, ptr belongs to the central heap
+        if (thread_local_heap != nullptr && m_transfer_batch_size > 1)
+        {
+            get_transfer_cache(thread_local_heap)->deallocate(&m_central_heap, m_central_heap.get_usable_size(ptr), ptr, m_transfer_batch_size);
+        }
+        else
+        {
+            m_central_heap.deallocate(ptr);
+        }
+        #else
+        builtin_aligned_free(ptr);
+        #endif
+
+    }
+
+    // 'ptr' should be allocated with the same size , either by allocate<size> or allocate
+    // Such sizes can't be very big objects , so only the calling context's own chunks need to be told apart from others
+    template <std::size_t size>
+    FORCE_INLINE void deallocate(void* ptr)
+    {
+        #if !defined(ENABLE_DEFAULT_MALLOC) && !defined(ENABLE_REPORT_INVALID_POINTERS)
+        if constexpr (has_compile_time_bin<size>())
+        {
+            auto thread_local_heap = get_current_local_heap();
+
+            // Stolen logical pages are in address ranges of their original heaps , see deallocate
+            if (likely(thread_local_heap != nullptr && find_owner_of_stolen_logical_page(ptr) == nullptr && thread_local_heap->owns_pointer(ptr)))
+            {
+                thread_local_heap->template deallocate_from_owner<size>(ptr);
+                return;
+            }
+        }
+        #endif
+
+        deallocate(ptr);
+    }
+
+    std::size_t get_usable_size(void* ptr)
+    {
+        if (ptr == nullptr) return 0;
+        
+        #ifdef ENABLE_REPORT_INVALID_POINTERS
+        if(m_invalid_ptr_detection_dict.has_key(reinterpret_cast<uint64_t>(ptr)) == false )
+        {
+            append_to_invalid_pointer_report("get_usable_size");
+        }
+        #endif
+
+        LocalHeapType* owner_heap = find_owner_of_stolen_logical_page(ptr);
+
+        if (owner_heap != nullptr)
+        {
+            return owner_heap->get_usable_size(ptr);
+        }
+
+        std::size_t local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0; i < local_heap_count; i++)
+        {
+            LocalHeapType* local_heap = get_ready_local_heap(i);
+
+            if (local_heap != nullptr && local_heap->owns_pointer(ptr))
+            {
+                return local_heap->get_usable_size(ptr);
+            }
+        }
+        // If we are here, ptr belongs to the central heap
+        return m_central_heap.get_usable_size(ptr);
+    }
+
+    CentralHeapType* get_central_heap() { return &m_central_heap; }
+
+    // Processes up to 'budget' remote deallocations queued to the calling thread's heap , 0 means all of them. Returns the number of processed deallocations
+    // Allocations already drain a bounded number of them , this one is for doing it at idle points of the calling thread, for ex in an event loop
+    // Local heaps need to implement 'std::size_t drain(std::size_t budget)'
+    std::size_t drain_thread_local_heap(std::size_t budget = 0)
+    {
+        auto thread_local_heap = get_current_local_heap();
+
+        if (thread_local_heap == nullptr)
+        {
+            return 0;
+        }
+
+        return thread_local_heap->drain(budget);
+    }
+
+    // Hands all remote deallocations buffered by the calling thread to their heaps
+    // It is called automatically when threads exit , this one is for doing it earlier , for ex before a producer thread drains its heap
+    void flush_remote_deallocations()
+    {
+        auto thread_local_heap = get_current_local_heap();
+
+        if (thread_local_heap != nullptr)
+        {
+            get_remote_deallocation_cache(thread_local_heap)->flush();
+        }
+    }
+
+    #ifdef UNIT_TEST
+    std::size_t get_observed_unique_thread_count() const { return m_observed_unique_thread_count.load(); }
+    std::size_t get_transfer_cache_refill_count() const { return m_transfer_cache_refill_count.load(); }
+    #endif
+
+    #ifdef ENABLE_STATS
+    bool save_stats_to_file(const std::string_view file_name)
+    {
+        std::ofstream outfile(file_name.data());
+
+        if (outfile.is_open())
+        {
+            outfile << "Central heap hit count = " << m_central_heap_hit_count << "\n";
+            outfile << "Created thread local heap count = " << m_used_thread_local_heap_count.load() << "\n";
+            outfile << "Stolen logical page count = " << m_stolen_logical_page_count.load() << "\n\n";
+
+            auto arena_stats = m_objects_arena.get_stats();
+            outfile << "Virtual memory latest usage = " << SizeUtilities::get_human_readible_size(arena_stats.m_latest_used_size) << "\n";
+            outfile << "Virtual memory allocation count = " << arena_stats.m_vm_allocation_count << "\n";
+
+            for(std::size_t i=0; i< arena_stats.m_vm_allocation_count; i++)
+            {
+                outfile << "\tVirtual memory allocation size = " << SizeUtilities::get_human_readible_size(arena_stats.m_vm_allocation_sizes[i]) << "\n";
+            }
+
+            auto process_heap_stats = [&] (LocalHeapType* heap, const char* name)
+            {
+                auto heap_segments_stats = heap->get_stats();
+                auto heap_segment_count = heap_segments_stats.size();
+
+                outfile << "--------------------------------------------------------------\n";
+                outfile << name << "\n\n";
+
+                for (std::size_t i = 0; i < heap_segment_count; i++)
+                {
+                    outfile << "Heap segment sizeclass = " << heap_segments_stats[i].m_size_class << "\n";
+                    outfile << "\t\tLatest logical page count = " << heap_segments_stats[i].m_latest_logical_page_count << "\n";
+                    outfile << "\t\tRecycle count = " << heap_segments_stats[i].m_recycle_count << "\n";
+                    outfile << "\t\tGrow count = " << heap_segments_stats[i].m_grow_size_count << "\n";
+
+                    for (std::size_t j = 0; j < heap_segments_stats[i].m_grow_size_count; j++)
+                    {
+                        outfile << "\t\t\t\tGrow size = " << heap_segments_stats[i].m_grow_sizes[j] << "\n";
+                    }
+                }
+
+                outfile << "--------------------------------------------------------------\n\n";
+            };
+
+            process_heap_stats(reinterpret_cast<LocalHeapType*>(&m_central_heap), "CENTRAL HEAP");
+
+            std::size_t local_heap_count = m_active_local_heap_count;
+
+            if(m_cached_thread_local_heap_count > local_heap_count )
+            {
+                local_heap_count = m_cached_thread_local_heap_count;
+            }
+
+            for (std::size_t i = 0; i < local_heap_count; i++)
+            {
+                if (is_local_heap_constructed(i) == false || m_local_heap_activities[i].m_state.load(std::memory_order_acquire) == LocalHeapState::DEAD)
+                {
+                    continue;
+                }
+
+                LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
+                outfile << "Local heap " << i << " logical page capacity = " << local_heap->get_logical_page_pool_capacity() << " , free = " << local_heap->get_free_logical_page_pool_slot_count()
+                        << " , latest exhaustion count = " << m_local_heap_activities[i].m_latest_exhaustion_count << "\n";
+                process_heap_stats(local_heap, "LOCAL HEAP");
+            }
+
+            outfile.close();
+            return true;
+        }
+        return false;
+    }
+    #endif
+
+    
+    #ifdef ENABLE_REPORT_INVALID_POINTERS
+    void append_to_invalid_pointer_report(const char* operation)
+    {
+        FILE* report = nullptr;
+        report = fopen("invalid_pointers.txt", "a+"); // does not allocate memory
+
+        if (report) 
+        {
+            fprintf(report, "Invalid pointer ( a pointer which was not allocated by this allocator ) detected during %s call\n", operation);
+            fclose(report);
+        }
+        else
+        {
+            fprintf(stderr, "Failed to open invalid_pointers.txt for writing\n"); // does not allocate memory
+        }
+    }
+    #endif
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // WRAPPER METHODS FOR MALLOC REPLACEMENT/INTEGRATION
+    [[nodiscard]] void* operator_new(std::size_t size)
+    {
+        void* ret = allocate(size);
+
+        if( unlikely(ret==nullptr) )
+        {
+            handle_operator_new_failure();
+        }
+
+        return ret;
+    }
+
+    [[nodiscard]] void* operator_new_aligned(std::size_t size, std::size_t alignment)
+    {
+        void* ret = allocate_aligned(size, alignment);
+
+        if( unlikely(ret==nullptr) )
+        {
+            handle_operator_new_failure();
+        }
+
+        return ret;
+    }
+
+    void handle_operator_new_failure()
+    {
+        std::new_handler handler;
+
+        this->enter_concurrent_context();
+        ///////////////////////////////////////
+        handler = std::get_new_handler();
+        ///////////////////////////////////////
+        this->leave_concurrent_context();
+
+        if(handler != nullptr)
+        {
+            handler();
+        }
+        else
+        {
+            throw std::bad_alloc();
+        }
+    }
+
+    [[nodiscard]] void* allocate_and_zero_memory(std::size_t num, std::size_t size)
+    {
+        auto total_size = num * size;
+        void* ret = allocate(total_size);
+
+        if (ret != nullptr)
+        {
+            builtin_memset(ret, 0, total_size);
+        }
+
+        return ret;
+    }
+
+    [[nodiscard]] void* reallocate(void* ptr, std::size_t size)
+    {
+        if (ptr == nullptr)
+        {
+            return  allocate(size);
+        }
+
+        if (size == 0)
+        {
+            deallocate(ptr);
+            return nullptr;
+        }
+        
+        std::size_t old_size = get_usable_size(ptr);
+        
+        if(size <= old_size)
+        {
+            return ptr;
+        }
+
+        void* new_ptr = allocate(size);
+
+        if (new_ptr != nullptr)
+        {
+            builtin_memcpy(new_ptr, ptr, old_size);
+            deallocate(ptr);
+        }
+
+        return new_ptr;
+    }
+
+    [[nodiscard]] void* aligned_reallocate(void* ptr, std::size_t size, std::size_t alignment)
+    {
+        if (ptr == nullptr)
+        {
+            return  allocate_aligned(size, alignment);
+        }
+
+        if (size == 0)
+        {
+            deallocate(ptr);
+            return nullptr;
+        }
+        
+        std::size_t old_size = get_usable_size(ptr);
+        
+        if(size <= old_size)
+        {
+            return ptr;
+        }
+
+        void* new_ptr = allocate_aligned(size, alignment);
+
+        if (new_ptr != nullptr)
+        {
+            
+            builtin_memcpy(new_ptr, ptr, old_size);
+            deallocate(ptr);
+        }
+
+        return new_ptr;
+    }
+
+    [[nodiscard]]void* reallocate_and_zero_memory(void *ptr, std::size_t num, std::size_t size)
+    {
+        auto total_size = num*size;
+        auto ret = reallocate(ptr, total_size);
+
+        if(ret != nullptr)
+        {
+            builtin_memset(ret, 0, total_size);
+        }
+
+        return ret;
+    }
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+private:
+    using RemoteDeallocationCacheType = RemoteDeallocationCache<LocalHeapType>;
+    using TransferCacheType = TransferCache<CentralHeapType>;
+
+    CentralHeapType m_central_heap;
+    ArenaType m_objects_arena;
+    char* m_metadata_buffer = nullptr;
+    std::size_t m_metadata_buffer_size = 131072;       // Default 128KB
+    RemoteDeallocationCacheType* m_remote_deallocation_caches = nullptr; // One for each local heap , used by the thread which owns the heap
+    std::size_t m_remote_deallocation_batch_size = 32;
+    std::size_t m_remote_deallocation_flush_interval = 1024;
+    TransferCacheType* m_transfer_caches = nullptr; // One for each local heap , used by the thread which owns the heap
+    std::size_t m_transfer_batch_size = 32;
+
+    struct StolenLogicalPage
+    {
+        uint64_t m_address = 0;
+        LocalHeapType* m_owner_heap = nullptr;
+    };
+
+    StolenLogicalPage* m_stolen_logical_pages = nullptr;    // Entries are published by incrementing m_stolen_logical_page_count , entries of released logical pages are reused
+    std::atomic<std::size_t> m_stolen_logical_page_count = 0;
+    std::atomic<std::size_t> m_free_stolen_logical_page_entry_count = 0;
+    std::size_t m_max_stolen_logical_page_count = 0;
+    std::size_t m_page_stealing_reserved_slot_count = 1;
+    std::size_t m_logical_page_pool_slot_size = 0;
+
+    enum class LocalHeapState : uint8_t
+    {
+        NOT_READY,      // Not claimed yet or still being built
+        READY,          // Built and published , other threads can iterate it
+        DEAD            // Its creation failed , it is never iterated
+    };
+
+    struct LocalHeapActivity
+    {
+        std::atomic<LocalHeapState> m_state = LocalHeapState::NOT_READY;  // Set by the thread which claimed the heap , see acquire_local_heap
+        std::atomic<std::size_t> m_exhaustion_count = 0;  // Incremented by the owner thread whenever its heap can't serve an allocation
+        std::size_t m_latest_exhaustion_count = 0;         // Exhaustions measured by the latest rebalancing
+        std::atomic<bool> m_exited = false;
+        std::atomic<bool> m_hot = false;                  // See set_current_thread_hot
+        std::atomic<std::size_t> m_slow_path_count = 0;   // Exhaustions and syscalls of very big objects , reset by prewarm_current_thread
+        std::atomic<uint64_t> m_active_epoch = 0;          // Set to the activity epoch by the owner thread when it allocates , see mark_local_heap_active
+        uint64_t m_last_activity_ns = 0;                   // Updated by release_idle_thread_caches
+    };
+
+    std::atomic<uint64_t> m_activity_epoch = 0;         // Advanced by every release_idle_thread_caches call
+    std::size_t m_hot_thread_arena_low_watermark = 0;
+    std::size_t m_hot_thread_free_logical_page_low_watermark = 0;
+    std::size_t m_hot_thread_free_logical_page_high_watermark = 0;
+    std::atomic<std::size_t> m_hot_thread_fallback_count = 0;
+
+    LocalHeapActivity* m_local_heap_activities = nullptr;  // One for each local heap
+    int64_t m_rebalancing_logical_page_budget = 0;
+    int64_t m_rebalancing_net_logical_page_count = 0;  // Logical pages taken from the arena minus logical pages released by rebalancing
+    std::size_t m_rebalancing_idle_heap_reserved_slot_count = 1;
+    std::size_t m_rebalancing_max_grow_count = 8;
+    std::atomic<std::size_t> m_active_local_heap_count = 0;   // High water mark of published heaps , iterations skip heaps up to it which are not ready , see get_ready_local_heap
+    std::atomic<std::size_t> m_claimed_local_heap_count = 0;  // Some claimed heaps may still be under construction
+    std::size_t m_max_thread_local_heap_count = 0;    // Used for only thread local heaps
+    std::size_t m_cached_thread_local_heap_count = 0; // Used for only thread local heaps , its number of available passive heaps
+    std::atomic<LocalHeapType*>* m_context_heaps = nullptr;  // One for each context key , see heap_selector.h
+    std::size_t m_context_key_count = 0;
+    bool m_fast_shutdown = false;
+    typename LocalHeapType::HeapCreationParams m_local_heap_creation_params;
+
+    static inline std::atomic<bool> m_initialised_successfully = false;
+    static inline std::atomic<bool> m_shutdown_started = false;
+    
+    Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator> m_very_big_object_dict;
+    UserspaceSpinlock<> m_very_big_object_allocation_lock;
+    DeallocationQueue m_offloaded_very_big_objects;     // See set_deallocation_offload
+    bool m_offload_very_big_object_deallocations = false;
+
+    #ifdef UNIT_TEST
+    std::atomic<std::size_t> m_observed_unique_thread_count = 0;
+    std::atomic<std::size_t> m_transfer_cache_refill_count = 0;
+    #endif
+
+    #ifdef ENABLE_STATS
+    std::size_t m_central_heap_hit_count = 0;
+    std::atomic<std::size_t> m_used_thread_local_heap_count =0 ;
+    #endif
+
+    #ifdef ENABLE_PERF_TRACES
+    std::size_t m_central_heap_hit_count = 0;
+    #endif
+
+    
+    #ifdef ENABLE_REPORT_INVALID_POINTERS
+    Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator> m_invalid_ptr_detection_dict;
+    UserspaceSpinlock<> m_invalid_ptr_detection_lock;
+    #endif
+
+    ScalableAllocator()
+    {
+        static_assert(std::is_base_of<HeapBase<CentralHeapType, ConcurrencyPolicy::CENTRAL>, CentralHeapType>::value);
+        static_assert(std::is_base_of<HeapBase<LocalHeapType, ConcurrencyPolicy::THREAD_LOCAL>, LocalHeapType>::value || std::is_base_of<HeapBase<LocalHeapType, ConcurrencyPolicy::SINGLE_THREAD>, LocalHeapType>::value);
+        static_assert(std::is_base_of<ArenaBase<ArenaType>, ArenaType>::value);
+    }
+
+    ~ScalableAllocator()
+    {
+        #ifdef ENABLE_STATS
+        save_stats_to_file("metamalloc_stats.txt");
+        #endif
+
+        
+        #ifndef ENABLE_REPORT_LEAKS
+        if(m_fast_shutdown)
+        {
+            return;
+        }
+        #endif
+
+        if(m_initialised_successfully.load() == true )
+        {
+            // We call it here it in case not called earlier and there are still running threads which are not destructed , no need to move logical pages between heaps
+            m_shutdown_started.store(true);
+
+            process_offloaded_deallocations();
+            destroy_heaps();
+
+            ThreadLocalStorage::get_instance().destroy();
+        }
+    }
+
+    ScalableAllocator(const ScalableAllocator& other) = delete;
+    ScalableAllocator& operator= (const ScalableAllocator& other) = delete;
+    ScalableAllocator(ScalableAllocator&& other) = delete;
+    ScalableAllocator& operator=(ScalableAllocator&& other) = delete;
+
+    static void thread_specific_destructor(void* arg)
+    {
+        if( m_initialised_successfully.load() == true && m_shutdown_started.load() == false )
+        {
+            auto thread_local_heap = reinterpret_cast<LocalHeapType*>(arg);
+
+            if(thread_local_heap) // Thread local arg is not supposed to be nullptr by OS specs but just to be safe
+            {
+                get_instance().get_remote_deallocation_cache(thread_local_heap)->flush();
+                get_instance().get_transfer_cache(thread_local_heap)->flush(get_instance().get_central_heap());
+
+                auto central_heap = get_instance().get_central_heap();
+                central_heap->transfer_logical_pages_from(reinterpret_cast<CentralHeapType*>(thread_local_heap));
+
+                if (get_instance().m_max_stolen_logical_page_count == 0)
+                {
+                    thread_local_heap->release_free_logical_page_pool_slots(); // Otherwise other heaps can still steal them
+                }
+
+                get_instance().get_local_heap_activity(thread_local_heap)->m_exited.store(true, std::memory_order_release);
+            }
+        }
+    }
+
+    std::size_t get_created_heap_count()
+    {
+        std::size_t active_local_heap_count = m_active_local_heap_count.load();
+        auto heap_count = m_cached_thread_local_heap_count > active_local_heap_count ? m_cached_thread_local_heap_count : active_local_heap_count;
+        return heap_count;
+    }
 
-            previous_page = iter_page;
+    void destroy_heaps()
+    {
+        if (m_metadata_buffer)
+        {
+            auto heap_count = get_created_heap_count();
 
-            /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-            // REST OF THE PAGES
-            for (std::size_t i = 1; i < logical_page_count; i++)
+            for (std::size_t i = 0; i < heap_count; i++)
             {
-                if (create_new_logical_page(buffer + (i * m_logical_page_size)) == false)
+                if (is_local_heap_constructed(i) == false)
                 {
-                    return nullptr;
+                    continue;
                 }
 
-                previous_page->set_next_logical_page(iter_page);
-                iter_page->set_previous_logical_page(previous_page);
-                previous_page = iter_page;
+                LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
+                local_heap->~LocalHeapType();
             }
-
-            m_tail = iter_page;
-
-            return first_new_logical_page;
         }
+    }
 
-        void recycle_logical_page(LogicalPageType* affected)
+    LocalHeapType* get_thread_local_heap()
+    {
+        if constexpr (HeapSelectorType::USES_CONTEXT_KEY)
         {
-            remove_logical_page(affected);
-            affected->~LogicalPageType();
-            m_arena->release_to_system(affected, m_logical_page_size);
-            #ifdef ENABLE_STATS
-            m_stats.m_recycle_count++;
-            #endif
+            std::size_t context_key = HeapSelectorType::get_context_key();
 
+            if (context_key < m_context_key_count)
+            {
+                auto context_heap = m_context_heaps[context_key].load(std::memory_order_acquire);
+                return likely(context_heap != nullptr) ? context_heap : create_context_heap(context_key);
+            }
         }
 
-        void remove_logical_page(LogicalPageType* affected)
+        return get_thread_local_heap_internal();
+    }
+
+    // Local heap of the calling context , without creating one
+    FORCE_INLINE LocalHeapType* get_current_local_heap()
+    {
+        if constexpr (HeapSelectorType::USES_CONTEXT_KEY)
         {
-            auto next = reinterpret_cast<LogicalPageType*>(affected->get_next_logical_page());
-            auto previous = reinterpret_cast<LogicalPageType*>(affected->get_previous_logical_page());
+            std::size_t context_key = HeapSelectorType::get_context_key();
 
-            if (affected == m_last_used)
+            if (context_key < m_context_key_count)
             {
-                if (previous)
-                {
-                    m_last_used = previous;
-                }
-                else if (next)
-                {
-                    m_last_used = next;
-                }
-                else
-                {
-                    m_last_used = nullptr;
-                }
+                return m_context_heaps[context_key].load(std::memory_order_acquire);
             }
+        }
 
-            if (previous == nullptr)
-            {
-                m_head = next;
+        return reinterpret_cast<LocalHeapType*>(ThreadLocalStorage::get_instance().get());
+    }
 
-                if (m_head == nullptr || m_head->get_next_logical_page() == 0)
-                {
-                    m_tail = m_head;
-                }
-            }
-            else
-            {
-                previous->set_next_logical_page(next);
+    // Happens only once for each context key. Only the context which has the key creates its heap , so there is no race on the table entry
+    LocalHeapType* create_context_heap(std::size_t context_key)
+    {
+        LocalHeapType* context_heap = acquire_local_heap();
 
-                if (m_tail == affected)
-                {
-                    m_tail = previous;
-                }
-            }
+        if (context_heap != nullptr)
+        {
+            m_context_heaps[context_key].store(context_heap, std::memory_order_release);
+        }
 
-            if (next)
-                next->set_previous_logical_page(previous);
+        return context_heap;
+    }
 
-            m_logical_page_count--;
-        }
+    FORCE_INLINE LocalHeapType* get_thread_local_heap_internal()
+    {
+        auto thread_local_heap = reinterpret_cast<LocalHeapType*>(ThreadLocalStorage::get_instance().get());
 
-        void add_logical_page(LogicalPageType* logical_page)
+        if (thread_local_heap == nullptr)
         {
-            if (m_tail)
-            {
-                m_tail->set_next_logical_page(logical_page);
-                logical_page->set_previous_logical_page(m_tail);
-            }
-            else
+            // HAPPENS ONLY ONCE FOR EACH THREAD , AT THEIR START. IT DOESN'T TAKE THE ALLOCATOR LOCK , SEE acquire_local_heap
+            #ifdef UNIT_TEST
+            m_observed_unique_thread_count.fetch_add(1, std::memory_order_relaxed);
+            #endif
+
+            thread_local_heap = acquire_local_heap();
+
+            if (thread_local_heap == nullptr)
             {
-                m_head = logical_page;
-                m_tail = logical_page;
+                return nullptr;
             }
 
-            logical_page->set_next_logical_page(nullptr);
-            m_logical_page_count++;
+            ThreadLocalStorage::get_instance().set(thread_local_heap);
         }
 
-        void destroy()
+        return thread_local_heap;
+    }
+
+    // Claims a heap slot with a CAS and builds the heap without any shared lock , so that threads starting together don't wait for each other's page faults
+    LocalHeapType* acquire_local_heap()
+    {
+        #ifdef ENABLE_STATS
+        m_used_thread_local_heap_count.fetch_add(1, std::memory_order_relaxed);
+        #endif
+
+        LocalHeapType* local_heap = nullptr;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 1. CLAIM A SLOT
+        std::size_t metadata_buffer_index = m_claimed_local_heap_count.load(std::memory_order_relaxed);
+
+        do
         {
-            if constexpr (concurrency_policy==ConcurrencyPolicy::THREAD_LOCAL)
+            if (metadata_buffer_index + 1 >= m_max_thread_local_heap_count)
             {
-                process_deallocation_queue();
+                // If we are here , it means that metadata buffer size is not sufficient to handle all threads of the application
+                return nullptr;
             }
+        } while (m_claimed_local_heap_count.compare_exchange_weak(metadata_buffer_index, metadata_buffer_index + 1, std::memory_order_relaxed) == false);
 
-            LogicalPageType* iter = m_head;
-            LogicalPageType* next = nullptr;
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 2. BUILD THE HEAP , THE ARENA HAS ITS OWN LOCK ONLY FOR CARVING THE HEAP BUFFER
+        if (metadata_buffer_index >= m_cached_thread_local_heap_count)
+        {
+            local_heap = create_local_heap(metadata_buffer_index);
+        }
+        else
+        {
+            local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (metadata_buffer_index * sizeof(LocalHeapType)));
+        }
 
-            while (iter)
-            {
-                next = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
-                /////////////////////////////////////////////////////////////////////////////
-                #ifdef ENABLE_REPORT_LEAKS
-                if (iter->get_used_size() != 0)
-                {
-                    FILE* leak_report = nullptr;
-                    leak_report = fopen("leaks.txt", "a+"); // does not allocate memory
-            
-                    if (leak_report) 
-                    {
-                        if(m_size_class!=0)
-                        {
-                            fprintf(leak_report, "Potential memory leak : sizeclass=%zu count=%zu\n", static_cast<std::size_t>(m_size_class), static_cast<std::size_t>(iter->get_used_size() / m_size_class));
-                        }
-                        else
-                        {
-                            fprintf(leak_report, "Potential memory leak : total size=%zu \n", static_cast<std::size_t>(iter->get_used_size()));
-                        }
-                        
-                        fclose(leak_report);
-                    }
-                    else
-                    {
-                        fprintf(stderr, "Failed to open leaks.txt for writing\n"); // does not allocate memory
-                    }
-                }
-                #endif
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // 3. PUBLISH IT
+        // Each slot is published on its own , so a thread doesn't wait for threads which claimed earlier slots and are still building their heaps.
+        // The active count is only a high water mark , iterations skip slots up to it which are not ready
+        m_local_heap_activities[metadata_buffer_index].m_state.store(local_heap != nullptr ? LocalHeapState::READY : LocalHeapState::DEAD, std::memory_order_release);
 
-                // There still maybe unloaded dynamic libraries (shared objects or DLLs) loaded by the host process
-                // Even worse there may be unloaded but memory-leaking dynamic libraries
-                // If we destroy a segment which has not been deallocated fully, we will crash, therefore this check is needed
-                // If it is not possible to destroy then OS will reclaim virtual memory pages as soon as the host process dies.
-                if (iter->get_used_size() == 0)
-                {
-                    // Invoking dtor of logical page
-                    iter->~LogicalPageType();
-                    // Release pages back to system if we are managing the arena
-                    m_arena->release_to_system(iter, m_logical_page_size);
-                }
+        std::size_t active_count = m_active_local_heap_count.load(std::memory_order_relaxed);
 
-                /////////////////////////////////////////////////////////////////////////////
-                iter = next;
-            }
+        while (active_count < metadata_buffer_index + 1 && m_active_local_heap_count.compare_exchange_weak(active_count, metadata_buffer_index + 1, std::memory_order_release, std::memory_order_relaxed) == false)
+        {
+        }
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-            m_head = nullptr;
-            m_tail = nullptr;
+        return local_heap;
+    }
+
+    bool create_heaps()
+    {
+        m_max_thread_local_heap_count = m_metadata_buffer_size / sizeof(LocalHeapType);
+
+        if (m_max_thread_local_heap_count == 0)
+        {
+            return false;
         }
 
-        // DEALLOCATES ALL POINTERS IN THE DEALLOCATION QUEUE
-        // IF THE CALLER IS ALLOCATOR INITIAL POINTER WON'T BE DEALLOCATED BUT INSTEAD RETURNED TO THE CALLER
-        // TO SERVE ALLOCATIONS AS FAST AS POSSIBLE
-        template <bool return_initial_pointer=false>
-        void* process_deallocation_queue()
+        if (m_max_thread_local_heap_count < m_cached_thread_local_heap_count)
         {
-            void* ret = nullptr;
+            m_cached_thread_local_heap_count = m_max_thread_local_heap_count;
+        }
 
-            while (true)
+        // Separate from the metadata buffer , so that the number of heaps it can hold doesn't change
+        m_remote_deallocation_caches = reinterpret_cast<RemoteDeallocationCacheType*>(ArenaType::MetadataAllocator::allocate(m_max_thread_local_heap_count * sizeof(RemoteDeallocationCacheType)));
+
+        if (m_remote_deallocation_caches == nullptr)
+        {
+            return false;
+        }
+
+        m_transfer_caches = reinterpret_cast<TransferCacheType*>(ArenaType::MetadataAllocator::allocate(m_max_thread_local_heap_count * sizeof(TransferCacheType)));
+
+        if (m_transfer_caches == nullptr)
+        {
+            return false;
+        }
+
+        m_local_heap_activities = reinterpret_cast<LocalHeapActivity*>(ArenaType::MetadataAllocator::allocate(m_max_thread_local_heap_count * sizeof(LocalHeapActivity)));
+
+        if (m_local_heap_activities == nullptr)
+        {
+            return false;
+        }
+
+        for (std::size_t i{ 0 }; i < m_max_thread_local_heap_count; i++)
+        {
+            new(m_remote_deallocation_caches + i) RemoteDeallocationCacheType();    // Placement new , does not invoke memory allocation
+            new(m_transfer_caches + i) TransferCacheType();
+            new(m_local_heap_activities + i) LocalHeapActivity();
+        }
+
+        if constexpr (HeapSelectorType::USES_CONTEXT_KEY)
+        {
+            if (m_context_key_count > 0)
             {
-                auto pointer = m_deallocation_queue.pop();
+                m_context_heaps = reinterpret_cast<std::atomic<LocalHeapType*>*>(ArenaType::MetadataAllocator::allocate(m_context_key_count * sizeof(std::atomic<LocalHeapType*>)));
 
-                if (pointer == nullptr)
+                if (m_context_heaps == nullptr)
                 {
-                    break;
+                    return false;
                 }
 
-                if constexpr (return_initial_pointer)
-                {
-                    if (likely(ret != nullptr))
-                    {
-                        deallocate_internal(pointer);
-                    }
-                    else
-                    {
-                        ret = pointer;
-                    }
-                }
-                else
+                for (std::size_t i{ 0 }; i < m_context_key_count; i++)
                 {
-                    deallocate_internal(pointer);
+                    new(m_context_heaps + i) std::atomic<LocalHeapType*>(nullptr);
                 }
             }
+        }
+
+        if (m_max_stolen_logical_page_count > 0)
+        {
+            m_stolen_logical_pages = reinterpret_cast<StolenLogicalPage*>(ArenaType::MetadataAllocator::allocate(m_max_stolen_logical_page_count * sizeof(StolenLogicalPage)));
+
+            if (m_stolen_logical_pages == nullptr)
+            {
+                return false;
+            }
+        }
 
-            return ret;
+        for (std::size_t i{ 0 }; i < m_cached_thread_local_heap_count; i++)
+        {
+            auto local_heap = create_local_heap(i);
+            if (!local_heap) return false;
         }
 
-        [[nodiscard]] void* allocate_internal(std::size_t size)
+        return true;
+    }
+
+    FORCE_INLINE std::size_t get_metadata_buffer_index(LocalHeapType* local_heap)
+    {
+        return static_cast<std::size_t>(reinterpret_cast<char*>(local_heap) - m_metadata_buffer) / sizeof(LocalHeapType);
+    }
+
+    template <std::size_t size>
+    static constexpr bool has_compile_time_bin()
+    {
+        return CentralHeapType::template has_compile_time_bin<size>() && LocalHeapType::template has_compile_time_bin<size>();
+    }
+
+    FORCE_INLINE bool is_managed_local_heap(LocalHeapType* local_heap)
+    {
+        return get_metadata_buffer_index(local_heap) < m_max_thread_local_heap_count; // Addresses below the buffer wrap around
+    }
+
+    FORCE_INLINE RemoteDeallocationCacheType* get_remote_deallocation_cache(LocalHeapType* local_heap)
+    {
+        return m_remote_deallocation_caches + get_metadata_buffer_index(local_heap);
+    }
+
+    FORCE_INLINE TransferCacheType* get_transfer_cache(LocalHeapType* local_heap)
+    {
+        return m_transfer_caches + get_metadata_buffer_index(local_heap);
+    }
+
+    FORCE_INLINE LocalHeapActivity* get_local_heap_activity(LocalHeapType* local_heap)
+    {
+        return m_local_heap_activities + get_metadata_buffer_index(local_heap);
+    }
+
+    // Returns nullptr if the heap in that slot is still being built or its creation failed
+    FORCE_INLINE LocalHeapType* get_ready_local_heap(std::size_t metadata_buffer_index)
+    {
+        if (m_local_heap_activities[metadata_buffer_index].m_state.load(std::memory_order_acquire) != LocalHeapState::READY)
         {
+            return nullptr;
+        }
 
-            if (unlikely(size > m_max_object_size))
-            {
-                return nullptr;
-            }
-
-            ///////////////////////////////////////////////////////////////////
-            // Next-fit like , we start searching from where we left if possible
-            void* ret = nullptr;
-            LogicalPageType* iter = m_last_used ? m_last_used : m_head;
+        return reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (metadata_buffer_index * sizeof(LocalHeapType)));
+    }
 
-            while (iter)
-            {
-                ret = iter->allocate(size);
+    // Cached heaps are built up front , others are built by threads which claim them
+    bool is_local_heap_constructed(std::size_t metadata_buffer_index)
+    {
+        return metadata_buffer_index < m_cached_thread_local_heap_count || m_local_heap_activities[metadata_buffer_index].m_state.load(std::memory_order_acquire) != LocalHeapState::NOT_READY;
+    }
 
-                if (ret != nullptr)
-                {
-                    m_last_used = iter;
+    FORCE_INLINE void count_slow_path(LocalHeapActivity* activity)
+    {
+        activity->m_slow_path_count.store(activity->m_slow_path_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); // Only the owner thread writes
 
-                    return ret;
-                }
+        if (activity->m_hot.load(std::memory_order_relaxed))
+        {
+            m_hot_thread_fallback_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
 
-                iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
-            }
-            ///////////////////////////////////////////////////////////////////
-            // If we started the search from a non-head node,  then we need one more iteration
-            if (m_last_used)
-            {
-                iter = m_head;
+    void count_slow_path_of_calling_thread()
+    {
+        auto thread_local_heap = get_current_local_heap();
 
-                while (iter != m_last_used)
-                {
-                    ret = iter->allocate(size);
+        if (thread_local_heap != nullptr)
+        {
+            count_slow_path(get_local_heap_activity(thread_local_heap));
+        }
+    }
 
-                    if (ret != nullptr)
-                    {
-                        m_last_used = iter;
+    // The epoch changes only when release_idle_thread_caches runs , so the owner thread writes its activity at most once between two calls
+    FORCE_INLINE void mark_local_heap_active(LocalHeapType* local_heap)
+    {
+        uint64_t epoch = m_activity_epoch.load(std::memory_order_relaxed);
+        LocalHeapActivity* activity = get_local_heap_activity(local_heap);
 
-                        return ret;
-                    }
+        if (unlikely(activity->m_active_epoch.load(std::memory_order_relaxed) != epoch))
+        {
+            activity->m_active_epoch.store(epoch, std::memory_order_relaxed);
+        }
+    }
 
-                    iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
-                }
-            }
-            ///////////////////////////////////////////////////////////////////
-            // If we reached here , it means that we need to allocate more memory
-            if constexpr (concurrency_policy == ConcurrencyPolicy::CENTRAL || concurrency_policy == ConcurrencyPolicy::SINGLE_THREAD) // Only unbounded concurrecy policies can grow
-            {
-                std::size_t new_logical_page_count = 0;
-                std::size_t minimum_new_logical_page_count = 0;
-                calculate_quantities(size, new_logical_page_count, minimum_new_logical_page_count);
+    // Returns true if a free logical page of another local heap is moved to the local heap
+    bool steal_logical_page(LocalHeapType* local_heap)
+    {
+        std::size_t slot_size = local_heap->get_logical_page_pool_slot_size();
 
-                char* new_buffer = nullptr;
-                new_buffer = static_cast<char*>(m_arena->allocate(m_logical_page_size * new_logical_page_count));
+        if (slot_size == 0)
+        {
+            return false; // The local heap doesn't use a logical page pool
+        }
 
-                if (new_buffer == nullptr && new_logical_page_count > minimum_new_logical_page_count)  // Meeting grow_coefficient is not possible so lower the new_logical_page_count
-                {
-                    new_buffer = static_cast<char*>(m_arena->allocate(m_logical_page_size * minimum_new_logical_page_count));
-                }
+        void* slot = nullptr;
 
-                if (!new_buffer)
-                {
-                    return nullptr;
-                }
+        // Stealing happens only after a local heap is exhausted , the allocator lock also serialises appends to the stolen logical page table
+        this->enter_concurrent_context();
 
-                auto first_new_logical_page = grow(new_buffer, new_logical_page_count);
+        std::size_t stolen_logical_page_count = m_stolen_logical_page_count.load(std::memory_order_relaxed);
 
-                #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
-                fprintf(stderr, "segment grow size=%zu  sizeclass=%u\n", size, m_size_class);
-                #endif
+        if (stolen_logical_page_count < m_max_stolen_logical_page_count || m_free_stolen_logical_page_entry_count.load(std::memory_order_relaxed) > 0)
+        {
+            std::size_t local_heap_count = m_active_local_heap_count.load(std::memory_order_acquire);
 
-                #ifdef ENABLE_STATS
-                if(m_stats.m_grow_size_count<MAX_GROW_STAT_COUNT)
-                {
-                    m_stats.m_grow_sizes[m_stats.m_grow_size_count] = new_logical_page_count;
-                    m_stats.m_grow_size_count++;
-                }
-                #endif
+            for (std::size_t i = 0; i < local_heap_count; i++)
+            {
+                LocalHeapType* victim_heap = get_ready_local_heap(i);
 
-                if (first_new_logical_page)
+                if (victim_heap != nullptr && victim_heap != local_heap)
                 {
-                    ret = first_new_logical_page->allocate(size);
+                    slot = victim_heap->steal_logical_page_pool_slot(m_page_stealing_reserved_slot_count);
 
-                    if (ret != nullptr)
+                    if (slot != nullptr)
                     {
-                        m_last_used = first_new_logical_page;
-
-                        return ret;
+                        break;
                     }
                 }
-
             }
 
-            // OUT OF MEMORY !
-            return nullptr;
-        }
-
-        void calculate_quantities(const std::size_t size, std::size_t& desired_new_logical_page_count, std::size_t& minimum_new_logical_page_count)
-        {
-            if constexpr (LogicalPageType::supports_any_size()) // That means size will be arbitrary therefore the size may not suffice
-            {
-                minimum_new_logical_page_count = SizeUtilities::get_required_page_count_for_allocation(m_logical_page_size, m_logical_page_object_size, size, 1);
-            }
-            else
+            if (slot != nullptr)
             {
-                minimum_new_logical_page_count = SizeUtilities::get_required_page_count_for_allocation(m_logical_page_size, m_logical_page_object_size, m_size_class, size / m_size_class);
+                register_moved_logical_page(slot, local_heap, slot_size); // Can't fail as there is space in the table
             }
+        }
 
-            if ( likely(m_grow_coefficient > 0))
-            {
-                desired_new_logical_page_count = static_cast<std::size_t>(m_logical_page_count * m_grow_coefficient);
+        this->leave_concurrent_context();
 
-                if (desired_new_logical_page_count < minimum_new_logical_page_count)
-                {
-                    desired_new_logical_page_count = minimum_new_logical_page_count;
-                }
-            }
-            else
-            {
-                desired_new_logical_page_count = minimum_new_logical_page_count;
-            }
+        if (slot == nullptr)
+        {
+            return false;
         }
 
-        void deallocate_internal(void* ptr)
+        local_heap->adopt_logical_page_pool_slot(slot);
+        return true;
+    }
+
+    // Should be called while holding the allocator lock. Returns false if the stolen logical page table is full
+    bool register_moved_logical_page(void* slot, LocalHeapType* owner_heap, std::size_t slot_size)
+    {
+        std::size_t stolen_logical_page_count = m_stolen_logical_page_count.load(std::memory_order_relaxed);
+
+        // A logical page which moved before may move again , lookups return the first match so its entry is updated
+        for (std::size_t i = 0; i < stolen_logical_page_count; i++)
         {
-            if constexpr (buffer_aligned_to_logical_page_size == true)
-            {
-                deallocate_from_aligned_logical_page(ptr);
-            }
-            else
+            if (m_stolen_logical_pages[i].m_address == reinterpret_cast<uint64_t>(slot))
             {
-                deallocate_by_search(ptr);
+                builtin_atomic_exchange64(reinterpret_cast<uint64_t*>(&m_stolen_logical_pages[i].m_owner_heap), reinterpret_cast<uint64_t>(owner_heap));
+                return true;
             }
         }
 
-        // WARNING : WHEN CALLING THIS ONE YOU HAVE TO MAKE SURE THAT ALL LOGICAL PAGES ARE
-        // PLACED AT m_logical_page_size ALIGNED ADDRESSES
-        void deallocate_from_aligned_logical_page(void* ptr)
-        {
-            auto affected = get_logical_page_from_address(ptr, m_logical_page_size);
-
-            affected->deallocate(ptr);
+        m_logical_page_pool_slot_size = slot_size; // All local heaps are created with the same parameters
 
-            if (affected->get_used_size() == 0)
+        // Entries of logical pages which went back to the system are reused before appending
+        if (m_free_stolen_logical_page_entry_count.load(std::memory_order_relaxed) > 0)
+        {
+            for (std::size_t i = 0; i < stolen_logical_page_count; i++)
             {
-                affected->mark_as_non_used();
-
-                if constexpr (page_recycling_policy == PageRecyclingPolicy::IMMEDIATE)
+                if (m_stolen_logical_pages[i].m_address == 0)
                 {
-                    if (m_logical_page_count > m_page_recycling_threshold)
-                    {
-                        recycle_logical_page(affected);
-                    }
+                    // The owner is set first so that lookups matching the address see it
+                    builtin_atomic_exchange64(reinterpret_cast<uint64_t*>(&m_stolen_logical_pages[i].m_owner_heap), reinterpret_cast<uint64_t>(owner_heap));
+                    builtin_atomic_exchange64(&m_stolen_logical_pages[i].m_address, reinterpret_cast<uint64_t>(slot));
+                    m_free_stolen_logical_page_entry_count.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
                 }
             }
         }
 
-        // MAKES A LINEAR SEARCH
-        void deallocate_by_search(void* ptr)
+        if (stolen_logical_page_count >= m_max_stolen_logical_page_count)
         {
-            std::size_t address = reinterpret_cast<std::size_t>(ptr);
-            LogicalPageType* iter = m_head;
+            return false;
+        }
 
-            while (iter != nullptr)
+        m_stolen_logical_pages[stolen_logical_page_count].m_address = reinterpret_cast<uint64_t>(slot);
+        m_stolen_logical_pages[stolen_logical_page_count].m_owner_heap = owner_heap;
+        m_stolen_logical_page_count.store(stolen_logical_page_count + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Should be called while holding the allocator lock , before the logical page goes back to the system. Its entry becomes free , otherwise deallocations
+    // in the same address range would still go to the previous owner after the arena hands it out again. Free entries have address 0 which no lookup matches
+    void unregister_moved_logical_page(void* slot)
+    {
+        std::size_t stolen_logical_page_count = m_stolen_logical_page_count.load(std::memory_order_relaxed);
+
+        for (std::size_t i = 0; i < stolen_logical_page_count; i++)
+        {
+            if (m_stolen_logical_pages[i].m_address == reinterpret_cast<uint64_t>(slot))
             {
-                std::size_t start = reinterpret_cast<std::size_t>(iter);
-                std::size_t end = start + m_logical_page_size;
+                builtin_atomic_exchange64(&m_stolen_logical_pages[i].m_address, static_cast<uint64_t>(0));
+                builtin_atomic_exchange64(reinterpret_cast<uint64_t*>(&m_stolen_logical_pages[i].m_owner_heap), static_cast<uint64_t>(0));
+                m_free_stolen_logical_page_entry_count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
 
-                if (address >= start && address < end)
-                {
-                    iter->deallocate(ptr);
+    // Should be called while holding the allocator lock
+    void release_logical_page_pool_slot(void* slot, std::size_t slot_size)
+    {
+        unregister_moved_logical_page(slot);
+        m_objects_arena.release_to_system(slot, slot_size);
+    }
 
-                    if (iter->get_used_size() == 0)
-                    {
-                        iter->mark_as_non_used();
+    // Should be called while holding the allocator lock. Gives free logical page pool slots of a local heap back to the system except 'reserved_slot_count' of them
+    // Returns the number of released slots
+    std::size_t release_logical_page_pool_slots(LocalHeapType* local_heap, std::size_t reserved_slot_count = 0)
+    {
+        if (m_stolen_logical_pages == nullptr)
+        {
+            return local_heap->release_free_logical_page_pool_slots(reserved_slot_count);
+        }
 
-                        if constexpr (page_recycling_policy == PageRecyclingPolicy::IMMEDIATE)
-                        {
-                            if (m_logical_page_count > m_page_recycling_threshold)
-                            {
-                                recycle_logical_page(iter);
-                            }
-                        }
-                    }
+        std::size_t slot_size = local_heap->get_logical_page_pool_slot_size();
+        std::size_t released_slot_count = 0;
+        void* slot = nullptr;
 
-                    return;
-                }
-                iter = reinterpret_cast<LogicalPageType*>(iter->get_next_logical_page());
-            }
+        while ((slot = local_heap->steal_logical_page_pool_slot(reserved_slot_count)) != nullptr)
+        {
+            release_logical_page_pool_slot(slot, slot_size);
+            released_slot_count++;
         }
-};
 
-#endif
-//INTERFACE FOR HEAPS WITH ONE CONCRETE IMPLEMENTATION : HeapBase::allocate_aligned
-#ifndef __HEAP_BASE_H__
-#define __HEAP_BASE_H__
+        return released_slot_count;
+    }
 
-template <typename HeapImplementation, ConcurrencyPolicy concurrency_policy = ConcurrencyPolicy::SINGLE_THREAD>
-class HeapBase
-{
-    public:
-        HeapBase() = default;
-        ~HeapBase() = default;
-        HeapBase(const HeapBase& other) = delete;
-        HeapBase& operator= (const HeapBase& other) = delete;
-        HeapBase(HeapBase&& other) = delete;
-        HeapBase& operator=(HeapBase&& other) = delete;
+    FORCE_INLINE LocalHeapType* find_owner_of_stolen_logical_page(void* ptr)
+    {
+        std::size_t stolen_logical_page_count = m_stolen_logical_page_count.load(std::memory_order_acquire);
 
-        [[nodiscard]] void* allocate(std::size_t size) { return static_cast<HeapImplementation*>(this)->allocate(size); }
+        if (likely(stolen_logical_page_count == 0))
+        {
+            return nullptr;
+        }
 
-        /*
-            Alignment has to be a power of two
+        uint64_t address = reinterpret_cast<uint64_t>(ptr);
 
-            Note that if alignment sizes are too large , than memory will be wasted in unncesserily big padding bytes.
-            If that is the case , override this method in your CRTP derived heap class
-            And call this base method only if alignment size is small. Otherwise redirect it to a bin that uses logical_page_any_size ( for ex big object)
-            as also logical_page_any_size can handle alignments and it will also be minimising used padding bytes during its search in its freelist
-            
-            As for deallocations, since LogicalPage holds free chunks for only one sizeclass and since it knows it start address, it re-adjusts the pointer during deallocation
-        */
-        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
-        void* allocate_aligned(std::size_t size, std::size_t alignment)
+        for (std::size_t i = 0; i < stolen_logical_page_count; i++)
         {
-            if (alignment <= MINIMUM_ALIGNMENT)
+            if (address - m_stolen_logical_pages[i].m_address < m_logical_page_pool_slot_size) // Unsigned wrap around covers addresses below the page
             {
-                // Framework already provides minimum 16 bit alignment
-                return allocate(size);
+                return m_stolen_logical_pages[i].m_owner_heap;
             }
-
-            std::size_t adjusted_size = size + alignment; // Adding padding bytes
-            /////////////////////////////////////////////
-            auto ptr = allocate(adjusted_size);
-            /////////////////////////////////////////////
-            std::size_t offset = alignment - (ModuloUtilities::modulo_pow2((reinterpret_cast<std::uint64_t>(ptr)), alignment));
-            void* ret = reinterpret_cast<void*>(reinterpret_cast<std::uint64_t>(ptr) + offset);
-            return ret;
         }
 
-        // Should be called only from bounded heaps as unbounded heaps may not have contigious memory
-        // Only Central and SingleThread concurrency policies are unbounded
-        // In other words owns_pointer is supposed to be called from only Thread Local or CPU Local heaps
-        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
-        bool owns_pointer(void* ptr)
+        return nullptr;
+    }
+
+    void* allocate_from_transfer_cache(LocalHeapType* local_heap, std::size_t size)
+    {
+        auto transfer_cache = get_transfer_cache(local_heap);
+        auto size_class = m_central_heap.get_size_class_from_size(size);
+
+        void* ret = transfer_cache->allocate(size_class);
+
+        if (ret == nullptr)
         {
-            if constexpr (concurrency_policy != ConcurrencyPolicy::THREAD_LOCAL)
-            {
-                assert(0 == 1);
-            }
+            #ifdef ENABLE_STATS
+            m_central_heap_hit_count++;
+            #endif
+
+            #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
+            m_central_heap_hit_count++;
+            fprintf(stderr, "scalable allocator , central heap hit count=%zu\n", m_central_heap_hit_count);
+            #endif
 
-            uint64_t address_in_question = reinterpret_cast<uint64_t>(ptr);
+            #ifdef UNIT_TEST
+            m_transfer_cache_refill_count++;
+            #endif
 
-            if ( address_in_question >= m_buffer_address && address_in_question < m_buffer_address + m_buffer_length )
+            // One central heap lock for the entire batch
+            if (transfer_cache->refill(&m_central_heap, size, size_class, m_transfer_batch_size) > 0)
             {
-                return true;
+                ret = transfer_cache->allocate(size_class);
             }
+        }
 
-            return false;
+        return ret;
+    }
+
+    LocalHeapType* create_local_heap(std::size_t metadata_buffer_index)
+    {
+        LocalHeapType* local_heap = new(m_metadata_buffer + (metadata_buffer_index * sizeof(LocalHeapType))) LocalHeapType();    // Placement new , does not invoke memory allocation
+
+        if (local_heap->create(m_local_heap_creation_params, &m_objects_arena) == false)
+        {
+            return nullptr;
         }
 
-    protected:
-        uint64_t m_buffer_address = 0;
-        std::size_t m_buffer_length = 0;
-        static constexpr inline std::size_t MINIMUM_ALIGNMENT = 16;
+        return local_heap;
+    }
 };
 
+// Constructs a T with memory of a ScalableAllocator , its size is resolved at compile time. See ScalableAllocator::allocate<size>
+template <typename T, typename AllocatorType, typename... Args>
+[[nodiscard]] T* metamalloc_new(Args&&... args)
+{
+    void* ptr = nullptr;
+
+    if constexpr (alignof(T) > AlignmentConstants::MINIMUM_VECTORISATION_WIDTH)
+    {
+        ptr = AllocatorType::get_instance().allocate_aligned(sizeof(T), alignof(T));
+    }
+    else
+    {
+        ptr = AllocatorType::get_instance().template allocate<sizeof(T)>();
+    }
+
+    if (unlikely(ptr == nullptr))
+    {
+        return nullptr;
+    }
+
+    return new(ptr) T(std::forward<Args>(args)...); // Placement new , does not invoke memory allocation
+}
+
+template <typename T, typename AllocatorType>
+void metamalloc_delete(T* object)
+{
+    if (object == nullptr)
+    {
+        return;
+    }
+
+    object->~T();
+
+    if constexpr (alignof(T) > AlignmentConstants::MINIMUM_VECTORISATION_WIDTH)
+    {
+        AllocatorType::get_instance().deallocate(object);
+    }
+    else
+    {
+        AllocatorType::get_instance().template deallocate<sizeof(T)>(object);
+    }
+}
+
 #endif
 /*
-    - THE ALLOCATOR WILL HAVE A CENTRAL HEAP AND ALSO THREAD OR CPU LOCAL HEAPS.
+    ARENA OF A MEMORY DOMAIN ( SEE memory_domain.h )
 
-    - ALLOCATIONS INITIALLY WILL BE FROM LOCAL ( EITHER THREAD LOCAL OR CPU LOCAL ) HEAPS. IF LOCAL HEAPS ARE EXHAUSTED , THEN CENTRAL HEAP WILL BE USED.
+    - RESERVES A SINGLE VIRTUAL MEMORY REGION OF 'region_size' BYTES , ALIGNED TO ITS SIZE. THEREFORE THE REGION OF ANY POINTER IN IT IS FOUND BY APPLYING A MASK
 
-    - USES CONFIGURABLE METADATA ( DEFAULT 128KB ) TO STORE LOCAL HEAPS. ALSO INITIALLY USES 64KB METADATA TO STORE VERY BIG SIZED ALLOCATIONS
+    - THE FIRST 'page_alignment' BYTES OF THE REGION ARE RESERVED FOR ITS OWNER , THE REST IS SERVED WITH A BUMP POINTER
 
-    - YOU HAVE TO MAKE SURE THAT METADATA SIZE WILL BE ABLE TO HANDLE NUMBER OF THREADS IN YOUR APPLICATION.
+    - RELEASED BUFFERS ARE NOT GIVEN BACK TO THE SYSTEM ONE BY ONE , SO THAT THE REGION HAS NO HOLES WHICH OTHER MAPPINGS CAN TAKE.
+      THEY ARE KEPT IN AN INTRUSIVE LIST AND REUSED BY ALLOCATIONS OF THE SAME SIZE. reset GIVES THE ENTIRE REGION BACK TO THE SYSTEM AT ONCE
+
+    - VIRTUAL MEMORY IS ONLY RESERVED , PAGES ARE BACKED BY PHYSICAL MEMORY WHEN THEY ARE TOUCHED.
+      ON WINDOWS BUMP ALLOCATIONS COMMIT THEIR PAGES ON DEMAND , SO THAT ONLY THE USED PART OF THE REGION IS CHARGED TO THE COMMIT LIMIT
 */
-#ifndef __SCALABLE_ALLOCATOR__H__
-#define __SCALABLE_ALLOCATOR__H__
+#ifndef _DOMAIN_ARENA_H_
+#define _DOMAIN_ARENA_H_
 
-template <
-            typename CentralHeapType,
-            typename LocalHeapType,
-            typename ArenaType = Arena<>
-         >
-class ScalableAllocator : public Lockable<LockPolicy::USERSPACE_LOCK>
+template <std::size_t region_size = 1073741824, LockPolicy lock_policy = LockPolicy::USERSPACE_LOCK> // Default 1GB
+class DomainArena : public Lockable<lock_policy>, public ArenaBase<DomainArena<region_size, lock_policy>>
 {
-public:
+    public:
 
-    // THIS CLASS IS INTENDED TO BE USED DIRECTLY IN MALLOC REPLACEMENTS
-    // SINCE THIS ONE IS A TEMPLATE CLASS , WE HAVE TO ENSURE A SINGLE ONLY STATIC VARIABLE INITIALISATION
-    static ScalableAllocator& get_instance()
-    {
-        static ScalableAllocator instance;
-        return instance;
-    }
+        static_assert(Pow2Utilities::compile_time_is_power_of_two<region_size>());
 
-    [[nodiscard]] bool create(const typename CentralHeapType::HeapCreationParams& params_central, const typename LocalHeapType::HeapCreationParams& params_local, std::size_t arena_capacity, std::size_t arena_page_alignment = 65536, std::size_t metadata_buffer_size = 131072)
-    {
-        if (arena_capacity <= 0 || arena_page_alignment <= 0 || metadata_buffer_size <= 0 || !MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(arena_page_alignment) || !MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(metadata_buffer_size))
+        DomainArena()
         {
-            return false;
+            m_vm_page_size = VirtualMemory::get_page_size();
         }
 
-        if (m_objects_arena.create(arena_capacity, arena_page_alignment) == false)
+        ~DomainArena()
         {
-            return false;
+            destroy();
         }
 
-        m_metadata_buffer_size = metadata_buffer_size;
-        m_metadata_buffer = reinterpret_cast<char*>(ArenaType::MetadataAllocator::allocate(m_metadata_buffer_size));
+        DomainArena(const DomainArena& other) = delete;
+        DomainArena& operator= (const DomainArena& other) = delete;
+        DomainArena(DomainArena&& other) = delete;
+        DomainArena& operator=(DomainArena&& other) = delete;
 
-        if (m_metadata_buffer == nullptr)
+        [[nodiscard]] bool create(std::size_t page_alignment)
         {
-            return false;
+            if (MultipleUtilities::is_size_a_multiple_of_page_allocation_granularity(page_alignment) == false || Pow2Utilities::is_power_of_two(page_alignment) == false || page_alignment >= region_size)
+            {
+                return false;
+            }
+
+            m_page_alignment = page_alignment;
+            return reserve_region();
         }
 
-        if (m_central_heap.create(params_central, &m_objects_arena) == false)
+        // Gives the entire region back to the system and reserves a new one. Its address may change
+        [[nodiscard]] bool reset()
         {
-            return false;
+            this->enter_concurrent_context();
+            //////////////////////////////////////////////////
+            destroy();
+            bool ret = reserve_region();
+            //////////////////////////////////////////////////
+            this->leave_concurrent_context();
+
+            return ret;
         }
 
-        if (ThreadLocalStorage::get_instance().create(ScalableAllocator::thread_specific_destructor) == false)
+        void destroy()
         {
-            return false;
-        }
+            if (m_region != nullptr)
+            {
+                VirtualMemory::deallocate(m_region, region_size);
+                m_region = nullptr;
+            }
 
-        m_local_heap_creation_params = params_local;
+            m_used_size = 0;
+            m_released_head = nullptr;
+        }
 
-        if (!create_heaps())
+        [[nodiscard]] char* allocate(std::size_t size)
         {
-            return false;
+            size = MultipleUtilities::get_next_pow2_multiple_of(size, m_page_alignment);
+            char* ret = nullptr;
+
+            this->enter_concurrent_context();
+            //////////////////////////////////////////////////
+            ReleasedBuffer** iter = &m_released_head;
+
+            while (*iter != nullptr && (*iter)->m_size != size)
+            {
+                iter = &((*iter)->m_next);
+            }
+
+            if (*iter != nullptr)
+            {
+                ret = reinterpret_cast<char*>(*iter);
+                *iter = (*iter)->m_next;
+            }
+            else if (m_region != nullptr && size <= region_size - m_used_size && VirtualMemory::commit(m_region + m_used_size, size))
+            {
+                ret = m_region + m_used_size;
+                m_used_size += size;
+            }
+            //////////////////////////////////////////////////
+            this->leave_concurrent_context();
+
+            return ret;
         }
-        
-        if (get_thread_local_heap()->get_max_allocation_size() != m_central_heap.get_max_allocation_size())
+
+        void release_to_system(void* address, std::size_t size)
         {
-            return false;
+            ReleasedBuffer* buffer = static_cast<ReleasedBuffer*>(address);
+
+            this->enter_concurrent_context();
+            //////////////////////////////////////////////////
+            buffer->m_size = MultipleUtilities::get_next_pow2_multiple_of(size, m_page_alignment);
+            buffer->m_next = m_released_head;
+            m_released_head = buffer;
+            //////////////////////////////////////////////////
+            this->leave_concurrent_context();
         }
-        
-        if( m_very_big_object_dict.initialise( 65536 / sizeof(typename Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator>::DictionaryNode) ) == false)
+
+        [[nodiscard]] void* allocate_from_system(std::size_t size)
         {
-            return false;
+            void* ret = VirtualMemory::reserve(size);
+
+            if (ret != nullptr && VirtualMemory::commit(ret, size) == false)
+            {
+                VirtualMemory::deallocate(ret, size);
+                ret = nullptr;
+            }
+
+            return ret;
         }
-        
-        m_very_big_object_allocation_lock.initialise();
-        
-        #ifdef ENABLE_REPORT_INVALID_POINTERS
-        if( m_invalid_ptr_detection_dict.initialise( 6553600 / sizeof(typename Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator>::DictionaryNode) ) == false)
+
+        char* get_region() const { return m_region; }
+        bool owns_pointer(void* ptr) const { return m_region != nullptr && get_region_of(ptr) == m_region; }
+        std::size_t get_used_size() const { return m_used_size; } // Including the owner's reserved bytes
+        std::size_t page_size()const { return m_vm_page_size; }
+        std::size_t page_alignment() const { return m_page_alignment; }
+
+        static char* get_region_of(void* ptr)
         {
-            return false;
+            return reinterpret_cast<char*>(reinterpret_cast<uint64_t>(ptr) & ~(static_cast<uint64_t>(region_size) - 1));
         }
 
-        m_invalid_ptr_detection_lock.initialise();
-        #endif
+        class MetadataAllocator
+        {
+            public:
+                static void* allocate(std::size_t size, void* hint_address = nullptr)
+                {
+                    return VirtualMemory::allocate<false>(size, hint_address); // No hugepage, no NUMA and no zeroing
+                }
 
-        m_initialised_successfully.store(true);
+                static void deallocate(void* address, std::size_t size)
+                {
+                    VirtualMemory::deallocate(address, size);
+                }
+        };
 
-        return true;
-    }
+    private:
+        struct ReleasedBuffer
+        {
+            ReleasedBuffer* m_next;
+            std::size_t m_size;
+        };
 
-    void set_thread_local_heap_cache_count(std::size_t count)
-    {
-        m_cached_thread_local_heap_count = count;
-    }
-    
-    void enable_fast_shutdown() 
-    {
-        m_fast_shutdown = true;
-    }
+        std::size_t m_vm_page_size = 0;
+        std::size_t m_page_alignment = 0;
+        char* m_region = nullptr;
+        std::size_t m_used_size = 0;
+        ReleasedBuffer* m_released_head = nullptr;
 
-    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
-    void* allocate(const std::size_t size)
-    {
-        #ifndef ENABLE_DEFAULT_MALLOC
-        if (unlikely( size > m_central_heap.get_max_allocation_size()))
+        // Same over-sized reservation as ArenaBase::allocate_aligned , however paddings go back to the system directly rather than to the released buffers
+        [[nodiscard]] bool reserve_region()
         {
-            auto ptr = VirtualMemory::allocate<false>(size);
-            m_very_big_object_allocation_lock.lock();
-            m_very_big_object_dict.insert( reinterpret_cast<uint64_t>(ptr), size);
-            m_very_big_object_allocation_lock.unlock();
-            return ptr;
-        }
-        
-        void* ret{ nullptr };
-        auto local_heap = get_thread_local_heap();
+            char* buffer = static_cast<char*>(VirtualMemory::reserve(region_size * 2));
 
-        if (local_heap != nullptr)
-        {
-            ret = local_heap->allocate(size);
-        }
+            if (buffer == nullptr)
+            {
+                return false;
+            }
 
-        if (ret == nullptr)
-        {
-            #ifdef ENABLE_STATS
-            m_central_heap_hit_count++;
-            #endif
+            std::size_t remainder = ModuloUtilities::modulo_pow2(reinterpret_cast<std::size_t>(buffer), region_size);
+            std::size_t delta = remainder > 0 ? region_size - remainder : 0;
 
-            #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
-            m_central_heap_hit_count++;
-            fprintf(stderr, "scalable allocator , central heap hit count=%zu\n", m_central_heap_hit_count);
-            #endif
+            if (delta > 0)
+            {
+                VirtualMemory::deallocate(buffer, delta);
+            }
 
-            //If the local one is exhausted , failover to the central one
-            ret = m_central_heap.allocate(size);
+            VirtualMemory::deallocate(buffer + delta + region_size, region_size - delta);
+
+            m_region = buffer + delta;
+
+            if (VirtualMemory::commit(m_region, m_page_alignment) == false)
+            {
+                VirtualMemory::deallocate(m_region, region_size);
+                m_region = nullptr;
+                return false;
+            }
+
+            m_used_size = m_page_alignment; // Reserved for the owner
+            return true;
         }
+};
 
-        #ifdef ENABLE_REPORT_INVALID_POINTERS
-        m_invalid_ptr_detection_lock.lock();
-        m_invalid_ptr_detection_dict.insert( reinterpret_cast<uint64_t>(ret), size);
-        m_invalid_ptr_detection_lock.unlock();
-        #endif
+#endif
 
-        return ret;
-        #else
-        return builtin_aligned_alloc(size, AlignmentConstants::MINIMUM_VECTORISATION_WIDTH);
-        #endif
+/*
+    ISOLATED ALLOCATOR INSTANCE , FOR EX FOR A TENANT OR A REQUEST CLASS. UNLIKE SCALABLE ALLOCATOR , IT IS NOT A SINGLETON
+
+    - EACH DOMAIN HAS ITS OWN REGION ( SEE DomainArena ) , HEAP CONFIGURATION AND STATS
+
+    - THE DOMAIN OF A POINTER IS FOUND IN O(1) : REGIONS ARE ALIGNED TO THEIR SIZES AND THE FIRST BYTES OF EACH REGION POINT TO THE OWNER DOMAIN. SEE get_domain_of
+
+    - release_all RELEASES ALL OBJECTS OF THE DOMAIN AT ONCE WITHOUT DEALLOCATING THEM ONE BY ONE : THE HEAP IS REBUILT AND THE REGION GOES BACK TO THE SYSTEM
+
+    - THE HEAP SHOULD USE DomainArena AS ITS ARENA. FOR DOMAINS SHARED BY THREADS , IT SHOULD BE A CENTRAL HEAP
+
+    - ALLOCATIONS BIGGER THAN THE HEAP'S MAX ALLOCATION SIZE ARE NOT SERVED
+*/
+#ifndef __MEMORY_DOMAIN_H__
+#define __MEMORY_DOMAIN_H__
+
+template <typename HeapType, typename ArenaType = DomainArena<>>
+class MemoryDomain : public Lockable<LockPolicy::USERSPACE_LOCK>
+{
+public:
+
+    MemoryDomain()
+    {
+        static_assert(std::is_base_of<ArenaBase<ArenaType>, ArenaType>::value);
+    }
+
+    ~MemoryDomain()
+    {
+        destroy_heap(); // Before the region goes away
+    }
+
+    MemoryDomain(const MemoryDomain& other) = delete;
+    MemoryDomain& operator= (const MemoryDomain& other) = delete;
+    MemoryDomain(MemoryDomain&& other) = delete;
+    MemoryDomain& operator=(MemoryDomain&& other) = delete;
+
+    [[nodiscard]] bool create(const typename HeapType::HeapCreationParams& params, std::size_t page_alignment = 65536)
+    {
+        if (m_arena.create(page_alignment) == false)
+        {
+            return false;
+        }
 
+        m_heap_creation_params = params;
+        return build();
     }
 
-    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
-    void* allocate_aligned(std::size_t size, std::size_t alignment)
+    [[nodiscard]] void* allocate(std::size_t size)
     {
-        #ifndef ENABLE_DEFAULT_MALLOC
-        if (unlikely( size > m_central_heap.get_max_allocation_size()))
+        if (unlikely(size > get_heap()->get_max_allocation_size()))
         {
-            auto ptr = VirtualMemory::allocate<false>(size);
-            m_very_big_object_allocation_lock.lock();
-            m_very_big_object_dict.insert( reinterpret_cast<uint64_t>(ptr), size);
-            m_very_big_object_allocation_lock.unlock();
-            return ptr;
+            return nullptr;
         }
-        
-        void* ret{ nullptr };
-        auto local_heap = get_thread_local_heap();
 
-        if (local_heap != nullptr)
+        void* ret = get_heap()->allocate(size);
+
+        if (likely(ret != nullptr))
         {
-            ret = local_heap->allocate_aligned(size, alignment);
+            m_allocation_count.fetch_add(1, std::memory_order_relaxed);
         }
 
-        if (ret == nullptr)
+        return ret;
+    }
+
+    [[nodiscard]] void* allocate_aligned(std::size_t size, std::size_t alignment)
+    {
+        if (unlikely(size + alignment > get_heap()->get_max_allocation_size()))
         {
-            #ifdef ENABLE_STATS
-            m_central_heap_hit_count++;
-            #endif
+            return nullptr;
+        }
 
-            #ifdef ENABLE_PERF_TRACES // INSIDE ALLOCATION CALLSTACK SO CAN'T ALLOCATE MEMORY HENCE OUTPUT TO stderr
-            m_central_heap_hit_count++;
-            fprintf(stderr, "scalable allocator , central heap hit count=%zu\n", m_central_heap_hit_count);
-            #endif
+        void* ret = get_heap()->allocate_aligned(size, alignment);
 
-            //If the local one is exhausted , failover to the central one
-            ret = m_central_heap.allocate_aligned(size, alignment);
+        if (likely(ret != nullptr))
+        {
+            m_allocation_count.fetch_add(1, std::memory_order_relaxed);
         }
 
-        #ifdef ENABLE_REPORT_INVALID_POINTERS
-        m_invalid_ptr_detection_lock.lock();
-        m_invalid_ptr_detection_dict.insert( reinterpret_cast<uint64_t>(ret), size);
-        m_invalid_ptr_detection_lock.unlock();
-        #endif
-
         return ret;
-        #else
-        return builtin_aligned_alloc(size, alignment);
-        #endif
-
     }
 
-    ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
     void deallocate(void* ptr)
     {
         if (unlikely(ptr == nullptr))
         {
             return;
         }
-        #ifndef ENABLE_DEFAULT_MALLOC
-        
-        #ifdef ENABLE_REPORT_INVALID_POINTERS
-        if(m_invalid_ptr_detection_dict.has_key(reinterpret_cast<uint64_t>(ptr)) == false )
-        {
-            append_to_invalid_pointer_report("deallocate");
-        }
-        #endif
 
-        
-        if (unlikely( m_very_big_object_dict.has_key( reinterpret_cast<uint64_t>(ptr) ) ))
+        get_heap()->deallocate(ptr);
+        m_deallocation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Releases all objects of the domain. No other thread should be using the domain meanwhile
+    // Its region is given back to the system and the domain starts again with an empty heap. Returns false if the system is out of memory
+    [[nodiscard]] bool release_all()
+    {
+        this->enter_concurrent_context();
+        //////////////////////////////////////////////////
+        destroy_heap(); // Gives only logical pages back to the arena , not objects
+
+        bool ret = m_arena.reset();
+
+        if (ret)
         {
-            std::size_t big_size = 0;
-            m_very_big_object_dict.get(reinterpret_cast<uint64_t>(ptr), big_size);
-            VirtualMemory::deallocate( ptr, big_size);
-            return;
+            ret = build();
         }
-        
-        // LINEAR SEARCH HOWEVER owns_pointer CHECK IS FAST IN BOUNDED LOCAL HEAPS
-        // THEY DON'T DO ANOTHER INTERNAL LINEAR SEARCH THROUGH FREELISTS
-        // SO THERE IS NO NESTED LINEAR SEARCHES BUT JUST ONE
-        for (std::size_t i = 0; i < m_active_local_heap_count; i++)
-        {
-            LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
 
-            if (local_heap->owns_pointer(ptr))
-            {
-                local_heap->deallocate(ptr);
-                return;
-            }
-        }
-        // If we are here, ptr belongs to the central heap
-        m_central_heap.deallocate(ptr);
-        #else
-        builtin_aligned_free(ptr);
-        #endif
+        m_allocation_count.store(0, std::memory_order_relaxed);
+        m_deallocation_count.store(0, std::memory_order_relaxed);
+        //////////////////////////////////////////////////
+        this->leave_concurrent_context();
 
+        return ret;
     }
 
-    std::size_t get_usable_size(void* ptr)
+    // O(1) , 'ptr' should be allocated by a domain of the same type
+    static MemoryDomain* get_domain_of(void* ptr)
     {
-        if (ptr == nullptr) return 0;
-        
-        #ifdef ENABLE_REPORT_INVALID_POINTERS
-        if(m_invalid_ptr_detection_dict.has_key(reinterpret_cast<uint64_t>(ptr)) == false )
-        {
-            append_to_invalid_pointer_report("get_usable_size");
-        }
-        #endif
+        return reinterpret_cast<RegionHeader*>(ArenaType::get_region_of(ptr))->m_domain;
+    }
 
-        for (std::size_t i = 0; i < m_active_local_heap_count; i++)
-        {
-            LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
+    bool owns_pointer(void* ptr) const { return m_arena.owns_pointer(ptr); }
 
-            if (local_heap->owns_pointer(ptr))
-            {
-                return local_heap->get_usable_size(ptr);
-            }
-        }
-        // If we are here, ptr belongs to the central heap
-        return m_central_heap.get_usable_size(ptr);
-    }
+    std::size_t get_allocation_count() const { return m_allocation_count.load(std::memory_order_relaxed); }
+    std::size_t get_deallocation_count() const { return m_deallocation_count.load(std::memory_order_relaxed); }
+    std::size_t get_used_region_size() const { return m_arena.get_used_size(); }    // Bytes taken from the region by the heap , including the header
+    HeapType* get_heap() { return reinterpret_cast<HeapType*>(m_heap_storage); }
 
-    CentralHeapType* get_central_heap() { return &m_central_heap; }
+private:
+    struct RegionHeader
+    {
+        MemoryDomain* m_domain;
+    };
 
-    #ifdef UNIT_TEST
-    std::size_t get_observed_unique_thread_count() const { return m_observed_unique_thread_count; }
-    #endif
+    ArenaType m_arena;
+    alignas(HeapType) char m_heap_storage[sizeof(HeapType)]; // The heap is rebuilt in place by release_all
+    bool m_heap_constructed = false;
+    typename HeapType::HeapCreationParams m_heap_creation_params;
+    std::atomic<std::size_t> m_allocation_count = 0;
+    std::atomic<std::size_t> m_deallocation_count = 0;
 
-    #ifdef ENABLE_STATS
-    bool save_stats_to_file(const std::string_view file_name)
+    bool build()
     {
-        std::ofstream outfile(file_name.data());
+        reinterpret_cast<RegionHeader*>(m_arena.get_region())->m_domain = this;
 
-        if (outfile.is_open())
+        new(m_heap_storage) HeapType(); // Placement new , does not invoke memory allocation
+        m_heap_constructed = true;
+
+        return get_heap()->create(m_heap_creation_params, &m_arena);
+    }
+
+    void destroy_heap()
+    {
+        if (m_heap_constructed)
         {
-            outfile << "Central heap hit count = " << m_central_heap_hit_count << "\n";
-            outfile << "Created thread local heap count = " << m_used_thread_local_heap_count << "\n\n";
+            get_heap()->~HeapType();
+            m_heap_constructed = false;
+        }
+    }
+};
 
-            auto arena_stats = m_objects_arena.get_stats();
-            outfile << "Virtual memory latest usage = " << SizeUtilities::get_human_readible_size(arena_stats.m_latest_used_size) << "\n";
-            outfile << "Virtual memory allocation count = " << arena_stats.m_vm_allocation_count << "\n";
+#endif
 
-            for(std::size_t i=0; i< arena_stats.m_vm_allocation_count; i++)
-            {
-                outfile << "\tVirtual memory allocation size = " << SizeUtilities::get_human_readible_size(arena_stats.m_vm_allocation_sizes[i]) << "\n";
-            }
+/*
+    MONOTONIC REGION ALLOCATOR FOR REQUEST SCOPED WORK
 
-            auto process_heap_stats = [&] (LocalHeapType* heap, const char* name)
-            {
-                auto heap_segments_stats = heap->get_stats();
-                auto heap_segment_count = heap_segments_stats.size();
+    - ALLOCATIONS BUMP A POINTER IN THE CURRENT CHUNK. DEALLOCATIONS DO NOTHING , ALL OBJECTS ARE RELEASED AT ONCE BY reset OR release
 
-                outfile << "--------------------------------------------------------------\n";
-                outfile << name << "\n\n";
+    - CHUNKS COME FROM AN ARENA AND ARE CHAINED THROUGH THEIR HEADERS. ALLOCATIONS BIGGER THAN A CHUNK GET THEIR OWN OVERSIZED CHUNKS
 
-                for (std::size_t i = 0; i < heap_segment_count; i++)
-                {
-                    outfile << "Heap segment sizeclass = " << heap_segments_stats[i].m_size_class << "\n";
-                    outfile << "\t\tLatest logical page count = " << heap_segments_stats[i].m_latest_logical_page_count << "\n";
-                    outfile << "\t\tRecycle count = " << heap_segments_stats[i].m_recycle_count << "\n";
-                    outfile << "\t\tGrow count = " << heap_segments_stats[i].m_grow_size_count << "\n";
+    - reset KEEPS REGULAR CHUNKS FOR THE NEXT REQUEST AND GIVES ONLY OVERSIZED ONES BACK TO THE ARENA , THEREFORE IT IS O(CHUNKS).
+      release GIVES ALL CHUNKS BACK
 
-                    for (std::size_t j = 0; j < heap_segments_stats[i].m_grow_size_count; j++)
-                    {
-                        outfile << "\t\t\t\tGrow size = " << heap_segments_stats[i].m_grow_sizes[j] << "\n";
-                    }
-                }
+    - IT IS NOT THREAD SAFE , LIKE SINGLE THREAD HEAPS. AN ARENA WITH LockPolicy::NO_LOCK CAN BE USED IF THE ARENA IS NOT SHARED
 
-                outfile << "--------------------------------------------------------------\n\n";
-            };
+    - MonotonicRegionResource ADAPTS IT TO std::pmr::memory_resource , SO THAT PMR CONTAINERS CAN USE IT. IT DOESN'T NEED RTTI AND ON ALLOCATION FAILURES IT FOLLOWS OPERATOR NEW :
+      IT CALLS THE NEW HANDLER IF THERE IS ONE , OTHERWISE IT THROWS std::bad_alloc OR ABORTS IF EXCEPTIONS ARE DISABLED
+*/
+#ifndef __MONOTONIC_REGION_H__
+#define __MONOTONIC_REGION_H__
 
-            process_heap_stats(reinterpret_cast<LocalHeapType*>(&m_central_heap), "CENTRAL HEAP");
+template <typename ArenaType = Arena<>>
+class MonotonicRegion
+{
+    public:
 
-            std::size_t local_heap_count = m_active_local_heap_count;
+        static constexpr inline std::size_t MINIMUM_ALIGNMENT = 16;
 
-            if(m_cached_thread_local_heap_count > local_heap_count )
-            {
-                local_heap_count = m_cached_thread_local_heap_count;
-            }
+        MonotonicRegion() = default;
 
-            for (std::size_t i = 0; i < local_heap_count; i++)
+        ~MonotonicRegion()
+        {
+            release();
+        }
+
+        MonotonicRegion(const MonotonicRegion& other) = delete;
+        MonotonicRegion& operator= (const MonotonicRegion& other) = delete;
+        MonotonicRegion(MonotonicRegion&& other) = delete;
+        MonotonicRegion& operator=(MonotonicRegion&& other) = delete;
+
+        // 'chunk_size' will be rounded up to a multiple of the arena's page alignment
+        [[nodiscard]] bool create(std::size_t chunk_size, ArenaType* arena)
+        {
+            if (arena == nullptr || chunk_size <= sizeof(ChunkHeader))
             {
-                LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
-                process_heap_stats(local_heap, "LOCAL HEAP");
+                return false;
             }
 
-            outfile.close();
+            m_arena = arena;
+            m_chunk_size = MultipleUtilities::get_next_pow2_multiple_of(chunk_size, m_arena->page_alignment());
             return true;
         }
-        return false;
-    }
-    #endif
-
-    
-    #ifdef ENABLE_REPORT_INVALID_POINTERS
-    void append_to_invalid_pointer_report(const char* operation)
-    {
-        FILE* report = nullptr;
-        report = fopen("invalid_pointers.txt", "a+"); // does not allocate memory
 
-        if (report) 
+        // Alignment has to be a power of two
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        FORCE_INLINE void* allocate(std::size_t size, std::size_t alignment = MINIMUM_ALIGNMENT)
         {
-            fprintf(report, "Invalid pointer ( a pointer which was not allocated by this allocator ) detected during %s call\n", operation);
-            fclose(report);
+            uint64_t address = MultipleUtilities::get_next_pow2_multiple_of(m_current, alignment);
+
+            if (likely(address + size <= m_end))
+            {
+                m_current = address + size;
+                return reinterpret_cast<void*>(address);
+            }
+
+            return allocate_from_next_chunk(size, alignment);
         }
-        else
+
+        void deallocate(void* ptr)
         {
-            fprintf(stderr, "Failed to open invalid_pointers.txt for writing\n"); // does not allocate memory
+            UNUSED(ptr); // Objects are released by reset or release
         }
-    }
-    #endif
-
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////
-    // WRAPPER METHODS FOR MALLOC REPLACEMENT/INTEGRATION
-    [[nodiscard]] void* operator_new(std::size_t size)
-    {
-        void* ret = allocate(size);
 
-        if( unlikely(ret==nullptr) )
+        // Releases all objects. Regular chunks are kept for the next allocations , oversized chunks go back to the arena
+        void reset()
         {
-            handle_operator_new_failure();
-        }
+            release_chunks(m_oversized_head);
+            m_oversized_head = nullptr;
 
-        return ret;
-    }
+            m_current_chunk = nullptr;
+            m_current = 0;
+            m_end = 0;
 
-    [[nodiscard]] void* operator_new_aligned(std::size_t size, std::size_t alignment)
-    {
-        void* ret = allocate_aligned(size, alignment);
+            if (m_head != nullptr)
+            {
+                start_chunk(m_head);
+            }
+        }
 
-        if( unlikely(ret==nullptr) )
+        // Releases all objects and gives all chunks back to the arena
+        void release()
         {
-            handle_operator_new_failure();
+            release_chunks(m_oversized_head);
+            release_chunks(m_head);
+            m_oversized_head = nullptr;
+            m_head = nullptr;
+            m_current_chunk = nullptr;
+            m_current = 0;
+            m_end = 0;
+            m_chunk_count = 0;
         }
 
-        return ret;
-    }
+        std::size_t get_chunk_count() const { return m_chunk_count; }       // Regular chunks
+        std::size_t get_chunk_size() const { return m_chunk_size; }
 
-    void handle_operator_new_failure()
-    {
-        std::new_handler handler;
+    private:
+        struct ChunkHeader
+        {
+            ChunkHeader* m_next;
+            std::size_t m_size;
+        };
 
-        this->enter_concurrent_context();
-        ///////////////////////////////////////
-        handler = std::get_new_handler();
-        ///////////////////////////////////////
-        this->leave_concurrent_context();
+        uint64_t m_current = 0;        // Bump pointer
+        uint64_t m_end = 0;
+        ChunkHeader* m_current_chunk = nullptr;
+        ChunkHeader* m_head = nullptr;              // Regular chunks , kept by reset
+        ChunkHeader* m_oversized_head = nullptr;
+        ArenaType* m_arena = nullptr;
+        std::size_t m_chunk_size = 0;
+        std::size_t m_chunk_count = 0;
 
-        if(handler != nullptr)
+        FORCE_INLINE void start_chunk(ChunkHeader* chunk)
         {
-            handler();
+            m_current_chunk = chunk;
+            m_current = reinterpret_cast<uint64_t>(chunk) + sizeof(ChunkHeader);
+            m_end = reinterpret_cast<uint64_t>(chunk) + chunk->m_size;
         }
-        else
+
+        ChunkHeader* create_chunk(std::size_t size)
         {
-            throw std::bad_alloc();
-        }
-    }
+            ChunkHeader* chunk = reinterpret_cast<ChunkHeader*>(m_arena->allocate(size));
 
-    [[nodiscard]] void* allocate_and_zero_memory(std::size_t num, std::size_t size)
-    {
-        auto total_size = num * size;
-        void* ret = allocate(total_size);
+            if (chunk != nullptr)
+            {
+                chunk->m_next = nullptr;
+                chunk->m_size = size;
+            }
 
-        if (ret != nullptr)
-        {
-            builtin_memset(ret, 0, total_size);
+            return chunk;
         }
 
-        return ret;
-    }
+        void* allocate_from_next_chunk(std::size_t size, std::size_t alignment)
+        {
+            if (m_arena == nullptr)
+            {
+                return nullptr;
+            }
+
+            std::size_t required_size = sizeof(ChunkHeader) + size + alignment;
+
+            if (required_size > m_chunk_size)
+            {
+                // Oversized chunks don't become the current chunk , so the rest of the current chunk is still used
+                ChunkHeader* chunk = create_chunk(MultipleUtilities::get_next_pow2_multiple_of(required_size, m_arena->page_alignment()));
+
+                if (chunk == nullptr)
+                {
+                    return nullptr;
+                }
+
+                chunk->m_next = m_oversized_head;
+                m_oversized_head = chunk;
+                return reinterpret_cast<void*>(MultipleUtilities::get_next_pow2_multiple_of(reinterpret_cast<uint64_t>(chunk) + sizeof(ChunkHeader), alignment));
+            }
+
+            // Chunks kept by reset are reused before creating new ones
+            ChunkHeader* next_chunk = m_current_chunk != nullptr ? m_current_chunk->m_next : m_head;
+
+            if (next_chunk == nullptr)
+            {
+                next_chunk = create_chunk(m_chunk_size);
+
+                if (next_chunk == nullptr)
+                {
+                    return nullptr;
+                }
+
+                if (m_current_chunk != nullptr)
+                {
+                    m_current_chunk->m_next = next_chunk;
+                }
+                else
+                {
+                    m_head = next_chunk;
+                }
 
-    [[nodiscard]] void* reallocate(void* ptr, std::size_t size)
-    {
-        if (ptr == nullptr)
-        {
-            return  allocate(size);
-        }
+                m_chunk_count++;
+            }
 
-        if (size == 0)
-        {
-            deallocate(ptr);
-            return nullptr;
+            start_chunk(next_chunk);
+            return allocate(size, alignment);
         }
-        
-        std::size_t old_size = get_usable_size(ptr);
-        
-        if(size <= old_size)
+
+        void release_chunks(ChunkHeader* chunk)
         {
-            return ptr;
+            while (chunk != nullptr)
+            {
+                ChunkHeader* next = chunk->m_next;
+                m_arena->release_to_system(chunk, chunk->m_size);
+                chunk = next;
+            }
         }
+};
 
-        void* new_ptr = allocate(size);
+template <typename ArenaType = Arena<>>
+class MonotonicRegionResource : public std::pmr::memory_resource
+{
+    public:
 
-        if (new_ptr != nullptr)
-        {
-            builtin_memcpy(new_ptr, ptr, old_size);
-            deallocate(ptr);
-        }
+        explicit MonotonicRegionResource(MonotonicRegion<ArenaType>* region) : m_region(region) {}
 
-        return new_ptr;
-    }
+    private:
+        MonotonicRegion<ArenaType>* m_region = nullptr;
 
-    [[nodiscard]] void* aligned_reallocate(void* ptr, std::size_t size, std::size_t alignment)
-    {
-        if (ptr == nullptr)
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
         {
-            return  allocate_aligned(size, alignment);
+            alignment = alignment < MonotonicRegion<ArenaType>::MINIMUM_ALIGNMENT ? MonotonicRegion<ArenaType>::MINIMUM_ALIGNMENT : alignment;
+            void* ret = m_region->allocate(bytes, alignment);
+
+            while (unlikely(ret == nullptr))
+            {
+                handle_allocation_failure();
+                ret = m_region->allocate(bytes, alignment);
+            }
+
+            return ret;
         }
 
-        if (size == 0)
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
         {
-            deallocate(ptr);
-            return nullptr;
+            UNUSED(bytes);
+            UNUSED(alignment);
+            m_region->deallocate(p);
         }
-        
-        std::size_t old_size = get_usable_size(ptr);
-        
-        if(size <= old_size)
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
         {
-            return ptr;
+            return this == &other; // Without RTTI , other resources can't be checked for their regions
         }
 
-        void* new_ptr = allocate_aligned(size, alignment);
-
-        if (new_ptr != nullptr)
+        static void handle_allocation_failure()
         {
-            
-            builtin_memcpy(new_ptr, ptr, old_size);
-            deallocate(ptr);
-        }
+            std::new_handler handler = std::get_new_handler();
 
-        return new_ptr;
-    }
+            if (handler != nullptr)
+            {
+                handler();
+                return;
+            }
 
-    [[nodiscard]]void* reallocate_and_zero_memory(void *ptr, std::size_t num, std::size_t size)
-    {
-        auto total_size = num*size;
-        auto ret = reallocate(ptr, total_size);
+            #if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+            throw std::bad_alloc();
+            #else
+            std::abort();
+            #endif
 
-        if(ret != nullptr)
-        {
-            builtin_memset(ret, 0, total_size);
         }
+};
 
-        return ret;
-    }
-    ///////////////////////////////////////////////////////////////////////////////////////////////////////////
+#endif
 
-private:
-    CentralHeapType m_central_heap;
-    ArenaType m_objects_arena;
-    char* m_metadata_buffer = nullptr;
-    std::size_t m_metadata_buffer_size = 131072;       // Default 128KB
-    std::size_t m_active_local_heap_count = 0;
-    std::size_t m_max_thread_local_heap_count = 0;    // Used for only thread local heaps
-    std::size_t m_cached_thread_local_heap_count = 0; // Used for only thread local heaps , its number of available passive heaps
-    bool m_fast_shutdown = false;
-    typename LocalHeapType::HeapCreationParams m_local_heap_creation_params;
+/*
+    TYPED OBJECT POOL FOR FIXED SIZE HOT OBJECTS , FOR EX ORDERS OR NODES
 
-    static inline std::atomic<bool> m_initialised_successfully = false;
-    static inline std::atomic<bool> m_shutdown_started = false;
-    
-    Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator> m_very_big_object_dict;
-    UserspaceSpinlock<> m_very_big_object_allocation_lock;
+    - THE SIZE CLASS IS FIXED AT COMPILE TIME : sizeof(T) ROUNDED UP TO A MULTIPLE OF 16. THERE IS NO SIZE TO BIN LOOKUP ON ANY PATH
 
-    #ifdef UNIT_TEST
-    std::size_t m_observed_unique_thread_count = 0;
-    #endif
+    - REUSES A SINGLE SEGMENT OF LOGICAL PAGES. LOGICAL PAGES ARE ALIGNED TO THEIR SIZES SO DEALLOCATIONS FIND THEIR PAGES BY MASKING
 
-    #ifdef ENABLE_STATS
-    std::size_t m_central_heap_hit_count = 0;
-    std::size_t m_used_thread_local_heap_count =0 ;
-    #endif
+    - ALLOCATIONS POP FROM AN INTRUSIVE CACHE. WHEN THE CACHE IS EMPTY IT IS REFILLED WITH A BATCH FROM THE SEGMENT ( SEE Segment::allocate_batch ).
+      WHEN IT GROWS BEYOND 2 BATCHES , A BATCH GOES BACK TO THE SEGMENT SO THAT LOGICAL PAGES CAN STILL BE RECYCLED
 
-    #ifdef ENABLE_PERF_TRACES
-    std::size_t m_central_heap_hit_count = 0;
-    #endif
+    - SINGLE_THREAD : ONLY ONE THREAD USES THE POOL. THE SEGMENT GROWS FROM THE ARENA WHEN ITS PAGES RUN OUT
 
-    
-    #ifdef ENABLE_REPORT_INVALID_POINTERS
-    Dictionary<uint64_t, std::size_t, typename ArenaType::MetadataAllocator> m_invalid_ptr_detection_dict;
-    UserspaceSpinlock<> m_invalid_ptr_detection_lock;
-    #endif
+    - THREAD_LOCAL : ONLY THE OWNER THREAD ALLOCATES AND IT DEALLOCATES WITH deallocate_from_owner. OTHER THREADS USE deallocate WHICH GOES TO THE SEGMENT'S
+      REMOTE DEALLOCATION PATH. THE SEGMENT IS BOUNDED BY ITS INITIAL LOGICAL PAGE COUNT
 
-    ScalableAllocator()
-    {
-        static_assert(std::is_base_of<HeapBase<CentralHeapType, ConcurrencyPolicy::CENTRAL>, CentralHeapType>::value);
-        static_assert(std::is_base_of<HeapBase<LocalHeapType, ConcurrencyPolicy::THREAD_LOCAL>, LocalHeapType>::value || std::is_base_of<HeapBase<LocalHeapType, ConcurrencyPolicy::SINGLE_THREAD>, LocalHeapType>::value);
-        static_assert(std::is_base_of<ArenaBase<ArenaType>, ArenaType>::value);
-    }
+    - construct AND destroy CONSTRUCT AND DESTROY OBJECTS IN PLACE
+*/
+#ifndef __OBJECT_POOL_H__
+#define __OBJECT_POOL_H__
 
-    ~ScalableAllocator()
-    {
-        #ifdef ENABLE_STATS
-        save_stats_to_file("metamalloc_stats.txt");
-        #endif
+struct ObjectPoolCreationParams
+{
+    std::size_t m_logical_page_size = 65536;     // Arena page alignment should be the same
+    std::size_t m_logical_page_count = 1;
+    std::size_t m_batch_size = 32;               // Number of objects moved between the cache and the segment at once
+    std::size_t m_logical_page_recycling_threshold = 0; // Free logical pages are kept while the segment has no more than that. THREAD_LOCAL pools can't grow back
+    double m_segment_grow_coefficient = 1.0;
+    std::size_t m_segment_deallocation_queue_drain_budget = 128; // Applies to THREAD_LOCAL , 0 means no limit
+};
 
-        
-        #ifndef ENABLE_REPORT_LEAKS
-        if(m_fast_shutdown)
-        {
-            return;
-        }
-        #endif
+template <
+            typename T,
+            ConcurrencyPolicy concurrency_policy = ConcurrencyPolicy::SINGLE_THREAD,
+            typename ArenaType = Arena<>,
+            PageRecyclingPolicy page_recycling_policy = PageRecyclingPolicy::IMMEDIATE,
+            typename LogicalPageType = LogicalPage<>
+        >
+class ObjectPool
+{
+    public:
 
-        if(m_initialised_successfully.load() == true )
-        {
-            // We call it here it in case not called earlier and there are still running threads which are not destructed , no need to move logical pages between heaps
-            m_shutdown_started.store(true);
+        static_assert(concurrency_policy == ConcurrencyPolicy::SINGLE_THREAD || concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL);
+        static_assert(alignof(T) <= 16); // Chunks are 16 byte aligned as size classes are multiples of 16
 
-            destroy_heaps();
+        static constexpr inline std::size_t SIZE_CLASS = sizeof(T) < 16 ? 16 : ((sizeof(T) + 15) & ~static_cast<std::size_t>(15));
 
-            ThreadLocalStorage::get_instance().destroy();
-        }
-    }
+        using SegmentType = Segment<concurrency_policy, LogicalPageType, ArenaType, page_recycling_policy, true>; // true as logical pages are placed at "logical page size" aligned addresses
 
-    ScalableAllocator(const ScalableAllocator& other) = delete;
-    ScalableAllocator& operator= (const ScalableAllocator& other) = delete;
-    ScalableAllocator(ScalableAllocator&& other) = delete;
-    ScalableAllocator& operator=(ScalableAllocator&& other) = delete;
+        ObjectPool() = default;
 
-    static void thread_specific_destructor(void* arg)
-    {
-        if( m_initialised_successfully.load() == true && m_shutdown_started.load() == false )
+        ~ObjectPool()
         {
-            auto thread_local_heap = reinterpret_cast<LocalHeapType*>(arg);
-
-            if(thread_local_heap) // Thread local arg is not supposed to be nullptr by OS specs but just to be safe
+            // Cached chunks keep their logical pages in use , they should go back before the segment is destroyed
+            while (m_cache_head != nullptr)
             {
-                auto central_heap = get_instance().get_central_heap();
-                central_heap->transfer_logical_pages_from(reinterpret_cast<CentralHeapType*>(thread_local_heap));
+                m_segment.deallocate_from_owner(pop_from_cache());
             }
         }
-    }
 
-    std::size_t get_created_heap_count()
-    {
-        auto heap_count = m_cached_thread_local_heap_count > m_active_local_heap_count ? m_cached_thread_local_heap_count : m_active_local_heap_count;
-        return heap_count;
-    }
+        ObjectPool(const ObjectPool& other) = delete;
+        ObjectPool& operator= (const ObjectPool& other) = delete;
+        ObjectPool(ObjectPool&& other) = delete;
+        ObjectPool& operator=(ObjectPool&& other) = delete;
 
-    void destroy_heaps()
-    {
-        if (m_metadata_buffer)
+        [[nodiscard]] bool create(const ObjectPoolCreationParams& params, ArenaType* arena)
         {
-            auto heap_count = get_created_heap_count();
+            if (arena == nullptr || params.m_batch_size == 0 || params.m_logical_page_count == 0 || arena->page_alignment() != params.m_logical_page_size)
+            {
+                return false;
+            }
 
-            for (std::size_t i = 0; i < heap_count; i++)
+            if (SIZE_CLASS > params.m_logical_page_size - sizeof(LogicalPageHeader))
             {
-                LocalHeapType* local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (i * sizeof(LocalHeapType)));
-                local_heap->~LocalHeapType();
+                return false;
             }
-        }
-    }
 
-    LocalHeapType* get_thread_local_heap()
-    {
-        return get_thread_local_heap_internal();
-    }
+            char* buffer = arena->allocate(params.m_logical_page_count * params.m_logical_page_size);
 
-    FORCE_INLINE LocalHeapType* get_thread_local_heap_internal()
-    {
-        auto thread_local_heap = reinterpret_cast<LocalHeapType*>(ThreadLocalStorage::get_instance().get());
+            if (buffer == nullptr)
+            {
+                return false;
+            }
 
-        if (thread_local_heap == nullptr)
+            SegmentCreationParameters segment_params;
+            segment_params.m_size_class = static_cast<uint32_t>(SIZE_CLASS);
+            segment_params.m_logical_page_count = params.m_logical_page_count;
+            segment_params.m_logical_page_size = params.m_logical_page_size;
+            segment_params.m_page_recycling_threshold = params.m_logical_page_recycling_threshold;
+            segment_params.m_grow_coefficient = params.m_segment_grow_coefficient;
+            segment_params.m_deallocation_queue_drain_budget = params.m_segment_deallocation_queue_drain_budget;
+
+            m_batch_size = params.m_batch_size;
+            return m_segment.create(buffer, arena, segment_params);
+        }
+
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE) [[nodiscard]]
+        FORCE_INLINE void* allocate()
         {
-            // LOCKING HERE WILL HAPPEN ONLY ONCE FOR EACH THREAD , AT THEIR START
-            // AS THERE ARE SHARED VARIABLES FOR THREAD-LOCAL HEAP CREATION
-            this->enter_concurrent_context();
+            if (unlikely(m_cache_head == nullptr) && refill() == false)
+            {
+                return nullptr;
+            }
 
-            #ifdef UNIT_TEST
-            m_observed_unique_thread_count++;
-            #endif
+            return pop_from_cache();
+        }
 
-            #ifdef ENABLE_STATS
-            m_used_thread_local_heap_count++;
-            #endif
+        // SINGLE_THREAD pools and the owner thread of THREAD_LOCAL pools
+        ALIGN_CODE(AlignmentConstants::CACHE_LINE_SIZE)
+        FORCE_INLINE void deallocate_from_owner(void* ptr)
+        {
+            push_to_cache(ptr);
 
-            ///////////////////////////////////////////////////////////////////////////////////////////////////////////
-            if (m_active_local_heap_count + 1 >= m_max_thread_local_heap_count)
+            if (unlikely(m_cache_count > m_batch_size * 2))
             {
-                // If we are here , it means that metadata buffer size is not sufficient to handle all threads of the application
-                this->leave_concurrent_context();
-                return nullptr;
+                flush(m_batch_size);
             }
+        }
 
-            if (m_active_local_heap_count >= m_cached_thread_local_heap_count)
+        // Can be called by any thread in THREAD_LOCAL case
+        void deallocate(void* ptr)
+        {
+            if constexpr (concurrency_policy == ConcurrencyPolicy::THREAD_LOCAL)
             {
-                thread_local_heap = create_local_heap(m_active_local_heap_count);
+                m_segment.deallocate(ptr);
             }
             else
             {
-                thread_local_heap = reinterpret_cast<LocalHeapType*>(m_metadata_buffer + (m_active_local_heap_count * sizeof(LocalHeapType)));
+                deallocate_from_owner(ptr);
             }
-
-            m_active_local_heap_count++;
-            ThreadLocalStorage::get_instance().set(thread_local_heap);
-            ///////////////////////////////////////////////////////////////////////////////////////////////////////////
-            this->leave_concurrent_context();
         }
 
-        return thread_local_heap;
-    }
+        template <typename... Args>
+        [[nodiscard]] T* construct(Args&&... args)
+        {
+            void* ptr = allocate();
 
-    bool create_heaps()
-    {
-        m_max_thread_local_heap_count = m_metadata_buffer_size / sizeof(LocalHeapType);
+            if (unlikely(ptr == nullptr))
+            {
+                return nullptr;
+            }
 
-        if (m_max_thread_local_heap_count == 0)
-        {
-            return false;
+            return new(ptr) T(std::forward<Args>(args)...); // Placement new , does not invoke memory allocation
         }
 
-        if (m_max_thread_local_heap_count < m_cached_thread_local_heap_count)
+        void destroy_from_owner(T* object)
         {
-            m_cached_thread_local_heap_count = m_max_thread_local_heap_count;
+            object->~T();
+            deallocate_from_owner(object);
         }
 
-        for (std::size_t i{ 0 }; i < m_cached_thread_local_heap_count; i++)
+        void destroy(T* object)
         {
-            auto local_heap = create_local_heap(i);
-            if (!local_heap) return false;
+            object->~T();
+            deallocate(object);
         }
 
-        return true;
-    }
+        std::size_t get_cached_count() const { return m_cache_count; }
+        std::size_t get_logical_page_count() const { return m_segment.get_logical_page_count(); }
 
-    LocalHeapType* create_local_heap(std::size_t metadata_buffer_index)
-    {
-        LocalHeapType* local_heap = new(m_metadata_buffer + (metadata_buffer_index * sizeof(LocalHeapType))) LocalHeapType();    // Placement new , does not invoke memory allocation
+    private:
+        void* m_cache_head = nullptr;     // Chunks are linked through their first 8 bytes
+        std::size_t m_cache_count = 0;
+        std::size_t m_batch_size = 0;
+        SegmentType m_segment;
 
-        if (local_heap->create(m_local_heap_creation_params, &m_objects_arena) == false)
+        FORCE_INLINE void* pop_from_cache()
         {
-            return nullptr;
+            void* ret = m_cache_head;
+            m_cache_head = *reinterpret_cast<void**>(ret);
+            m_cache_count--;
+            return ret;
         }
 
-        return local_heap;
-    }
+        FORCE_INLINE void push_to_cache(void* ptr)
+        {
+            *reinterpret_cast<void**>(ptr) = m_cache_head;
+            m_cache_head = ptr;
+            m_cache_count++;
+        }
+
+        bool refill()
+        {
+            void* first = nullptr;
+            std::size_t count = m_segment.allocate_batch(m_batch_size, &first);
+
+            if (count == 0)
+            {
+                return false;
+            }
+
+            m_cache_head = first;
+            m_cache_count = count;
+            return true;
+        }
+
+        void flush(std::size_t count)
+        {
+            for (std::size_t i = 0; i < count && m_cache_head != nullptr; i++)
+            {
+                m_segment.deallocate_from_owner(pop_from_cache());
+            }
+        }
 };
 
 #endif
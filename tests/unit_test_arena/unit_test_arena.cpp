@@ -127,6 +127,46 @@ int main(int argc, char* argv[])
         }
     }
 
+    // CACHE REPLENISHING
+    {
+        Arena<> arena;
+        bool success = arena.create(65536 * 4, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return -1; }
+
+        auto ptr = arena.allocate(65536 * 3);
+        unit_test.test_equals(arena.get_available_cache_size(), 65536, "arena", "available cache size after allocation");
+
+        success = arena.replenish_cache(65536 * 2);
+        unit_test.test_equals(success, true, "arena", "cache replenishing");
+        unit_test.test_equals(arena.get_available_cache_size(), 65536 * 4, "arena", "available cache size after replenishing");
+
+        success = arena.replenish_cache(65536);
+        unit_test.test_equals(arena.get_available_cache_size(), 65536 * 4, "arena", "no replenishing above the low watermark");
+
+        auto next_ptr = arena.allocate(65536);
+        unit_test.test_equals(next_ptr != nullptr && validate_buffer(next_ptr, 65536), true, "arena", "allocation from the replenished cache");
+
+        arena.release_to_system(ptr, 65536 * 3);
+        arena.release_to_system(next_ptr, 65536);
+    }
+
+    // DEFERRED RELEASE
+    {
+        Arena<> arena;
+        bool success = arena.create(65536 * 4, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return -1; }
+
+        arena.set_deferred_release(true);
+
+        auto ptr = arena.allocate(65536 * 2);
+        auto next_ptr = arena.allocate(65536);
+        arena.release_to_system(ptr, 65536 * 2);
+        arena.release_to_system(next_ptr, 65536);
+
+        unit_test.test_equals(arena.process_deferred_releases(), 2, "arena", "deferred releases");
+        unit_test.test_equals(arena.process_deferred_releases(), 0, "arena", "no deferred releases left");
+    }
+
     // HUGE PAGES
     {
         // CHECK IF WE CAN USE HUGE PAGE IN THE TEST
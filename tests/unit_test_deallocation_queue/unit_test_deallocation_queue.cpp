@@ -1,41 +1,23 @@
 #include "../unit_test.h" // Always should be the 1st one as it defines UNIT_TEST macro
 
-#include "../../include/compiler/unused.h"
 #include "../../include/deallocation_queue.h"
 
 #include <cstdlib>
 #include <cstring>
 #include <atomic>
 #include <vector>
+#include <algorithm>
 #include <thread>
 #include <iostream>
 using namespace std;
 
 UnitTest unit_test;
 
-class DeallocationQueueStdAllocator
-{
-public:
-    static void* allocate(std::size_t size)
-    {
-        return std::malloc(size);
-    }
-
-    static void deallocate(void* ptr, std::size_t size)
-    {
-        UNUSED(size);
-        std::free(ptr);
-    }
-};
-
 int main(int argc, char* argv[])
 {
-    static_assert( sizeof(PointerPage) == 65536);
-
-    // SINGLE THREAD  BASIC OPERATIONS SINGLE PAGE
+    // SINGLE THREAD BASIC OPERATIONS , QUEUE IS INTRUSIVE SO PUSHED POINTERS SHOULD HOLD AT LEAST 8 BYTES
     {
-        DeallocationQueue<DeallocationQueueStdAllocator> q;
-        if (q.create(1) == false) { std::cout << "deallocation q creation failed !!!\n"; return -1; }
+        DeallocationQueue q;
 
         std::size_t pointer_count = 20000;
 
@@ -76,15 +58,14 @@ int main(int argc, char* argv[])
 
     // CONCURRENCY TESTS
     {
-        DeallocationQueue<DeallocationQueueStdAllocator> q;
-        if (q.create(65536) == false) { std::cout << "deallocation q creation failed !!!\n"; return -1; }
+        DeallocationQueue q;
 
         constexpr std::size_t producer_thread_count = 128;
         constexpr std::size_t production_count_per_producer_thread = 640;
         std::vector<std::unique_ptr<std::thread>> producer_threads;
         std::thread* consumer_thread;
 
-        std::size_t consumer_result = 0; // Will only be accessed by consumer thread
+        std::vector<void*> consumed_pointers; // Will only be accessed by consumer thread
         std::atomic<bool> producers_finished;
         producers_finished.store(false);
 
@@ -98,7 +79,7 @@ int main(int argc, char* argv[])
                 {
                     break;
                 }
-                consumer_result++;
+                consumed_pointers.push_back(pointer);
             }
         };
 
@@ -149,7 +130,13 @@ int main(int argc, char* argv[])
         // WAIT FOR CONSUMER THREAD
         consumer_thread->join();
 
-        unit_test.test_equals(consumer_result, producer_thread_count * production_count_per_producer_thread, "deallocation queue", "thread safety");
+        unit_test.test_equals(consumed_pointers.size(), producer_thread_count * production_count_per_producer_thread, "deallocation queue", "thread safety");
+
+        std::sort(consumed_pointers.begin(), consumed_pointers.end());
+        bool no_duplicates = std::adjacent_find(consumed_pointers.begin(), consumed_pointers.end()) == consumed_pointers.end();
+        unit_test.test_equals(no_duplicates, true, "deallocation queue", "thread safety , each pointer consumed once");
+
+        for (auto ptr : consumed_pointers) { std::free(ptr); }
 
         delete consumer_thread;
     }
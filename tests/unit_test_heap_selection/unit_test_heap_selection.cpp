@@ -0,0 +1,125 @@
+#include "../unit_test.h" // Always should be the 1st one as it defines UNIT_TEST macro
+
+
+#include "../../examples/simple_heap_pow2.h"
+using namespace metamalloc;
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+constexpr std::size_t WORKER_COUNT = 4;
+thread_local std::size_t current_worker_id = HeapSelector::NO_CONTEXT_KEY; // Set by the worker pool
+
+struct WorkerIdHeapSelector
+{
+    static constexpr inline bool USES_CONTEXT_KEY = true;
+    static std::size_t get_context_key() { return current_worker_id; }
+};
+
+using CentralHeapType = SimpleHeapPow2<ConcurrencyPolicy::CENTRAL>;
+using LocalHeapType = SimpleHeapPow2<ConcurrencyPolicy::THREAD_LOCAL>;
+
+using AllocatorType =
+ScalableAllocator<
+        CentralHeapType,
+        LocalHeapType,
+        Arena<>,
+        WorkerIdHeapSelector
+>;
+
+UnitTest unit_test;
+
+int main(int argc, char* argv[])
+{
+    constexpr std::size_t ARENA_CAPACITY = 2147483648; // 2GB
+
+    CentralHeapType::HeapCreationParams params_central;
+    LocalHeapType::HeapCreationParams params_local;
+
+    AllocatorType::get_instance().set_context_key_count(WORKER_COUNT);
+    bool success = AllocatorType::get_instance().create(params_central, params_local, ARENA_CAPACITY);
+    if (!success) { std::cout << "Creation failed !!!\n"; return -1; }
+
+    ////////////////////////////////////// HEAPS SELECTED BY WORKER IDS
+    // The main thread has no worker id , it gets a thread local heap during creation
+    std::vector<std::thread> workers;
+    std::vector<void*> worker_pointers(WORKER_COUNT, nullptr);
+    std::vector<void*> worker_page_holders(WORKER_COUNT, nullptr); // Keep logical pages in use , so that they are not recycled
+
+    for (std::size_t i = 0; i < WORKER_COUNT; i++)
+    {
+        workers.emplace_back([&, i]()
+        {
+            current_worker_id = i;
+            worker_pointers[i] = AllocatorType::get_instance().allocate(64);
+            std::memset(worker_pointers[i], static_cast<int>(i), 64);
+            worker_page_holders[i] = AllocatorType::get_instance().allocate(64);
+        });
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    unit_test.test_equals(AllocatorType::get_instance().get_observed_unique_thread_count(), 1, "heap selection", "no thread local heaps for workers");
+    unit_test.test_equals(worker_pointers[0] != worker_pointers[1], true, "heap selection", "separate heaps for worker ids");
+
+    ////////////////////////////////////// CONTEXT MIGRATION
+    // Another thread continues the context of worker 1 : the chunk goes straight back to its logical page as the calling context owns the heap ,
+    // so the next allocation gets it again instead of it being buffered as a remote deallocation
+    std::thread migrated_thread([&]()
+    {
+        current_worker_id = 1;
+        void* ptr = worker_pointers[1];
+        AllocatorType::get_instance().deallocate(ptr);
+        void* next_ptr = AllocatorType::get_instance().allocate(64);
+        unit_test.test_equals(next_ptr, ptr, "heap selection", "deallocation by the owner context on another thread");
+        AllocatorType::get_instance().deallocate(next_ptr);
+    });
+
+    migrated_thread.join();
+
+    ////////////////////////////////////// THREADS WITHOUT CONTEXT KEYS
+    std::thread unkeyed_thread([&]()
+    {
+        for (std::size_t i = 0; i < WORKER_COUNT; i++)
+        {
+            if (i != 1)
+            {
+                AllocatorType::get_instance().deallocate(worker_pointers[i]); // Remote deallocations
+            }
+
+            AllocatorType::get_instance().deallocate(worker_page_holders[i]);
+        }
+
+        void* ptr = AllocatorType::get_instance().allocate(64);
+        unit_test.test_equals(ptr != nullptr, true, "heap selection", "allocation without a context key");
+        AllocatorType::get_instance().deallocate(ptr);
+    });
+
+    unkeyed_thread.join();
+
+    unit_test.test_equals(AllocatorType::get_instance().get_observed_unique_thread_count(), 2, "heap selection", "thread local heap for a thread without a context key");
+
+    ////////////////////////////////////// PRINT THE REPORT
+    std::cout << unit_test.get_summary_report("HeapSelection");
+    std::cout.flush();
+
+    #if _WIN32
+    bool pause = true;
+    if(argc > 1)
+    {
+        if (std::strcmp(argv[1], "no_pause") == 0)
+            pause = false;
+    }
+    if(pause)
+        std::system("pause");
+    #endif
+
+    return unit_test.did_all_pass();
+}
@@ -0,0 +1,238 @@
+#include "../unit_test.h" // Always should be the 1st one as it defines UNIT_TEST macro
+
+
+#include "../../examples/simple_heap_pow2.h"
+using namespace metamalloc;
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+using CentralHeapType = SimpleHeapPow2<ConcurrencyPolicy::CENTRAL>;
+using LocalHeapType = SimpleHeapPow2<ConcurrencyPolicy::THREAD_LOCAL>;
+
+using AllocatorType =
+ScalableAllocator<
+        CentralHeapType,
+        LocalHeapType
+>;
+
+UnitTest unit_test;
+
+int main(int argc, char* argv[])
+{
+    constexpr std::size_t ARENA_CAPACITY = 2147483648; // 2GB
+    constexpr std::size_t LOW_WATERMARK = 4;
+    constexpr std::size_t HIGH_WATERMARK = 8;
+
+    CentralHeapType::HeapCreationParams params_central;
+    LocalHeapType::HeapCreationParams params_local;
+    params_local.m_use_shared_logical_page_pool = true; // 12 logical pages per local heap
+
+    AllocatorType::get_instance().set_page_stealing(64, 0);
+    AllocatorType::get_instance().set_hot_thread_watermarks(65536 * 16, LOW_WATERMARK, HIGH_WATERMARK);
+    bool success = AllocatorType::get_instance().create(params_central, params_local, ARENA_CAPACITY);
+    if (!success) { std::cout << "Creation failed !!!\n"; return -1; }
+
+    std::atomic<int> phase = 0;
+
+    std::thread hot_thread([&]()
+    {
+        const std::size_t chunks_per_logical_page = (params_local.m_logical_page_size - sizeof(LogicalPage<>)) / 2048;
+        std::vector<void*> pointers;
+
+        unit_test.test_equals(AllocatorType::get_instance().set_current_thread_hot(), true, "hot threads", "marking the calling thread hot");
+
+        phase.store(1);
+        while (phase.load() != 2) { std::this_thread::yield(); }
+
+        // Free logical pages above the high watermark were released by the replenisher
+        unit_test.test_equals(AllocatorType::get_instance().get_thread_local_heap_logical_page_capacity(), HIGH_WATERMARK, "hot threads", "capacity after releasing above the high watermark");
+
+        auto allocate_chunks = [&](std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; i++)
+            {
+                void* ptr = AllocatorType::get_instance().allocate(2048);
+
+                if (ptr == nullptr)
+                {
+                    return false;
+                }
+
+                std::memset(ptr, static_cast<int>(i), 2048);
+                pointers.push_back(ptr);
+            }
+
+            return true;
+        };
+
+        unit_test.test_equals(allocate_chunks(chunks_per_logical_page * HIGH_WATERMARK), true, "hot threads", "allocations");
+        unit_test.test_equals(AllocatorType::get_instance().get_hot_thread_fallback_count(), 0, "hot threads", "no fallbacks");
+
+        phase.store(3);
+        while (phase.load() != 4) { std::this_thread::yield(); }
+
+        // The replenisher gave logical pages up to the low watermark
+        unit_test.test_equals(AllocatorType::get_instance().get_thread_local_heap_logical_page_capacity(), HIGH_WATERMARK + LOW_WATERMARK, "hot threads", "capacity after replenishing");
+        unit_test.test_equals(allocate_chunks(chunks_per_logical_page * LOW_WATERMARK), true, "hot threads", "allocations from replenished logical pages");
+        unit_test.test_equals(AllocatorType::get_instance().get_hot_thread_fallback_count(), 0, "hot threads", "no fallbacks after replenishing");
+        unit_test.test_equals(AllocatorType::get_instance().get_usable_size(pointers.back()), 2048, "hot threads", "usable size of a chunk in a replenished logical page");
+
+        // The heap is exhausted now
+        unit_test.test_equals(allocate_chunks(1), true, "hot threads", "allocation from an exhausted heap");
+        unit_test.test_equals(AllocatorType::get_instance().get_hot_thread_fallback_count(), 1, "hot threads", "fallback of an exhausted heap");
+
+        void* very_big_ptr = AllocatorType::get_instance().allocate(1024 * 1024);
+        AllocatorType::get_instance().deallocate(very_big_ptr);
+        unit_test.test_equals(AllocatorType::get_instance().get_hot_thread_fallback_count(), 3, "hot threads", "fallbacks of a very big object");
+
+        for (auto ptr : pointers)
+        {
+            AllocatorType::get_instance().deallocate(ptr);
+        }
+    });
+
+    while (phase.load() != 1) { std::this_thread::yield(); }
+    unit_test.test_equals(AllocatorType::get_instance().replenish(), 0, "hot threads", "nothing to replenish");
+    phase.store(2);
+
+    while (phase.load() != 3) { std::this_thread::yield(); }
+    unit_test.test_equals(AllocatorType::get_instance().replenish(), LOW_WATERMARK, "hot threads", "replenishing up to the low watermark");
+    phase.store(4);
+
+    hot_thread.join();
+
+    ////////////////////////////////////// REPLENISHING AND RELEASING MORE LOGICAL PAGES THAN THE STOLEN LOGICAL PAGE TABLE CAN HOLD
+    std::atomic<bool> looping_done = false;
+
+    std::thread looping_hot_thread([&]()
+    {
+        AllocatorType::get_instance().set_current_thread_hot();
+        AllocatorType::get_instance().flush_thread_cache(); // The heap starts with no free logical pages
+        phase.store(5);
+        while (looping_done.load() == false) { std::this_thread::yield(); }
+    });
+
+    while (phase.load() != 5) { std::this_thread::yield(); }
+
+    bool all_replenishments_ok = true;
+
+    for (std::size_t i = 0; i < (64 / LOW_WATERMARK) * 4; i++)
+    {
+        if (AllocatorType::get_instance().replenish() != LOW_WATERMARK)
+        {
+            all_replenishments_ok = false;
+        }
+
+        AllocatorType::get_instance().release_idle_thread_caches(0); // Releases all free logical pages , their table entries are freed
+    }
+
+    unit_test.test_equals(all_replenishments_ok, true, "hot threads", "replenishing after releases beyond the stolen logical page table size");
+    unit_test.test_equals(AllocatorType::get_instance().get_stolen_logical_page_count(), 0, "hot threads", "stolen logical page table entries of released logical pages");
+
+    looping_done.store(true);
+    looping_hot_thread.join();
+
+    ////////////////////////////////////// PREWARMING
+    std::thread prewarmed_thread([&]()
+    {
+        const std::size_t chunks_per_logical_page = (params_local.m_logical_page_size - sizeof(LogicalPage<>)) / 2048;
+
+        AllocatorType::PrewarmProfile profile;
+        profile.m_sizes[0] = 2048;
+        profile.m_free_chunk_counts[0] = chunks_per_logical_page * 2;
+        profile.m_sizes[1] = 64;
+        profile.m_free_chunk_counts[1] = 100;
+        profile.m_size_count = 2;
+
+        unit_test.test_equals(AllocatorType::get_instance().prewarm_current_thread(profile), true, "prewarming", "prewarming the calling thread");
+        unit_test.test_equals(AllocatorType::get_instance().get_slow_path_count_of_current_thread(), 0, "prewarming", "no slow path events after prewarming");
+
+        std::vector<void*> pointers;
+
+        for (std::size_t i = 0; i < chunks_per_logical_page * 2; i++)
+        {
+            pointers.push_back(AllocatorType::get_instance().allocate(2048));
+        }
+
+        for (std::size_t i = 0; i < 100; i++)
+        {
+            pointers.push_back(AllocatorType::get_instance().allocate(64));
+        }
+
+        unit_test.test_equals(AllocatorType::get_instance().get_slow_path_count_of_current_thread(), 0, "prewarming", "no slow path events in allocations");
+
+        for (auto ptr : pointers)
+        {
+            AllocatorType::get_instance().deallocate(ptr);
+        }
+
+        void* very_big_ptr = AllocatorType::get_instance().allocate(1024 * 1024);
+        AllocatorType::get_instance().deallocate(very_big_ptr);
+        unit_test.test_equals(AllocatorType::get_instance().get_slow_path_count_of_current_thread(), 2, "prewarming", "slow path events of a very big object");
+
+        AllocatorType::PrewarmProfile too_big_profile;
+        too_big_profile.m_sizes[0] = 2048;
+        too_big_profile.m_free_chunk_counts[0] = chunks_per_logical_page * 64;
+        too_big_profile.m_size_count = 1;
+        unit_test.test_equals(AllocatorType::get_instance().prewarm_current_thread(too_big_profile), false, "prewarming", "targets beyond the local heap");
+
+        AllocatorType::PrewarmProfile locking_profile;
+        locking_profile.m_sizes[0] = 64;
+        locking_profile.m_free_chunk_counts[0] = 100;
+        locking_profile.m_size_count = 1;
+        locking_profile.m_lock_pages = true;
+        unit_test.test_equals(AllocatorType::get_instance().prewarm_current_thread(locking_profile), true, "prewarming", "prewarming with page locking");
+        unit_test.test_equals(AllocatorType::get_instance().unlock_pages_of_current_thread(), true, "prewarming", "unlocking prewarmed pages");
+    });
+
+    prewarmed_thread.join();
+
+    ////////////////////////////////////// DEALLOCATION OFFLOAD
+    AllocatorType::get_instance().set_deallocation_offload(true);
+    phase.store(0);
+
+    std::thread offloading_thread([&]()
+    {
+        auto initial_fallback_count = AllocatorType::get_instance().get_hot_thread_fallback_count();
+        AllocatorType::get_instance().set_current_thread_hot();
+
+        for (std::size_t i = 0; i < 4; i++)
+        {
+            void* very_big_ptr = AllocatorType::get_instance().allocate(1024 * 1024);
+            std::memset(very_big_ptr, static_cast<int>(i), 1024 * 1024);
+            AllocatorType::get_instance().deallocate(very_big_ptr);
+        }
+
+        // Only allocations made syscalls
+        unit_test.test_equals(AllocatorType::get_instance().get_hot_thread_fallback_count(), initial_fallback_count + 4, "deallocation offload", "fallbacks of offloaded very big objects");
+        phase.store(1);
+    });
+
+    while (phase.load() != 1) { std::this_thread::yield(); }
+    unit_test.test_equals(AllocatorType::get_instance().process_offloaded_deallocations(), 4, "deallocation offload", "unmapped very big objects");
+    unit_test.test_equals(AllocatorType::get_instance().process_offloaded_deallocations(), 0, "deallocation offload", "nothing left to unmap");
+
+    offloading_thread.join();
+
+    ////////////////////////////////////// PRINT THE REPORT
+    std::cout << unit_test.get_summary_report("HotThreads");
+    std::cout.flush();
+
+    #if _WIN32
+    bool pause = true;
+    if(argc > 1)
+    {
+        if (std::strcmp(argv[1], "no_pause") == 0)
+            pause = false;
+    }
+    if(pause)
+        std::system("pause");
+    #endif
+
+    return unit_test.did_all_pass();
+}
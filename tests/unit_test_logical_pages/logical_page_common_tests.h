@@ -4,6 +4,7 @@
 #include <string>
 #include "../../include/arena.h"
 #include "../../include/logical_page.h"
+#include "../../include/logical_page_any_size.h"
 #include "../../include/os/thread_utilities.h"
 
 bool validate_buffer(void* buffer, std::size_t buffer_size);
@@ -26,6 +27,10 @@ bool test_general(std::size_t);
 
 int test_extras_logical_page_any_size();
 
+void test_thread_free_list();
+
+void test_non_pow2_size_classes();
+
 template <typename LogicalPageType>
 void test_incorrect_creation(std::size_t buffer_size)
 {
@@ -230,4 +235,173 @@ bool test_general(std::size_t buffer_size)
     return true;
 }
 
-#endif
\ No newline at end of file
+int test_extras_logical_page_any_size()
+{
+    Arena arena;
+    std::size_t BUFFER_SIZE = 65536;
+    std::string test_category = "logical page any size";
+
+    LogicalPageAnySize<> logical_page;
+    bool success = logical_page.create(arena.allocate(BUFFER_SIZE), BUFFER_SIZE);
+    unit_test.test_equals(true, success, test_category, "creation");
+    unit_test.test_equals(logical_page.get_free_block_count(), 1, test_category, "initially one free block");
+
+    // ALLOCATION HEADERS & USABLE SIZES
+    auto ptr1 = logical_page.allocate(100);
+    auto ptr2 = logical_page.allocate(200);
+    auto ptr3 = logical_page.allocate(300);
+    unit_test.test_equals(logical_page.get_usable_size(ptr1), 112, test_category, "usable size is rounded up to 16 bytes");
+    unit_test.test_equals(reinterpret_cast<std::size_t>(ptr2) - reinterpret_cast<std::size_t>(ptr1), 128, test_category, "blocks are packed densely");
+    unit_test.test_equals(true, validate_buffer(ptr3, 300), test_category, "buffer validation");
+
+    // COALESCING
+    logical_page.deallocate(ptr1);
+    logical_page.deallocate(ptr3);
+    unit_test.test_equals(logical_page.get_free_block_count(), 2, test_category, "last freed block coalesced with the remainder");
+    logical_page.deallocate(ptr2);
+    unit_test.test_equals(logical_page.get_free_block_count(), 1, test_category, "coalescing with both neighbours");
+    unit_test.test_equals(logical_page.get_used_size(), 0, test_category, "used size after coalescing");
+
+    // GOOD FIT : A FREED SMALL BLOCK SHOULD BE REUSED INSTEAD OF SPLITTING THE BIG ONE
+    auto small = logical_page.allocate(48);
+    auto separator = logical_page.allocate(48);
+    logical_page.deallocate(small);
+    auto reused = logical_page.allocate(40);
+    unit_test.test_equals(true, reused == small, test_category, "good fit reuses the small free block");
+    logical_page.deallocate(reused);
+    logical_page.deallocate(separator);
+
+    // ALIGNMENT AWARE CARVING
+    std::vector<void*> aligned_pointers;
+    std::size_t alignments[] = { 32, 64, 256, 4096 };
+
+    for (auto alignment : alignments)
+    {
+        auto ptr = logical_page.allocate_aligned(24, alignment);
+        unit_test.test_equals(true, ptr != nullptr && AlignmentChecks::is_address_aligned(ptr, alignment), test_category, "aligned allocation " + std::to_string(alignment));
+        unit_test.test_equals(logical_page.get_usable_size(ptr), 32, test_category, "aligned allocation does not consume padding bytes " + std::to_string(alignment));
+        aligned_pointers.push_back(ptr);
+    }
+
+    for (auto ptr : aligned_pointers)
+    {
+        logical_page.deallocate(ptr);
+    }
+
+    unit_test.test_equals(logical_page.get_free_block_count(), 1, test_category, "coalescing after aligned allocations");
+    unit_test.test_equals(logical_page.get_used_size(), 0, test_category, "used size after aligned allocations");
+
+    // THE WHOLE PAGE IN ONE ALLOCATION
+    auto max_size = LogicalPageAnySize<>::get_max_allocation_size(BUFFER_SIZE);
+    auto biggest = logical_page.allocate(max_size);
+    unit_test.test_equals(true, biggest != nullptr, test_category, "max allocation size");
+    unit_test.test_equals(true, logical_page.allocate(1) == nullptr, test_category, "exhaustion");
+    logical_page.deallocate(biggest);
+    unit_test.test_equals(true, logical_page.allocate(max_size + 1) == nullptr, test_category, "too big allocation");
+
+    return 0;
+}
+
+void test_thread_free_list()
+{
+    constexpr std::size_t BUFFER_SIZE = 65536;
+    constexpr std::size_t SIZE_CLASS = 128;
+    constexpr std::size_t CHUNK_COUNT = BUFFER_SIZE / SIZE_CLASS;
+    constexpr std::size_t THREAD_COUNT = 8;
+
+    Arena arena;
+    LogicalPage<> logical_page;
+    bool success = logical_page.create(arena.allocate(BUFFER_SIZE), BUFFER_SIZE, SIZE_CLASS);
+    unit_test.test_equals(true, success, "thread free list", "creation");
+
+    std::vector<void*> pointers;
+
+    for (std::size_t i = 0; i < CHUNK_COUNT; i++)
+    {
+        pointers.push_back(logical_page.allocate(SIZE_CLASS));
+    }
+
+    unit_test.test_equals(logical_page.allocate(SIZE_CLASS) == nullptr, true, "thread free list", "exhaustion");
+    unit_test.test_equals(logical_page.collect_thread_free_list(), 0, "thread free list", "empty collection");
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < THREAD_COUNT; i++)
+    {
+        threads.emplace_back([&logical_page, &pointers, i]()
+        {
+            for (std::size_t j = i; j < CHUNK_COUNT; j += THREAD_COUNT)
+            {
+                logical_page.deallocate_to_thread_free_list(pointers[j]);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    unit_test.test_equals(logical_page.get_used_size(), BUFFER_SIZE, "thread free list", "remote deallocations don't touch used size");
+    unit_test.test_equals(logical_page.allocate(SIZE_CLASS) == nullptr, true, "thread free list", "remote deallocations don't touch local freelist");
+    unit_test.test_equals(logical_page.collect_thread_free_list(), CHUNK_COUNT, "thread free list", "collection count");
+    unit_test.test_equals(logical_page.get_used_size(), 0, "thread free list", "used size after collection");
+
+    std::size_t allocation_count = 0;
+
+    while (logical_page.allocate(SIZE_CLASS) != nullptr)
+    {
+        allocation_count++;
+    }
+
+    unit_test.test_equals(allocation_count, CHUNK_COUNT, "thread free list", "allocations after collection");
+}
+
+void test_non_pow2_size_classes()
+{
+    constexpr std::size_t BUFFER_SIZE = 65536;
+    const std::size_t size_classes[] = { 24, 48, 80, 112, 1040, 3072, 5000 };
+
+    for (const auto size_class : size_classes)
+    {
+        Arena arena;
+        LogicalPage<> logical_page;
+        void* buffer = arena.allocate(BUFFER_SIZE);
+        bool success = logical_page.create(buffer, BUFFER_SIZE, static_cast<uint32_t>(size_class));
+        unit_test.test_equals(true, success, "non pow2 size classes", "creation sizeclass=" + std::to_string(size_class));
+
+        const std::size_t chunk_count = BUFFER_SIZE / size_class;
+        std::vector<std::size_t> pointers;
+
+        for (std::size_t i = 0; i < chunk_count; i++)
+        {
+            pointers.push_back(reinterpret_cast<std::size_t>(logical_page.allocate(size_class)));
+        }
+
+        unit_test.test_equals(logical_page.allocate(size_class) == nullptr, true, "non pow2 size classes", "exhaustion sizeclass=" + std::to_string(size_class));
+
+        // Deallocate padded pointers , each one pointing to a different offset inside its chunk
+        for (std::size_t i = 0; i < chunk_count; i++)
+        {
+            logical_page.deallocate(reinterpret_cast<void*>(pointers[i] + (i % size_class)));
+        }
+
+        unit_test.test_equals(logical_page.get_used_size(), 0, "non pow2 size classes", "used size after padded deallocations sizeclass=" + std::to_string(size_class));
+
+        bool all_chunk_starts = true;
+
+        for (std::size_t i = 0; i < chunk_count; i++)
+        {
+            auto address = reinterpret_cast<std::size_t>(logical_page.allocate(size_class));
+
+            if ((address - reinterpret_cast<std::size_t>(buffer)) % size_class != 0)
+            {
+                all_chunk_starts = false;
+            }
+        }
+
+        unit_test.test_equals(all_chunk_starts, true, "non pow2 size classes", "unpadded to chunk starts sizeclass=" + std::to_string(size_class));
+    }
+}
+
+#endif
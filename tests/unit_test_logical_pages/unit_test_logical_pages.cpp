@@ -35,6 +35,30 @@ int main(int argc, char* argv[])
 
         // GENERAL TESTS
         test_general<LogicalPage<>, LogicalPageNode>(65536);
+
+        // THREAD FREE LIST
+        test_thread_free_list();
+
+        // NON POWER OF TWO SIZE CLASSES
+        test_non_pow2_size_classes();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // LOGICAL PAGE ANY SIZE TESTS
+    {
+        unit_test.test_equals(sizeof(LogicalPageAnySizeNode), 32, "Logical page any size node size", "Should be 32 bytes");
+
+        // CREATION CHECKS
+        test_incorrect_creation<LogicalPageAnySize<>>(6);
+
+        // ERRORS
+        test_errors<LogicalPageAnySize<>>();
+
+        // GENERAL TESTS
+        test_general<LogicalPageAnySize<>, LogicalPageAnySizeNode>(65536);
+
+        // SEGREGATED FREELISTS , COALESCING AND ALIGNMENT
+        test_extras_logical_page_any_size();
     }
 
 
@@ -0,0 +1,139 @@
+#include "../unit_test.h" // Always should be the 1st one as it defines UNIT_TEST macro
+
+
+#include "../../examples/simple_heap_pow2.h"
+using namespace metamalloc;
+
+#include <vector>
+#include <thread>
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+using DomainArenaType = DomainArena<268435456>; // 256MB regions
+using DomainHeapType = SimpleHeapPow2<ConcurrencyPolicy::CENTRAL, DomainArenaType>;
+using DomainType = MemoryDomain<DomainHeapType, DomainArenaType>;
+
+UnitTest unit_test;
+
+bool validate_buffer(void* buffer, std::size_t buffer_size, int value)
+{
+    char* char_buffer = static_cast<char*>(buffer);
+
+    for (std::size_t i = 0; i < buffer_size; i++)
+    {
+        if (char_buffer[i] != static_cast<char>(value))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    DomainHeapType::HeapCreationParams params;
+
+    DomainType tenant_a;
+    DomainType tenant_b;
+
+    unit_test.test_equals(tenant_a.create(params), true, "memory domain", "creation");
+    unit_test.test_equals(tenant_b.create(params), true, "memory domain", "creation of the 2nd domain");
+
+    auto initial_used_region_size = tenant_a.get_used_region_size(); // The header and the initial logical pages of the heap
+
+    ////////////////////////////////////// ALLOCATIONS AND DOMAIN LOOKUPS
+    std::vector<void*> pointers_a;
+    std::vector<void*> pointers_b;
+    bool all_allocations_ok = true;
+    bool all_lookups_ok = true;
+
+    for (std::size_t i = 0; i < 10000; i++)
+    {
+        std::size_t size = static_cast<std::size_t>(16) << (i % 11); // Up to 16KB
+        void* ptr_a = tenant_a.allocate(size);
+        void* ptr_b = tenant_b.allocate(size);
+
+        if (ptr_a == nullptr || ptr_b == nullptr)
+        {
+            all_allocations_ok = false;
+            break;
+        }
+
+        std::memset(ptr_a, 'a', size);
+        std::memset(ptr_b, 'b', size);
+        pointers_a.push_back(ptr_a);
+        pointers_b.push_back(ptr_b);
+
+        if (DomainType::get_domain_of(ptr_a) != &tenant_a || DomainType::get_domain_of(ptr_b) != &tenant_b || tenant_a.owns_pointer(ptr_b) || tenant_b.owns_pointer(ptr_a))
+        {
+            all_lookups_ok = false;
+        }
+    }
+
+    unit_test.test_equals(all_allocations_ok, true, "memory domain", "allocations");
+    unit_test.test_equals(all_lookups_ok, true, "memory domain", "domain lookups from pointers");
+    unit_test.test_equals(tenant_a.get_allocation_count(), 10000, "memory domain", "allocation count");
+    unit_test.test_equals(tenant_a.allocate(1048576) == nullptr, true, "memory domain", "allocation bigger than the max allocation size");
+
+    // A thread allocating and deallocating in a shared domain
+    std::thread worker([&]()
+    {
+        for (std::size_t i = 0; i < 1000; i++)
+        {
+            tenant_b.deallocate(tenant_b.allocate(64));
+        }
+    });
+
+    worker.join();
+
+    unit_test.test_equals(tenant_b.get_deallocation_count(), 1000, "memory domain", "deallocation count");
+
+    ////////////////////////////////////// RELEASING A DOMAIN
+    unit_test.test_equals(tenant_a.get_used_region_size() > initial_used_region_size, true, "memory domain", "used region size");
+    unit_test.test_equals(tenant_a.release_all(), true, "memory domain", "releasing all objects");
+    unit_test.test_equals(tenant_a.get_used_region_size(), initial_used_region_size, "memory domain", "used region size after release");
+    unit_test.test_equals(tenant_a.get_allocation_count(), 0, "memory domain", "allocation count after release");
+
+    void* ptr = tenant_a.allocate(128);
+    unit_test.test_equals(ptr != nullptr && DomainType::get_domain_of(ptr) == &tenant_a, true, "memory domain", "allocation after release");
+    std::memset(ptr, 'c', 128);
+    unit_test.test_equals(validate_buffer(ptr, 128, 'c'), true, "memory domain", "buffer after release");
+    tenant_a.deallocate(ptr);
+
+    bool other_domain_ok = true;
+
+    for (std::size_t i = 0; i < pointers_b.size(); i++)
+    {
+        if (validate_buffer(pointers_b[i], static_cast<std::size_t>(16) << (i % 11), 'b') == false)
+        {
+            other_domain_ok = false;
+            break;
+        }
+    }
+
+    unit_test.test_equals(other_domain_ok, true, "memory domain", "objects of the other domain after release");
+
+    for (auto b_ptr : pointers_b)
+    {
+        tenant_b.deallocate(b_ptr);
+    }
+
+    ////////////////////////////////////// PRINT THE REPORT
+    std::cout << unit_test.get_summary_report("MemoryDomain");
+    std::cout.flush();
+
+    #if _WIN32
+    bool pause = true;
+    if(argc > 1)
+    {
+        if (std::strcmp(argv[1], "no_pause") == 0)
+            pause = false;
+    }
+    if(pause)
+        std::system("pause");
+    #endif
+
+    return unit_test.did_all_pass();
+}
@@ -0,0 +1,131 @@
+#include "../unit_test.h" // Always should be the 1st one as it defines UNIT_TEST macro
+
+
+#include "../../metamalloc.h"
+using namespace metamalloc;
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+using namespace std;
+
+using ArenaType = Arena<LockPolicy::NO_LOCK>;
+using RegionType = MonotonicRegion<ArenaType>;
+
+UnitTest unit_test;
+
+int main(int argc, char* argv[])
+{
+    constexpr std::size_t CHUNK_SIZE = 65536;
+
+    ArenaType arena;
+    bool success = arena.create(CHUNK_SIZE * 16, 65536);
+    if (!success) { std::cout << "Arena creation failed !!!\n"; return -1; }
+
+    RegionType region;
+    unit_test.test_equals(region.create(CHUNK_SIZE, &arena), true, "monotonic region", "creation");
+
+    ////////////////////////////////////// BUMP ALLOCATIONS
+    bool all_allocations_ok = true;
+    bool all_alignments_ok = true;
+    void* first_ptr = nullptr;
+
+    for (std::size_t i = 0; i < 10000; i++)
+    {
+        std::size_t size = 1 + (i % 100);
+        std::size_t alignment = static_cast<std::size_t>(16) << (i % 4);
+        void* ptr = region.allocate(size, alignment);
+
+        if (ptr == nullptr)
+        {
+            all_allocations_ok = false;
+            break;
+        }
+
+        if (first_ptr == nullptr)
+        {
+            first_ptr = ptr;
+        }
+
+        std::memset(ptr, 'a', size);
+
+        if (reinterpret_cast<uint64_t>(ptr) % alignment != 0)
+        {
+            all_alignments_ok = false;
+        }
+    }
+
+    unit_test.test_equals(all_allocations_ok, true, "monotonic region", "allocations");
+    unit_test.test_equals(all_alignments_ok, true, "monotonic region", "alignments");
+    unit_test.test_equals(region.get_chunk_count() > 1, true, "monotonic region", "chunk chaining");
+
+    void* oversized_ptr = region.allocate(CHUNK_SIZE * 2);
+    unit_test.test_equals(oversized_ptr != nullptr, true, "monotonic region", "oversized allocation");
+    std::memset(oversized_ptr, 'b', CHUNK_SIZE * 2);
+
+    ////////////////////////////////////// RESET KEEPS CHUNKS
+    auto chunk_count = region.get_chunk_count();
+    region.reset();
+    unit_test.test_equals(region.allocate(1), first_ptr, "monotonic region", "allocation after reset starts from the first chunk");
+
+    for (std::size_t i = 0; i < 10000; i++)
+    {
+        region.deallocate(region.allocate(1 + (i % 100)));
+    }
+
+    unit_test.test_equals(region.get_chunk_count(), chunk_count, "monotonic region", "chunks reused after reset");
+
+    ////////////////////////////////////// PMR ADAPTER
+    region.reset();
+    MonotonicRegionResource<ArenaType> resource(&region);
+
+    {
+        std::pmr::vector<std::pmr::string> strings(&resource);
+
+        for (std::size_t i = 0; i < 1000; i++)
+        {
+            strings.emplace_back("a string which does not fit into the small string buffer");
+        }
+
+        bool strings_ok = true;
+
+        for (const auto& str : strings)
+        {
+            if (str != "a string which does not fit into the small string buffer")
+            {
+                strings_ok = false;
+                break;
+            }
+        }
+
+        unit_test.test_equals(strings_ok, true, "monotonic region", "pmr containers");
+    }
+
+    MonotonicRegionResource<ArenaType> other_resource(&region);
+    unit_test.test_equals(resource.is_equal(resource), true, "monotonic region", "pmr resource equality");
+    unit_test.test_equals(resource.is_equal(other_resource), false, "monotonic region", "pmr resource inequality");
+
+    ////////////////////////////////////// RELEASE
+    region.release();
+    unit_test.test_equals(region.get_chunk_count(), 0, "monotonic region", "release");
+    unit_test.test_equals(region.allocate(128) != nullptr, true, "monotonic region", "allocation after release");
+
+    ////////////////////////////////////// PRINT THE REPORT
+    std::cout << unit_test.get_summary_report("MonotonicRegion");
+    std::cout.flush();
+
+    #if _WIN32
+    bool pause = true;
+    if(argc > 1)
+    {
+        if (std::strcmp(argv[1], "no_pause") == 0)
+            pause = false;
+    }
+    if(pause)
+        std::system("pause");
+    #endif
+
+    return unit_test.did_all_pass();
+}
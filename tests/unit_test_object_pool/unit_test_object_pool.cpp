@@ -0,0 +1,174 @@
+#include "../unit_test.h" // Always should be the 1st one as it defines UNIT_TEST macro
+
+
+#include "../../metamalloc.h"
+using namespace metamalloc;
+
+#include <vector>
+#include <thread>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+using namespace std;
+
+struct Order
+{
+    Order(uint64_t id, double price) : m_id(id), m_price(price) { s_live_count++; }
+    ~Order() { s_live_count--; }
+
+    uint64_t m_id;
+    double m_price;
+    char m_symbol[24];
+
+    static inline int s_live_count = 0;
+};
+
+using SingleThreadPoolType = ObjectPool<Order, ConcurrencyPolicy::SINGLE_THREAD, Arena<LockPolicy::NO_LOCK>>;
+using ThreadLocalPoolType = ObjectPool<Order, ConcurrencyPolicy::THREAD_LOCAL, Arena<>>;
+
+UnitTest unit_test;
+
+int main(int argc, char* argv[])
+{
+    unit_test.test_equals(SingleThreadPoolType::SIZE_CLASS, 48, "object pool", "compile time size class");
+
+    ////////////////////////////////////// SINGLE THREAD
+    {
+        Arena<LockPolicy::NO_LOCK> arena;
+        bool success = arena.create(65536 * 64, 65536);
+        if (!success) { std::cout << "Arena creation failed !!!\n"; return -1; }
+
+        ObjectPoolCreationParams params;
+        SingleThreadPoolType pool;
+        unit_test.test_equals(pool.create(params, &arena), true, "object pool", "single thread creation");
+
+        std::vector<Order*> orders;
+        bool all_constructions_ok = true;
+
+        for (uint64_t i = 0; i < 10000; i++) // More than a logical page can hold , the segment grows
+        {
+            Order* order = pool.construct(i, static_cast<double>(i) * 0.5);
+
+            if (order == nullptr || reinterpret_cast<uint64_t>(order) % 16 != 0)
+            {
+                all_constructions_ok = false;
+                break;
+            }
+
+            orders.push_back(order);
+        }
+
+        unit_test.test_equals(all_constructions_ok, true, "object pool", "single thread constructions");
+        unit_test.test_equals(Order::s_live_count, 10000, "object pool", "live objects");
+        unit_test.test_equals(pool.get_logical_page_count() > 1, true, "object pool", "segment growth");
+
+        bool all_values_ok = true;
+
+        for (uint64_t i = 0; i < orders.size(); i++)
+        {
+            if (orders[i]->m_id != i || orders[i]->m_price != static_cast<double>(i) * 0.5)
+            {
+                all_values_ok = false;
+            }
+        }
+
+        unit_test.test_equals(all_values_ok, true, "object pool", "object values");
+
+        for (auto order : orders)
+        {
+            pool.destroy(order);
+        }
+
+        unit_test.test_equals(Order::s_live_count, 0, "object pool", "destructions");
+        unit_test.test_equals(pool.get_cached_count() <= params.m_batch_size * 2, true, "object pool", "cache bounded by batches");
+
+        // The most recently destroyed object is served first
+        Order* last = pool.construct(1, 1.0);
+        pool.destroy_from_owner(last);
+        unit_test.test_equals(pool.construct(2, 2.0), last, "object pool", "reuse of the latest object");
+        pool.destroy(last);
+    }
+
+    ////////////////////////////////////// THREAD LOCAL
+    {
+        Arena<> arena;
+        bool success = arena.create(65536 * 64, 65536);
+        if (!success) { std::cout << "Arena creation failed !!!\n"; return -1; }
+
+        ObjectPoolCreationParams params;
+        params.m_logical_page_count = 8;
+        params.m_logical_page_recycling_threshold = 8; // Keep all pages of the bounded segment
+        ThreadLocalPoolType pool;
+        unit_test.test_equals(pool.create(params, &arena), true, "object pool", "thread local creation");
+
+        std::vector<Order*> orders;
+
+        for (uint64_t i = 0; i < 1000; i++)
+        {
+            orders.push_back(pool.construct(i, 0.0));
+        }
+
+        // Another thread destroys half of them , they go to the segment's deallocation queue
+        std::thread remote_thread([&]()
+        {
+            for (std::size_t i = 0; i < 500; i++)
+            {
+                pool.destroy(orders[i]);
+            }
+        });
+
+        remote_thread.join();
+
+        for (std::size_t i = 500; i < 1000; i++)
+        {
+            pool.destroy_from_owner(orders[i]);
+        }
+
+        unit_test.test_equals(Order::s_live_count, 0, "object pool", "remote and owner destructions");
+
+        // Bounded by 8 logical pages , remotely deallocated objects have to be reused to go beyond that
+        bool all_allocations_ok = true;
+
+        for (std::size_t round = 0; round < 10; round++)
+        {
+            orders.clear();
+
+            for (uint64_t i = 0; i < 5000; i++)
+            {
+                Order* order = pool.construct(i, 0.0);
+
+                if (order == nullptr)
+                {
+                    all_allocations_ok = false;
+                    break;
+                }
+
+                orders.push_back(order);
+            }
+
+            for (auto order : orders)
+            {
+                pool.destroy_from_owner(order);
+            }
+        }
+
+        unit_test.test_equals(all_allocations_ok, true, "object pool", "thread local reuse");
+    }
+
+    ////////////////////////////////////// PRINT THE REPORT
+    std::cout << unit_test.get_summary_report("ObjectPool");
+    std::cout.flush();
+
+    #if _WIN32
+    bool pause = true;
+    if(argc > 1)
+    {
+        if (std::strcmp(argv[1], "no_pause") == 0)
+            pause = false;
+    }
+    if(pause)
+        std::system("pause");
+    #endif
+
+    return unit_test.did_all_pass();
+}
@@ -0,0 +1,195 @@
+#include "../unit_test.h" // Always should be the 1st one as it defines UNIT_TEST macro
+
+
+#include "../../examples/simple_heap_pow2.h"
+using namespace metamalloc;
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+using CentralHeapType = SimpleHeapPow2<ConcurrencyPolicy::CENTRAL>;
+using LocalHeapType = SimpleHeapPow2<ConcurrencyPolicy::THREAD_LOCAL>;
+
+using AllocatorType =
+ScalableAllocator<
+        CentralHeapType,
+        LocalHeapType
+>;
+
+UnitTest unit_test;
+
+int main(int argc, char* argv[])
+{
+    constexpr std::size_t ARENA_CAPACITY = 2147483648; // 2GB
+    constexpr std::size_t RESERVED_SLOT_COUNT = 2;
+
+    CentralHeapType::HeapCreationParams params_central;
+    LocalHeapType::HeapCreationParams params_local;
+    params_local.m_use_shared_logical_page_pool = true; // 12 logical pages per local heap
+
+    AllocatorType::get_instance().set_page_stealing(64, RESERVED_SLOT_COUNT);
+    AllocatorType::get_instance().set_heap_rebalancing(8, 1, 8);
+    bool success = AllocatorType::get_instance().create(params_central, params_local, ARENA_CAPACITY);
+    if (!success) { std::cout << "Creation failed !!!\n"; return -1; }
+
+    // The main thread gets a local heap during creation and stays idle , its heap can lend all but 2 of its logical pages
+
+    // A thread which exits without using most of its logical pages
+    std::thread exiting_thread([&]()
+    {
+        void* ptr = AllocatorType::get_instance().allocate(16);
+        AllocatorType::get_instance().deallocate(ptr);
+    });
+
+    exiting_thread.join();
+
+    // A thread which needs 30 logical pages for 2048 bytes
+    std::thread allocating_thread([&]()
+    {
+        const std::size_t chunks_per_logical_page = (params_local.m_logical_page_size - sizeof(LogicalPage<>)) / 2048;
+        const std::size_t allocation_count = chunks_per_logical_page * 30;
+        auto initial_refill_count = AllocatorType::get_instance().get_transfer_cache_refill_count();
+
+        for (std::size_t repeat = 0; repeat < 2; repeat++)
+        {
+            std::vector<void*> pointers;
+            bool all_allocations_ok = true;
+
+            for (std::size_t i = 0; i < allocation_count; i++)
+            {
+                void* ptr = AllocatorType::get_instance().allocate(2048);
+
+                if (ptr == nullptr)
+                {
+                    all_allocations_ok = false;
+                    break;
+                }
+
+                std::memset(ptr, static_cast<int>(i), 2048);
+                pointers.push_back(ptr);
+            }
+
+            unit_test.test_equals(all_allocations_ok, true, "page stealing", "allocations");
+            // 12 own logical pages , 10 from the idle main thread's heap and 8 from the exited thread's heap
+            unit_test.test_equals(AllocatorType::get_instance().get_stolen_logical_page_count(), 18, "page stealing", "stolen logical page count");
+            unit_test.test_equals(AllocatorType::get_instance().get_transfer_cache_refill_count(), initial_refill_count, "page stealing", "no central heap usage");
+            unit_test.test_equals(AllocatorType::get_instance().get_usable_size(pointers.back()), 2048, "page stealing", "usable size of a chunk in a stolen logical page");
+
+            // Stolen logical pages stay with the stealing heap , so the 2nd round won't steal more
+            for (auto ptr : pointers)
+            {
+                AllocatorType::get_instance().deallocate(ptr);
+            }
+        }
+    });
+
+    allocating_thread.join();
+
+    ////////////////////////////////////// HEAP REBALANCING
+    // No heap is hot , idle main thread's heap keeps 1 free logical page and the ones of exited threads are released
+    unit_test.test_equals(AllocatorType::get_instance().rebalance_thread_local_heaps(), 0, "heap rebalancing", "no hot heaps");
+    unit_test.test_equals(AllocatorType::get_instance().get_thread_local_heap_logical_page_capacity(), 1, "heap rebalancing", "idle heap capacity");
+
+    std::atomic<int> phase = 0;
+
+    std::thread hot_thread([&]()
+    {
+        const std::size_t chunks_per_logical_page = (params_local.m_logical_page_size - sizeof(LogicalPage<>)) / 2048;
+        std::vector<void*> pointers;
+
+        // Fill own 12 logical pages , then 8 more allocations can't be served by the local heap
+        for (std::size_t i = 0; i < chunks_per_logical_page * 12 + 8; i++)
+        {
+            pointers.push_back(AllocatorType::get_instance().allocate(2048));
+        }
+
+        phase.store(1);
+        while (phase.load() != 2) { std::this_thread::yield(); }
+
+        unit_test.test_equals(AllocatorType::get_instance().get_thread_local_heap_logical_page_capacity(), 20, "heap rebalancing", "hot heap capacity");
+
+        auto initial_refill_count = AllocatorType::get_instance().get_transfer_cache_refill_count();
+        bool all_allocations_ok = true;
+
+        for (std::size_t i = 0; i < chunks_per_logical_page * 8; i++)
+        {
+            void* ptr = AllocatorType::get_instance().allocate(2048);
+
+            if (ptr == nullptr)
+            {
+                all_allocations_ok = false;
+                break;
+            }
+
+            std::memset(ptr, static_cast<int>(i), 2048);
+            pointers.push_back(ptr);
+        }
+
+        unit_test.test_equals(all_allocations_ok, true, "heap rebalancing", "allocations");
+        unit_test.test_equals(AllocatorType::get_instance().get_transfer_cache_refill_count(), initial_refill_count, "heap rebalancing", "no central heap usage");
+        unit_test.test_equals(AllocatorType::get_instance().get_usable_size(pointers.back()), 2048, "heap rebalancing", "usable size of a chunk in a given logical page");
+
+        for (auto ptr : pointers)
+        {
+            AllocatorType::get_instance().deallocate(ptr);
+        }
+    });
+
+    while (phase.load() != 1) { std::this_thread::yield(); }
+    unit_test.test_equals(AllocatorType::get_instance().rebalance_thread_local_heaps(), 8, "heap rebalancing", "logical pages given to the hot heap");
+    phase.store(2);
+
+    hot_thread.join();
+
+    ////////////////////////////////////// IDLE THREAD CACHES
+    // The main thread's heap kept 1 free logical page after rebalancing
+    unit_test.test_equals(AllocatorType::get_instance().flush_thread_cache(), 1, "idle thread caches", "flush of the calling thread");
+    unit_test.test_equals(AllocatorType::get_instance().get_thread_local_heap_logical_page_capacity(), 0, "idle thread caches", "capacity after flush");
+
+    // Heaps of exited threads are always released
+    AllocatorType::get_instance().release_idle_thread_caches(3600000000000ull);
+
+    phase.store(0);
+
+    std::thread idle_thread([&]()
+    {
+        void* ptr = AllocatorType::get_instance().allocate(16);
+        AllocatorType::get_instance().deallocate(ptr);
+
+        phase.store(1);
+        while (phase.load() != 2) { std::this_thread::yield(); }
+
+        unit_test.test_equals(AllocatorType::get_instance().get_thread_local_heap_logical_page_capacity(), 0, "idle thread caches", "capacity of the idle heap");
+        ptr = AllocatorType::get_instance().allocate(16);
+        unit_test.test_equals(ptr != nullptr, true, "idle thread caches", "allocation after release");
+        AllocatorType::get_instance().deallocate(ptr);
+    });
+
+    while (phase.load() != 1) { std::this_thread::yield(); }
+    unit_test.test_equals(AllocatorType::get_instance().release_idle_thread_caches(3600000000000ull), 0, "idle thread caches", "recently active heaps are kept");
+    unit_test.test_equals(AllocatorType::get_instance().release_idle_thread_caches(0), 12, "idle thread caches", "free logical pages of the idle heap");
+    phase.store(2);
+
+    idle_thread.join();
+
+    ////////////////////////////////////// PRINT THE REPORT
+    std::cout << unit_test.get_summary_report("PageStealing");
+    std::cout.flush();
+
+    #if _WIN32
+    bool pause = true;
+    if(argc > 1)
+    {
+        if (std::strcmp(argv[1], "no_pause") == 0)
+            pause = false;
+    }
+    if(pause)
+        std::system("pause");
+    #endif
+
+    return unit_test.did_all_pass();
+}
@@ -6,6 +6,7 @@
 using namespace metamalloc;
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstring>
 #include <thread>
@@ -101,7 +102,7 @@ int main(int argc, char* argv[])
     // PER THREAD
     {
         PerThreadCachingAllocatorType::get_instance().set_thread_local_heap_cache_count(8);
-        success = PerThreadCachingAllocatorType::get_instance().create({65536}, {65536}, 6553600, 65536, 65536);
+        success = PerThreadCachingAllocatorType::get_instance().create({65536}, {65536}, 6553600, 65536, 131072); // Metadata for 32 threads
         if (!success) { std::cout << "per thread caching allocator creation failed !!!" << std::endl; return -1; }
 
         constexpr std::size_t thread_count = 32;
@@ -200,6 +201,155 @@ int main(int argc, char* argv[])
         PerThreadCachingAllocatorType::get_instance().deallocate(very_big_ptr);
     }
 
+    ////////////////////////////////////////////////////////////////////////////
+    // REMOTE DEALLOCATION BATCHING
+    {
+        constexpr std::size_t batch_size = 4;
+        constexpr std::size_t allocation_count = 10;
+        PerThreadCachingAllocatorType::get_instance().set_remote_deallocation_batching(batch_size, 0);
+
+        std::vector<void*> pointers;
+
+        for (std::size_t i = 0; i < allocation_count; i++)
+        {
+            pointers.push_back(PerThreadCachingAllocatorType::get_instance().allocate(64));
+        }
+
+        std::atomic<bool> deallocations_done = false;
+        std::atomic<bool> flush_requested = false;
+
+        std::thread consumer_thread([&]()
+        {
+            // So that the consumer has its own heap and remote deallocation cache
+            void* own_ptr = PerThreadCachingAllocatorType::get_instance().allocate(64);
+
+            for (auto ptr : pointers)
+            {
+                PerThreadCachingAllocatorType::get_instance().deallocate(ptr);
+            }
+
+            deallocations_done.store(true);
+            while (flush_requested.load() == false) { std::this_thread::yield(); }
+
+            PerThreadCachingAllocatorType::get_instance().flush_remote_deallocations();
+            PerThreadCachingAllocatorType::get_instance().deallocate(own_ptr);
+        });
+
+        while (deallocations_done.load() == false) { std::this_thread::yield(); }
+
+        // Only full batches are handed over
+        unit_test.test_equals(PerThreadCachingAllocatorType::get_instance().drain_thread_local_heap(), (allocation_count / batch_size) * batch_size, "scalable allocator", "remote deallocation batching - full batches");
+
+        flush_requested.store(true);
+        consumer_thread.join();
+
+        unit_test.test_equals(PerThreadCachingAllocatorType::get_instance().drain_thread_local_heap(), allocation_count % batch_size, "scalable allocator", "remote deallocation batching - flush");
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // TRANSFER CACHE
+    {
+        constexpr std::size_t batch_size = 32;
+        constexpr std::size_t allocation_count = 16384; // More than the local heap can hold for its 64 bytes bin
+        PerThreadCachingAllocatorType::get_instance().set_transfer_batch_size(batch_size);
+
+        std::thread allocating_thread([&]()
+        {
+            std::vector<void*> pointers;
+            bool all_allocations_ok = true;
+            auto initial_refill_count = PerThreadCachingAllocatorType::get_instance().get_transfer_cache_refill_count();
+
+            for (std::size_t i = 0; i < allocation_count; i++)
+            {
+                void* ptr = PerThreadCachingAllocatorType::get_instance().allocate(64);
+
+                if (ptr == nullptr || validate_buffer(ptr, 64) == false)
+                {
+                    all_allocations_ok = false;
+                    break;
+                }
+
+                pointers.push_back(ptr);
+            }
+
+            auto refill_count = PerThreadCachingAllocatorType::get_instance().get_transfer_cache_refill_count() - initial_refill_count;
+
+            unit_test.test_equals(all_allocations_ok, true, "scalable allocator", "transfer cache - allocations");
+            unit_test.test_equals(refill_count > 0, true, "scalable allocator", "transfer cache - central heap used");
+            unit_test.test_equals(refill_count <= allocation_count / batch_size + 1, true, "scalable allocator", "transfer cache - batched central heap accesses");
+
+            for (auto ptr : pointers)
+            {
+                PerThreadCachingAllocatorType::get_instance().deallocate(ptr);
+            }
+        });
+
+        allocating_thread.join();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // COMPILE TIME SIZES
+    {
+        struct Order
+        {
+            Order(uint64_t id) : m_id(id) {}
+            uint64_t m_id;
+            char m_symbol[40];
+        };
+
+        using HeapType = SimpleHeapPow2<ConcurrencyPolicy::THREAD_LOCAL>;
+        unit_test.test_equals(HeapType::get_bin_index_from_size(1), 0, "scalable allocator", "compile time sizes - bin of the min size class");
+        unit_test.test_equals(HeapType::get_bin_index_from_size(48), 2, "scalable allocator", "compile time sizes - bin of a non pow2 size");
+        unit_test.test_equals(HeapType::has_bin_for_size(65536), false, "scalable allocator", "compile time sizes - very big size");
+
+        std::vector<Order*> orders;
+        std::vector<void*> very_big_objects;
+
+        std::thread allocating_thread([&]()
+        {
+            bool all_allocations_ok = true;
+
+            for (uint64_t i = 0; i < 1000; i++)
+            {
+                Order* order = metamalloc_new<Order, PerThreadCachingAllocatorType>(i);
+                void* ptr = PerThreadCachingAllocatorType::get_instance().allocate<48>();
+
+                if (order == nullptr || ptr == nullptr || validate_buffer(ptr, 48) == false)
+                {
+                    all_allocations_ok = false;
+                    break;
+                }
+
+                orders.push_back(order);
+                PerThreadCachingAllocatorType::get_instance().deallocate<48>(ptr); // Owner deallocation
+            }
+
+            unit_test.test_equals(all_allocations_ok, true, "scalable allocator", "compile time sizes - allocations");
+
+            very_big_objects.push_back(PerThreadCachingAllocatorType::get_instance().allocate<1048576>());
+            unit_test.test_equals(validate_buffer(very_big_objects[0], 1048576), true, "scalable allocator", "compile time sizes - very big object");
+        });
+
+        allocating_thread.join();
+
+        bool all_values_ok = true;
+
+        for (uint64_t i = 0; i < orders.size(); i++)
+        {
+            if (orders[i]->m_id != i)
+            {
+                all_values_ok = false;
+            }
+
+            metamalloc_delete<Order, PerThreadCachingAllocatorType>(orders[i]); // Remote deallocation
+        }
+
+        unit_test.test_equals(all_values_ok, true, "scalable allocator", "compile time sizes - objects");
+
+        PerThreadCachingAllocatorType::get_instance().deallocate<1048576>(very_big_objects[0]);
+        PerThreadCachingAllocatorType::get_instance().deallocate<48>(nullptr);
+    }
+
     ////////////////////////////////////// PRINT THE REPORT
     std::cout << unit_test.get_summary_report("ScalableAllocator");
     std::cout.flush();
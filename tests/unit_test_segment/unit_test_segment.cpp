@@ -1,6 +1,7 @@
 #include "../unit_test.h" // Always should be the 1st one as it defines UNIT_TEST macro
 
 #include "../../include/logical_page.h"
+#include "../../include/logical_page_any_size.h"
 #include "../../include/arena.h"
 #include "../../include/segment.h"
 
@@ -9,6 +10,9 @@
 #include <cstddef>
 #include <cstdlib>
 #include <vector>
+#include <thread>
+#include <algorithm>
+#include <array>
 
 using namespace std;
 
@@ -200,6 +204,50 @@ int main(int argc, char* argv[])
     // UNBOUNDED SEGMENT TESTS, LOGICAL PAGE SIZE 64K
     run_test<LogicalPage<>>("LogicalPage", 65536, size_class, logical_page_count_per_segment, 16352, false); // no padding bytes , 64 bytes page header so 65536-64=65472 , 65472/128=511 , 511*32 = 16352
 
+    //////////////////////////////////////////////////////////////////////////
+    // UNBOUNDED SEGMENT TESTS WITH ANY SIZE LOGICAL PAGES, 16 BYTES ALLOCATION HEADER , 64 BYTES PAGE HEADER + 128 BYTES FREELIST TABLE
+    #ifdef __linux__
+    run_test<LogicalPageAnySize<>>("LogicalPageAnySize", 4096, size_class, logical_page_count_per_segment, 864, true); // 4096-64-128=3904 , 3904/144=27 , 27*32 = 864
+    #endif
+    run_test<LogicalPageAnySize<>>("LogicalPageAnySize", 65536, size_class, logical_page_count_per_segment, 14496, true); // 65536-64-128=65344 , 65344/144=453 , 453*32 = 14496
+
+    //////////////////////////////////////////////////////////////////////////
+    // ALIGNED ALLOCATIONS FROM ANY SIZE LOGICAL PAGES
+    {
+        Arena<>  arena;
+        bool success = arena.create(65536 * 10, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return false; }
+
+        Segment<ConcurrencyPolicy::SINGLE_THREAD, LogicalPageAnySize<>, Arena<>> segment;
+
+        SegmentCreationParameters params;
+        params.m_size_class = 0;
+        params.m_logical_page_count = 1;
+        params.m_logical_page_size = 65536;
+        params.m_page_recycling_threshold = 1;
+        params.m_grow_coefficient = 1;
+
+        success = segment.create(static_cast <char*>(arena.allocate(65536)), &arena, params);
+        if (!success) { std::cout << "Segment creation failed"; return -1; }
+
+        std::vector<void*> pointers;
+
+        for (std::size_t alignment = 16; alignment <= 8192; alignment *= 2)
+        {
+            auto ptr = segment.allocate_aligned(1000, alignment);
+            unit_test.test_equals(true, ptr != nullptr && AlignmentChecks::is_address_aligned(ptr, alignment), "segment any size", "aligned allocation " + std::to_string(alignment));
+            unit_test.test_equals(true, segment.get_usable_size(ptr) >= 1000, "segment any size", "usable size of aligned allocation " + std::to_string(alignment));
+            pointers.push_back(ptr);
+        }
+
+        unit_test.test_equals(true, segment.allocate(65536 - 64 - 128 - 16 + 1) == nullptr, "segment any size", "too big size");
+
+        for (auto ptr : pointers)
+        {
+            segment.deallocate(ptr);
+        }
+    }
+
     //////////////////////////////////////////////////////////////////////////
     // BOUNDED SEGMENT TEST ( THREAD LOCAL )
     {
@@ -240,6 +288,111 @@ int main(int argc, char* argv[])
         }
     }
 
+    //////////////////////////////////////////////////////////////////////////
+    // BOUNDED DRAINING OF THE DEALLOCATION QUEUE ( THREAD LOCAL )
+    {
+        Arena<>  arena;
+        bool success = arena.create(65536 * 10, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return false; }
+
+        Segment<ConcurrencyPolicy::THREAD_LOCAL, LogicalPage<>, Arena<>, PageRecyclingPolicy::DEFERRED> segment;
+        std::vector<void*> pointers;
+
+        SegmentCreationParameters params;
+        params.m_size_class = 64;
+        params.m_logical_page_count = 1;
+        params.m_logical_page_size = 65536;
+        params.m_deallocation_queue_drain_budget = 16;
+
+        success = segment.create(static_cast <char*>(arena.allocate(65536)), &arena, params);
+        if (!success) { std::cout << "Segment creation failed"; return -1; }
+
+        constexpr std::size_t ALLOCATION_COUNT = 1000; // Page capacity is (65536-64)/64 = 1023
+
+        for (std::size_t i = 0; i < ALLOCATION_COUNT; i++)
+        {
+            pointers.push_back(segment.allocate(64));
+        }
+
+        std::thread remote_deallocating_thread([&]()
+        {
+            for (auto ptr : pointers)
+            {
+                segment.deallocate(ptr);
+            }
+        });
+
+        remote_deallocating_thread.join();
+
+        // One of the popped pointers is returned to the caller , the other 15 are deallocated. Rest should stay in the queue
+        void* ptr = segment.allocate(64);
+        unit_test.test_equals(ptr != nullptr, true, "segment deallocation queue draining", "allocation from the queue");
+        unit_test.test_equals(segment.drain(100), 100, "segment deallocation queue draining", "drain with budget");
+        unit_test.test_equals(segment.drain(), ALLOCATION_COUNT - 16 - 100, "segment deallocation queue draining", "drain all");
+        unit_test.test_equals(segment.drain(), 0, "segment deallocation queue draining", "drain of an empty queue");
+
+        // Exhaust the page while there are pending deallocations beyond the budget , allocations should drain the rest before failing
+        pointers.clear();
+
+        for (std::size_t i = 0; i < 1022; i++)
+        {
+            pointers.push_back(segment.allocate(64));
+        }
+
+        remote_deallocating_thread = std::thread([&]()
+        {
+            for (auto ptr : pointers)
+            {
+                segment.deallocate(ptr);
+            }
+        });
+
+        remote_deallocating_thread.join();
+
+        bool all_allocations_ok = true;
+
+        for (std::size_t i = 0; i < 1022; i++) // 'ptr' is still in use
+        {
+            if (segment.allocate(64) == nullptr)
+            {
+                all_allocations_ok = false;
+                break;
+            }
+        }
+
+        unit_test.test_equals(all_allocations_ok, true, "segment deallocation queue draining", "draining all before failing");
+        unit_test.test_equals(segment.allocate(64) == nullptr, true, "segment deallocation queue draining", "exhaustion");
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // OWNER THREAD DEALLOCATIONS BYPASSING THE DEALLOCATION QUEUE ( THREAD LOCAL )
+    {
+        Arena<>  arena;
+        bool success = arena.create(65536 * 10, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return false; }
+
+        Segment<ConcurrencyPolicy::THREAD_LOCAL, LogicalPage<>, Arena<>, PageRecyclingPolicy::DEFERRED> segment;
+
+        SegmentCreationParameters params;
+        params.m_size_class = 64;
+        params.m_logical_page_count = 1;
+        params.m_logical_page_size = 65536;
+
+        success = segment.create(static_cast <char*>(arena.allocate(65536)), &arena, params);
+        if (!success) { std::cout << "Segment creation failed"; return -1; }
+
+        void* first_ptr = segment.allocate(64);
+        segment.deallocate_from_owner(first_ptr);
+        unit_test.test_equals(segment.drain(), 0, "segment owner deallocation", "deallocation queue untouched");
+
+        // Chunk should be available right away , hence the same address
+        void* second_ptr = segment.allocate(64);
+        unit_test.test_equals(second_ptr, first_ptr, "segment owner deallocation", "chunk returned to the page");
+
+        segment.deallocate(second_ptr);
+        unit_test.test_equals(segment.drain(), 1, "segment owner deallocation", "remote deallocation queued");
+    }
+
     //////////////////////////////////////////////////////////////////////////
     // PAGE RECYCLING , MODE AUTO
     {
@@ -364,6 +517,381 @@ int main(int argc, char* argv[])
         segment_two.transfer_logical_pages_from(segment_one);
         unit_test.test_equals(segment_one.get_logical_page_count(), 0, "segment logical page transfer", "after transfer , source segment");
         unit_test.test_equals(segment_two.get_logical_page_count(), 8, "segment logical page transfer", "after transfer , destination segment");
+
+        // Transferred logical pages should be reachable from the list , otherwise the segment would grow
+        std::vector<void*> pointers;
+
+        for (std::size_t i = 0; i < 8 * 2000; i++)
+        {
+            pointers.push_back(segment_two.allocate(32));
+        }
+
+        unit_test.test_equals(segment_two.get_logical_page_count(), 8, "segment logical page transfer", "allocations from transferred logical pages");
+
+        for (auto ptr : pointers)
+        {
+            segment_two.deallocate(ptr);
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // NON POWER OF TWO SIZE CLASSES
+    {
+        const uint32_t size_classes[] = { 48, 80, 1040, 3072 };
+
+        for (const auto size_class : size_classes)
+        {
+            Arena<>  arena;
+            bool success = arena.create(65536 * 10, 65536);
+            if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return false; }
+            Segment<ConcurrencyPolicy::CENTRAL, LogicalPage<>, Arena<>, PageRecyclingPolicy::IMMEDIATE, true> segment;
+
+            SegmentCreationParameters params;
+            params.m_size_class = size_class;
+            params.m_logical_page_count = 1;
+            params.m_logical_page_size = 65536;
+            params.m_page_recycling_threshold = 1;
+
+            success = segment.create(static_cast<char*>(arena.allocate(65536)), &arena, params);
+            if (!success) { std::cout << "Segment creation failed"; return -1; }
+
+            const std::size_t allocation_count = 2 * ((65536 - sizeof(LogicalPageHeader)) / size_class) + 1; // Will need 3 logical pages
+            std::vector<std::uint64_t> pointers;
+
+            for (std::size_t i = 0; i < allocation_count; i++)
+            {
+                pointers.push_back(reinterpret_cast<std::uint64_t>(segment.allocate(size_class)));
+            }
+
+            unit_test.test_equals(segment.get_logical_page_count(), 3, "segment non pow2 size classes", "grow sizeclass=" + std::to_string(size_class));
+
+            for (std::size_t i = 0; i < allocation_count; i++)
+            {
+                segment.deallocate(reinterpret_cast<void*>(pointers[i] + (i % size_class))); // Padded pointers
+            }
+
+            unit_test.test_equals(segment.get_logical_page_count(), 1, "segment non pow2 size classes", "recycling after padded deallocations sizeclass=" + std::to_string(size_class));
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // LOGICAL PAGES PLACED TO A BIGGER ALIGNMENT THAN THEIR SIZES
+    {
+        Arena<>  arena;
+        bool success = arena.create(262144 * 10, 262144);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return false; }
+        using SegmentType = Segment<ConcurrencyPolicy::CENTRAL, LogicalPage<>, Arena<>, PageRecyclingPolicy::IMMEDIATE, true>;
+
+        SegmentCreationParameters params;
+        params.m_size_class = 4096;
+        params.m_logical_page_count = 2;
+        params.m_logical_page_size = 65536;
+        params.m_logical_page_alignment = 100000; // Wrong param intended , not a multiple of the logical page size
+        params.m_page_recycling_threshold = 1;
+
+        {
+            SegmentType segment;
+            success = segment.create(static_cast<char*>(arena.allocate(262144 * 2)), &arena, params);
+            unit_test.test_equals(success, false, "segment logical page alignment", "creation failure due to incorrect alignment");
+        }
+
+        {
+            SegmentType segment;
+            params.m_logical_page_alignment = 262144;
+            success = segment.create(static_cast<char*>(arena.allocate(262144)), &arena, params);
+            unit_test.test_equals(success, false, "segment logical page alignment", "creation failure due to a logical page count which doesn't fill blocks");
+        }
+
+        SegmentType segment;
+        params.m_logical_page_alignment = 262144;
+        params.m_logical_page_count = 4; // 4 logical pages per 262144 bytes block
+        char* buffer = static_cast<char*>(arena.allocate(262144));
+        success = segment.create(buffer, &arena, params);
+        if (!success) { std::cout << "Segment creation failed"; return -1; }
+
+        const std::size_t allocation_count = 4 * ((65536 - sizeof(LogicalPageHeader)) / 4096) + 1; // Will need 5 logical pages
+        std::vector<void*> pointers;
+        bool all_pages_found_with_bigger_mask = true;
+        bool all_pages_in_blocks = true;
+
+        for (std::size_t i = 0; i < allocation_count; i++)
+        {
+            void* ptr = segment.allocate(4096);
+
+            if (ptr == nullptr || validate_buffer(ptr, 4096) == false || SegmentType::get_size_class_from_address(ptr, 262144) != 4096)
+            {
+                all_pages_found_with_bigger_mask = false;
+                break;
+            }
+
+            if (i < allocation_count - 1 && (reinterpret_cast<char*>(ptr) < buffer || reinterpret_cast<char*>(ptr) >= buffer + 262144))
+            {
+                all_pages_in_blocks = false; // First 4 logical pages are back to back in the initial block
+            }
+
+            pointers.push_back(ptr);
+        }
+
+        unit_test.test_equals(all_pages_found_with_bigger_mask, true, "segment logical page alignment", "finding logical pages with the alignment mask");
+        unit_test.test_equals(all_pages_in_blocks, true, "segment logical page alignment", "logical pages placed back to back in blocks");
+        unit_test.test_equals(segment.get_logical_page_count(), 8, "segment logical page alignment", "grow by whole blocks");
+
+        for (auto ptr : pointers)
+        {
+            segment.deallocate(ptr);
+        }
+
+        // The first logical page of each block holds the size class for the alignment mask , so it is not recycled
+        // 3 logical pages of the initial block are recycled , the second block keeps its head and 3 never used logical pages
+        unit_test.test_equals(segment.get_logical_page_count(), 5, "segment logical page alignment", "recycling except block heads");
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // THREAD LOCAL SEGMENT WITH THREAD FREE LISTS , DEALLOCATIONS FROM MULTIPLE THREADS
+    {
+        Arena<>  arena;
+        bool success = arena.create(65536 * 10, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return false; }
+        Segment<ConcurrencyPolicy::THREAD_LOCAL, LogicalPage<>, Arena<>, PageRecyclingPolicy::DEFERRED, true, RemoteDeallocationPolicy::THREAD_FREE_LIST> segment;
+
+        char* initial_buffer = static_cast <char*>(arena.allocate(65536));
+
+        SegmentCreationParameters params;
+        params.m_size_class = 2048;
+        params.m_logical_page_count = 1;
+        params.m_logical_page_size = 65536;
+
+        success = segment.create(initial_buffer, &arena, params);
+        if (!success) { std::cout << "Segment creation failed"; return -1; }
+
+        constexpr std::size_t CHUNK_COUNT = 31;
+        constexpr std::size_t THREAD_COUNT = 4;
+        std::vector<std::uint64_t> pointers;
+
+        for (std::size_t i = 0; i < CHUNK_COUNT; i++)
+        {
+            pointers.push_back(reinterpret_cast<std::uint64_t>(segment.allocate(2048)));
+        }
+
+        unit_test.test_equals(segment.allocate(2048) == nullptr, true, "segment thread free list", "exhaustion");
+
+        std::vector<std::thread> threads;
+
+        for (std::size_t i = 0; i < THREAD_COUNT; i++)
+        {
+            threads.emplace_back([&segment, &pointers, i]()
+            {
+                for (std::size_t j = i; j < CHUNK_COUNT; j += THREAD_COUNT)
+                {
+                    segment.deallocate(reinterpret_cast<void*>(pointers[j]));
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        std::vector<std::uint64_t> reallocated_pointers;
+
+        for (std::size_t i = 0; i < CHUNK_COUNT; i++)
+        {
+            reallocated_pointers.push_back(reinterpret_cast<std::uint64_t>(segment.allocate(2048)));
+        }
+
+        std::sort(pointers.begin(), pointers.end());
+        std::sort(reallocated_pointers.begin(), reallocated_pointers.end());
+
+        unit_test.test_equals(reallocated_pointers == pointers, true, "segment thread free list", "all remote deallocations collected");
+        unit_test.test_equals(segment.allocate(2048) == nullptr, true, "segment thread free list", "exhaustion after collection");
+        unit_test.test_equals(segment.get_logical_page_count(), 1, "segment thread free list", "bounded page count");
+
+        for (const auto& ptr : reallocated_pointers)
+        {
+            segment.deallocate(reinterpret_cast<void*>(ptr + 16)); // Padded pointers from aligned allocations are also handled
+        }
+
+        unit_test.test_equals(segment.allocate(2048) != nullptr, true, "segment thread free list", "allocation after padded deallocations");
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // CENTRAL SEGMENT WITH LOCKFREE FREE LIST , ALLOCATIONS AND DEALLOCATIONS FROM MULTIPLE THREADS
+    {
+        Arena<>  arena;
+        bool success = arena.create(65536 * 100, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return false; }
+        Segment<ConcurrencyPolicy::CENTRAL, LogicalPage<>, Arena<>, PageRecyclingPolicy::IMMEDIATE, true, RemoteDeallocationPolicy::DEALLOCATION_QUEUE, CentralFreeListPolicy::LOCKFREE> segment;
+
+        SegmentCreationParameters params;
+        params.m_size_class = 64;
+        params.m_logical_page_count = 1;
+        params.m_logical_page_size = 65536;
+
+        success = segment.create(static_cast <char*>(arena.allocate(65536)), &arena, params);
+        if (!success) { std::cout << "Segment creation failed"; return -1; }
+
+        // Padded pointers from aligned allocations should go back as chunk starts
+        void* first_ptr = segment.allocate(64);
+        segment.deallocate(static_cast<char*>(first_ptr) + 16);
+        unit_test.test_equals(segment.allocate(64), first_ptr, "segment lockfree central free list", "padded deallocation");
+        segment.deallocate(first_ptr);
+
+        constexpr std::size_t THREAD_COUNT = 8;
+        constexpr std::size_t ITERATION_COUNT = 20000;
+        constexpr std::size_t LIVE_POINTER_COUNT = 64;
+        std::array<bool, THREAD_COUNT> thread_results;
+        std::vector<std::thread> threads;
+
+        for (std::size_t i = 0; i < THREAD_COUNT; i++)
+        {
+            threads.emplace_back([&segment, &thread_results, i]()
+            {
+                // Each thread stamps its chunks , if a chunk was handed to 2 threads at the same time a stamp will be overwritten
+                std::array<uint64_t*, LIVE_POINTER_COUNT> live_pointers{};
+                thread_results[i] = true;
+
+                for (std::size_t j = 0; j < ITERATION_COUNT; j++)
+                {
+                    auto& slot = live_pointers[j % LIVE_POINTER_COUNT];
+
+                    if (slot != nullptr)
+                    {
+                        if (slot[1] != i || slot[7] != j % LIVE_POINTER_COUNT) { thread_results[i] = false; }
+                        segment.deallocate(slot);
+                    }
+
+                    slot = static_cast<uint64_t*>(segment.allocate(64));
+
+                    if (slot == nullptr) { thread_results[i] = false; return; }
+
+                    slot[1] = i;
+                    slot[7] = j % LIVE_POINTER_COUNT;
+                }
+
+                for (auto ptr : live_pointers)
+                {
+                    segment.deallocate(ptr);
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        bool all_ok = true;
+
+        for (const auto result : thread_results)
+        {
+            all_ok = all_ok && result;
+        }
+
+        unit_test.test_equals(all_ok, true, "segment lockfree central free list", "multithreaded allocations and deallocations");
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // CENTRAL SEGMENT WITH LOCKFREE FREE LIST , LOGICAL PAGE RECYCLING
+    {
+        Arena<>  arena;
+        bool success = arena.create(65536 * 100, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return false; }
+
+        using LockfreeSegmentType = Segment<ConcurrencyPolicy::CENTRAL, LogicalPage<>, Arena<>, PageRecyclingPolicy::IMMEDIATE, true, RemoteDeallocationPolicy::DEALLOCATION_QUEUE, CentralFreeListPolicy::LOCKFREE>;
+
+        SegmentCreationParameters params;
+        params.m_size_class = 64;
+        params.m_logical_page_count = 1;
+        params.m_logical_page_size = 65536;
+        params.m_page_recycling_threshold = 1;
+
+        constexpr std::size_t ALLOCATION_COUNT = 4000; // Needs 4 logical pages
+        std::vector<void*> pointers;
+
+        // Drains only on demand
+        {
+            params.m_central_free_list_drain_interval = 0;
+            LockfreeSegmentType segment;
+            success = segment.create(static_cast <char*>(arena.allocate(65536)), &arena, params);
+            if (!success) { std::cout << "Segment creation failed"; return -1; }
+
+            pointers.clear();
+
+            for (std::size_t i = 0; i < ALLOCATION_COUNT; i++)
+            {
+                pointers.push_back(segment.allocate(64));
+            }
+
+            auto grown_logical_page_count = segment.get_logical_page_count();
+
+            for (auto ptr : pointers)
+            {
+                segment.deallocate(ptr);
+            }
+
+            unit_test.test_equals(segment.get_logical_page_count(), grown_logical_page_count, "segment lockfree central free list", "chunks stay in the free list before drain");
+            unit_test.test_equals(segment.drain(), ALLOCATION_COUNT, "segment lockfree central free list", "drain count");
+            unit_test.test_equals(segment.get_logical_page_count(), 1, "segment lockfree central free list", "logical page recycling after drain");
+            unit_test.test_equals(segment.allocate(64) != nullptr, true, "segment lockfree central free list", "allocation after drain");
+        }
+
+        // Periodic drains , while other threads allocate and deallocate
+        {
+            params.m_central_free_list_drain_interval = 256;
+            LockfreeSegmentType segment;
+            success = segment.create(static_cast <char*>(arena.allocate(65536)), &arena, params);
+            if (!success) { std::cout << "Segment creation failed"; return -1; }
+
+            constexpr std::size_t THREAD_COUNT = 4;
+            std::array<bool, THREAD_COUNT> thread_results;
+            std::vector<std::thread> threads;
+
+            for (std::size_t i = 0; i < THREAD_COUNT; i++)
+            {
+                threads.emplace_back([&segment, &thread_results, i]()
+                {
+                    thread_results[i] = true;
+
+                    for (std::size_t round = 0; round < 20; round++)
+                    {
+                        std::vector<uint64_t*> thread_pointers;
+
+                        for (std::size_t j = 0; j < ALLOCATION_COUNT; j++)
+                        {
+                            auto ptr = static_cast<uint64_t*>(segment.allocate(64));
+                            if (ptr == nullptr) { thread_results[i] = false; return; }
+                            ptr[1] = i;
+                            thread_pointers.push_back(ptr);
+                        }
+
+                        for (auto ptr : thread_pointers)
+                        {
+                            if (ptr[1] != i) { thread_results[i] = false; }
+                            segment.deallocate(ptr);
+                        }
+                    }
+                });
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            bool all_ok = true;
+
+            for (const auto result : thread_results)
+            {
+                all_ok = all_ok && result;
+            }
+
+            unit_test.test_equals(all_ok, true, "segment lockfree central free list", "multithreaded allocations and deallocations with periodic drains");
+            unit_test.test_equals(segment.get_logical_page_count() < THREAD_COUNT * 4, true, "segment lockfree central free list", "logical page recycling with periodic drains");
+
+            segment.drain();
+            unit_test.test_equals(segment.get_logical_page_count(), 1, "segment lockfree central free list", "logical page recycling after final drain");
+        }
     }
 
     ////////////////////////////////////// PRINT THE REPORT
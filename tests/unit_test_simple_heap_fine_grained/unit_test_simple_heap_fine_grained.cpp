@@ -0,0 +1,311 @@
+#define UNIT_TEST
+#include "../../metamalloc.h"
+using namespace metamalloc;
+
+#include "../../tests/unit_test.h" // Always should be the 1st one as it defines UNIT_TEST macro
+#include "../../examples/simple_heap_fine_grained.h"
+
+#include <array>
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+UnitTest unit_test;
+
+struct Allocation
+{
+    void* ptr = nullptr;
+    uint32_t size_class = 0;
+};
+
+inline bool validate_buffer(void* buffer, std::size_t buffer_size)
+{
+    char* char_buffer = static_cast<char*>(buffer);
+
+    // TRY WRITING
+    for (std::size_t i = 0; i < buffer_size; i++)
+    {
+        char* dest = char_buffer + i;
+        *dest = static_cast<char>(i);
+    }
+
+    // NOW CHECK READING
+    for (std::size_t i = 0; i < buffer_size; i++)
+    {
+        auto test = char_buffer[i];
+        if (test != static_cast<char>(i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+using HeapType = SimpleHeapFineGrained<>;
+
+using PerThreadCachingAllocatorType = ScalableAllocator<
+    SimpleHeapFineGrained<ConcurrencyPolicy::CENTRAL>,       // CENTRAL HEAP
+    SimpleHeapFineGrained<ConcurrencyPolicy::THREAD_LOCAL>,  // THREAD LOCAL HEAP
+    Arena<>
+>;
+
+int main(int argc, char* argv[])
+{
+    ///////////////////////////////////////////////////////////////////////////////////////
+    // SIZE CLASSES
+    {
+        const std::array<uint32_t, HeapType::BIN_COUNT> expected_size_classes = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024,
+                                                                                    1280, 1536, 1792, 2048, 2560, 3072, 3584, 4096, 5120, 6144, 7168, 8192, 10240, 12288, 14336, 16384, 20480, 24576, 28672, 32768 };
+
+        unit_test.test_equals(HeapType::SIZE_CLASSES == expected_size_classes, true, "heap fine grained", "size classes");
+        unit_test.test_equals(HeapType::LARGEST_SIZE_CLASS, 32768, "heap fine grained", "largest size class");
+
+        // Every size should map to the smallest size class which can hold it
+        bool all_sizes_mapped_correctly = true;
+
+        for (std::size_t size = 1; size <= HeapType::LARGEST_SIZE_CLASS; size++)
+        {
+            auto bin_index = HeapType::get_bin_index_from_size(size);
+            bool fits = HeapType::get_size_class(bin_index) >= size;
+            bool tightest = bin_index == 0 || HeapType::get_size_class(bin_index - 1) < size;
+
+            if (!fits || !tightest)
+            {
+                std::cout << "WRONG BIN INDEX FOR SIZE " << size << std::endl;
+                all_sizes_mapped_correctly = false;
+                break;
+            }
+        }
+
+        unit_test.test_equals(all_sizes_mapped_correctly, true, "heap fine grained", "size to bin lookups");
+        unit_test.test_equals(HeapType::get_bin_index_from_size(0), 0, "heap fine grained", "size 0 lookup");
+        unit_test.test_equals(HeapType::get_bin_index_from_size(48), 2, "heap fine grained", "48 bytes lookup");
+        unit_test.test_equals(HeapType::get_size_class(HeapType::get_bin_index_from_size(600)), 640, "heap fine grained", "600 bytes lookup");
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    // HEAP CREATION FAILURE
+    {
+        HeapType heap;
+        Arena<> arena;
+        bool success = arena.create(65536 * 10, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return -1; }
+        HeapType::HeapCreationParams params;
+        params.m_logical_page_size = 65500; // Wrong param intended
+        success = heap.create(params, &arena);
+        unit_test.test_equals(success, false, "heap fine grained", "creation failure due to incorrect parameters");
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    // HEAP GENERAL TESTS , ALL SIZE CLASSES WITH GROWTH
+    {
+        HeapType heap;
+        Arena<> arena;
+        bool success = arena.create(65536 * 100, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return -1; }
+        HeapType::HeapCreationParams params;
+        params.m_logical_page_size = 65536;
+        params.m_segment_grow_coefficient = 0;
+        params.m_logical_page_recycling_threshold = 1;
+
+        success = heap.create(params, &arena);
+        if (!success) { std::cout << "HEAP CREATION FAILED !!!" << std::endl; return -1; }
+
+        constexpr std::size_t ALLOCATION_COUNT_PER_SIZE_CLASS = 64;
+        std::vector<Allocation> allocations;
+        bool all_allocations_ok = true;
+
+        for (std::size_t bin_index = 0; bin_index < HeapType::BIN_COUNT; bin_index++)
+        {
+            // Request one byte more than the previous size class , so that we hit the worst case for internal fragmentation
+            std::size_t allocation_size = bin_index == 0 ? 1 : HeapType::get_size_class(bin_index - 1) + 1;
+
+            for (std::size_t i = 0; i < ALLOCATION_COUNT_PER_SIZE_CLASS; i++)
+            {
+                void* ptr = heap.allocate(allocation_size);
+
+                if (ptr == nullptr || validate_buffer(ptr, allocation_size) == false || heap.get_usable_size(ptr) != HeapType::get_size_class(bin_index))
+                {
+                    all_allocations_ok = false;
+                    break;
+                }
+
+                allocations.push_back({ ptr, HeapType::get_size_class(bin_index) });
+            }
+        }
+
+        unit_test.test_equals(all_allocations_ok, true, "heap fine grained", "allocations of all size classes");
+        unit_test.test_equals(heap.get_bin_logical_page_count(HeapType::BIN_COUNT - 1) > 1, true, "heap fine grained", "largest bin growth");
+
+        for (const auto& allocation : allocations)
+        {
+            heap.deallocate(allocation.ptr);
+        }
+
+        bool all_bins_shrunk = true;
+
+        for (std::size_t bin_index = 0; bin_index < HeapType::BIN_COUNT; bin_index++)
+        {
+            if (heap.get_bin_logical_page_count(bin_index) != 1)
+            {
+                all_bins_shrunk = false;
+            }
+        }
+
+        unit_test.test_equals(all_bins_shrunk, true, "heap fine grained", "recycling after deallocations");
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    // ALIGNED ALLOCATIONS , NON POW2 SIZE CLASSES SHOULD BE UNPADDED CORRECTLY
+    {
+        HeapType heap;
+        Arena<> arena;
+        bool success = arena.create(65536 * 100, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return -1; }
+        HeapType::HeapCreationParams params;
+        params.m_logical_page_size = 65536;
+        params.m_logical_page_recycling_threshold = 4096;
+
+        success = heap.create(params, &arena);
+        if (!success) { std::cout << "HEAP CREATION FAILED !!!" << std::endl; return -1; }
+
+        struct AlignedAllocation
+        {
+            std::size_t size = 0;
+            std::size_t alignment = 0;
+        };
+
+        std::vector<AlignedAllocation> aligned_allocations = { {5,32}, {23,128}, {40, 64}, {1025, 64} , {1008,1024} , {240, 256}, {600, 512}, {2032, 2048}, {4080, 4096}, {8176, 8192} };
+
+        for (const auto& aligned_allocation : aligned_allocations)
+        {
+            void* first_ptr = heap.allocate_aligned(aligned_allocation.size, aligned_allocation.alignment);
+            bool ok = first_ptr != nullptr && AlignmentChecks::is_address_aligned(first_ptr, aligned_allocation.alignment) && validate_buffer(first_ptr, aligned_allocation.size);
+            heap.deallocate(first_ptr);
+
+            // Padded pointer should have been added back as the original chunk, hence the same address
+            void* second_ptr = heap.allocate_aligned(aligned_allocation.size, aligned_allocation.alignment);
+            ok = ok && second_ptr == first_ptr;
+            heap.deallocate(second_ptr);
+
+            unit_test.test_equals(ok, true, "heap fine grained", "aligned allocation size=" + std::to_string(aligned_allocation.size) + " alignment=" + std::to_string(aligned_allocation.alignment));
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    // SCALABLE ALLOCATOR , AS CENTRAL AND THREAD LOCAL HEAPS
+    {
+        PerThreadCachingAllocatorType::get_instance().set_thread_local_heap_cache_count(4);
+        bool success = PerThreadCachingAllocatorType::get_instance().create({ 65536 }, { 65536 }, 65536 * 1024, 65536, 65536);
+        unit_test.test_equals(success, true, "heap fine grained", "scalable allocator creation");
+
+        constexpr std::size_t THREAD_COUNT = 8;
+        constexpr std::size_t ALLOCATION_PER_THREAD_COUNT = 1024;
+        std::array<std::vector<Allocation>, THREAD_COUNT> thread_allocations;
+        std::array<bool, THREAD_COUNT> thread_results;
+
+        auto allocating_thread_function = [&](std::size_t thread_index)
+        {
+            thread_results[thread_index] = true;
+
+            for (std::size_t i = 0; i < ALLOCATION_PER_THREAD_COUNT; i++)
+            {
+                std::size_t allocation_size = 1 + ((i * 37 + thread_index * 101) % 4096);
+                void* ptr = PerThreadCachingAllocatorType::get_instance().allocate(allocation_size);
+
+                if (ptr == nullptr || validate_buffer(ptr, allocation_size) == false)
+                {
+                    thread_results[thread_index] = false;
+                    return;
+                }
+
+                thread_allocations[thread_index].push_back({ ptr, static_cast<uint32_t>(allocation_size) });
+            }
+        };
+
+        auto deallocating_thread_function = [&](std::size_t bucket_index)
+        {
+            for (const auto& allocation : thread_allocations[bucket_index])
+            {
+                PerThreadCachingAllocatorType::get_instance().deallocate(allocation.ptr);
+            }
+        };
+
+        std::vector<std::thread> threads;
+
+        for (std::size_t i = 0; i < THREAD_COUNT; i++)
+        {
+            threads.emplace_back(allocating_thread_function, i);
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        threads.clear();
+
+        bool all_allocations_ok = true;
+
+        for (const auto result : thread_results)
+        {
+            all_allocations_ok = all_allocations_ok && result;
+        }
+
+        unit_test.test_equals(all_allocations_ok, true, "heap fine grained", "scalable allocator multithreaded allocations");
+
+        // Deallocations from different threads than the allocating ones
+        for (std::size_t i = 0; i < THREAD_COUNT; i++)
+        {
+            threads.emplace_back(deallocating_thread_function, THREAD_COUNT - 1 - i);
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        // Keeps the logical page in use , so that it is not recycled during the tests below
+        void* held_ptr = PerThreadCachingAllocatorType::get_instance().allocate(600);
+
+        void* ptr = PerThreadCachingAllocatorType::get_instance().allocate(600);
+        unit_test.test_equals(PerThreadCachingAllocatorType::get_instance().get_usable_size(ptr), 640, "heap fine grained", "scalable allocator usable size");
+        PerThreadCachingAllocatorType::get_instance().deallocate(ptr);
+
+        // Deallocations from the owner thread don't go through the deallocation queue
+        unit_test.test_equals(PerThreadCachingAllocatorType::get_instance().drain_thread_local_heap(), 0, "heap fine grained", "scalable allocator owner deallocation bypassing the queue");
+
+        // Whereas the ones from other threads do
+        ptr = PerThreadCachingAllocatorType::get_instance().allocate(600);
+        std::thread remote_deallocating_thread([&]() { PerThreadCachingAllocatorType::get_instance().deallocate(ptr); });
+        remote_deallocating_thread.join();
+        unit_test.test_equals(PerThreadCachingAllocatorType::get_instance().drain_thread_local_heap(), 1, "heap fine grained", "scalable allocator draining thread local heap");
+        unit_test.test_equals(PerThreadCachingAllocatorType::get_instance().drain_thread_local_heap(), 0, "heap fine grained", "scalable allocator draining empty thread local heap");
+
+        PerThreadCachingAllocatorType::get_instance().deallocate(held_ptr);
+    }
+
+    ////////////////////////////////////// PRINT THE REPORT
+    std::cout << unit_test.get_summary_report("Simple heap fine grained");
+    std::cout.flush();
+
+    #if _WIN32
+    bool pause = true;
+    if(argc > 1)
+    {
+        if (std::strcmp(argv[1], "no_pause") == 0)
+            pause = false;
+    }
+    if(pause)
+        std::system("pause");
+    #endif
+
+    return unit_test.did_all_pass();
+}
@@ -262,6 +262,88 @@ int main(int argc, char* argv[])
     }
 
 
+    ///////////////////////////////////////////////////////////////////////////////////////
+    // BINS WITH DIFFERENT LOGICAL PAGE SIZES
+    {
+        SimpleHeapPow2<>::HeapCreationParams params;
+        params.m_logical_page_size = 65536;
+        params.m_segment_grow_coefficient = 0;
+        params.m_logical_page_recycling_threshold = 4096;
+        params.m_bin_logical_page_sizes[10] = 262144; // 16KB sizeclass
+        params.m_bin_logical_page_sizes[11] = 262144; // 32KB sizeclass
+
+        {
+            SimpleHeapPow2<> heap;
+            Arena<> arena;
+            bool success = arena.create(262144 * 40, 65536);
+            if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return -1; }
+            success = heap.create(params, &arena);
+            unit_test.test_equals(success, false, "heap pow 2", "different logical page sizes , creation failure due to arena alignment");
+        }
+
+        {
+            SimpleHeapPow2<> heap;
+            Arena<> arena;
+            bool success = arena.create(262144 * 40, 262144);
+            if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return -1; }
+            auto wrong_params = params;
+            wrong_params.m_bin_logical_page_sizes[9] = 196608; // Not a power of two
+            success = heap.create(wrong_params, &arena);
+            unit_test.test_equals(success, false, "heap pow 2", "different logical page sizes , creation failure due to non power of two size");
+        }
+
+        SimpleHeapPow2<> heap;
+        Arena<> arena;
+        bool success = arena.create(262144 * 40, 262144);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return -1; }
+        success = heap.create(params, &arena);
+        unit_test.test_equals(success, true, "heap pow 2", "different logical page sizes , creation");
+
+        std::vector<Allocation> object_allocations;
+
+        // A 256KB page should hold 7 32KB chunks and 15 16KB chunks , whereas a 64KB page can hold only 1 and 3
+        for (std::size_t i = 0; i < 7; i++)
+        {
+            if (validate_allocation(&heap, 32768, 262144, object_allocations) == false) return -1;
+        }
+
+        for (std::size_t i = 0; i < 15; i++)
+        {
+            if (validate_allocation(&heap, 16384, 262144, object_allocations) == false) return -1;
+        }
+
+        unit_test.test_equals(heap.get_bin_logical_page_count(11), 1, "heap pow 2", "different logical page sizes , 32KB chunks in a single page");
+        unit_test.test_equals(heap.get_bin_logical_page_count(10), 1, "heap pow 2", "different logical page sizes , 16KB chunks in a single page");
+
+        if (validate_allocation(&heap, 32768, 262144, object_allocations) == false) return -1;
+        unit_test.test_equals(heap.get_bin_logical_page_count(11), 2, "heap pow 2", "different logical page sizes , growth");
+
+        // Bins with 64KB pages , their pages are still found with the 256KB mask as they start on 256KB aligned addresses
+        for (const auto& size_class : { 16, 256, 2048, 8192 })
+        {
+            for (std::size_t i = 0; i < 64; i++)
+            {
+                if (validate_allocation(&heap, size_class, 262144, object_allocations) == false) return -1;
+            }
+        }
+
+        unit_test.test_equals(heap.get_bin_logical_page_count(9) > 1, true, "heap pow 2", "different logical page sizes , growth of a bin with smaller pages");
+
+        bool all_usable_sizes_correct = true;
+
+        for (const auto& object_allocation : object_allocations)
+        {
+            if (heap.get_usable_size(reinterpret_cast<void*>(object_allocation.ptr)) != object_allocation.size_class)
+            {
+                all_usable_sizes_correct = false;
+            }
+
+            heap.deallocate(reinterpret_cast<void*>(object_allocation.ptr));
+        }
+
+        unit_test.test_equals(all_usable_sizes_correct, true, "heap pow 2", "different logical page sizes , size class lookups");
+    }
+
     
     ///////////////////////////////////////////////////////////////////////////////////////
     // ALIGNED ALLOCATIONS
@@ -437,6 +519,150 @@ int main(int argc, char* argv[])
             heap.deallocate(reinterpret_cast<void*>(object_allocation.ptr));
         }
     }
+
+    ///////////////////////////////////////////////////////////////////////////////////////
+    // BOUNDED HEAP WITH SHARED LOGICAL PAGE POOL
+    {
+        using TestHeapType = SimpleHeapPow2<ConcurrencyPolicy::THREAD_LOCAL>;
+
+        Arena<> arena;
+        bool success = arena.create(65536 * 16, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return -1; }
+
+        TestHeapType::HeapCreationParams params;
+        params.m_logical_page_size = 65536;
+        params.m_logical_page_recycling_threshold = 0;
+        params.m_use_shared_logical_page_pool = true; // 12 bins with 1 logical page each , so 12 logical pages in the pool
+
+        {
+            SimpleHeapPow2<> central_heap;
+            SimpleHeapPow2<>::HeapCreationParams central_heap_params;
+            central_heap_params.m_use_shared_logical_page_pool = true;
+            success = central_heap.create(central_heap_params, &arena);
+            unit_test.test_equals(success, false, "heap pow 2", "shared logical page pool , creation failure due to unbounded heap");
+        }
+
+        TestHeapType heap;
+        success = heap.create(params, &arena);
+        unit_test.test_equals(success, true, "heap pow 2", "shared logical page pool , creation");
+        unit_test.test_equals(heap.get_bin_logical_page_count(0), 0, "heap pow 2", "shared logical page pool , bins start empty");
+        unit_test.test_equals(heap.get_free_logical_page_pool_slot_count(), 12, "heap pow 2", "shared logical page pool , initial free slot count");
+
+        // Bin16 can use more logical pages than its own share
+        std::size_t objects_per_16_byte_page = (params.m_logical_page_size - sizeof(LogicalPage<>)) / 16;
+        std::vector<void*> pointers;
+
+        for (std::size_t i = 0; i < objects_per_16_byte_page * 3; i++)
+        {
+            void* ptr = heap.allocate(16);
+
+            if (ptr == nullptr || heap.owns_pointer(ptr) == false)
+            {
+                std::cout << "ALLOCATION FAILED !!!" << std::endl;
+                return -1;
+            }
+
+            pointers.push_back(ptr);
+        }
+
+        unit_test.test_equals(heap.get_bin_logical_page_count(0), 3, "heap pow 2", "shared logical page pool , Bin16 grows beyond its share");
+        unit_test.test_equals(heap.get_free_logical_page_pool_slot_count(), 9, "heap pow 2", "shared logical page pool , free slot count after Bin16 growth");
+
+        // Empty logical pages go back to the pool
+        for (auto ptr : pointers)
+        {
+            heap.deallocate_from_owner(ptr);
+        }
+
+        pointers.clear();
+
+        unit_test.test_equals(heap.get_bin_logical_page_count(0), 0, "heap pow 2", "shared logical page pool , Bin16 after recycling");
+        unit_test.test_equals(heap.get_free_logical_page_pool_slot_count(), 12, "heap pow 2", "shared logical page pool , free slot count after recycling");
+
+        // And another bin can use all of them
+        std::size_t objects_per_2048_byte_page = (params.m_logical_page_size - sizeof(LogicalPage<>)) / 2048;
+
+        for (std::size_t i = 0; i < objects_per_2048_byte_page * 12; i++)
+        {
+            void* ptr = heap.allocate(2048);
+
+            if (ptr == nullptr || validate_buffer(ptr, 2048) == false)
+            {
+                std::cout << "ALLOCATION FAILED !!!" << std::endl;
+                return -1;
+            }
+
+            pointers.push_back(ptr);
+        }
+
+        unit_test.test_equals(heap.get_bin_logical_page_count(7), 12, "heap pow 2", "shared logical page pool , Bin2048 uses all pooled pages");
+        unit_test.test_equals(heap.allocate(2048) == nullptr, true, "heap pow 2", "shared logical page pool , bounded by the pool size");
+
+        for (auto ptr : pointers)
+        {
+            heap.deallocate_from_owner(ptr);
+        }
+    }
+
+    // BOUNDED HEAP WHICH GROWS BY EXTRA REGIONS
+    {
+        using TestHeapType = SimpleHeapPow2<ConcurrencyPolicy::THREAD_LOCAL>;
+
+        Arena<> arena;
+        bool success = arena.create(65536 * 32, 65536);
+        if (!success) { std::cout << "ARENA CREATION FAILED !!!" << std::endl; return -1; }
+
+        TestHeapType::HeapCreationParams params;
+        params.m_logical_page_size = 65536;
+        params.m_logical_page_recycling_threshold = 0;
+        params.m_use_shared_logical_page_pool = true; // 12 logical pages in the pool
+        params.m_max_extra_region_count = 2;
+        params.m_extra_region_logical_page_count = 4;
+
+        {
+            TestHeapType heap;
+            TestHeapType::HeapCreationParams params_without_pool;
+            params_without_pool.m_max_extra_region_count = 2;
+            success = heap.create(params_without_pool, &arena);
+            unit_test.test_equals(success, false, "heap pow 2", "extra regions , creation failure without a shared logical page pool");
+        }
+
+        TestHeapType heap;
+        success = heap.create(params, &arena);
+        unit_test.test_equals(success, true, "heap pow 2", "extra regions , creation");
+
+        std::size_t objects_per_2048_byte_page = (params.m_logical_page_size - sizeof(LogicalPage<>)) / 2048;
+        std::vector<void*> pointers;
+
+        // 12 initial logical pages and 2 extra regions with 4 logical pages each
+        for (std::size_t i = 0; i < objects_per_2048_byte_page * 20; i++)
+        {
+            void* ptr = heap.allocate(2048);
+
+            if (ptr == nullptr || heap.owns_pointer(ptr) == false || validate_buffer(ptr, 2048) == false)
+            {
+                std::cout << "ALLOCATION FAILED !!!" << std::endl;
+                return -1;
+            }
+
+            pointers.push_back(ptr);
+        }
+
+        unit_test.test_equals(heap.get_extra_region_count(), 2, "heap pow 2", "extra regions , region count");
+        unit_test.test_equals(heap.get_logical_page_pool_capacity(), 20, "heap pow 2", "extra regions , logical page capacity");
+        unit_test.test_equals(heap.get_bin_logical_page_count(7), 20, "heap pow 2", "extra regions , Bin2048 uses all logical pages");
+        unit_test.test_equals(heap.allocate(2048) == nullptr, true, "heap pow 2", "extra regions , bounded by the max region count");
+
+        int dummy = 0;
+        unit_test.test_equals(heap.owns_pointer(&dummy), false, "heap pow 2", "extra regions , owns_pointer for a foreign pointer");
+
+        for (auto ptr : pointers)
+        {
+            heap.deallocate_from_owner(ptr);
+        }
+
+        unit_test.test_equals(heap.get_free_logical_page_pool_slot_count(), 20, "heap pow 2", "extra regions , free slot count after recycling");
+    }
     
     {
         Arena<> m_arena;
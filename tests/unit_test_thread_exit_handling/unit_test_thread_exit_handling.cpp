@@ -5,6 +5,7 @@
 using namespace metamalloc;
 
 #include <vector>
+#include <atomic>
 #include <memory>
 #include <thread>
 #include <cstring>
@@ -53,6 +54,33 @@ int main(int argc, char* argv[])
 
     unit_test.test_equals(central_heap->get_bin_logical_page_count(11), 2, "thread exit handling", "logical page count after transfer");
 
+    // Threads starting together claim heap slots without a shared lock
+    constexpr std::size_t STARTING_THREAD_COUNT = 32;
+    std::atomic<bool> start = false;
+    threads.clear();
+
+    for (std::size_t i = 0; i < STARTING_THREAD_COUNT; i++)
+    {
+        threads.emplace_back(new std::thread([&]()
+        {
+            while (start.load() == false) { std::this_thread::yield(); }
+
+            void* ptr = AllocatorType::get_instance().allocate(16);
+            AllocatorType::get_instance().deallocate(ptr);
+        }));
+    }
+
+    start.store(true);
+
+    for (auto& thread : threads)
+    {
+        thread->join();
+    }
+
+    // Each exiting thread transfers its own heap's logical pages
+    unit_test.test_equals(central_heap->get_bin_logical_page_count(11), 2 + STARTING_THREAD_COUNT, "thread start", "a distinct heap for each starting thread");
+    unit_test.test_equals(AllocatorType::get_instance().get_observed_unique_thread_count(), STARTING_THREAD_COUNT + 2, "thread start", "observed unique thread count");
+
     ////////////////////////////////////// PRINT THE REPORT
     std::cout << unit_test.get_summary_report("ThreadExitHandling");
     std::cout.flush();